@@ -1,34 +1,78 @@
 #include <stdio.h>
+#include <string.h>
 #include <math.h> 
 #include "pico/stdlib.h"
 #include "hardware/adc.h"
 #include "hardware/timer.h"
 #include "pico/bootrom.h"
-#include "hardware/pio.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
 #include "hardware/clocks.h"
 #include "hardware/i2c.h"
-#include "ws2812.pio.h"
 #include "lib/ssd1306.h"
-#include "lib/font.h"
+#include "lib/acquisition.h"
+#include "lib/noise_level.h"
+#include "lib/weighting.h"
+#include "lib/spectrum.h"
+#include "lib/led_matrix.h"
+#include "lib/sos.h"
+#include "lib/scheduler.h"
+#include "lib/spsc_ring.h"
+#include "lib/instr.h"
+#include "lib/audio_stream.h"
+#include "lib/event_log.h"
+#include "lib/settings.h"
+#include "lib/noise_floor.h"
+#include "lib/level_history.h"
+#include "lib/level_stats.h"
+#include "lib/input.h"
+#include "lib/capture.h"
+#include "lib/tone_bank.h"
+#include "pico/stdio_usb.h"
+#ifdef DETECTOR_BENCH
+#include "lib/bench.h"
+#endif
 
 // Definições de pinos
 const uint MICROPHONE = 28; // Microfone conectado ao GPIO28 (ADC2)
 const uint BTN_B_PIN = 6;   // Botão B conectado ao GPIO6
 const uint BTN_A_PIN = 5;   // Botão A conectado ao GPIO5
+const uint BTN_JOY_PIN = 22; // Botão do joystick conectado ao GPIO22
 const uint JOYSTICK_X = 26; // Eixo X do joystick no GPIO26 (ADC0)
 const uint JOYSTICK_Y = 27; // Eixo Y do joystick no GPIO27 (ADC1)
 const uint BUZZER_PIN = 21; // Buzzer conectado ao GPIO21
 #define WS2812_PIN 7        // Pino da matriz de LEDs WS2812
-#define NUM_PIXELS 25       // Número de pixels na matriz 5x5
 #define I2C_PORT i2c1       // Porta I2C para o display SSD1306
 #define I2C_SDA 14          // Pino SDA do SSD1306
 #define I2C_SCL 15          // Pino SCL do SSD1306
 #define SSD1306_ADDR 0x3C   // Endereço I2C do SSD1306
+#ifndef I2C_BAUD_HZ
+#define I2C_BAUD_HZ (400 * 1000) // 400 kHz (Fast-mode); 1 MHz com a opção DETECTOR_I2C_FAST_PLUS do CMake
+#endif
 
-// Configurações de amostragem e debounce
+// Configurações de amostragem
 const uint SAMPLES_PER_SECOND = 8000; // Taxa de amostragem de 8 kHz para o microfone
-const uint DEBOUNCE_DELAY = 200;      // Atraso de debounce em milissegundos para os botões
-const uint ADC_MAX_VALUE = 4094;      // Limite máximo ajustado para 4094
+const int RMS_MAX_VALUE = LEVEL_RMS_MAX; // Limite máximo do range: o nível comparado é o RMS sem DC (até 2048)
+#define FREQ_WEIGHTING WEIGHTING_A           // Ponderação em frequência do nível (A, C ou Z)
+#define TIME_WEIGHTING TIME_WEIGHTING_FAST   // Ponderação no tempo do nível comparado (Fast ou Slow)
+#define SPECTRUM_FLOOR_DB 70                 // Faixa das barras do espectro: -70 dBFS a 0 dBFS
+#define RUN_PAGES 7                          // Status, níveis estatísticos, oitavas, terços e tendências de 1 s, 1 min e 15 min
+#define RUN_PAGE_STATS 1                     // L10/L50/L90, Lmax e Lmin de 1 e de 15 minutos
+#define RUN_PAGE_OCTAVE 2                    // Espectro em oitavas (a seguinte é em terços)
+#define RUN_PAGE_TREND 4                     // Primeira tela de tendência (uma por resolução do histórico)
+#define TREND_TOP 8                          // Linha de cima do gráfico de tendência (acima fica o título)
+#define ADAPTIVE_MARGIN_HIGH_X10 100         // Modo adaptativo: alerta 10 dB acima do ruído de fundo
+#define ADAPTIVE_MARGIN_LOW_X10 200          // e 20 dB abaixo dele (microfone mudo ou desconectado)
+
+// Períodos das tarefas do escalonador
+#define SCHED_TICK_US 1000     // Base de tempo do escalonador (1 ms)
+#define LEVELS_PERIOD_MS 8     // Resultados do núcleo 1 (um por bloco de 32 ms)
+#define INPUT_PERIOD_MS 10     // Botões e joystick (100 Hz, ritmo de amostragem de lib/input.c)
+#define DISPLAY_PERIOD_MS 40   // Display (25 Hz)
+#define LED_PERIOD_MS 100      // Matriz de LEDs (10 Hz)
+#define REPORT_PERIOD_MS 1000  // Relatórios via USB
+#define LOG_DUMP_PER_PASS 4    // Registros de eventos listados por passada da tarefa de entrada
+#define CAPTURE_DUMP_PER_PASS 4 // Quadros da captura do alarme enviados por passada da tarefa de entrada
 
 // Configurações do buzzer
 #define BUZZER_FREQ_HZ 2000 // Frequência do buzzer em Hz
@@ -37,98 +81,150 @@ const uint ADC_MAX_VALUE = 4094;      // Limite máximo ajustado para 4094
 #define GAP_TIME 125        // Pausa entre sinais no SOS (ms)
 #define LETTER_GAP 250      // Pausa entre letras no SOS (ms)
 #define CYCLE_GAP 3000      // Pausa entre ciclos completos de SOS (ms)
+const sos_timing_t sos_timing = {DOT_TIME, DASH_TIME, GAP_TIME, LETTER_GAP, CYCLE_GAP};
+
+// Mensagens entre os núcleos
+typedef enum
+{
+    CORE1_CMD_START,      // Inicia a aquisição com o range informado
+    CORE1_CMD_STOP,       // Para a aquisição e libera o ADC
+    CORE1_CMD_STREAM_ON,  // Passa a enviar os blocos crus pela USB (tools/capture_audio.py)
+    CORE1_CMD_STREAM_OFF, // Encerra o streaming
+    CORE1_CMD_BUZZER_ON,  // O SOS começou a tocar: os detectores de tom ignoram o buzzer
+    CORE1_CMD_BUZZER_OFF  // O SOS parou
+} core1_cmd_type_t;
+
+typedef struct
+{
+    uint8_t type;
+    uint16_t threshold_min;
+    uint16_t threshold_max;
+    uint8_t mode; // settings_mode_t; no adaptativo o range vem do ruído de fundo
+    uint8_t format; // CORE1_CMD_STREAM_ON: AUDIO_STREAM_PACKED12 ou AUDIO_STREAM_ADPCM
+} core1_cmd_t;
+
+typedef enum
+{
+    LEVEL_MSG_LEVEL,        // Resultado de um bloco
+    LEVEL_MSG_OUT_OF_RANGE, // Resultado do bloco que saiu do range ou com tom detectado (uma vez por monitoração)
+    LEVEL_MSG_STOPPED       // Confirmação de CORE1_CMD_STOP: o ADC está livre
+} level_msg_type_t;
+
+typedef struct
+{
+    uint8_t type;
+    uint32_t seq;                       // Número do bloco de áudio
+    uint16_t rms;                       // RMS ponderado (Fast/Slow), em códigos do ADC
+    uint16_t leq;                       // Leq desde o início da monitoração
+    int16_t octave[SPECTRUM_MAX_BANDS]; // Bandas de oitava, em décimos de dBFS
+    int16_t third[SPECTRUM_MAX_BANDS];  // Bandas de terço de oitava, em décimos de dBFS
+    uint16_t threshold_min;             // Range comparado neste bloco (no adaptativo, muda com o fundo)
+    uint16_t threshold_max;
+    int16_t floor;                      // Ruído de fundo, em décimos de dBFS (INT16_MIN sem piso aprendido)
+    uint8_t tones;                      // Detectores de tom ativos (bit i: detector i de lib/tone_bank.h)
+    int16_t tone_level[TONE_BANK_MAX_DETECTORS]; // Nível de cada tom, em décimos de dBFS
+} level_msg_t;
 
 // Variáveis globais
-volatile bool button_b_pressed = false; // Estado do botão B (pressionado ou não)
-volatile bool button_a_pressed = false; // Estado do botão A (pressionado ou não)
-uint32_t last_button_b_time = 0;        // Último tempo de pressão do botão B (ms)
-uint32_t last_button_a_time = 0;        // Último tempo de pressão do botão A (ms)
+input_t input;                          // Botões e joystick: eventos de toque e repetição
 bool out_of_range = false;              // Indica se o sinal do microfone está fora do range
 bool program_running = false;           // Indica se o programa está no modo de execução
 int threshold_min = 0;                  // Limite mínimo do range de detecção
 int threshold_max = 0;                  // Limite máximo do range de detecção
+uint8_t detect_mode = SETTINGS_MODE_FIXED; // Range fixo ou adaptativo (settings_mode_t)
 int step = 0;                           // Etapa atual do programa (0 a 3)
+int run_page = 0;                       // Tela do modo de execução (0: status, 1: estatísticas, 2: oitavas, 3: terços, 4 a 6: tendência)
 int digit_pos = 0;                      // Posição do dígito sendo ajustado no range
 int digits_min[3] = {0, 0, 0};          // Dígitos do valor mínimo (centena, dezena, unidade)
 int digits_max[4] = {0, 0, 0, 0};       // Dígitos do valor máximo (milhar, centena, dezena, unidade)
-PIO pio = pio0;                         // Instância PIO para controle dos LEDs WS2812
-int sm = 0;                             // Máquina de estado para PIO
-uint32_t led_buffer[NUM_PIXELS] = {0};  // Buffer para os estados dos LEDs WS2812
 ssd1306_t ssd;                          // Estrutura para controle do display SSD1306
+uint32_t reported_overruns = 0;         // Perdas de blocos de áudio já informadas via USB
+uint32_t reported_dropped_msgs = 0;     // Mensagens de nível descartadas já informadas via USB
+uint32_t reported_stream_drops = 0;     // Blocos do streaming descartados já informados via USB
+spsc_ring_t core1_cmds;                 // Comandos do núcleo 0 para o núcleo 1
+core1_cmd_t core1_cmd_storage[4];
+spsc_ring_t level_msgs;                 // Resultados e eventos do núcleo 1 para o núcleo 0
+level_msg_t level_msg_storage[8];
+level_msg_t last_level;                 // Último resultado recebido (telas de espectro)
+bool core1_acquiring = false;           // Núcleo 1 com o ADC em uso (até chegar LEVEL_MSG_STOPPED)
+uint32_t incident_start_ms = 0;         // Início do incidente de fora do range em curso
+uint16_t incident_level = 0;            // RMS que disparou o incidente
+uint16_t incident_peak = 0;             // Maior RMS durante o incidente
+uint16_t incident_leq = 0;              // Leq no disparo
+uint16_t incident_threshold_min = 0;    // Range em vigor no disparo
+uint16_t incident_threshold_max = 0;
+uint8_t incident_tones = 0;             // Detectores de tom que dispararam o incidente (0: range)
+bool log_dumping = false;               // Listagem do registro de eventos em curso via USB
+event_log_iter_t log_iter;              // Próximo registro da listagem
+capture_t mic_capture;                  // Áudio em volta do último alarme (gravado pelo núcleo 1)
+bool capture_dumping = false;           // Envio da captura congelada em curso via USB
+uint32_t capture_dump_pos = 0;          // Próxima amostra da captura a enviar
+capture_info_t capture_dump_info;       // Captura sendo enviada
+uint8_t capture_dump_format;            // CAPTURE_FORMAT_PACKED12 ('C') ou CAPTURE_FORMAT_ADPCM ('D')
+uint32_t reported_capture = 0;          // Última captura anunciada via USB
+bool fast_boot = false;                 // Boot direto na monitoração com a configuração salva
+volatile uint32_t first_sample_us = 0;  // Início da amostragem após o reset (medido no núcleo 1)
+volatile bool first_sample_seen = false;
+bool boot_time_reported = false;        // Tempo até a primeira amostra já informado via USB
+level_history_t level_history;          // Mínimo, Leq e máximo por segundo, minuto e 15 minutos
+level_stats_t level_stats;              // Histogramas do nível por 1 e 15 minutos (L10/L50/L90)
+uint32_t reported_stats[LEVEL_STATS_INTERVALS]; // Intervalos fechados já informados via USB
+uint8_t reported_tones = 0;             // Detectores de tom ativos já informados via USB
+int trend_tier_shown = -1;              // Resolução do gráfico que está no buffer do display (-1: nenhuma)
+uint32_t trend_pushed_shown = 0;        // Células dessa resolução já desenhadas
 
-// Funções para controle dos LEDs WS2812
-static inline void put_pixel(uint32_t pixel_grb)
-{
-    // Envia um pixel no formato GRB para a matriz WS2812 via PIO
-    pio_sm_put_blocking(pio, sm, pixel_grb << 8u);
-}
+// Estado do DSP, usado somente pelo núcleo 1
+dc_blocker_t mic_dc;                    // Remoção do nível DC do microfone polarizado
+noise_level_t mic_level;                // RMS em janela e Leq do microfone
+weighting_filter_t mic_weighting;       // Filtro de ponderação em frequência (A/C/Z)
+time_weighting_t mic_time_weighting;    // Ponderação no tempo (Fast/Slow) do nível comparado
+spectrum_t mic_spectrum;                // Analisador de bandas de oitava/terço de oitava
+noise_floor_t mic_floor;                // Ruído de fundo aprendido (modo adaptativo)
+tone_bank_t mic_tones;                  // Detectores de tom (Goertzel), com o buzzer mascarado durante o SOS
+int16_t mic_block[ACQ_BLOCK_SAMPLES];   // Bloco do microfone sem DC
 
-static inline uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b)
-{
-    // Converte valores RGB (0-255) em um único valor de 32 bits no formato GRB
-    return ((uint32_t)(r) << 8) | ((uint32_t)(g) << 16) | (uint32_t)(b);
-}
-
-void set_leds_from_buffer()
-{
-    // Atualiza todos os LEDs da matriz WS2812 com base no buffer
-    for (int i = 0; i < NUM_PIXELS; i++)
-    {
-        put_pixel(led_buffer[i]);
-    }
-}
+// Tarefas do escalonador, em ordem de prioridade
+void task_levels();
+void task_input();
+void task_display();
+void task_leds();
+void task_report();
+sched_task_t tasks[] = {
+    {"niveis", task_levels, LEVELS_PERIOD_MS * 1000},
+    {"entrada", task_input, INPUT_PERIOD_MS * 1000},
+    {"display", task_display, DISPLAY_PERIOD_MS * 1000},
+    {"leds", task_leds, LED_PERIOD_MS * 1000},
+    {"relatorio", task_report, REPORT_PERIOD_MS * 1000},
+};
+uint32_t reported_misses[sizeof(tasks) / sizeof(tasks[0])]; // Prazos perdidos já informados via USB
 
+// Funções para controle dos LEDs WS2812
 void set_all_leds(uint8_t r, uint8_t g, uint8_t b)
 {
-    // Define todos os LEDs da matriz WS2812 com a mesma cor RGB e atualiza
-    for (int i = 0; i < NUM_PIXELS; i++)
-    {
-        led_buffer[i] = urgb_u32(r, g, b);
-    }
-    set_leds_from_buffer();
+    // Define todos os LEDs da matriz com a mesma cor; só envia se a cor mudou
+    led_matrix_fill(r, g, b);
+    led_matrix_show();
 }
 
 // Função para entrar no modo BOOTSEL
 void enter_bootsel()
 {
-    set_all_leds(0, 0, 0);  // Desliga todos os LEDs para indicar reinicialização
-    set_leds_from_buffer(); // Força a atualização dos LEDs
-    sleep_ms(50);           // Pausa de 50 ms para garantir que os LEDs sejam apagados
+    led_matrix_fill(0, 0, 0); // Desliga todos os LEDs para indicar reinicialização
+    led_matrix_flush();       // Espera o quadro e o reset chegarem aos LEDs
     reset_usb_boot(0, 0);   // Reinicia o Pico no modo BOOTSEL para reprogramação
 }
 
-// Função de debounce para botões
-bool debounce_button(uint32_t *last_time)
-{
-    // Implementa debounce verificando se passou tempo suficiente desde a última pressão
-    uint32_t current_time = to_ms_since_boot(get_absolute_time());
-    if (current_time - *last_time >= DEBOUNCE_DELAY)
-    {
-        *last_time = current_time;
-        return true; // Botão válido
-    }
-    return false; // Botão ignorado (debounce ativo)
-}
-
-// Manipulador de interrupções dos botões
+// Manipulador de interrupções dos botões: só marca a borda (o debounce é feito em task_input)
 void button_isr_handler(uint gpio, uint32_t events)
 {
-    if (gpio == BTN_B_PIN && events & GPIO_IRQ_EDGE_FALL)
-    {
-        // Detecta borda de descida no botão B e aplica debounce
-        if (debounce_button(&last_button_b_time))
-        {
-            button_b_pressed = true;
-        }
-    }
-    if (gpio == BTN_A_PIN && events & GPIO_IRQ_EDGE_FALL)
-    {
-        // Detecta borda de descida no botão A e aplica debounce
-        if (debounce_button(&last_button_a_time))
-        {
-            button_a_pressed = true;
-        }
-    }
+    if (!(events & GPIO_IRQ_EDGE_FALL))
+        return;
+    if (gpio == BTN_B_PIN)
+        input_button_edge(&input, INPUT_KEY_B);
+    else if (gpio == BTN_A_PIN)
+        input_button_edge(&input, INPUT_KEY_A);
+    else if (gpio == BTN_JOY_PIN)
+        input_button_edge(&input, INPUT_KEY_JOY);
 }
 
 // Configuração das interrupções dos botões
@@ -142,15 +238,20 @@ void setup_button_interrupts()
     gpio_set_dir(BTN_A_PIN, GPIO_IN);
     gpio_pull_up(BTN_A_PIN); // Configura pull-up interno no botão A
 
-    // Habilita interrupções de borda de descida para ambos os botões
+    gpio_init(BTN_JOY_PIN);
+    gpio_set_dir(BTN_JOY_PIN, GPIO_IN);
+    gpio_pull_up(BTN_JOY_PIN); // Configura pull-up interno no botão do joystick
+
+    // Habilita interrupções de borda de descida para os botões
     gpio_set_irq_enabled_with_callback(BTN_B_PIN, GPIO_IRQ_EDGE_FALL, true, &button_isr_handler);
     gpio_set_irq_enabled_with_callback(BTN_A_PIN, GPIO_IRQ_EDGE_FALL, true, &button_isr_handler);
+    gpio_set_irq_enabled_with_callback(BTN_JOY_PIN, GPIO_IRQ_EDGE_FALL, true, &button_isr_handler);
 }
 
 // Inicialização do display SSD1306
 void setup_ssd1306()
 {
-    i2c_init(I2C_PORT, 400 * 1000); // Inicializa I2C a 400 kHz
+    i2c_init(I2C_PORT, I2C_BAUD_HZ); // Inicializa o I2C do display
     gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
     gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
     gpio_pull_up(I2C_SDA);
@@ -160,93 +261,156 @@ void setup_ssd1306()
     ssd1306_config(&ssd);                                             // Aplica configurações padrão
 }
 
-// Função para desenhar dígitos invertidos no display
-void draw_inverted_digit(ssd1306_t *ssd, char digit, uint8_t x, uint8_t y)
+// Desenha as bandas do espectro como barras verticais
+void draw_spectrum(ssd1306_t *ssd, spectrum_bands_t bands)
 {
-    // Preenche um quadrado 8x8 com fundo preto
-    for (uint8_t i = 0; i < 8; i++)
-    {
-        for (uint8_t j = 0; j < 8; j++)
-        {
-            ssd1306_pixel(ssd, x + i, y + j, true);
-        }
-    }
+    uint8_t count = spectrum_band_count(bands);
+    uint8_t pitch = (ssd->width - 2) / count;        // Largura de cada barra mais o espaço
+    uint8_t bar_width = (pitch > 2) ? pitch - 1 : 1;
+    uint8_t max_height = ssd->height - 10;          // Abaixo da linha de título
 
-    // Desenha o dígito em branco sobre o fundo preto usando a fonte
-    uint16_t index = (digit - '0' + 1) * 8;
-    for (uint8_t i = 0; i < 8; ++i)
+    const int16_t *levels = bands == SPECTRUM_OCTAVE ? last_level.octave : last_level.third;
+    ssd1306_draw_string(ssd, bands == SPECTRUM_OCTAVE ? "Oitavas" : "Tercos oitava", 0, 0);
+    for (uint8_t i = 0; i < count; i++)
     {
-        uint8_t line = font[index + i];
-        for (uint8_t j = 0; j < 8; ++j)
-        {
-            bool pixel_value = (line & (1 << j));
-            if (pixel_value)
-            {
-                ssd1306_pixel(ssd, x + i, y + j, false);
-            }
-        }
+        // Converte o nível da banda (décimos de dBFS) em altura da barra
+        int32_t db = levels[i] + SPECTRUM_FLOOR_DB * 10;
+        if (db <= 0)
+            continue;
+        uint8_t height = (db >= SPECTRUM_FLOOR_DB * 10) ? max_height : (uint8_t)(db * max_height / (SPECTRUM_FLOOR_DB * 10));
+        if (height == 0)
+            continue;
+        ssd1306_rect(ssd, ssd->height - height, 1 + i * pitch, bar_width, height, true, true);
     }
 }
 
-// Funções do buzzer
-void start_buzzer(uint32_t duration_ms)
+// Linha do display para um nível do histórico (mesma faixa das barras do espectro)
+uint8_t trend_y(uint8_t code)
+{
+    int32_t db = level_history_dbfs_x10(code) + SPECTRUM_FLOOR_DB * 10;
+    if (db < 0)
+        db = 0;
+    if (db > SPECTRUM_FLOOR_DB * 10)
+        db = SPECTRUM_FLOOR_DB * 10;
+    return (uint8_t)(HEIGHT - 1 - db * (HEIGHT - 1 - TREND_TOP) / (SPECTRUM_FLOOR_DB * 10));
+}
+
+// Uma coluna do gráfico: barra do mínimo ao máximo, com a média (Leq) vazada
+void draw_trend_column(ssd1306_t *ssd, uint8_t x, const level_cell_t *cell)
 {
-    // Gera um tom no buzzer com a frequência definida por BUZZER_FREQ_HZ
-    uint32_t period = 1000000 / BUZZER_FREQ_HZ;
-    uint32_t half_period = period / 2;
-    uint32_t end_time = time_us_32() + (duration_ms * 1000);
+    uint8_t y_max = trend_y(cell->max), y_min = trend_y(cell->min);
+    ssd1306_vline(ssd, x, y_max, y_min, true);
+    if (y_min - y_max >= 2)
+        ssd1306_pixel(ssd, x, trend_y(cell->mean), false);
+}
 
-    gpio_set_dir(BUZZER_PIN, GPIO_OUT);
+// Tendência do nível numa resolução do histórico, célula mais nova à direita.
+// O gráfico fica no buffer do display entre as chamadas: a cada célula nova
+// ele rola para a esquerda e só as colunas novas são desenhadas
+void draw_trend(ssd1306_t *ssd, level_tier_t tier)
+{
+    static const char *const names[LEVEL_TIERS] = {"1s", "1min", "15min"};
+    uint32_t pushed = level_history_pushed(&level_history, tier);
+    uint32_t fresh = pushed - trend_pushed_shown;
+    if (trend_tier_shown != (int)tier || fresh >= ssd->width)
+    {
+        ssd1306_fill(ssd, false); // Outra tela estava no buffer: redesenha tudo
+        fresh = level_history_count(&level_history, tier);
+    }
+    else if (fresh)
+        ssd1306_scroll_left(ssd, 0, ssd->width - 1, TREND_TOP / 8, ssd->pages - 1, (uint8_t)fresh);
+    level_cell_t cell;
+    for (uint32_t age = 0; age < fresh && level_history_get(&level_history, tier, (uint16_t)age, &cell); age++)
+        draw_trend_column(ssd, (uint8_t)(ssd->width - 1 - age), &cell);
+    trend_tier_shown = (int)tier;
+    trend_pushed_shown = pushed;
 
-    while (time_us_32() < end_time)
+    // Título com o Leq da célula mais nova
+    char buffer[20];
+    ssd1306_rect(ssd, 0, 0, ssd->width, TREND_TOP, false, true);
+    if (level_history_get(&level_history, tier, 0, &cell))
     {
-        if (button_a_pressed || button_b_pressed)
-        {
-            gpio_put(BUZZER_PIN, 0); // Interrompe o buzzer se um botão for pressionado
-            return;
-        }
-        gpio_put(BUZZER_PIN, 1);
-        sleep_us(half_period);
-        gpio_put(BUZZER_PIN, 0);
-        sleep_us(half_period);
+        int mean = level_history_dbfs_x10(cell.mean);
+        int mag = mean < 0 ? -mean : mean;
+        snprintf(buffer, sizeof(buffer), "%s Leq %s%d.%d", names[tier], mean < 0 ? "-" : "", mag / 10, mag % 10);
     }
-    gpio_put(BUZZER_PIN, 0); // Garante que o buzzer esteja desligado ao final
+    else
+        snprintf(buffer, sizeof(buffer), "%s sem dados", names[tier]);
+    ssd1306_draw_string(ssd, buffer, 0, 0);
 }
 
-void send_sos_buzzer()
+// Nível em décimos de dBFS com uma casa decimal ("--" sem dados)
+void format_dbfs(char *buffer, size_t size, int16_t db_x10)
 {
-    // Emite o padrão SOS (3 pontos, 3 traços, 3 pontos) no buzzer
-    for (int i = 0; i < 3; i++)
+    if (db_x10 == INT16_MIN)
     {
-        start_buzzer(DOT_TIME);
-        if (button_a_pressed || button_b_pressed) return;
-        sleep_ms(GAP_TIME);
+        snprintf(buffer, size, "--");
+        return;
     }
-    sleep_ms(LETTER_GAP);
-    if (button_a_pressed || button_b_pressed) return;
+    int mag = db_x10 < 0 ? -db_x10 : db_x10;
+    snprintf(buffer, size, "%s%d.%d", db_x10 < 0 ? "-" : "", mag / 10, mag % 10);
+}
 
-    for (int i = 0; i < 3; i++)
+// Nomes dos detectores de tom de uma máscara, separados por espaço; com
+// levels, cada nome vem seguido do nível em dBFS
+void format_tones(char *buffer, size_t size, uint8_t tones, const int16_t *levels)
+{
+    size_t len = 0;
+    buffer[0] = '\0';
+    for (uint8_t d = 0; d < tone_bank_count() && len < size; d++)
     {
-        start_buzzer(DASH_TIME);
-        if (button_a_pressed || button_b_pressed) return;
-        sleep_ms(GAP_TIME);
+        if (!(tones & (1u << d)))
+            continue;
+        char level[8] = "";
+        if (levels)
+            format_dbfs(level, sizeof(level), levels[d]);
+        len += snprintf(buffer + len, size - len, "%s%s%s%s", len ? " " : "", tone_bank_name(d), levels ? " " : "", level);
     }
-    sleep_ms(LETTER_GAP);
-    if (button_a_pressed || button_b_pressed) return;
+}
 
-    for (int i = 0; i < 3; i++)
+// Tabela dos níveis estatísticos: uma coluna por intervalo, com o último
+// intervalo fechado ou, antes do primeiro, o em curso (título sublinhado)
+void draw_stats(ssd1306_t *ssd)
+{
+    static const char *const labels[5] = {"L10", "L50", "L90", "Max", "Min"};
+    level_stats_result_t results[LEVEL_STATS_INTERVALS];
+    bool valid[LEVEL_STATS_INTERVALS], partial[LEVEL_STATS_INTERVALS];
+    for (int i = 0; i < LEVEL_STATS_INTERVALS; i++)
     {
-        start_buzzer(DOT_TIME);
-        if (button_a_pressed || button_b_pressed) return;
-        sleep_ms(GAP_TIME);
+        partial[i] = level_stats_completed(&level_stats, (level_stats_interval_t)i) == 0;
+        valid[i] = level_stats_get(&level_stats, (level_stats_interval_t)i, partial[i], &results[i]);
+    }
+
+    char buffer[24], cols[LEVEL_STATS_INTERVALS][8];
+    static const uint8_t title_x[LEVEL_STATS_INTERVALS][2] = {{32, 63}, {72, 111}}; // Colunas de "1min" e "15min"
+    ssd1306_draw_string(ssd, "    1min 15min", 0, 0);
+    for (int i = 0; i < LEVEL_STATS_INTERVALS; i++)
+        if (partial[i])
+            ssd1306_hline(ssd, title_x[i][0], title_x[i][1], 8, true);
+    for (int row = 0; row < 5; row++)
+    {
+        for (int i = 0; i < LEVEL_STATS_INTERVALS; i++)
+        {
+            const level_stats_result_t *r = &results[i];
+            int16_t values[5] = {r->l10, r->l50, r->l90, r->lmax, r->lmin};
+            format_dbfs(cols[i], sizeof(cols[i]), valid[i] ? values[row] : INT16_MIN);
+        }
+        snprintf(buffer, sizeof(buffer), "%s%6s%6s", labels[row], cols[0], cols[1]);
+        ssd1306_draw_string(ssd, buffer, 0, 10 + row * 10);
     }
 }
 
 // Atualização do display SSD1306
 void update_display()
 {
+    INSTR_TIME_BEGIN(instr_start);
     char buffer[32];
-    ssd1306_fill(&ssd, false); // Limpa o display
+    bool trend = step == 3 && run_page >= RUN_PAGE_TREND;
+    if (!trend)
+    {
+        ssd1306_fill(&ssd, false); // Limpa o display (o gráfico de tendência só rola)
+        trend_tier_shown = -1;
+    }
 
     switch (step)
     {
@@ -254,12 +418,13 @@ void update_display()
         ssd1306_draw_string(&ssd, "Detector", 0, 0);
         ssd1306_draw_string(&ssd, "De Ruido", 0, 10);
         ssd1306_draw_string(&ssd, "Iniciado", 0, 20);
+        ssd1306_draw_string(&ssd, detect_mode == SETTINGS_MODE_ADAPTIVE ? "X: Adaptativo" : "X: Range fixo", 0, 30);
         ssd1306_draw_string(&ssd, "A: Prosseguir", 0, 40);
         break;
     case 1: // Configuração do valor mínimo
         snprintf(buffer, sizeof(buffer), "Min: %d%d%d", digits_min[0], digits_min[1], digits_min[2]);
         ssd1306_draw_string(&ssd, buffer, 0, 0);
-        draw_inverted_digit(&ssd, digits_min[digit_pos] + '0', 40 + digit_pos * 8, 0);
+        ssd1306_draw_inverted_digit(&ssd, digits_min[digit_pos] + '0', 40 + digit_pos * 8, 0);
         ssd1306_draw_string(&ssd, "X: mais:menos", 0, 10);
         ssd1306_draw_string(&ssd, "Y: digito", 0, 20);
         ssd1306_draw_string(&ssd, "A: Prosseguir", 0, 40);
@@ -267,194 +432,767 @@ void update_display()
     case 2: // Configuração do valor máximo
         snprintf(buffer, sizeof(buffer), "Max: %d%d%d%d", digits_max[0], digits_max[1], digits_max[2], digits_max[3]);
         ssd1306_draw_string(&ssd, buffer, 0, 0);
-        draw_inverted_digit(&ssd, digits_max[digit_pos] + '0', 40 + digit_pos * 8, 0);
+        ssd1306_draw_inverted_digit(&ssd, digits_max[digit_pos] + '0', 40 + digit_pos * 8, 0);
         ssd1306_draw_string(&ssd, "X: mais:menos", 0, 10);
         ssd1306_draw_string(&ssd, "Y: digito", 0, 20);
         ssd1306_draw_string(&ssd, "A: Prosseguir", 0, 40);
         break;
     case 3: // Modo de execução
-        snprintf(buffer, sizeof(buffer), "Min:%03d", threshold_min);
-        ssd1306_draw_string(&ssd, buffer, 0, 0);
-        snprintf(buffer, sizeof(buffer), "Max:%04d", threshold_max);
-        ssd1306_draw_string(&ssd, buffer, 0, 8);
+        if (trend) // Telas de tendência
+        {
+            draw_trend(&ssd, (level_tier_t)(run_page - RUN_PAGE_TREND));
+            break;
+        }
+        if (run_page == RUN_PAGE_STATS) // Níveis estatísticos
+        {
+            draw_stats(&ssd);
+            break;
+        }
+        if (run_page == RUN_PAGE_OCTAVE || run_page == RUN_PAGE_OCTAVE + 1) // Telas de espectro
+        {
+            draw_spectrum(&ssd, run_page == RUN_PAGE_OCTAVE ? SPECTRUM_OCTAVE : SPECTRUM_THIRD_OCTAVE);
+            break;
+        }
+        if (detect_mode == SETTINGS_MODE_ADAPTIVE)
+        {
+            if (last_level.floor == INT16_MIN)
+            {
+                ssd1306_draw_string(&ssd, "Aprendendo", 0, 0);
+                ssd1306_draw_string(&ssd, "o fundo", 0, 8);
+            }
+            else
+            {
+                // Piso em dBFS com uma casa decimal, e o limite de cima que resulta dele
+                int floor_x10 = last_level.floor < 0 ? -last_level.floor : last_level.floor;
+                snprintf(buffer, sizeof(buffer), "Fundo:%s%d.%d", last_level.floor < 0 ? "-" : "", floor_x10 / 10,
+                         floor_x10 % 10);
+                ssd1306_draw_string(&ssd, buffer, 0, 0);
+                snprintf(buffer, sizeof(buffer), "Max:%04u", last_level.threshold_max);
+                ssd1306_draw_string(&ssd, buffer, 0, 8);
+            }
+        }
+        else
+        {
+            snprintf(buffer, sizeof(buffer), "Min:%03d", threshold_min);
+            ssd1306_draw_string(&ssd, buffer, 0, 0);
+            snprintf(buffer, sizeof(buffer), "Max:%04d", threshold_max);
+            ssd1306_draw_string(&ssd, buffer, 0, 8);
+        }
+        ssd1306_draw_string(&ssd, "A: Configurar", 0, 24);
         ssd1306_draw_string(&ssd, "Monitoramento", 0, 40);
         ssd1306_draw_string(&ssd, "Iniciado", 0, 50); 
         break;
     }
-    ssd1306_send_data(&ssd); // Envia os dados para o display
+    ssd1306_send_data_async(&ssd); // Enfileira só o que mudou, sem esperar o barramento
+    INSTR_TIME_END(INSTR_DISPLAY_UPDATE, instr_start);
 }
 
-int main()
+// Envia um comando ao núcleo 1 e o acorda
+void send_core1_cmd(const core1_cmd_t *cmd)
 {
-    stdio_init_all(); // Inicializa comunicação serial padrão
+    while (!spsc_ring_try_push(&core1_cmds, cmd))
+        tight_loop_contents();
+    __sev();
+}
 
-    // Inicializa o ADC para microfone e joystick
-    adc_init();
-    adc_gpio_init(MICROPHONE); // Configura GPIO28 como entrada analógica para o microfone
-    adc_gpio_init(JOYSTICK_X); // Configura GPIO26 como entrada analógica para o eixo X do joystick
-    adc_gpio_init(JOYSTICK_Y); // Configura GPIO27 como entrada analógica para o eixo Y do joystick
+// Liga ou desliga o SOS no buzzer. O estado vai ao núcleo 1 pela fila de
+// comandos, em vez de ser lido de lib/sos.c, que pertence a este núcleo
+void set_sos(bool on)
+{
+    if (on)
+        sos_start();
+    else
+        sos_stop();
+    core1_cmd_t cmd = {on ? CORE1_CMD_BUZZER_ON : CORE1_CMD_BUZZER_OFF, 0, 0};
+    send_core1_cmd(&cmd);
+}
 
-    // Inicializa a matriz WS2812
-    uint offset = pio_add_program(pio, &ws2812_program);
-    ws2812_program_init(pio, sm, offset, WS2812_PIN, 800000, false);
+// Carrega o range atual nos dígitos da configuração
+void load_digits()
+{
+    digits_min[0] = threshold_min / 100;
+    digits_min[1] = threshold_min / 10 % 10;
+    digits_min[2] = threshold_min % 10;
+    digits_max[0] = threshold_max / 1000;
+    digits_max[1] = threshold_max / 100 % 10;
+    digits_max[2] = threshold_max / 10 % 10;
+    digits_max[3] = threshold_max % 10;
+}
 
-    // Inicializa o display SSD1306
-    setup_ssd1306();
+// Inicia a amostragem contínua do microfone no núcleo 1 com o range atual
+void start_monitoring()
+{
+    step = 3;
+    program_running = true; // Ativa o modo de execução
+    run_page = 0;
+    core1_cmd_t cmd = {CORE1_CMD_START, (uint16_t)threshold_min, (uint16_t)threshold_max, detect_mode};
+    memset(&last_level, 0, sizeof(last_level));
+    last_level.floor = INT16_MIN;
+    core1_acquiring = true;
+    send_core1_cmd(&cmd);
+}
 
-    // Inicializa o buzzer como saída
-    gpio_init(BUZZER_PIN);
-    gpio_set_dir(BUZZER_PIN, GPIO_OUT);
+// Para a monitoração e volta à tela inicial, com o range atual nos dígitos
+void enter_config()
+{
+    core1_cmd_t cmd = {CORE1_CMD_STOP, 0, 0};
+    send_core1_cmd(&cmd);    // Libera o ADC para a leitura do joystick
+    step = 0;                // Volta à tela inicial
+    digit_pos = 0;           // Reseta a posição do dígito
+    out_of_range = false;    // Sai do estado de fora do range
+    program_running = false; // Desativa o modo de execução
+    reported_overruns = 0;   // A próxima aquisição recomeça a contagem de perdas
+    load_digits();
+}
 
-    setup_button_interrupts(); // Configura interrupções para os botões
+// Grava o incidente de fora do range que está terminando no registro persistente
+void log_incident(uint8_t flags)
+{
+    event_record_t record = {0};
+    record.type = incident_tones ? EVENT_TONE : EVENT_OUT_OF_RANGE;
+    record.flags = flags;
+    record.time_ms = incident_start_ms;
+    record.duration_ms = to_ms_since_boot(get_absolute_time()) - incident_start_ms;
+    record.level = incident_level;
+    record.peak = incident_peak;
+    record.leq = incident_leq;
+    record.threshold_min = incident_threshold_min;
+    record.threshold_max = incident_threshold_max;
+    record.tones = incident_tones;
+    event_log_append(&record); // A gravação na flash é feita em lote por task_report
+}
 
-    // Exibe a tela inicial e define LEDs azuis para indicar modo de configuração
-    update_display();
-    set_all_leds(0, 0, 10); // LEDs azuis
+// Lista o registro de eventos via USB, alguns registros por chamada
+void print_event_log()
+{
+    event_record_t r;
+    for (int i = 0; i < LOG_DUMP_PER_PASS; i++)
+    {
+        if (!event_log_iter_next(&log_iter, &r))
+        {
+            printf("Fim do registro\n");
+            log_dumping = false;
+            return;
+        }
+        char tones[48] = "";
+        if (r.type == EVENT_TONE)
+        {
+            strcpy(tones, ", tom ");
+            format_tones(tones + strlen(tones), sizeof(tones) - strlen(tones), r.tones, NULL);
+        }
+        printf("Evento %lu: boot %u, inicio %lu.%03lu s, duracao %lu.%03lu s, nivel %u, pico %u, Leq %u, range %u-%u%s%s\n",
+               (unsigned long)r.seq, r.boot, (unsigned long)(r.time_ms / 1000), (unsigned long)(r.time_ms % 1000),
+               (unsigned long)(r.duration_ms / 1000), (unsigned long)(r.duration_ms % 1000), r.level, r.peak, r.leq,
+               r.threshold_min, r.threshold_max, tones, (r.flags & EVENT_FLAG_BOOTSEL) ? ", interrompido (BOOTSEL)" : "");
+    }
+}
 
-    // Define o intervalo de amostragem do microfone (125 µs para 8 kHz)
-    uint64_t interval_us = 1000000 / SAMPLES_PER_SECOND;
+// Botão B: entra no modo BOOTSEL
+void handle_bootsel_button()
+{
+    ssd1306_fill(&ssd, false);
+    ssd1306_send_data(&ssd); // Limpa o display
+    set_sos(false);          // Desliga o buzzer
+    if (out_of_range)
+        log_incident(EVENT_FLAG_BOOTSEL);
+    event_log_flush();       // Nada da fila em RAM se perde no reset
+    enter_bootsel();         // Entra no modo BOOTSEL
+}
 
-    while (true)
+// Eventos das etapas de configuração (a aquisição do microfone está parada)
+void handle_config_input(const input_event_t *ev)
+{
+    // Botão A avança entre as etapas; no modo adaptativo não há range a digitar
+    if (ev->key == INPUT_KEY_A)
     {
-        // Trata o botão B para entrar no modo BOOTSEL
-        if (button_b_pressed)
+        step = (step == 0 && detect_mode == SETTINGS_MODE_ADAPTIVE) ? 3 : step + 1;
+        digit_pos = 0; // Reseta a posição do dígito
+        if (step == 3)
         {
-            button_b_pressed = false;
-            set_all_leds(0, 0, 0);  // Desliga os LEDs
-            set_leds_from_buffer(); // Força a atualização
-            sleep_ms(50);           // Pausa para garantir que os LEDs sejam apagados
-            ssd1306_fill(&ssd, false);
-            ssd1306_send_data(&ssd); // Limpa o display
-            gpio_put(BUZZER_PIN, 0); // Desliga o buzzer
-            enter_bootsel();         // Entra no modo BOOTSEL
+            // Converte os dígitos em valores inteiros para o range
+            threshold_min = digits_min[0] * 100 + digits_min[1] * 10 + digits_min[2];
+            threshold_max = digits_max[0] * 1000 + digits_max[1] * 100 + digits_max[2] * 10 + digits_max[3];
+            // Garante que threshold_max não exceda o maior RMS possível
+            if (threshold_max > RMS_MAX_VALUE) threshold_max = RMS_MAX_VALUE;
+            // Salva o range e o modo para o próximo boot (a aquisição está parada, apagar é permitido)
+            settings_t settings = {(uint16_t)threshold_min, (uint16_t)threshold_max, detect_mode};
+            settings_save(&settings);
+            set_all_leds(0, 10, 0); // LEDs verdes indicando configuração concluída
+            start_monitoring();
         }
+        update_display();
+        return;
+    }
 
-        // Lê os valores analógicos do joystick
-        adc_select_input(0); // Seleciona ADC0 (eixo X do joystick)
-        uint16_t joy_x = adc_read(); // Valor de 0 a 4095
-        adc_select_input(1); // Seleciona ADC1 (eixo Y do joystick)
-        uint16_t joy_y = adc_read(); // Valor de 0 a 4095
-
-        if (step < 3) // Etapas de configuração
+    // Eixo X do joystick na tela inicial: alterna entre range fixo e adaptativo (sem repetição)
+    if (step == 0)
+    {
+        if ((ev->key == INPUT_KEY_LEFT || ev->key == INPUT_KEY_RIGHT) && ev->type == INPUT_PRESS)
         {
-            set_all_leds(0, 0, 10); // Mantém LEDs azuis durante a configuração
-            update_display();        // Atualiza o display com o estado atual
+            detect_mode = detect_mode == SETTINGS_MODE_ADAPTIVE ? SETTINGS_MODE_FIXED : SETTINGS_MODE_ADAPTIVE;
+            update_display();
+        }
+        return;
+    }
+
+    // Ajuste do range pelo joystick nas etapas 1 e 2; direções mantidas repetem cada vez mais rápido
+    int *current_digits = (step == 1) ? digits_min : digits_max; // Seleciona o array de dígitos
+    int max_pos = (step == 1) ? 2 : 3;                           // Define o número máximo de dígitos
+    int max_digit_value = (step == 1 || digit_pos > 0) ? 9 : RMS_MAX_VALUE / 1000; // Limita o primeiro dígito de threshold_max a 2
 
-            // Trata o botão A para avançar entre as etapas
-            if (button_a_pressed)
+    // Eixo X do joystick: ajusta o valor do dígito atual
+    if (ev->key == INPUT_KEY_LEFT && current_digits[digit_pos] > 0) // Movimento à esquerda diminui o dígito
+    {
+        current_digits[digit_pos]--;
+        update_display();
+    }
+    else if (ev->key == INPUT_KEY_RIGHT && current_digits[digit_pos] < max_digit_value) // Movimento à direita aumenta o dígito com limite
+    {
+        // Verifica se o incremento mantém threshold_max <= 2048
+        int new_digit = current_digits[digit_pos] + 1;
+        if (step == 2)
+        {
+            int potential_max = digits_max[0] * 1000 + digits_max[1] * 100 + digits_max[2] * 10 + digits_max[3] +
+                                (new_digit - current_digits[digit_pos]) * (int)pow(10, 3 - digit_pos);
+            if (potential_max <= RMS_MAX_VALUE)
             {
-                button_a_pressed = false;
-                step++;
-                digit_pos = 0; // Reseta a posição do dígito
-                if (step == 3)
-                {
-                    // Converte os dígitos em valores inteiros para o range
-                    threshold_min = digits_min[0] * 100 + digits_min[1] * 10 + digits_min[2];
-                    threshold_max = digits_max[0] * 1000 + digits_max[1] * 100 + digits_max[2] * 10 + digits_max[3];
-                    // Garante que threshold_max não exceda 4094
-                    if (threshold_max > ADC_MAX_VALUE) threshold_max = ADC_MAX_VALUE;
-                    program_running = true; // Ativa o modo de execução
-                    update_display();
-                    set_all_leds(0, 10, 0); // LEDs verdes indicando configuração concluída
-                    sleep_ms(2000);         // Pausa de 2 segundos para feedback
-                }
-                update_display();
+                current_digits[digit_pos] = new_digit;
             }
+        }
+        else
+        {
+            current_digits[digit_pos] = new_digit;
+        }
+        update_display();
+    }
 
-            // Ajuste do range pelo joystick nas etapas 1 e 2
-            if (step == 1 || step == 2)
-            {
-                int *current_digits = (step == 1) ? digits_min : digits_max; // Seleciona o array de dígitos
-                int max_pos = (step == 1) ? 2 : 3;                           // Define o número máximo de dígitos
-                int max_digit_value = (step == 1) ? 9 : ((digit_pos == 0 && digits_max[0] <= 4) ? 4 : 9); // Limita o primeiro dígito de threshold_max a 4
+    // Eixo Y do joystick: navega entre os dígitos
+    if (ev->key == INPUT_KEY_UP && digit_pos > 0) // Movimento para cima seleciona o dígito anterior
+    {
+        digit_pos--;
+        update_display();
+    }
+    else if (ev->key == INPUT_KEY_DOWN && digit_pos < max_pos) // Movimento para baixo seleciona o próximo dígito
+    {
+        digit_pos++;
+        update_display();
+    }
+}
 
-                // Calcula o valor atual de threshold_max para verificar o limite
-                int temp_max = digits_max[0] * 1000 + digits_max[1] * 100 + digits_max[2] * 10 + digits_max[3];
+// Eventos do modo de execução (o joystick só troca de tela pelo botão)
+void handle_run_input(const input_event_t *ev)
+{
+    if (!out_of_range)
+    {
+        // Botão do joystick alterna entre status, estatísticas, oitavas, terços e tendências
+        if (ev->key == INPUT_KEY_JOY)
+        {
+            run_page = (run_page + 1) % RUN_PAGES;
+            update_display();
+        }
+        // Botão A volta à configuração (o boot com a configuração salva pula direto para cá)
+        else if (ev->key == INPUT_KEY_A)
+        {
+            enter_config();
+        }
+    }
+    else if (ev->key == INPUT_KEY_A) // Estado de fora do range: botão A reinicia a configuração
+    {
+        set_sos(false);        // Silencia o buzzer
+        log_incident(0);       // Incidente reconhecido: vai para o registro persistente
+        enter_config();
+    }
+}
 
-                // Eixo X do joystick: ajusta o valor do dígito atual
-                if (joy_x < 1000 && current_digits[digit_pos] > 0) // Movimento à esquerda diminui o dígito
-                {
-                    current_digits[digit_pos]--;
-                    update_display();
-                    sleep_ms(200); // Debounce manual de 200 ms
-                }
-                else if (joy_x > 3000 && current_digits[digit_pos] < max_digit_value) // Movimento à direita aumenta o dígito com limite
-                {
-                    // Verifica se o incremento mantém threshold_max <= 4094
-                    int new_digit = current_digits[digit_pos] + 1;
-                    if (step == 2)
-                    {
-                        int potential_max = digits_max[0] * 1000 + digits_max[1] * 100 + digits_max[2] * 10 + digits_max[3] +
-                                            (new_digit - current_digits[digit_pos]) * (int)pow(10, 3 - digit_pos);
-                        if (potential_max <= ADC_MAX_VALUE)
-                        {
-                            current_digits[digit_pos] = new_digit;
-                        }
-                    }
-                    else
-                    {
-                        current_digits[digit_pos] = new_digit;
-                    }
-                    update_display();
-                    sleep_ms(200); // Debounce manual de 200 ms
-                }
+// Envia a captura congelada em quadros FRAME_CAPTURE, alguns por chamada;
+// sem espaço no link, continua na próxima. No fim a captura é rearmada
+void send_capture()
+{
+    for (int i = 0; i < CAPTURE_DUMP_PER_PASS; i++)
+    {
+        if (capture_dump_pos >= capture_dump_info.total)
+        {
+            printf("Fim da captura\n");
+            capture_release(&mic_capture);
+            capture_dumping = false;
+            return;
+        }
+        if (!capture_send_chunk(&mic_capture, capture_dump_pos, capture_dump_info.total - capture_dump_pos,
+                                capture_dump_format))
+            return;
+        capture_dump_pos += CAPTURE_CHUNK_SAMPLES;
+    }
+}
 
-                // Eixo Y do joystick: navega entre os dígitos
-                if (joy_y < 1000 && digit_pos > 0) // Movimento para cima seleciona o dígito anterior
-                {
-                    digit_pos--;
-                    update_display();
-                    sleep_ms(200); // Debounce manual de 200 ms
-                }
-                else if (joy_y > 3000 && digit_pos < max_pos) // Movimento para baixo seleciona o próximo dígito
-                {
-                    digit_pos++;
-                    update_display();
-                    sleep_ms(200); // Debounce manual de 200 ms
-                }
-            }
+// Tarefa de entrada: botões, joystick e comandos pela USB
+void task_input()
+{
+    // 'S' liga o streaming de áudio em 12 bits, 'A' em ADPCM, e 'P' desliga (o
+    // núcleo 1 envia os blocos); 'L' lista o registro de eventos; 'C' baixa a
+    // captura do último alarme em 12 bits e 'D' em ADPCM
+    int usb_cmd = getchar_timeout_us(0);
+    if (usb_cmd == 'S' || usb_cmd == 'A' || usb_cmd == 'P')
+    {
+        core1_cmd_t cmd = {usb_cmd == 'P' ? CORE1_CMD_STREAM_OFF : CORE1_CMD_STREAM_ON, 0, 0};
+        cmd.format = usb_cmd == 'A' ? AUDIO_STREAM_ADPCM : AUDIO_STREAM_PACKED12;
+        send_core1_cmd(&cmd);
+        if (usb_cmd != 'P')
+            reported_stream_drops = 0; // O núcleo 1 zera os contadores ao ligar o streaming
+    }
+    else if (usb_cmd == 'L' && !log_dumping)
+    {
+        event_log_stats_t log_stats;
+        event_log_get_stats(&log_stats);
+        printf("Registro de eventos: %lu registros, %lu gravacoes interrompidas, boot atual %u\n",
+               (unsigned long)log_stats.records, (unsigned long)log_stats.torn, event_log_boot());
+        event_log_iter_begin(&log_iter);
+        log_dumping = true;
+    }
+    else if ((usb_cmd == 'C' || usb_cmd == 'D') && !capture_dumping)
+    {
+        if (capture_get_info(&mic_capture, &capture_dump_info))
+        {
+            printf("Captura %lu: %lu amostras a %u Hz, gatilho na amostra %lu (bloco %lu)\n",
+                   (unsigned long)capture_dump_info.number, (unsigned long)capture_dump_info.total, CAPTURE_SAMPLE_RATE,
+                   (unsigned long)capture_dump_info.trigger, (unsigned long)capture_dump_info.block_seq);
+            capture_dump_pos = 0;
+            capture_dump_format = usb_cmd == 'D' ? CAPTURE_FORMAT_ADPCM : CAPTURE_FORMAT_PACKED12;
+            capture_dumping = true;
         }
-        else if (program_running) // Modo de execução
+        else
         {
-            if (!out_of_range) // Monitoramento ativo do sinal do microfone
+            printf("Captura: nenhuma pronta\n");
+        }
+    }
+    if (log_dumping)
+        print_event_log();
+    if (capture_dumping)
+        send_capture();
+
+    // Amostra botões (ativos em nível baixo) e joystick; o joystick só é lido
+    // com o ADC livre, na configuração, e fica centrado durante a monitoração
+    uint32_t buttons = (uint32_t)!gpio_get(BTN_A_PIN) << INPUT_KEY_A | (uint32_t)!gpio_get(BTN_B_PIN) << INPUT_KEY_B |
+                       (uint32_t)!gpio_get(BTN_JOY_PIN) << INPUT_KEY_JOY;
+    uint16_t joy[ACQ_AUX_CHANNELS];
+    bool joy_available = step < 3 && !core1_acquiring;
+    if (joy_available)
+        acq_read_aux(joy); // Rajada sobreamostrada (a aquisição do microfone está parada)
+    input_poll(&input, to_ms_since_boot(get_absolute_time()), buttons, joy_available ? joy : NULL);
+
+    // Enquanto o núcleo 1 não confirma a parada do ADC, os eventos da configuração esperam na fila
+    input_event_t ev;
+    while (!(step < 3 && core1_acquiring) && input_get_event(&input, &ev))
+    {
+        if (ev.key == INPUT_KEY_B && ev.type == INPUT_PRESS)
+            handle_bootsel_button();
+        else if (step < 3)
+            handle_config_input(&ev);
+        else if (program_running)
+            handle_run_input(&ev);
+    }
+}
+
+// Tarefa de níveis: consome os resultados e eventos publicados pelo núcleo 1
+void task_levels()
+{
+    level_msg_t msg;
+    while (spsc_ring_pop(&level_msgs, &msg))
+    {
+        if (msg.type == LEVEL_MSG_STOPPED)
+        {
+            core1_acquiring = false;
+            event_log_service(to_ms_since_boot(get_absolute_time()), true); // Grava já o incidente reconhecido
+            continue;
+        }
+        last_level = msg;
+        level_history_add(&level_history, msg.rms);
+        level_stats_add(&level_stats, msg.rms);
+        if (out_of_range && msg.rms > incident_peak)
+            incident_peak = msg.rms;
+
+        if (msg.type == LEVEL_MSG_OUT_OF_RANGE && program_running && !out_of_range)
+        {
+            out_of_range = true;    // Marca o estado de fora do range
+            incident_start_ms = to_ms_since_boot(get_absolute_time());
+            incident_level = incident_peak = msg.rms;
+            incident_leq = msg.leq;
+            incident_threshold_min = msg.threshold_min;
+            incident_threshold_max = msg.threshold_max;
+            incident_tones = msg.tones;
+            set_sos(true);          // Inicia o SOS no buzzer sem bloquear o laço
+            set_all_leds(10, 0, 0); // LEDs vermelhos para alerta
+            char buffer[32];
+            ssd1306_fill(&ssd, false);
+            trend_tier_shown = -1;
+            ssd1306_draw_string(&ssd, "ATENCAO", 0, 0);
+            if (msg.tones)
+            {
+                // Primeiro detector ativo, com o nível do tom (o nome tem até 8 caracteres)
+                uint8_t d = 0;
+                while (!(msg.tones & (1u << d)))
+                    d++;
+                char level[8];
+                format_dbfs(level, sizeof(level), msg.tone_level[d]);
+                ssd1306_draw_string(&ssd, "TOM DETECTADO", 0, 10);
+                snprintf(buffer, sizeof(buffer), "%s %s", tone_bank_name(d), level);
+            }
+            else
             {
-                adc_select_input(2); // Seleciona ADC2 (microfone)
-                uint16_t mic_value = adc_read(); // Lê o valor analógico do microfone (0 a 4095)
+                ssd1306_draw_string(&ssd, "FORA DO RANGE", 0, 10);
+                snprintf(buffer, sizeof(buffer), "Valor:%u", msg.rms);
+            }
+            ssd1306_draw_string(&ssd, buffer, 0, 20);      // Exibe o RMS fora do range ou o tom
+            snprintf(buffer, sizeof(buffer), "Leq:%u", msg.leq);
+            ssd1306_draw_string(&ssd, buffer, 0, 30);      // Nível equivalente desde o início
+            ssd1306_draw_string(&ssd, "A: Reiniciar", 0, 40);
+            ssd1306_send_data_async(&ssd);
+        }
+    }
+}
 
-                // Verifica se o sinal está fora do range definido
-                if (mic_value < threshold_min || mic_value > threshold_max)
+// Núcleo 1: aquisição contínua do microfone, DSP e comparação com o range.
+// A aquisição continua durante o alerta, pois o SOS é tocado por alarmes e PWM
+void core1_main()
+{
+    multicore_lockout_victim_init(); // Permite ao núcleo 0 pausar este núcleo para gravar a flash
+    acq_init(SAMPLES_PER_SECOND); // A IRQ do DMA da aquisição fica neste núcleo
+    bool running = false;
+    bool alerted = false;
+    bool streaming = false;
+    bool buzzer = false; // SOS tocando, segundo os comandos do núcleo 0
+    bool adaptive = false;
+    uint16_t min = 0, max = 0;
+    // Evento de fora do range que não coube na fila: vai antes de qualquer
+    // resultado novo, tentando de novo a cada bloco
+    level_msg_t event_msg;
+    bool event_pending = false;
+    // O fundo aprendido sobrevive às reconfigurações; só recomeça no boot
+    noise_floor_init(&mic_floor, SAMPLES_PER_SECOND / ACQ_BLOCK_SAMPLES);
+    tone_bank_init(&mic_tones, BUZZER_FREQ_HZ);
+
+    while (true)
+    {
+        bool worked = false;
+        core1_cmd_t cmd;
+        while (spsc_ring_pop(&core1_cmds, &cmd))
+        {
+            worked = true;
+            if (cmd.type == CORE1_CMD_START)
+            {
+                min = cmd.threshold_min;
+                max = cmd.threshold_max;
+                adaptive = cmd.mode == SETTINGS_MODE_ADAPTIVE;
+                dc_blocker_init(&mic_dc);
+                noise_level_init(&mic_level);
+                weighting_filter_init(&mic_weighting, FREQ_WEIGHTING, SAMPLES_PER_SECOND);
+                time_weighting_init(&mic_time_weighting, TIME_WEIGHTING, SAMPLES_PER_SECOND);
+                spectrum_init(&mic_spectrum);
+                tone_bank_reset(&mic_tones);
+                capture_restart(&mic_capture);
+                alerted = false;
+                event_pending = false;
+                running = true;
+                acq_start();
+                if (!first_sample_seen)
                 {
-                    out_of_range = true;    // Marca o estado de fora do range
-                    set_all_leds(10, 0, 0); // LEDs vermelhos para alerta
-                    char buffer[32];
-                    snprintf(buffer, sizeof(buffer), "Valor:%u", mic_value);
-                    ssd1306_fill(&ssd, false);
-                    ssd1306_draw_string(&ssd, "ATENCAO", 0, 0);
-                    ssd1306_draw_string(&ssd, "FORA DO RANGE", 0, 10);
-                    ssd1306_draw_string(&ssd, buffer, 0, 20);      // Exibe o valor fora do range
-                    ssd1306_draw_string(&ssd, "A: Reiniciar", 0, 40);
-                    ssd1306_send_data(&ssd);
+                    first_sample_us = time_us_32(); // O ADC começa a converter agora
+                    first_sample_seen = true;
                 }
             }
-            else // Estado de fora do range
+            else if (cmd.type == CORE1_CMD_STREAM_ON)
             {
-                send_sos_buzzer();   // Emite o sinal SOS continuamente
-                sleep_ms(CYCLE_GAP); // Pausa entre ciclos SOS
+                audio_stream_reset(cmd.format);
+                streaming = true;
+            }
+            else if (cmd.type == CORE1_CMD_STREAM_OFF)
+            {
+                streaming = false;
+            }
+            else if (cmd.type == CORE1_CMD_BUZZER_ON || cmd.type == CORE1_CMD_BUZZER_OFF)
+            {
+                buzzer = cmd.type == CORE1_CMD_BUZZER_ON;
+            }
+            else
+            {
+                acq_stop();
+                capture_stop(&mic_capture);
+                running = false;
+                event_pending = false; // A monitoração do evento acabou; o núcleo 0 já não o trataria
+                level_msg_t msg = {.type = LEVEL_MSG_STOPPED};
+                while (!spsc_ring_try_push(&level_msgs, &msg))
+                    tight_loop_contents();
+            }
+        }
+
+        acq_block_t block;
+        while (running && acq_get_block(&block))
+        {
+            worked = true;
+            INSTR_TIME_BEGIN(instr_start);
+            dc_blocker_process(&mic_dc, block.samples, mic_block, block.len);
+            if (streaming)
+                audio_stream_send_block(block.seq, block.samples, block.len); // Empacota direto do buffer do DMA
+            capture_push(&mic_capture, block.samples, block.len);
+            acq_release_block(&block);
+            spectrum_process(&mic_spectrum, mic_block, block.len); // Espectro sem ponderação (Z)
+            // Tons também sem ponderação; o próprio buzzer não conta enquanto o SOS toca
+            uint8_t tones = tone_bank_process(&mic_tones, mic_block, block.len, buzzer);
+            weighting_filter_process(&mic_weighting, mic_block, block.len);
+            noise_level_process(&mic_level, mic_block, block.len);
+            time_weighting_process(&mic_time_weighting, mic_block, block.len);
+
+            level_msg_t msg;
+            msg.type = LEVEL_MSG_LEVEL;
+            msg.seq = block.seq;
+            msg.rms = time_weighting_rms(&mic_time_weighting);
+            msg.leq = noise_level_leq(&mic_level);
+            spectrum_band_levels(&mic_spectrum, SPECTRUM_OCTAVE, msg.octave);
+            spectrum_band_levels(&mic_spectrum, SPECTRUM_THIRD_OCTAVE, msg.third);
+            msg.tones = tones;
+            memcpy(msg.tone_level, mic_tones.level_x10, sizeof(msg.tone_level));
 
-                // Botão A reinicia a configuração
-                if (button_a_pressed)
+            // Modo adaptativo: o range acompanha o ruído de fundo, que não é
+            // aprendido durante um alerta; até haver um piso não há comparação
+            bool compare = true;
+            msg.floor = INT16_MIN;
+            if (adaptive)
+            {
+                if (!alerted)
+                    noise_floor_update(&mic_floor, msg.rms);
+                compare = noise_floor_ready(&mic_floor);
+                if (compare)
                 {
-                    button_a_pressed = false;
-                    step = 0;              // Volta à tela inicial
-                    digit_pos = 0;         // Reseta a posição do dígito
-                    out_of_range = false;  // Sai do estado de fora do range
-                    program_running = false; // Desativa o modo de execução
-                    for (int i = 0; i < 3; i++) digits_min[i] = 0; // Reseta os dígitos mínimos
-                    for (int i = 0; i < 4; i++) digits_max[i] = 0; // Reseta os dígitos máximos
+                    msg.floor = noise_floor_dbfs_x10(&mic_floor);
+                    min = noise_floor_threshold(&mic_floor, -ADAPTIVE_MARGIN_LOW_X10);
+                    max = noise_floor_threshold(&mic_floor, ADAPTIVE_MARGIN_HIGH_X10);
+                    if (max > RMS_MAX_VALUE)
+                        max = RMS_MAX_VALUE;
                 }
             }
+            msg.threshold_min = min;
+            msg.threshold_max = max;
+
+            // Verifica se o nível ponderado (RMS com Fast/Slow) está fora do range
+            // definido ou se algum detector de tom está ativo
+            if (!alerted && ((compare && (msg.rms < min || msg.rms > max)) || msg.tones))
+            {
+                msg.type = LEVEL_MSG_OUT_OF_RANGE;
+                alerted = true;
+                capture_trigger(&mic_capture, block.len, block.seq); // Gatilho no início do bloco do alarme
+                event_msg = msg;
+                event_pending = true;
+            }
+            // O evento é repetido até entrar, sem contar como perda; resultados
+            // comuns são descartados (e contados) com a fila cheia ou atrás dele
+            if (event_pending && spsc_ring_try_push(&level_msgs, &event_msg))
+                event_pending = false;
+            if (msg.type == LEVEL_MSG_LEVEL)
+            {
+                if (event_pending)
+                    level_msgs.dropped++;
+                else
+                    spsc_ring_push(&level_msgs, &msg);
+            }
+            INSTR_TIME_END(INSTR_BLOCK_DSP, instr_start);
         }
 
-        sleep_us(interval_us); // Mantém a taxa de amostragem de 8 kHz
+        if (!worked)
+            __wfe(); // Acorda com a IRQ do DMA ou com o __sev() de send_core1_cmd
+    }
+}
+
+#ifdef DETECTOR_INSTR
+// Mede cada envio ao display, do enfileiramento (bus_bytes mudou) até o DMA e o
+// I2C esvaziarem; chamado a cada passada do escalonador (resolução de um tick)
+void instr_poll_display_transfer()
+{
+    static uint32_t bytes_seen, start_us;
+    static bool active;
+    if (!active && ssd.bus_bytes != bytes_seen)
+    {
+        active = true;
+        start_us = instr_backend_now_us();
+    }
+    if (active && !ssd1306_busy(&ssd))
+    {
+        INSTR_RECORD(INSTR_DISPLAY_TRANSFER, instr_backend_now_us() - start_us);
+        INSTR_COUNT(INSTR_DISPLAY_BYTES, ssd.bus_bytes - bytes_seen);
+        bytes_seen = ssd.bus_bytes;
+        active = false;
+    }
+}
+#endif
+
+// Tarefa do display: redesenha as telas que mudam sozinhas e envia o que mudou
+void task_display()
+{
+    if (step < 3 || (program_running && !out_of_range && run_page != 0))
+        update_display();
+    ssd1306_send_data_async(&ssd); // Também completa quadros adiados por barramento ocupado
+}
+
+// Tarefa dos LEDs: nada é enviado se o quadro não mudou
+void task_leds()
+{
+    if (step < 3)
+        led_matrix_fill(0, 0, 10); // LEDs azuis durante a configuração
+    led_matrix_show();
+}
+
+// Tarefa de relatório via USB: perdas de blocos de áudio e prazos perdidos.
+// Também grava o registro de eventos (apagar setores só com a aquisição parada)
+void task_report()
+{
+    event_log_service(to_ms_since_boot(get_absolute_time()), !core1_acquiring);
+    // Tempo do reset até a primeira amostra, uma vez, quando houver um terminal USB.
+    // Só no boot com a configuração salva é o tempo de boot; sem ela inclui a
+    // espera na tela de configuração e sai com outro rótulo
+    if (first_sample_seen && !boot_time_reported && stdio_usb_connected())
+    {
+        boot_time_reported = true;
+        if (fast_boot)
+            printf("Boot: amostragem iniciada %lu us apos o reset (configuracao salva)\n",
+                   (unsigned long)first_sample_us);
+        else
+            printf("Configuracao manual: amostragem iniciada %lu us apos o reset (inclui a configuracao)\n",
+                   (unsigned long)first_sample_us);
+    }
+    acq_stats_t stats;
+    acq_get_stats(&stats);
+    INSTR_SET(INSTR_ACQ_BLOCKS, stats.blocks);
+    INSTR_SET(INSTR_ACQ_OVERRUNS, stats.overruns);
+    INSTR_SET(INSTR_LEVEL_DROPS, level_msgs.dropped);
+    INSTR_ONLY(instr_send_report();) // Registro binário de telemetria (tools/decode_telemetry.py)
+    if (stats.overruns != reported_overruns)
+    {
+        reported_overruns = stats.overruns;
+        printf("Aquisicao: %lu blocos perdidos de %lu\n", (unsigned long)stats.overruns, (unsigned long)stats.blocks);
+    }
+    if (level_msgs.dropped != reported_dropped_msgs)
+    {
+        reported_dropped_msgs = level_msgs.dropped;
+        printf("Nucleo 1: %lu resultados descartados com a fila cheia\n", (unsigned long)reported_dropped_msgs);
+    }
+    audio_stream_stats_t stream;
+    audio_stream_get_stats(&stream);
+    if (stream.blocks_dropped != reported_stream_drops)
+    {
+        reported_stream_drops = stream.blocks_dropped;
+        printf("Streaming: %lu blocos descartados sem espaco na USB\n", (unsigned long)reported_stream_drops);
+    }
+    capture_info_t capture;
+    if (capture_get_info(&mic_capture, &capture) && capture.number != reported_capture)
+    {
+        reported_capture = capture.number;
+        printf("Captura %lu pronta: %lu ms em volta do alarme ('C' baixa)\n", (unsigned long)capture.number,
+               (unsigned long)(capture.total * 1000 / CAPTURE_SAMPLE_RATE));
+    }
+    // Detectores de tom que entraram ou saíram, com o nível de cada ativo
+    if (last_level.tones != reported_tones)
+    {
+        reported_tones = last_level.tones;
+        char tones[96];
+        format_tones(tones, sizeof(tones), reported_tones, last_level.tone_level);
+        printf("Tons: %s\n", reported_tones ? tones : "nenhum");
     }
-}
\ No newline at end of file
+    // Níveis estatísticos de cada intervalo de 1 e de 15 minutos que fechou
+    for (int i = 0; i < LEVEL_STATS_INTERVALS; i++)
+    {
+        level_stats_result_t r;
+        uint32_t completed = level_stats_completed(&level_stats, (level_stats_interval_t)i);
+        if (completed != reported_stats[i] && level_stats_get(&level_stats, (level_stats_interval_t)i, false, &r))
+        {
+            reported_stats[i] = completed;
+            char l10[8], l50[8], l90[8], lmax[8], lmin[8];
+            format_dbfs(l10, sizeof(l10), r.l10);
+            format_dbfs(l50, sizeof(l50), r.l50);
+            format_dbfs(l90, sizeof(l90), r.l90);
+            format_dbfs(lmax, sizeof(lmax), r.lmax);
+            format_dbfs(lmin, sizeof(lmin), r.lmin);
+            printf("Niveis %s: L10 %s L50 %s L90 %s Lmax %s Lmin %s dBFS\n", i == LEVEL_STATS_MINUTE ? "1 min" : "15 min",
+                   l10, l50, l90, lmax, lmin);
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(tasks) / sizeof(tasks[0]); i++)
+    {
+        if (tasks[i].misses != reported_misses[i])
+        {
+            reported_misses[i] = tasks[i].misses;
+            printf("Tarefa %s: %lu prazos perdidos, pior execucao %lu us\n", tasks[i].name,
+                   (unsigned long)tasks[i].misses, (unsigned long)tasks[i].max_run_us);
+        }
+    }
+}
+
+int main()
+{
+    // Inicializa o ADC para microfone e joystick
+    adc_init();
+    adc_gpio_init(MICROPHONE); // Configura GPIO28 como entrada analógica para o microfone
+    adc_gpio_init(JOYSTICK_X); // Configura GPIO26 como entrada analógica para o eixo X do joystick
+    adc_gpio_init(JOYSTICK_Y); // Configura GPIO27 como entrada analógica para o eixo Y do joystick
+
+    // Aquisição e DSP no núcleo 1; a comunicação é feita só pelas filas
+    spsc_ring_init(&core1_cmds, core1_cmd_storage, sizeof(core1_cmd_t), 4);
+    spsc_ring_init(&level_msgs, level_msg_storage, sizeof(level_msg_t), 8);
+    capture_init(&mic_capture);
+    multicore_launch_core1(core1_main);
+
+    level_history_init(&level_history, ACQ_BLOCK_SAMPLES, SAMPLES_PER_SECOND);
+    level_stats_init(&level_stats, ACQ_BLOCK_SAMPLES, SAMPLES_PER_SECOND);
+
+    // Com uma configuração salva a monitoração começa já, antes de USB, LEDs e display
+    settings_t settings;
+    fast_boot = settings_load(&settings);
+    if (fast_boot)
+    {
+        threshold_min = settings.threshold_min;
+        threshold_max = settings.threshold_max;
+        if (threshold_max > RMS_MAX_VALUE) threshold_max = RMS_MAX_VALUE; // Salva antes do limite de 2048
+        detect_mode = settings.mode;
+        load_digits();
+        start_monitoring();
+    }
+
+    stdio_init_all(); // Inicializa comunicação serial padrão
+
+    // Recupera o registro de eventos da flash (só leitura)
+    event_log_init();
+
+    // Inicializa a matriz WS2812 (PIO + DMA)
+    led_matrix_init(WS2812_PIN);
+
+    // Inicializa o display SSD1306
+    setup_ssd1306();
+
+    // Inicializa o buzzer (PWM) e o sequenciador do SOS
+    sos_init(BUZZER_PIN, BUZZER_FREQ_HZ, &sos_timing);
+
+    input_init(&input);
+    setup_button_interrupts(); // Configura interrupções para os botões
+
+#ifdef DETECTOR_BENCH
+    // Micro-benchmarks: espera o terminal USB (até 10 s) e imprime o resultado em CSV
+    for (int i = 0; i < 100 && !stdio_usb_connected(); i++)
+        sleep_ms(100);
+    bench_result_t bench_results[BENCH_MAX_RESULTS];
+    size_t bench_count = bench_run_all(&ssd, bench_results, BENCH_MAX_RESULTS, 0);
+    bench_print(bench_results, bench_count, BENCH_CSV);
+#endif
+
+    // Exibe a tela inicial com LEDs azuis (configuração) ou a de monitoração com LEDs verdes
+    update_display();
+    if (fast_boot)
+        set_all_leds(0, 10, 0);
+    else
+        set_all_leds(0, 0, 10);
+
+    // A amostragem em si é feita pelo ADC e DMA; o laço só despacha as tarefas
+    sched_init(tasks, sizeof(tasks) / sizeof(tasks[0]), SCHED_TICK_US);
+    while (true)
+    {
+        sched_run_pending();
+        INSTR_ONLY(instr_poll_display_transfer();)
+    }
+}
@@ -0,0 +1,15 @@
+// Gerado por tools/gen_decimator_coeffs.py - não editar manualmente
+// FIR de compensação de 31 taps simétricos em Q18, com ganho DC 1 / 10.125
+#define DECIMATOR_COEFFS_RATE 8000
+#define DECIMATOR_CIC_ORDER 4
+#define DECIMATOR_CIC_RATIO 6
+#define DECIMATOR_CIC_SHIFT 7
+#define DECIMATOR_FIR_RATIO 2
+#define DECIMATOR_FIR_TAPS 31
+#define DECIMATOR_COEF_SHIFT 18
+
+// Primeira metade dos taps (o central é o último); a outra é o espelho
+static const int32_t decimator_fir[16] = {
+    -17, 43, 105, -80, -269, 122, 555, -155,
+    -1033, 146, 1857, 1, -3520, -840, 8791, 14477,
+};
@@ -0,0 +1,147 @@
+// Gerado por tools/gen_fft_tables.py - não editar manualmente
+#define FFT_TABLE_SIZE 512
+#define FFT_TABLE_RATE 8000
+#define FFT_OCTAVE_BANDS 7
+#define FFT_THIRD_OCTAVE_BANDS 21
+
+static const int16_t fft_window[512] = {
+    0, 1, 5, 11, 20, 31, 44, 60, 79, 100, 123, 149,
+    177, 208, 241, 277, 315, 355, 398, 443, 491, 541, 593, 648,
+    705, 765, 827, 891, 958, 1027, 1098, 1171, 1247, 1325, 1406, 1488,
+    1573, 1660, 1749, 1841, 1935, 2030, 2128, 2229, 2331, 2435, 2542, 2651,
+    2761, 2874, 2989, 3105, 3224, 3345, 3468, 3592, 3719, 3847, 3978, 4110,
+    4244, 4380, 4518, 4657, 4799, 4942, 5087, 5233, 5381, 5531, 5682, 5835,
+    5990, 6146, 6304, 6463, 6624, 6786, 6950, 7115, 7282, 7449, 7619, 7789,
+    7961, 8134, 8308, 8484, 8661, 8839, 9018, 9198, 9379, 9561, 9745, 9929,
+    10114, 10300, 10487, 10676, 10864, 11054, 11245, 11436, 11628, 11821, 12014, 12208,
+    12403, 12598, 12794, 12991, 13188, 13385, 13583, 13781, 13980, 14179, 14378, 14578,
+    14778, 14978, 15179, 15379, 15580, 15781, 15982, 16183, 16384, 16585, 16786, 16987,
+    17188, 17389, 17589, 17790, 17990, 18190, 18390, 18589, 18788, 18987, 19185, 19383,
+    19580, 19777, 19974, 20170, 20365, 20560, 20754, 20947, 21140, 21332, 21523, 21714,
+    21904, 22092, 22281, 22468, 22654, 22839, 23023, 23207, 23389, 23570, 23750, 23929,
+    24107, 24284, 24460, 24634, 24807, 24979, 25149, 25319, 25486, 25653, 25818, 25982,
+    26144, 26305, 26464, 26622, 26778, 26933, 27086, 27237, 27387, 27535, 27681, 27826,
+    27969, 28111, 28250, 28388, 28524, 28658, 28790, 28921, 29049, 29176, 29300, 29423,
+    29544, 29663, 29779, 29894, 30007, 30117, 30226, 30333, 30437, 30539, 30640, 30738,
+    30833, 30927, 31019, 31108, 31195, 31280, 31362, 31443, 31521, 31597, 31670, 31741,
+    31810, 31877, 31941, 32003, 32063, 32120, 32175, 32227, 32277, 32325, 32370, 32413,
+    32453, 32491, 32527, 32560, 32591, 32619, 32645, 32668, 32689, 32708, 32724, 32737,
+    32748, 32757, 32763, 32767, 32767, 32767, 32763, 32757, 32748, 32737, 32724, 32708,
+    32689, 32668, 32645, 32619, 32591, 32560, 32527, 32491, 32453, 32413, 32370, 32325,
+    32277, 32227, 32175, 32120, 32063, 32003, 31941, 31877, 31810, 31741, 31670, 31597,
+    31521, 31443, 31362, 31280, 31195, 31108, 31019, 30927, 30833, 30738, 30640, 30539,
+    30437, 30333, 30226, 30117, 30007, 29894, 29779, 29663, 29544, 29423, 29300, 29176,
+    29049, 28921, 28790, 28658, 28524, 28388, 28250, 28111, 27969, 27826, 27681, 27535,
+    27387, 27237, 27086, 26933, 26778, 26622, 26464, 26305, 26144, 25982, 25818, 25653,
+    25486, 25319, 25149, 24979, 24807, 24634, 24460, 24284, 24107, 23929, 23750, 23570,
+    23389, 23207, 23023, 22839, 22654, 22468, 22281, 22092, 21904, 21714, 21523, 21332,
+    21140, 20947, 20754, 20560, 20365, 20170, 19974, 19777, 19580, 19383, 19185, 18987,
+    18788, 18589, 18390, 18190, 17990, 17790, 17589, 17389, 17188, 16987, 16786, 16585,
+    16384, 16183, 15982, 15781, 15580, 15379, 15179, 14978, 14778, 14578, 14378, 14179,
+    13980, 13781, 13583, 13385, 13188, 12991, 12794, 12598, 12403, 12208, 12014, 11821,
+    11628, 11436, 11245, 11054, 10864, 10676, 10487, 10300, 10114, 9929, 9745, 9561,
+    9379, 9198, 9018, 8839, 8661, 8484, 8308, 8134, 7961, 7789, 7619, 7449,
+    7282, 7115, 6950, 6786, 6624, 6463, 6304, 6146, 5990, 5835, 5682, 5531,
+    5381, 5233, 5087, 4942, 4799, 4657, 4518, 4380, 4244, 4110, 3978, 3847,
+    3719, 3592, 3468, 3345, 3224, 3105, 2989, 2874, 2761, 2651, 2542, 2435,
+    2331, 2229, 2128, 2030, 1935, 1841, 1749, 1660, 1573, 1488, 1406, 1325,
+    1247, 1171, 1098, 1027, 958, 891, 827, 765, 705, 648, 593, 541,
+    491, 443, 398, 355, 315, 277, 241, 208, 177, 149, 123, 100,
+    79, 60, 44, 31, 20, 11, 5, 1,
+};
+
+static const int16_t fft_cos[256] = {
+    32767, 32766, 32758, 32746, 32729, 32706, 32679, 32647, 32610, 32568, 32522, 32470,
+    32413, 32352, 32286, 32214, 32138, 32058, 31972, 31881, 31786, 31686, 31581, 31471,
+    31357, 31238, 31114, 30986, 30853, 30715, 30572, 30425, 30274, 30118, 29957, 29792,
+    29622, 29448, 29269, 29086, 28899, 28707, 28511, 28311, 28106, 27897, 27684, 27467,
+    27246, 27020, 26791, 26557, 26320, 26078, 25833, 25583, 25330, 25073, 24812, 24548,
+    24279, 24008, 23732, 23453, 23170, 22884, 22595, 22302, 22006, 21706, 21403, 21097,
+    20788, 20475, 20160, 19841, 19520, 19195, 18868, 18538, 18205, 17869, 17531, 17190,
+    16846, 16500, 16151, 15800, 15447, 15091, 14733, 14373, 14010, 13646, 13279, 12910,
+    12540, 12167, 11793, 11417, 11039, 10660, 10279, 9896, 9512, 9127, 8740, 8351,
+    7962, 7571, 7180, 6787, 6393, 5998, 5602, 5205, 4808, 4410, 4011, 3612,
+    3212, 2811, 2411, 2009, 1608, 1206, 804, 402, 0, -402, -804, -1206,
+    -1608, -2009, -2411, -2811, -3212, -3612, -4011, -4410, -4808, -5205, -5602, -5998,
+    -6393, -6787, -7180, -7571, -7962, -8351, -8740, -9127, -9512, -9896, -10279, -10660,
+    -11039, -11417, -11793, -12167, -12540, -12910, -13279, -13646, -14010, -14373, -14733, -15091,
+    -15447, -15800, -16151, -16500, -16846, -17190, -17531, -17869, -18205, -18538, -18868, -19195,
+    -19520, -19841, -20160, -20475, -20788, -21097, -21403, -21706, -22006, -22302, -22595, -22884,
+    -23170, -23453, -23732, -24008, -24279, -24548, -24812, -25073, -25330, -25583, -25833, -26078,
+    -26320, -26557, -26791, -27020, -27246, -27467, -27684, -27897, -28106, -28311, -28511, -28707,
+    -28899, -29086, -29269, -29448, -29622, -29792, -29957, -30118, -30274, -30425, -30572, -30715,
+    -30853, -30986, -31114, -31238, -31357, -31471, -31581, -31686, -31786, -31881, -31972, -32058,
+    -32138, -32214, -32286, -32352, -32413, -32470, -32522, -32568, -32610, -32647, -32679, -32706,
+    -32729, -32746, -32758, -32766,
+};
+
+static const int16_t fft_sin[256] = {
+    0, 402, 804, 1206, 1608, 2009, 2411, 2811, 3212, 3612, 4011, 4410,
+    4808, 5205, 5602, 5998, 6393, 6787, 7180, 7571, 7962, 8351, 8740, 9127,
+    9512, 9896, 10279, 10660, 11039, 11417, 11793, 12167, 12540, 12910, 13279, 13646,
+    14010, 14373, 14733, 15091, 15447, 15800, 16151, 16500, 16846, 17190, 17531, 17869,
+    18205, 18538, 18868, 19195, 19520, 19841, 20160, 20475, 20788, 21097, 21403, 21706,
+    22006, 22302, 22595, 22884, 23170, 23453, 23732, 24008, 24279, 24548, 24812, 25073,
+    25330, 25583, 25833, 26078, 26320, 26557, 26791, 27020, 27246, 27467, 27684, 27897,
+    28106, 28311, 28511, 28707, 28899, 29086, 29269, 29448, 29622, 29792, 29957, 30118,
+    30274, 30425, 30572, 30715, 30853, 30986, 31114, 31238, 31357, 31471, 31581, 31686,
+    31786, 31881, 31972, 32058, 32138, 32214, 32286, 32352, 32413, 32470, 32522, 32568,
+    32610, 32647, 32679, 32706, 32729, 32746, 32758, 32766, 32767, 32766, 32758, 32746,
+    32729, 32706, 32679, 32647, 32610, 32568, 32522, 32470, 32413, 32352, 32286, 32214,
+    32138, 32058, 31972, 31881, 31786, 31686, 31581, 31471, 31357, 31238, 31114, 30986,
+    30853, 30715, 30572, 30425, 30274, 30118, 29957, 29792, 29622, 29448, 29269, 29086,
+    28899, 28707, 28511, 28311, 28106, 27897, 27684, 27467, 27246, 27020, 26791, 26557,
+    26320, 26078, 25833, 25583, 25330, 25073, 24812, 24548, 24279, 24008, 23732, 23453,
+    23170, 22884, 22595, 22302, 22006, 21706, 21403, 21097, 20788, 20475, 20160, 19841,
+    19520, 19195, 18868, 18538, 18205, 17869, 17531, 17190, 16846, 16500, 16151, 15800,
+    15447, 15091, 14733, 14373, 14010, 13646, 13279, 12910, 12540, 12167, 11793, 11417,
+    11039, 10660, 10279, 9896, 9512, 9127, 8740, 8351, 7962, 7571, 7180, 6787,
+    6393, 5998, 5602, 5205, 4808, 4410, 4011, 3612, 3212, 2811, 2411, 2009,
+    1608, 1206, 804, 402,
+};
+
+static const uint8_t fft_bitrev[256] = {
+    0, 128, 64, 192, 32, 160, 96, 224, 16, 144, 80, 208, 48, 176, 112, 240,
+    8, 136, 72, 200, 40, 168, 104, 232, 24, 152, 88, 216, 56, 184, 120, 248,
+    4, 132, 68, 196, 36, 164, 100, 228, 20, 148, 84, 212, 52, 180, 116, 244,
+    12, 140, 76, 204, 44, 172, 108, 236, 28, 156, 92, 220, 60, 188, 124, 252,
+    2, 130, 66, 194, 34, 162, 98, 226, 18, 146, 82, 210, 50, 178, 114, 242,
+    10, 138, 74, 202, 42, 170, 106, 234, 26, 154, 90, 218, 58, 186, 122, 250,
+    6, 134, 70, 198, 38, 166, 102, 230, 22, 150, 86, 214, 54, 182, 118, 246,
+    14, 142, 78, 206, 46, 174, 110, 238, 30, 158, 94, 222, 62, 190, 126, 254,
+    1, 129, 65, 193, 33, 161, 97, 225, 17, 145, 81, 209, 49, 177, 113, 241,
+    9, 137, 73, 201, 41, 169, 105, 233, 25, 153, 89, 217, 57, 185, 121, 249,
+    5, 133, 69, 197, 37, 165, 101, 229, 21, 149, 85, 213, 53, 181, 117, 245,
+    13, 141, 77, 205, 45, 173, 109, 237, 29, 157, 93, 221, 61, 189, 125, 253,
+    3, 131, 67, 195, 35, 163, 99, 227, 19, 147, 83, 211, 51, 179, 115, 243,
+    11, 139, 75, 203, 43, 171, 107, 235, 27, 155, 91, 219, 59, 187, 123, 251,
+    7, 135, 71, 199, 39, 167, 103, 231, 23, 151, 87, 215, 55, 183, 119, 247,
+    15, 143, 79, 207, 47, 175, 111, 239, 31, 159, 95, 223, 63, 191, 127, 255,
+};
+
+static const uint16_t fft_octave_center_hz[7] = {
+    31, 62, 125, 250, 500, 1000, 2000,
+};
+
+static const uint16_t fft_octave_first_bin[7] = {
+    2, 3, 6, 12, 23, 46, 91,
+};
+
+static const uint16_t fft_octave_last_bin[7] = {
+    2, 5, 11, 22, 45, 90, 181,
+};
+
+static const uint16_t fft_third_octave_center_hz[21] = {
+    32, 40, 50, 63, 79, 100, 126, 158, 200, 251, 316, 398,
+    501, 631, 794, 1000, 1259, 1585, 1995, 2512, 3162,
+};
+
+static const uint16_t fft_third_octave_first_bin[21] = {
+    2, 3, 3, 4, 5, 6, 8, 10, 12, 15, 19, 23,
+    29, 36, 46, 58, 72, 91, 114, 144, 181,
+};
+
+static const uint16_t fft_third_octave_last_bin[21] = {
+    2, 3, 3, 4, 5, 7, 9, 11, 14, 18, 22, 28,
+    36, 45, 57, 71, 90, 113, 143, 180, 227,
+};
@@ -0,0 +1,38 @@
+// Gerado por tools/gen_goertzel_coeffs.py - não editar manualmente
+// Banco de detectores de tom: 2·cos(2π·f/fs) em Q14, limiar em décimos de dBFS
+#define TONE_COEFFS_RATE 8000
+#define TONE_COEFFS_BLOCK 256
+#define TONE_COEFF_SHIFT 14
+#define TONE_DETECTORS 1
+#define TONE_WINDOW_SHIFT 15
+#define TONE_WINDOW_GAIN 128
+
+static const uint16_t tone_freq_hz[1] = {2000};
+static const int32_t tone_coeff[1] = {0};
+static const int16_t tone_threshold_x10[1] = {-300};
+static const char *const tone_name[1] = {"Buzzer"};
+
+static const int16_t tone_window[256] = {
+    0, 5, 20, 44, 79, 123, 177, 241, 315, 398, 491, 593,
+    705, 827, 958, 1098, 1247, 1406, 1573, 1749, 1935, 2128, 2331, 2542,
+    2761, 2989, 3224, 3468, 3719, 3978, 4244, 4518, 4799, 5087, 5381, 5682,
+    5990, 6304, 6624, 6950, 7282, 7619, 7961, 8308, 8661, 9018, 9379, 9745,
+    10114, 10487, 10864, 11245, 11628, 12014, 12403, 12794, 13188, 13583, 13980, 14378,
+    14778, 15179, 15580, 15982, 16384, 16786, 17188, 17589, 17990, 18390, 18788, 19185,
+    19580, 19974, 20365, 20754, 21140, 21523, 21904, 22281, 22654, 23023, 23389, 23750,
+    24107, 24460, 24807, 25149, 25486, 25818, 26144, 26464, 26778, 27086, 27387, 27681,
+    27969, 28250, 28524, 28790, 29049, 29300, 29544, 29779, 30007, 30226, 30437, 30640,
+    30833, 31019, 31195, 31362, 31521, 31670, 31810, 31941, 32063, 32175, 32277, 32370,
+    32453, 32527, 32591, 32645, 32689, 32724, 32748, 32763, 32767, 32763, 32748, 32724,
+    32689, 32645, 32591, 32527, 32453, 32370, 32277, 32175, 32063, 31941, 31810, 31670,
+    31521, 31362, 31195, 31019, 30833, 30640, 30437, 30226, 30007, 29779, 29544, 29300,
+    29049, 28790, 28524, 28250, 27969, 27681, 27387, 27086, 26778, 26464, 26144, 25818,
+    25486, 25149, 24807, 24460, 24107, 23750, 23389, 23023, 22654, 22281, 21904, 21523,
+    21140, 20754, 20365, 19974, 19580, 19185, 18788, 18390, 17990, 17589, 17188, 16786,
+    16384, 15982, 15580, 15179, 14778, 14378, 13980, 13583, 13188, 12794, 12403, 12014,
+    11628, 11245, 10864, 10487, 10114, 9745, 9379, 9018, 8661, 8308, 7961, 7619,
+    7282, 6950, 6624, 6304, 5990, 5682, 5381, 5087, 4799, 4518, 4244, 3978,
+    3719, 3468, 3224, 2989, 2761, 2542, 2331, 2128, 1935, 1749, 1573, 1406,
+    1247, 1098, 958, 827, 705, 593, 491, 398, 315, 241, 177, 123,
+    79, 44, 20, 5,
+};
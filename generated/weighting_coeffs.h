@@ -0,0 +1,15 @@
+// Gerado por tools/gen_weighting_coeffs.py - não editar manualmente
+// Seções biquad {b0, b1, b2, a1, a2} em Q28
+#define WEIGHTING_COEFFS_RATE 8000
+#define WEIGHTING_COEF_SHIFT 28
+
+static const biquad_coeffs_t weighting_a_sections[3] = {
+    {268435456, -536870912, 268435456, -528255075, 259888754},
+    {268435456, -536870912, 268435456, -397041582, 138178270},
+    {234272394, 8668079, 0, 0, 0},
+};
+
+static const biquad_coeffs_t weighting_c_sections[2] = {
+    {268435456, -536870912, 268435456, -528255075, 259888754},
+    {257424724, 9524715, 0, 0, 0},
+};
@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <string.h>
+#include "acquisition.h"
+#include "acquisition_replay.h"
+#include "hal_shim.h"
+
+static FILE *replay_file = NULL;
+static bool replay_wav = false;      // true: PCM 16 bits com sinal; false: códigos crus do ADC
+static uint16_t replay_channels = 1; // Apenas o primeiro canal do WAV é usado
+static uint32_t replay_rate = 0;     // Taxa declarada no WAV (0 para arquivos crus)
+static bool running = false;
+static bool replay_eof = true;
+static uint16_t *dma_write = NULL; // Buffer sendo "gravado" pelo DMA simulado
+static uint16_t *dma_armed = NULL; // Buffer do canal encadeado
+
+static uint32_t read_le(const uint8_t *p, int n)
+{
+  uint32_t v = 0;
+  for (int i = n - 1; i >= 0; i--)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+// Posiciona o arquivo no início do chunk "data" e lê o formato do chunk "fmt "
+static bool parse_wav(void)
+{
+  uint8_t hdr[12];
+  if (fread(hdr, 1, 12, replay_file) != 12 || memcmp(hdr, "RIFF", 4) != 0 || memcmp(hdr + 8, "WAVE", 4) != 0)
+    return false;
+
+  uint8_t chunk[8];
+  while (fread(chunk, 1, 8, replay_file) == 8)
+  {
+    uint32_t size = read_le(chunk + 4, 4);
+    if (memcmp(chunk, "fmt ", 4) == 0)
+    {
+      uint8_t fmt[16];
+      if (size < 16 || fread(fmt, 1, 16, replay_file) != 16)
+        return false;
+      if (read_le(fmt, 2) != 1 || read_le(fmt + 14, 2) != 16)
+        return false; // Somente PCM linear de 16 bits
+      replay_channels = read_le(fmt + 2, 2);
+      replay_rate = read_le(fmt + 4, 4);
+      fseek(replay_file, (long)(size - 16 + (size & 1)), SEEK_CUR);
+    }
+    else if (memcmp(chunk, "data", 4) == 0)
+    {
+      return replay_channels > 0;
+    }
+    else
+    {
+      fseek(replay_file, (long)(size + (size & 1)), SEEK_CUR);
+    }
+  }
+  return false;
+}
+
+bool acq_replay_open(const char *path)
+{
+  acq_replay_close();
+  replay_file = fopen(path, "rb");
+  if (!replay_file)
+    return false;
+
+  replay_eof = false;
+  replay_wav = parse_wav();
+  if (!replay_wav)
+  {
+    rewind(replay_file);
+    replay_channels = 1;
+    replay_rate = 0;
+  }
+  return true;
+}
+
+void acq_replay_close(void)
+{
+  if (replay_file)
+    fclose(replay_file);
+  replay_file = NULL;
+  replay_eof = true;
+}
+
+bool acq_replay_eof(void)
+{
+  return replay_eof;
+}
+
+uint32_t acq_replay_sample_rate(void)
+{
+  return replay_rate;
+}
+
+static bool read_sample(uint16_t *code)
+{
+  uint8_t frame[2 * 8];
+  size_t frame_bytes = 2u * (replay_channels < 8 ? replay_channels : 8);
+  if (fread(frame, 1, frame_bytes, replay_file) != frame_bytes)
+    return false;
+  if (replay_channels > 8)
+    fseek(replay_file, (long)(2u * (replay_channels - 8)), SEEK_CUR);
+
+  uint16_t raw = (uint16_t)read_le(frame, 2);
+  if (replay_wav)
+    *code = (uint16_t)(((int32_t)(int16_t)raw + 32768) >> 4); // Centraliza como o microfone polarizado
+  else
+    *code = raw & 0x0FFF;
+  return true;
+}
+
+uint32_t acq_replay_pump(uint32_t max_blocks)
+{
+  uint32_t completed = 0;
+  while (running && replay_file && completed < max_blocks)
+  {
+    for (size_t i = 0; i < ACQ_BLOCK_SAMPLES; i++)
+    {
+      if (!read_sample(&dma_write[i]))
+      {
+        replay_eof = true; // Fim do arquivo: o bloco parcial é descartado como no hardware parado
+        return completed;
+      }
+    }
+    // O joystick chega junto com cada bloco, como as médias do round robin
+    uint16_t aux[ACQ_AUX_CHANNELS];
+    acq_backend_read_aux(aux);
+    acq_aux_done_from_isr(aux);
+    uint16_t *next = acq_block_done_from_isr();
+    dma_write = dma_armed;
+    dma_armed = next;
+    completed++;
+  }
+  return completed;
+}
+
+void acq_backend_init(uint32_t sample_rate_hz)
+{
+  (void)sample_rate_hz; // O ritmo é dado por quem chama acq_replay_pump()
+}
+
+void acq_backend_start(void)
+{
+  dma_write = acq_block_buffer(0);
+  dma_armed = acq_block_buffer(1);
+  running = true;
+}
+
+void acq_backend_stop(void)
+{
+  running = false;
+}
+
+void acq_backend_read_aux(uint16_t values[ACQ_AUX_CHANNELS])
+{
+  for (int i = 0; i < ACQ_AUX_CHANNELS; i++)
+    values[i] = hal_shim_get_adc((unsigned int)i);
+}
@@ -0,0 +1,18 @@
+#ifndef ACQUISITION_REPLAY_H
+#define ACQUISITION_REPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Backend de aquisição para o host: no lugar do ADC e do DMA, as amostras vêm
+// de um arquivo WAV (PCM 16 bits) ou de um binário cru de códigos do ADC
+// (uint16 little-endian). Cada chamada de acq_replay_pump() equivale às
+// interrupções de fim de bloco do DMA.
+
+bool acq_replay_open(const char *path);
+void acq_replay_close(void);
+uint32_t acq_replay_sample_rate(void);
+uint32_t acq_replay_pump(uint32_t max_blocks);
+bool acq_replay_eof(void); // O arquivo acabou (ou não foi aberto)
+
+#endif
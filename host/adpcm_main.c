@@ -0,0 +1,241 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "acquisition.h"
+#include "acquisition_replay.h"
+#include "adpcm.h"
+
+// Passa uma gravação pelo codificador ADPCM (lib/adpcm.c) bloco a bloco,
+// como o streaming do núcleo 1, decodifica cada bloco sozinho e imprime a
+// SNR da ida e volta contra os códigos originais, a compressão e o tempo de
+// codificação e decodificação por amostra no host (o custo no RP2040 sai do
+// caso adpcm_encode_block do detector_bench). Confere também que o
+// decodificador reconstrói exatamente o que o codificador previu. Sai com 1
+// se a SNR fica abaixo do mínimo ou a reconstrução diverge. Com saida.wav,
+// grava o áudio decodificado para ouvir. Sem arquivo, gera sinais conhecidos
+// (senos em vários níveis, tons somados, ruído branco e uma varredura) com a
+// polarização do microfone, cada um com a sua SNR mínima.
+//
+// Uso: detector_adpcm [audio.wav|.raw [snr_minima_db] [saida.wav]]
+
+#define ADPCM_TOOL_MIN_SNR_DB 20.0
+#define ADPCM_TOOL_RATE 8000
+#define ADPCM_TOOL_BLOCKS 125 // 4 s de cada sinal sintético
+
+typedef struct
+{
+  const char *name;
+  double freq, amplitude;   // Seno principal (amplitude em códigos; 0: nenhum)
+  double freq2, amplitude2; // Segundo tom
+  double noise;             // Ruído branco uniforme (pico em códigos)
+  bool sweep;               // freq sobe até freq2 ao longo do sinal
+  double min_snr_db;        // Uns 3 dB abaixo do medido
+} synthetic_t;
+
+static const synthetic_t synthetics[] = {
+    {"seno de 1 kHz a -6 dBFS", 1000.0, 1024.0, 0, 0, 0, false, 18.0},
+    {"seno de 440 Hz a -30 dBFS", 440.0, 65.0, 0, 0, 0, false, 24.0},
+    {"dois tons de 300 Hz e 2,5 kHz", 300.0, 800.0, 2500.0, 300.0, 0, false, 20.0},
+    {"ruido branco a -20 dBFS", 0, 0, 0, 0, 355.0, false, 12.0},
+    {"varredura de 100 Hz a 3,5 kHz", 100.0, 900.0, 3500.0, 0, 0, true, 15.0},
+};
+
+typedef struct
+{
+  uint32_t samples, bytes, blocks, mismatched_blocks;
+  double sum, sum_sq, err_sq, encode_ns, decode_ns;
+} adpcm_totals_t;
+
+static uint8_t encoded[ADPCM_BLOCK_BYTES(ACQ_BLOCK_SAMPLES)];
+static int16_t decoded[ACQ_BLOCK_SAMPLES];
+static uint16_t codes[ACQ_BLOCK_SAMPLES];
+static int errors;
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void put_le(FILE *f, uint32_t v, int bytes)
+{
+  for (int i = 0; i < bytes; i++)
+    fputc((int)((v >> (8 * i)) & 0xFF), f);
+}
+
+// Cabeçalho de WAV mono de 16 bits; reescrito com os tamanhos no fim
+static void write_wav_header(FILE *f, uint32_t rate, uint32_t samples)
+{
+  fseek(f, 0, SEEK_SET);
+  fwrite("RIFF", 1, 4, f);
+  put_le(f, 36 + samples * 2, 4);
+  fwrite("WAVEfmt ", 1, 8, f);
+  put_le(f, 16, 4);
+  put_le(f, 1, 2);
+  put_le(f, 1, 2);
+  put_le(f, rate, 4);
+  put_le(f, rate * 2, 4);
+  put_le(f, 2, 2);
+  put_le(f, 16, 2);
+  fwrite("data", 1, 4, f);
+  put_le(f, samples * 2, 4);
+}
+
+// Ida e volta de um bloco, como o streaming: codifica com o estado contínuo e
+// decodifica o bloco sozinho
+static void process_block(adpcm_state_t *state, const uint16_t *samples, size_t len, adpcm_totals_t *t, FILE *out)
+{
+  double t0 = now_ns();
+  size_t bytes = adpcm_encode_block(state, samples, len, encoded);
+  double t1 = now_ns();
+  adpcm_decode_block(encoded, len, decoded);
+  double t2 = now_ns();
+  t->encode_ns += t1 - t0;
+  t->decode_ns += t2 - t1;
+
+  for (size_t i = 0; i < len; i++)
+  {
+    double x = ((int32_t)(samples[i] & 0x0FFF) - 2048) * 16.0;
+    double e = decoded[i] - x;
+    t->sum += x;
+    t->sum_sq += x * x;
+    t->err_sq += e * e;
+  }
+  if (len && decoded[len - 1] != state->predictor)
+    t->mismatched_blocks++;
+  if (out)
+    fwrite(decoded, sizeof(decoded[0]), len, out); // O host é little-endian, como o WAV
+  t->samples += (uint32_t)len;
+  t->bytes += (uint32_t)bytes;
+  t->blocks++;
+}
+
+// SNR sobre a parte variável do sinal: a polarização do microfone não conta como sinal
+static double snr_db(const adpcm_totals_t *t)
+{
+  double mean = t->sum / t->samples;
+  double signal = t->sum_sq / t->samples - mean * mean;
+  double noise = t->err_sq / t->samples;
+  return noise > 0 ? 10.0 * log10(signal / noise) : INFINITY;
+}
+
+static int run_file(const char *path, double min_snr, const char *out_path)
+{
+  if (!acq_replay_open(path))
+  {
+    fprintf(stderr, "nao foi possivel abrir %s\n", path);
+    return 1;
+  }
+  uint32_t rate = acq_replay_sample_rate();
+  if (rate == 0)
+    rate = ADPCM_TOOL_RATE; // Binário cru: a taxa do firmware
+  FILE *out = NULL;
+  if (out_path)
+  {
+    out = fopen(out_path, "wb");
+    if (!out)
+    {
+      fprintf(stderr, "nao foi possivel criar %s\n", out_path);
+      return 1;
+    }
+    write_wav_header(out, rate, 0);
+  }
+
+  acq_init(rate);
+  acq_start();
+  adpcm_state_t state;
+  adpcm_init(&state);
+  adpcm_totals_t t = {0};
+  while (!acq_replay_eof())
+  {
+    acq_replay_pump(1);
+    acq_block_t block;
+    while (acq_get_block(&block))
+    {
+      process_block(&state, block.samples, block.len, &t, out);
+      acq_release_block(&block);
+    }
+  }
+  acq_replay_close();
+  if (out)
+  {
+    write_wav_header(out, rate, t.samples);
+    fclose(out);
+  }
+  if (t.samples == 0)
+  {
+    fprintf(stderr, "nenhum bloco completo em %s\n", path);
+    return 1;
+  }
+
+  double snr = snr_db(&t);
+  bool ok = snr >= min_snr && t.mismatched_blocks == 0;
+  printf("%lu blocos, %lu amostras (%.2f s a %lu Hz)\n", (unsigned long)t.blocks, (unsigned long)t.samples,
+         (double)t.samples / rate, (unsigned long)rate);
+  printf("ADPCM: %lu bytes, %.2f bits/amostra, %.2f:1 contra PCM 16 bits e %.2f:1 contra 12 bits empacotados\n",
+         (unsigned long)t.bytes, t.bytes * 8.0 / t.samples, t.samples * 2.0 / t.bytes, t.samples * 1.5 / t.bytes);
+  printf("SNR da ida e volta: %.1f dB (minimo %.1f dB)\n", snr, min_snr);
+  printf("Codificacao: %.1f ns/amostra (%.1f Mamostras/s); decodificacao: %.1f ns/amostra\n",
+         t.encode_ns / t.samples, t.samples / t.encode_ns * 1e3, t.decode_ns / t.samples);
+  printf("Blocos com reconstrucao divergente: %lu\n", (unsigned long)t.mismatched_blocks);
+  errors += !ok;
+  return 0;
+}
+
+static void run_synthetic(const synthetic_t *sig)
+{
+  adpcm_state_t state;
+  adpcm_init(&state);
+  adpcm_totals_t t = {0};
+  uint32_t seed = 2463534242u;
+  double phase = 0;
+  uint32_t total = ADPCM_TOOL_BLOCKS * ACQ_BLOCK_SAMPLES;
+  for (uint32_t b = 0; b < ADPCM_TOOL_BLOCKS; b++)
+  {
+    for (size_t i = 0; i < ACQ_BLOCK_SAMPLES; i++)
+    {
+      uint32_t n = b * ACQ_BLOCK_SAMPLES + (uint32_t)i;
+      double freq = sig->sweep ? sig->freq + (sig->freq2 - sig->freq) * n / total : sig->freq;
+      phase += 2.0 * M_PI * freq / ADPCM_TOOL_RATE;
+      double v = 1900.0 + sig->amplitude * sin(phase); // Polarização do microfone fora do meio da escala
+      if (!sig->sweep)
+        v += sig->amplitude2 * sin(2.0 * M_PI * sig->freq2 * n / ADPCM_TOOL_RATE);
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+      v += sig->noise * (2.0 * seed / 4294967296.0 - 1.0);
+      long code = lround(v);
+      codes[i] = (uint16_t)(code < 0 ? 0 : code > 4095 ? 4095 : code);
+    }
+    process_block(&state, codes, ACQ_BLOCK_SAMPLES, &t, NULL);
+  }
+  double snr = snr_db(&t);
+  bool ok = snr >= sig->min_snr_db && t.mismatched_blocks == 0;
+  printf("%-32s SNR %.1f dB (minimo %.1f dB), %.2f bits/amostra, %lu blocos divergentes: %s\n", sig->name, snr,
+         sig->min_snr_db, t.bytes * 8.0 / t.samples, (unsigned long)t.mismatched_blocks, ok ? "ok" : "ERRO");
+  errors += !ok;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 4)
+  {
+    fprintf(stderr, "uso: %s [audio.wav|.raw [snr_minima_db] [saida.wav]]\n", argv[0]);
+    return 2;
+  }
+  if (argc > 1)
+  {
+    int rc = run_file(argv[1], argc > 2 ? atof(argv[2]) : ADPCM_TOOL_MIN_SNR_DB, argc > 3 ? argv[3] : NULL);
+    if (rc)
+      return rc;
+  }
+  else
+  {
+    for (size_t i = 0; i < sizeof(synthetics) / sizeof(synthetics[0]); i++)
+      run_synthetic(&synthetics[i]);
+  }
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,33 @@
+#include <time.h>
+#include "bench.h"
+
+void bench_backend_init(void)
+{
+}
+
+uint32_t bench_backend_ticks(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+uint32_t bench_backend_elapsed(uint32_t start)
+{
+  return bench_backend_ticks() - start; // Estoura a cada 4,3 s, muito além de uma iteração
+}
+
+uint32_t bench_backend_tick_hz(void)
+{
+  return 1000000000u;
+}
+
+uint32_t bench_backend_cpu_hz(void)
+{
+  return 0;
+}
+
+const char *bench_backend_platform(void)
+{
+  return "host";
+}
@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "led_matrix.h"
+#include "ssd1306.h"
+#include "ssd1306_host.h"
+
+// Roda os micro-benchmarks de lib/bench.c no host. Com iteracoes, cada caso
+// roda no máximo essa quantidade (o teste de fumaça do ctest usa 2).
+// Uso: detector_bench [--csv|--json] [iteracoes]
+
+int main(int argc, char **argv)
+{
+  bench_format_t format = BENCH_CSV;
+  uint32_t max_iterations = 0;
+  char *end = NULL;
+  if (argc > 1 && strcmp(argv[1], "--json") == 0)
+    format = BENCH_JSON;
+  if (argc > 2)
+    max_iterations = (uint32_t)strtoul(argv[2], &end, 10);
+  if (argc > 3 || (argc > 1 && strcmp(argv[1], "--json") != 0 && strcmp(argv[1], "--csv") != 0) ||
+      (argc > 2 && (*end != '\0' || max_iterations == 0)))
+  {
+    fprintf(stderr, "uso: %s [--csv|--json] [iteracoes]\n", argv[0]);
+    return 2;
+  }
+
+  ssd1306_t ssd;
+  ssd1306_host_reset();
+  ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c1);
+  ssd1306_config(&ssd);
+  led_matrix_init(7);
+
+  bench_result_t results[BENCH_MAX_RESULTS];
+  size_t count = bench_run_all(&ssd, results, BENCH_MAX_RESULTS, max_iterations);
+  bench_print(results, count, format);
+  return count ? 0 : 1;
+}
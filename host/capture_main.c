@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "acquisition.h"
+#include "capture.h"
+
+// Injeta um transiente num sinal em que cada amostra é conhecida, passa os
+// blocos por lib/capture.c como o núcleo 1 (grava, compara, dispara no bloco
+// do alarme) e confere amostra a amostra que a captura congelada é a janela
+// certa do sinal: começa CAPTURE_PRE_MS antes do início do bloco do alarme
+// (ou no início da aquisição, se ela for mais curta), termina CAPTURE_POST_MS
+// depois, e o transiente aparece no índice esperado. Sai com 1 se algo não
+// bate.
+//
+// Uso: detector_capture [amostra_do_transiente ...]
+
+#define CAPTURE_TOOL_BLOCKS 160        // 5,1 s de sinal
+#define CAPTURE_TOOL_PEAK 4095         // Transiente: uma amostra no topo da escala
+#define CAPTURE_TOOL_ALARM_DEVIATION 1500 // "Fora do range": pico a mais disso do meio da escala
+
+static uint16_t signal[CAPTURE_TOOL_BLOCKS * ACQ_BLOCK_SAMPLES];
+static capture_t capture;
+
+// Ruído determinístico em volta do meio da escala, diferente a cada amostra
+static void make_signal(uint32_t transient)
+{
+  uint32_t seed = 1;
+  for (uint32_t n = 0; n < sizeof(signal) / sizeof(signal[0]); n++)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    signal[n] = (uint16_t)(2048 + ((int32_t)(seed >> 23) - 256));
+  }
+  signal[transient] = CAPTURE_TOOL_PEAK;
+}
+
+static bool block_alarms(const uint16_t *block)
+{
+  for (int i = 0; i < ACQ_BLOCK_SAMPLES; i++)
+    if (abs((int)block[i] - 2048) > CAPTURE_TOOL_ALARM_DEVIATION)
+      return true;
+  return false;
+}
+
+// Roda a aquisição até stop_block (ou até o fim) e confere a captura; devolve o número de erros
+static int run_case(uint32_t transient, uint32_t stop_block)
+{
+  make_signal(transient);
+  capture_restart(&capture);
+  uint32_t alarm_block = UINT32_MAX;
+  for (uint32_t b = 0; b < CAPTURE_TOOL_BLOCKS && b < stop_block; b++)
+  {
+    const uint16_t *block = &signal[b * ACQ_BLOCK_SAMPLES];
+    capture_push(&capture, block, ACQ_BLOCK_SAMPLES);
+    if (alarm_block == UINT32_MAX && block_alarms(block))
+    {
+      alarm_block = b;
+      capture_trigger(&capture, ACQ_BLOCK_SAMPLES, b);
+    }
+  }
+  capture_stop(&capture);
+
+  capture_info_t info;
+  if (!capture_get_info(&capture, &info))
+  {
+    printf("transiente %lu: nenhuma captura congelada\n", (unsigned long)transient);
+    return 1;
+  }
+
+  uint32_t trigger_sample = alarm_block * ACQ_BLOCK_SAMPLES;
+  uint32_t expected_pre = trigger_sample < CAPTURE_PRE_SAMPLES ? trigger_sample : CAPTURE_PRE_SAMPLES;
+  uint32_t available_post = stop_block * ACQ_BLOCK_SAMPLES - trigger_sample;
+  uint32_t expected_total = expected_pre + (available_post < CAPTURE_POST_SAMPLES ? available_post : CAPTURE_POST_SAMPLES);
+  uint32_t first = trigger_sample - expected_pre;
+  int errors = 0;
+  if (info.trigger != expected_pre || info.total != expected_total || info.block_seq != alarm_block)
+  {
+    printf("transiente %lu: gatilho %lu/%lu amostras (bloco %lu), esperado %lu/%lu (bloco %lu)\n",
+           (unsigned long)transient, (unsigned long)info.trigger, (unsigned long)info.total,
+           (unsigned long)info.block_seq, (unsigned long)expected_pre, (unsigned long)expected_total,
+           (unsigned long)alarm_block);
+    errors++;
+  }
+  uint32_t mismatches = 0, peak_at = UINT32_MAX;
+  for (uint32_t i = 0; i < info.total && i < expected_total; i++)
+  {
+    uint16_t v = capture_sample(&capture, i);
+    mismatches += v != signal[first + i];
+    if (v == CAPTURE_TOOL_PEAK && peak_at == UINT32_MAX)
+      peak_at = i;
+  }
+  uint32_t expected_peak = transient - first;
+  errors += mismatches != 0 || peak_at != expected_peak;
+  printf("transiente na amostra %lu: captura %lu com %lu amostras, gatilho em %lu, transiente em %lu (esperado %lu), "
+         "%lu amostras diferentes: %s\n",
+         (unsigned long)transient, (unsigned long)info.number, (unsigned long)info.total, (unsigned long)info.trigger,
+         (unsigned long)peak_at, (unsigned long)expected_peak, (unsigned long)mismatches, errors ? "ERRO" : "ok");
+  capture_release(&capture);
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  capture_init(&capture);
+  int errors = 0;
+  if (argc > 1)
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      uint32_t t = (uint32_t)strtoul(argv[i], NULL, 0);
+      if (t >= sizeof(signal) / sizeof(signal[0]))
+      {
+        fprintf(stderr, "%s: amostra %lu fora do sinal\n", argv[0], (unsigned long)t);
+        return 2;
+      }
+      errors += run_case(t, CAPTURE_TOOL_BLOCKS);
+    }
+  }
+  else
+  {
+    // Meio do sinal em posições par e ímpar, início de bloco, pré-gatilho curto,
+    // janela posterior cortada pela parada e um alarme a mais com a captura congelada
+    errors += run_case(20000, CAPTURE_TOOL_BLOCKS);
+    errors += run_case(20001, CAPTURE_TOOL_BLOCKS);
+    errors += run_case(12800, CAPTURE_TOOL_BLOCKS);
+    errors += run_case(1000, CAPTURE_TOOL_BLOCKS);
+    errors += run_case(30000, 30000 / ACQ_BLOCK_SAMPLES + 3);
+
+    make_signal(20000);
+    signal[30000] = CAPTURE_TOOL_PEAK;
+    capture_restart(&capture);
+    uint32_t alarms = 0, dropped_before = capture.dropped_triggers;
+    for (uint32_t b = 0; b < CAPTURE_TOOL_BLOCKS; b++)
+    {
+      capture_push(&capture, &signal[b * ACQ_BLOCK_SAMPLES], ACQ_BLOCK_SAMPLES);
+      if (block_alarms(&signal[b * ACQ_BLOCK_SAMPLES]))
+      {
+        alarms++;
+        capture_trigger(&capture, ACQ_BLOCK_SAMPLES, b);
+      }
+    }
+    capture_info_t info;
+    bool kept = capture_get_info(&capture, &info) && info.block_seq == 20000 / ACQ_BLOCK_SAMPLES &&
+                capture.dropped_triggers - dropped_before == alarms - 1;
+    printf("segundo alarme com a captura congelada: %s\n", kept ? "ignorado, primeira captura mantida (ok)" : "ERRO");
+    errors += !kept;
+    capture_release(&capture);
+  }
+
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
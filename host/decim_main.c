@@ -0,0 +1,187 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "decimator.h"
+#include "decimator_coeffs.h"
+
+// Passa tons sintéticos pelo decimador do microfone (lib/decimator.c), na taxa
+// crua do round robin e em trechos do tamanho dos do DMA, e mede o ganho de
+// cada tom na frequência em que ele aparece depois da decimação:
+//  - na banda passante (até 3,2 kHz, de 50 em 50 Hz), entre
+//    DECIM_TOOL_PASS_MIN_X100 e DECIM_TOOL_PASS_MAX_X100;
+//  - acima de 4,8 kHz, o que dobra sobre a banda passante fica atenuado em
+//    DECIM_TOOL_ALIAS_DB ou mais;
+//  - a SNR de um tom de 1 kHz com ruído gaussiano (o ruído do próprio ADC)
+//    sobreamostrado e decimado ganha sobre a amostragem direta a 8 kHz ao
+//    menos os bits efetivos de noise_cases.
+// Sai com 1 se algo não bate.
+//
+// Uso: detector_decim
+
+#define DECIM_FS_OUT DECIMATOR_COEFFS_RATE
+#define DECIM_FS_RAW (DECIM_FS_OUT * DECIMATOR_RATIO)
+#define DECIM_CHUNK (64 * DECIMATOR_RATIO) // Quadros crus por interrupção no RP2040
+#define DECIM_OUTPUTS DECIM_FS_OUT         // 1 s de saída: tons em Hz inteiros têm ciclos inteiros
+#define DECIM_SETTLE 64                    // Saídas descartadas enquanto o CIC e o FIR enchem
+#define DECIM_AMPLITUDE 1000.0             // Amplitude dos tons em códigos do ADC
+#define DECIM_TOOL_PASS_MIN_X100 -15       // -0,15 dB
+#define DECIM_TOOL_PASS_MAX_X100 5         // +0,05 dB
+#define DECIM_TOOL_ALIAS_DB 47.0
+
+// Ruído na entrada (códigos RMS) e ganho mínimo em centésimos de bit
+static const struct
+{
+  double noise_rms;
+  int min_gain_x100;
+} noise_cases[] = {{2.0, 150}, {0.5, 70}};
+
+static uint16_t raw[(DECIM_OUTPUTS + DECIM_SETTLE) * DECIMATOR_RATIO];
+static uint16_t out[DECIM_OUTPUTS + DECIM_SETTLE];
+static uint32_t rng_state = 2463534242u;
+
+static double gaussian(void)
+{
+  // Box-Muller sobre um xorshift32
+  double u[2];
+  for (int i = 0; i < 2; i++)
+  {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    u[i] = (rng_state + 0.5) / 4294967296.0;
+  }
+  return sqrt(-2.0 * log(u[0])) * cos(2.0 * M_PI * u[1]);
+}
+
+// Converte um tom com ruído em códigos de 12 bits, como o ADC, a fs Hz
+static void synthesize(uint16_t *dst, size_t count, double freq, double fs, double noise_rms)
+{
+  for (size_t n = 0; n < count; n++)
+  {
+    double v = 2048.0 + DECIM_AMPLITUDE * sin(2.0 * M_PI * freq * n / fs) + noise_rms * gaussian();
+    long code = lround(v);
+    dst[n] = (uint16_t)(code < 0 ? 0 : code > 4095 ? 4095 : code);
+  }
+}
+
+static void decimate(void)
+{
+  decimator_t d;
+  decimator_init(&d);
+  size_t produced = 0;
+  for (size_t i = 0; i < sizeof(raw) / sizeof(raw[0]); i += DECIM_CHUNK)
+    produced += decimator_process(&d, &raw[i], DECIM_CHUNK, 1, &out[produced]);
+}
+
+// Amplitude do componente em freq e resíduo RMS depois de tirá-lo (e a média)
+static double fit_tone(const uint16_t *x, size_t count, double freq, double fs, double *residual_rms)
+{
+  double mean = 0, re = 0, im = 0;
+  for (size_t n = 0; n < count; n++)
+    mean += x[n];
+  mean /= count;
+  for (size_t n = 0; n < count; n++)
+  {
+    double w = 2.0 * M_PI * freq * n / fs;
+    re += (x[n] - mean) * cos(w);
+    im += (x[n] - mean) * sin(w);
+  }
+  re *= 2.0 / count;
+  im *= 2.0 / count;
+  if (residual_rms)
+  {
+    double sum = 0;
+    for (size_t n = 0; n < count; n++)
+    {
+      double w = 2.0 * M_PI * freq * n / fs;
+      double e = x[n] - mean - re * cos(w) - im * sin(w);
+      sum += e * e;
+    }
+    *residual_rms = sqrt(sum / count);
+  }
+  return sqrt(re * re + im * im);
+}
+
+static double snr_db(double amplitude, double residual_rms)
+{
+  return 20.0 * log10(amplitude / sqrt(2.0) / residual_rms);
+}
+
+// Ganho em dB de um tom em f, medido na frequência dobrada
+static double tone_gain(double f)
+{
+  double folded = fmod(f, DECIM_FS_OUT);
+  if (folded > DECIM_FS_OUT / 2)
+    folded = DECIM_FS_OUT - folded;
+  synthesize(raw, sizeof(raw) / sizeof(raw[0]), f, DECIM_FS_RAW, 0.0);
+  decimate();
+  double a = fit_tone(&out[DECIM_SETTLE], DECIM_OUTPUTS, folded, DECIM_FS_OUT, NULL);
+  return 20.0 * log10(fmax(a, 1e-3) / DECIM_AMPLITUDE);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    fprintf(stderr, "uso: %s\n", argv[0]);
+    return 2;
+  }
+  int errors = 0;
+
+  // Banda passante até a borda, sem ruído
+  double pass_min = 1e9, pass_max = -1e9;
+  for (int f = 50; f <= DECIM_FS_OUT * 4 / 10; f += 50)
+  {
+    double gain = tone_gain(f);
+    pass_min = fmin(pass_min, gain);
+    pass_max = fmax(pass_max, gain);
+  }
+  bool ok = pass_min >= DECIM_TOOL_PASS_MIN_X100 / 100.0 && pass_max <= DECIM_TOOL_PASS_MAX_X100 / 100.0;
+  printf("Banda passante 50 a %d Hz: %+.2f a %+.2f dB: %s\n", DECIM_FS_OUT * 4 / 10, pass_min, pass_max,
+         ok ? "ok" : "ERRO");
+  errors += !ok;
+
+  // Dobras sobre a banda passante: centenas ímpares de Hz nunca caem em 0 ou em fs/2 depois da dobra
+  double alias_max = -1e9, alias_worst_f = 0;
+  for (int f = DECIM_FS_OUT - DECIM_FS_OUT * 4 / 10 + 100; f < DECIM_FS_RAW / 2; f += 200)
+  {
+    int folded = f % DECIM_FS_OUT;
+    if (folded > DECIM_FS_OUT / 2)
+      folded = DECIM_FS_OUT - folded;
+    if (folded > DECIM_FS_OUT * 4 / 10)
+      continue;
+    double gain = tone_gain(f);
+    if (gain > alias_max)
+    {
+      alias_max = gain;
+      alias_worst_f = f;
+    }
+  }
+  ok = alias_max <= -DECIM_TOOL_ALIAS_DB;
+  printf("Dobras de %d a %d Hz sobre a banda passante: pior %.1f dB (em %.0f Hz): %s\n",
+         DECIM_FS_OUT - DECIM_FS_OUT * 4 / 10, DECIM_FS_RAW / 2, alias_max, alias_worst_f, ok ? "ok" : "ERRO");
+  errors += !ok;
+
+  // Tom de 1 kHz com ruído: amostragem direta na taxa de saída contra decimação
+  for (size_t i = 0; i < sizeof(noise_cases) / sizeof(noise_cases[0]); i++)
+  {
+    double noise_rms = noise_cases[i].noise_rms, residual;
+    synthesize(out, DECIM_OUTPUTS, 1000.0, DECIM_FS_OUT, noise_rms);
+    double amplitude = fit_tone(out, DECIM_OUTPUTS, 1000.0, DECIM_FS_OUT, &residual);
+    double direct = snr_db(amplitude, residual);
+    synthesize(raw, sizeof(raw) / sizeof(raw[0]), 1000.0, DECIM_FS_RAW, noise_rms);
+    decimate();
+    amplitude = fit_tone(&out[DECIM_SETTLE], DECIM_OUTPUTS, 1000.0, DECIM_FS_OUT, &residual);
+    double decim = snr_db(amplitude, residual);
+    double gain_bits = (decim - direct) / 6.02;
+    ok = gain_bits * 100.0 >= noise_cases[i].min_gain_x100;
+    printf("1 kHz com ruido de %.2f codigos: direto %.1f dB (%.2f bits), decimado %.1f dB (%.2f bits), "
+           "ganho %+.2f bits: %s\n", noise_rms, direct, (direct - 1.76) / 6.02, decim, (decim - 1.76) / 6.02,
+           gain_bits, ok ? "ok" : "ERRO");
+    errors += !ok;
+  }
+
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
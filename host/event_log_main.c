@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include "event_log.h"
+#include "nvm_host.h"
+
+// Quedas de energia em todas as posições de byte de uma gravação do registro
+// de eventos (lib/event_log.c), no emulador da flash (host/nvm_host.c):
+//  - na gravação de uma página que reprograma registros anteriores e na da
+//    página que abre um setor (cabeçalho e registros): depois do
+//    event_log_init, voltam os registros anteriores intactos e os novos que
+//    estavam completos antes do byte cortado, em ordem e com o conteúdo
+//    gravado; o registro (ou cabeçalho) pela metade conta em torn;
+//  - no apagamento do setor mais antigo durante o rodízio: o histórico dos
+//    outros três setores volta inteiro, só um cabeçalho pela metade conta em
+//    torn, e o apagamento é refeito no próximo serviço ocioso.
+// Depois de cada queda, um registro novo tem de sair com o seq seguinte ao
+// maior recuperado, sem reaproveitar o slot interrompido, e o histórico tem
+// de continuar em ordem crescente de seq pelo rodízio dos setores. Sai com 1
+// se algo não bate.
+//
+// Uso: detector_event_log
+
+#define EVENT_LOG_TOOL_PER_SECTOR (EVENT_LOG_SLOTS_PER_SECTOR - 1)
+#define EVENT_LOG_TOOL_MAX (EVENT_LOG_SECTORS * EVENT_LOG_TOOL_PER_SECTOR)
+
+static int errors;
+
+// Conteúdo derivado do seq, para conferir o que volta da flash
+static event_record_t make_record(uint32_t seq)
+{
+  event_record_t r = {0};
+  r.type = EVENT_OUT_OF_RANGE;
+  r.time_ms = seq * 1000 + 7;
+  r.duration_ms = seq * 3;
+  r.level = (uint16_t)(seq * 5);
+  r.peak = (uint16_t)(seq * 5 + 1);
+  r.leq = (uint16_t)seq;
+  r.threshold_min = 100;
+  r.threshold_max = 1800;
+  return r;
+}
+
+// Acrescenta count registros, gravando a cada fila cheia; devolve o próximo seq
+static uint32_t append(uint32_t seq, uint32_t count, bool flush)
+{
+  for (uint32_t i = 0; i < count; i++, seq++)
+  {
+    event_record_t r = make_record(seq);
+    event_log_append(&r);
+    if (flush && (i + 1) % EVENT_LOG_QUEUE == 0)
+      event_log_flush();
+  }
+  if (flush)
+    event_log_flush();
+  return seq;
+}
+
+// Registros em ordem, do mais antigo ao mais novo: seqs consecutivos de first
+// em diante e conteúdo de make_record. Devolve a quantidade (-1 se algo não bate)
+static int read_back(uint32_t first)
+{
+  event_log_iter_t it;
+  event_record_t r;
+  int count = 0;
+  event_log_iter_begin(&it);
+  while (event_log_iter_next(&it, &r))
+  {
+    event_record_t expected = make_record(first + count);
+    if (r.seq != first + count || r.type != expected.type || r.time_ms != expected.time_ms ||
+        r.duration_ms != expected.duration_ms || r.level != expected.level || r.peak != expected.peak ||
+        r.leq != expected.leq || r.threshold_min != expected.threshold_min ||
+        r.threshold_max != expected.threshold_max)
+      return -1;
+    count++;
+  }
+  return count;
+}
+
+// Reinicia depois da queda e acrescenta um registro: tem de sair com o seq
+// seguinte e em ordem depois dos recuperados
+static bool append_after_recovery(uint32_t first, int recovered)
+{
+  event_log_service(0, true); // Apagamento pendente, se houver
+  append(first + recovered, 1, true);
+  event_log_init();
+  event_log_stats_t stats;
+  event_log_get_stats(&stats);
+  return read_back(first) == recovered + 1 && stats.records == (uint32_t)recovered + 1;
+}
+
+typedef struct
+{
+  const char *name;
+  uint32_t before; // Registros já gravados
+  uint32_t start;  // Byte da página em que começam os dados novos (cabeçalho incluído)
+  uint32_t data;   // Byte da página em que começa o primeiro registro novo
+} page_case_t;
+
+static const page_case_t page_cases[] = {
+    {"pagina com registros anteriores", 10, 3 * EVENT_LOG_RECORD_BYTES, 3 * EVENT_LOG_RECORD_BYTES},
+    {"pagina que abre um setor", EVENT_LOG_TOOL_PER_SECTOR, 0, EVENT_LOG_RECORD_BYTES},
+};
+
+// Três registros novos numa página; a energia cai no byte cut da gravação
+static void check_page(const page_case_t *c)
+{
+  uint32_t bad = 0, torn_cuts = 0;
+  for (uint32_t cut = 0; cut < EVENT_LOG_PAGE_BYTES; cut++)
+  {
+    nvm_host_reset();
+    event_log_init();
+    uint32_t seq = append(0, c->before, true);
+    append(seq, 3, false);
+    nvm_host_power_cut(cut, NULL);
+    event_log_flush();
+    nvm_host_power_on();
+
+    event_log_init();
+    event_log_stats_t stats;
+    event_log_get_stats(&stats);
+    int recovered = read_back(0);
+    uint32_t complete = cut < c->data ? 0 : (cut - c->data) / EVENT_LOG_RECORD_BYTES;
+    complete = complete > 3 ? 3 : complete;
+    uint32_t new_records = recovered < 0 ? 0 : (uint32_t)recovered - c->before;
+    // O byte cortado fica pela metade: se cair dentro dos dados novos, o registro (ou
+    // cabeçalho) dele não volta e conta em torn. No último byte de um registro a
+    // metade gravada pode já ser o valor final, e aí o registro volta inteiro
+    bool in_data = cut >= c->start && cut < c->data + 3 * EVENT_LOG_RECORD_BYTES;
+    bool last_byte =
+        cut >= c->data && in_data && (cut - c->data) % EVENT_LOG_RECORD_BYTES == EVENT_LOG_RECORD_BYTES - 1;
+    bool whole = last_byte && new_records == complete + 1 && stats.torn == 0;
+    bool expected = whole || (new_records == complete && stats.torn == (in_data ? 1u : 0u));
+    bool ok = recovered >= (int)c->before && expected && stats.records == (uint32_t)recovered &&
+              append_after_recovery(0, recovered);
+    torn_cuts += stats.torn;
+    if (!ok && !bad++)
+      printf("  corte no byte %lu: %d registros recuperados (esperado %lu), torn %lu\n", (unsigned long)cut,
+             recovered, (unsigned long)(c->before + complete), (unsigned long)stats.torn);
+  }
+  printf("%-34s %d cortes, %lu com dado pela metade, %lu fora do esperado: %s\n", c->name, EVENT_LOG_PAGE_BYTES,
+         (unsigned long)torn_cuts, (unsigned long)bad, bad ? "ERRO" : "ok");
+  errors += bad != 0;
+}
+
+// Com os quatro setores cheios, o registro seguinte abre o último e o mais
+// antigo é apagado; a energia cai no byte cut do apagamento
+static void check_erase(void)
+{
+  uint32_t bad = 0;
+  uint32_t filled = (EVENT_LOG_SECTORS - 1) * EVENT_LOG_TOOL_PER_SECTOR;
+  for (uint32_t cut = 0; cut < EVENT_LOG_SECTOR_BYTES; cut++)
+  {
+    nvm_host_reset();
+    event_log_init();
+    uint32_t seq = append(0, filled, true);
+    append(seq, 1, false);
+    nvm_host_power_cut(EVENT_LOG_PAGE_BYTES + cut, NULL); // Depois da página que abre o último setor
+    event_log_flush();
+    nvm_host_power_on();
+
+    event_log_init();
+    event_log_stats_t stats;
+    event_log_get_stats(&stats);
+    // O setor 0 sai do histórico; só um cabeçalho pela metade (não apagado) conta em torn
+    int recovered = read_back(EVENT_LOG_TOOL_PER_SECTOR);
+    bool ok = recovered == (int)(filled + 1 - EVENT_LOG_TOOL_PER_SECTOR) &&
+              stats.torn == (cut < EVENT_LOG_RECORD_BYTES ? 1u : 0u) && nvm_host_erase_count(0) == 1 &&
+              append_after_recovery(EVENT_LOG_TOOL_PER_SECTOR, recovered) && nvm_host_erase_count(0) == 2;
+
+    // Rodízio: completa o último setor e volta ao 0, que sai apagado; o 1 é o próximo a sair
+    uint32_t next = EVENT_LOG_TOOL_PER_SECTOR + (uint32_t)recovered + 1;
+    append(next, EVENT_LOG_TOOL_MAX - next + 1, true);
+    event_log_init();
+    int after = read_back(2 * EVENT_LOG_TOOL_PER_SECTOR);
+    ok = ok && after == (int)(EVENT_LOG_TOOL_MAX + 1 - 2 * EVENT_LOG_TOOL_PER_SECTOR) &&
+         nvm_host_erase_count(1) == 1 && nvm_host_erase_count(2) == 0;
+    if (!ok && !bad++)
+      printf("  corte no byte %lu: %d registros recuperados, torn %lu, %d depois do rodizio\n", (unsigned long)cut,
+             recovered, (unsigned long)stats.torn, after);
+  }
+  printf("%-34s %d cortes, %lu fora do esperado: %s\n", "apagamento no rodizio", EVENT_LOG_SECTOR_BYTES,
+         (unsigned long)bad, bad ? "ERRO" : "ok");
+  errors += bad != 0;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    fprintf(stderr, "uso: %s\n", argv[0]);
+    return 2;
+  }
+  for (size_t i = 0; i < sizeof(page_cases) / sizeof(page_cases[0]); i++)
+    check_page(&page_cases[i]);
+  check_erase();
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,297 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "acquisition.h"
+#include "acquisition_replay.h"
+#include "noise_floor.h"
+#include "noise_level.h"
+#include "weighting.h"
+
+// Aprendizado do ruído de fundo no modo adaptativo (lib/noise_floor.c). Com
+// uma gravação, reproduz pelo mesmo caminho do núcleo 1 (remoção de DC,
+// ponderação A e Fast) e imprime em CSV a evolução do nível, do fundo
+// aprendido e do range resultante, para ajustar o estimador com gravações
+// reais. Um alerta congela o aprendizado como no firmware; aqui ele é
+// reconhecido sozinho quando o nível volta ao range.
+//
+// Sem arquivo, confere o mesmo laço sobre um traço sintético do RMS por bloco
+// (fundo com flutuação de ±FLOOR_TOOL_JITTER_X10, rajadas curtas, queda do
+// fundo, um degrau sustentado e uma rampa lenta):
+//  - depois do aprendizado inicial e de cada mudança do fundo, o piso fica a
+//    até FLOOR_TOOL_TOL_X10 do L90 exato dos últimos segundos do traço;
+//  - o range é o piso mais a margem de cima e menos a de baixo (até um
+//    código de arredondamento);
+//  - cada rajada e o degrau disparam exatamente um alerta, a queda do fundo
+//    nenhum, e o piso fica congelado durante o alerta do degrau;
+//  - a rampa dispara um alerta antes de subir FLOOR_TOOL_RAMP_MAX_X10 (o piso
+//    não a absorve) e termina em alerta.
+// Sai com 1 se algo não bate.
+//
+// Uso: detector_floor [audio.wav|.raw [margem_acima_db] [margem_abaixo_db] [passo_s]]
+
+#define FLOOR_MARGIN_HIGH_X10 100 // Mesmas margens de DetectorRuido.c
+#define FLOOR_MARGIN_LOW_X10 200
+#define FLOOR_TOOL_RATE 8000
+#define FLOOR_TOOL_JITTER_X10 30 // Flutuação do fundo bloco a bloco (pico)
+#define FLOOR_TOOL_TOL_X10 15    // Piso contra o L90 exato
+#define FLOOR_TOOL_L90_S 10      // Janela do L90 exato
+#define FLOOR_TOOL_RAMP_MAX_X10 150 // Subida da rampa até o primeiro alerta
+#define FLOOR_TOOL_END_S 240
+
+typedef struct
+{
+  noise_floor_t floor;
+  int16_t margin_high, margin_low;
+  uint16_t min, max; // Range atual (0, 0 durante o aprendizado inicial)
+  bool alerted;
+  uint32_t alerts, alert_blocks;
+} tracker_t;
+
+static int16_t mic_block[ACQ_BLOCK_SAMPLES];
+static int errors;
+
+static void tracker_init(tracker_t *t, uint32_t blocks_per_second, int16_t margin_high, int16_t margin_low)
+{
+  noise_floor_init(&t->floor, blocks_per_second);
+  t->margin_high = margin_high;
+  t->margin_low = margin_low;
+  t->min = t->max = 0;
+  t->alerted = false;
+  t->alerts = t->alert_blocks = 0;
+}
+
+// Um bloco, como na tarefa do núcleo 1
+static void tracker_update(tracker_t *t, uint16_t rms)
+{
+  if (!t->alerted)
+    noise_floor_update(&t->floor, rms);
+  if (!noise_floor_ready(&t->floor))
+    return;
+  t->min = noise_floor_threshold(&t->floor, (int16_t)-t->margin_low);
+  t->max = noise_floor_threshold(&t->floor, t->margin_high);
+  bool outside = rms < t->min || rms > t->max;
+  if (outside && !t->alerted)
+    t->alerts++;
+  t->alerted = outside;
+  t->alert_blocks += t->alerted;
+}
+
+static int run_file(const char *path, int16_t margin_high, int16_t margin_low, double report_s)
+{
+  if (!acq_replay_open(path))
+  {
+    fprintf(stderr, "nao foi possivel abrir %s\n", path);
+    return 1;
+  }
+
+  uint32_t rate = acq_replay_sample_rate();
+  if (rate == 0)
+    rate = FLOOR_TOOL_RATE; // Binário cru: a taxa do firmware
+  uint32_t report_blocks = (uint32_t)(report_s * rate / ACQ_BLOCK_SAMPLES);
+  if (report_blocks == 0)
+    report_blocks = 1;
+
+  dc_blocker_t dc;
+  weighting_filter_t weighting;
+  time_weighting_t time_weighting;
+  tracker_t t;
+  dc_blocker_init(&dc);
+  weighting_filter_init(&weighting, WEIGHTING_A, rate);
+  time_weighting_init(&time_weighting, TIME_WEIGHTING_FAST, rate);
+  tracker_init(&t, rate / ACQ_BLOCK_SAMPLES, margin_high, margin_low);
+  acq_init(rate);
+  acq_start();
+
+  printf("tempo_s,nivel_dbfs,fundo_dbfs,min,max,alerta\n");
+  uint32_t blocks = 0;
+  while (!acq_replay_eof())
+  {
+    acq_replay_pump(1);
+    acq_block_t block;
+    while (acq_get_block(&block))
+    {
+      dc_blocker_process(&dc, block.samples, mic_block, block.len);
+      acq_release_block(&block);
+      weighting_filter_process(&weighting, mic_block, block.len);
+      time_weighting_process(&time_weighting, mic_block, block.len);
+      uint16_t rms = time_weighting_rms(&time_weighting);
+      tracker_update(&t, rms);
+
+      if (++blocks % report_blocks == 0)
+      {
+        int16_t level = rms ? level_dbfs_x10((uint64_t)rms * rms) : NOISE_FLOOR_MIN_DBFS_X10;
+        if (noise_floor_ready(&t.floor))
+          printf("%.2f,%.1f,%.1f,%u,%u,%d\n", (double)blocks * ACQ_BLOCK_SAMPLES / rate, level / 10.0,
+                 noise_floor_dbfs_x10(&t.floor) / 10.0, t.min, t.max, t.alerted);
+        else
+          printf("%.2f,%.1f,,,,0\n", (double)blocks * ACQ_BLOCK_SAMPLES / rate, level / 10.0);
+      }
+    }
+  }
+  acq_replay_close();
+
+  fprintf(stderr, "%lu blocos, %lu alertas, %.1f s em alerta, fundo final %.1f dBFS\n", (unsigned long)blocks,
+          (unsigned long)t.alerts, (double)t.alert_blocks * ACQ_BLOCK_SAMPLES / rate,
+          noise_floor_dbfs_x10(&t.floor) / 10.0);
+  return 0;
+}
+
+// Traço sintético: nível de fundo em décimos de dBFS a cada instante, e se há rajada
+static int16_t background_x10(double s)
+{
+  if (s < 90)
+    return -300;
+  if (s < 150 || (s >= 170 && s < 180))
+    return -420;
+  if (s < 170)
+    return -250; // Degrau sustentado
+  if (s < 220)
+    return (int16_t)(-420 + (s - 180) * 5); // Rampa de 0,5 dB/s
+  return -220;
+}
+
+static bool burst(double s)
+{
+  return s >= 6 && s < 90 && fmod(s, 6.0) < 0.5; // Meio segundo, 15 dB acima, a cada 6 s
+}
+
+static uint16_t rms_of(int16_t level_x10)
+{
+  return (uint16_t)lround(2048.0 * pow(10.0, level_x10 / 200.0));
+}
+
+static int compare_levels(const void *a, const void *b)
+{
+  return (int)*(const int16_t *)a - (int)*(const int16_t *)b;
+}
+
+// L90 exato (o nível superado em 90% do tempo) dos últimos FLOOR_TOOL_L90_S segundos
+static int16_t exact_l90(const int16_t *levels, uint32_t end, uint32_t blocks_per_second)
+{
+  static int16_t window[FLOOR_TOOL_L90_S * FLOOR_TOOL_RATE / ACQ_BLOCK_SAMPLES];
+  uint32_t n = FLOOR_TOOL_L90_S * blocks_per_second;
+  for (uint32_t i = 0; i < n; i++)
+    window[i] = levels[end - n + i];
+  qsort(window, n, sizeof(window[0]), compare_levels);
+  return window[n / 10];
+}
+
+static void check(const char *what, bool ok)
+{
+  printf("%-56s %s\n", what, ok ? "ok" : "ERRO");
+  errors += !ok;
+}
+
+// O range tem de ser o piso deslocado pelas margens, a menos do arredondamento
+static bool range_matches(const tracker_t *t)
+{
+  int16_t floor_x10 = noise_floor_dbfs_x10(&t->floor);
+  return abs(t->max - rms_of((int16_t)(floor_x10 + t->margin_high))) <= 1 &&
+         abs(t->min - rms_of((int16_t)(floor_x10 - t->margin_low))) <= 1;
+}
+
+static void run_synthetic(void)
+{
+  static int16_t levels[FLOOR_TOOL_END_S * FLOOR_TOOL_RATE / ACQ_BLOCK_SAMPLES];
+  uint32_t blocks_per_second = FLOOR_TOOL_RATE / ACQ_BLOCK_SAMPLES;
+  double block_s = (double)ACQ_BLOCK_SAMPLES / FLOOR_TOOL_RATE;
+  uint32_t total = (uint32_t)(FLOOR_TOOL_END_S / block_s);
+  tracker_t t;
+  tracker_init(&t, blocks_per_second, FLOOR_MARGIN_HIGH_X10, FLOOR_MARGIN_LOW_X10);
+
+  // Instantes conferidos: o fundo já aprendido, antes de cada mudança
+  static const struct
+  {
+    double s;
+    const char *name;
+  } settled[] = {{60.0, "piso no fundo inicial"}, {89.0, "piso com as rajadas"}, {149.0, "piso depois da queda"}};
+  size_t next_settled = 0;
+
+  uint32_t seed = 1, bursts = 0, step_alerts = 0, ramp_alerts = 0, quiet_alerts = 0;
+  double first_ramp_alert_s = 0;
+  int16_t floor_at_step = 0;
+  bool floor_frozen = true, cleared_after_step = false, range_ok = true;
+  for (uint32_t b = 0; b < total; b++)
+  {
+    double s = b * block_s;
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    int16_t jitter = (int16_t)((int32_t)(seed % (2 * FLOOR_TOOL_JITTER_X10 + 1)) - FLOOR_TOOL_JITTER_X10);
+    int16_t level = (int16_t)(background_x10(s) + jitter + (burst(s) ? 150 : 0));
+    uint16_t rms = rms_of(level);
+    levels[b] = rms ? level_dbfs_x10((uint64_t)rms * rms) : NOISE_FLOOR_MIN_DBFS_X10;
+
+    uint32_t alerts = t.alerts;
+    if (s >= 150 && s - 150 < block_s)
+      floor_at_step = noise_floor_dbfs_x10(&t.floor);
+    tracker_update(&t, rms);
+    if (noise_floor_ready(&t.floor))
+      range_ok = range_ok && range_matches(&t);
+
+    // Quem disparou cada alerta novo
+    if (t.alerts != alerts)
+    {
+      if (burst(s))
+        bursts++;
+      else if (s >= 150 && s < 151)
+        step_alerts++;
+      else if (s >= 180 && s < 220)
+        first_ramp_alert_s = ramp_alerts++ ? first_ramp_alert_s : s;
+      else
+        quiet_alerts++;
+    }
+    if (s >= 150 && s < 170 && t.alerted && noise_floor_dbfs_x10(&t.floor) != floor_at_step)
+      floor_frozen = false;
+    if (s >= 170 && s < 171 && !t.alerted)
+      cleared_after_step = true;
+
+    if (next_settled < sizeof(settled) / sizeof(settled[0]) && s >= settled[next_settled].s)
+    {
+      int16_t l90 = exact_l90(levels, b + 1, blocks_per_second);
+      int16_t floor_x10 = noise_floor_dbfs_x10(&t.floor);
+      char what[96];
+      snprintf(what, sizeof(what), "%s: %.1f dBFS (L90 exato %.1f)", settled[next_settled].name, floor_x10 / 10.0,
+               l90 / 10.0);
+      check(what, abs(floor_x10 - l90) <= FLOOR_TOOL_TOL_X10);
+      next_settled++;
+    }
+  }
+
+  // Rajadas depois do aprendizado inicial; as do aprendizado só entram no fundo
+  uint32_t expected_bursts = 0;
+  for (double s = 6; s < 90; s += 6)
+    expected_bursts += s >= NOISE_FLOOR_WARMUP_S;
+  char what[96];
+  snprintf(what, sizeof(what), "range = piso +%d/-%d dB", FLOOR_MARGIN_HIGH_X10 / 10, FLOOR_MARGIN_LOW_X10 / 10);
+  check(what, range_ok);
+  snprintf(what, sizeof(what), "um alerta por rajada: %lu de %lu", (unsigned long)bursts,
+           (unsigned long)expected_bursts);
+  check(what, bursts == expected_bursts);
+  snprintf(what, sizeof(what), "nenhum alerta na queda do fundo: %lu", (unsigned long)quiet_alerts);
+  check(what, quiet_alerts == 0);
+  check("degrau: um alerta, piso congelado, reconhecido ao voltar",
+        step_alerts == 1 && floor_frozen && cleared_after_step);
+  // O piso sobe devagar: a rampa chega à margem de cima antes de ele andar muito
+  double ramp_rise = (first_ramp_alert_s - 180) * 0.5;
+  snprintf(what, sizeof(what), "rampa de 0,5 dB/s: alerta com %.1f dB de subida", ramp_rise);
+  check(what, ramp_alerts > 0 && ramp_rise <= FLOOR_TOOL_RAMP_MAX_X10 / 10.0 && t.alerted);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 5)
+  {
+    fprintf(stderr, "uso: %s [audio.wav|.raw [margem_acima_db] [margem_abaixo_db] [passo_s]]\n", argv[0]);
+    return 2;
+  }
+  if (argc > 1)
+  {
+    int16_t margin_high = argc > 2 ? (int16_t)(atof(argv[2]) * 10) : FLOOR_MARGIN_HIGH_X10;
+    int16_t margin_low = argc > 3 ? (int16_t)(atof(argv[3]) * 10) : FLOOR_MARGIN_LOW_X10;
+    return run_file(argv[1], margin_high, margin_low, argc > 4 ? atof(argv[4]) : 1.0);
+  }
+  run_synthetic();
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
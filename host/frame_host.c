@@ -0,0 +1,12 @@
+#include "frame.h"
+#include "usb_link.h"
+
+void frame_backend_write(const uint8_t *data, size_t len)
+{
+  usb_link_write(data, len);
+}
+
+size_t frame_backend_space(void)
+{
+  return usb_link_space();
+}
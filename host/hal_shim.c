@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+#include "pico/stdlib.h"
+#include "pico/bootrom.h"
+#include "pico/multicore.h"
+#include "pico/stdio_usb.h"
+#include "hardware/adc.h"
+#include "hardware/sync.h"
+#include "hardware/i2c.h"
+#include "hal_shim.h"
+#include "usb_link.h"
+#include "virtual_clock.h"
+
+#define HAL_GPIO_COUNT 30
+#define HAL_ADC_INPUTS 5
+#define CORE1_STACK_BYTES (256 * 1024)
+
+i2c_inst_t i2c0_inst = {0};
+i2c_inst_t i2c1_inst = {1};
+
+static gpio_irq_callback_t gpio_callback;
+static uint32_t gpio_irq_mask[HAL_GPIO_COUNT];
+static uint16_t adc_values[HAL_ADC_INPUTS] = {2048, 2048, 2048, 2048, 2048}; // Joystick centrado
+static uint adc_input;
+static void (*reset_handler)(void);
+
+// Núcleo 1 como corrotina: roda até esperar (WFE) ou girar num laço (SPIN)
+typedef enum
+{
+  CORE1_OFF,
+  CORE1_RUNNING,
+  CORE1_WFE,
+  CORE1_SPIN
+} core1_state_t;
+
+static ucontext_t core0_context, core1_context;
+static void (*core1_entry)(void);
+static core1_state_t core1_state = CORE1_OFF;
+static bool core1_event; // Registrador de evento do __wfe/__sev
+static bool on_core1;
+
+static void core1_trampoline(void)
+{
+  core1_entry();
+  fprintf(stderr, "hal_shim: o núcleo 1 retornou\n");
+  exit(1);
+}
+
+static void core1_yield(core1_state_t state)
+{
+  core1_state = state;
+  on_core1 = false;
+  swapcontext(&core1_context, &core0_context);
+  on_core1 = true;
+}
+
+void hal_shim_run_core1(void)
+{
+  if (on_core1 || core1_state == CORE1_OFF)
+    return;
+  if (core1_state == CORE1_WFE)
+  {
+    if (!core1_event)
+      return;
+    core1_event = false;
+  }
+  core1_state = CORE1_RUNNING;
+  on_core1 = true;
+  swapcontext(&core0_context, &core1_context);
+  on_core1 = false;
+}
+
+void hal_shim_core1_irq(void)
+{
+  core1_event = true; // O núcleo 1 anda no próximo hal_shim_run_core1()
+}
+
+void multicore_launch_core1(void (*entry)(void))
+{
+  core1_entry = entry;
+  getcontext(&core1_context);
+  core1_context.uc_stack.ss_sp = malloc(CORE1_STACK_BYTES);
+  core1_context.uc_stack.ss_size = CORE1_STACK_BYTES;
+  core1_context.uc_link = NULL;
+  makecontext(&core1_context, core1_trampoline, 0);
+  vclock_set_after_alarm_hook(hal_shim_run_core1);
+  core1_state = CORE1_SPIN;
+  hal_shim_run_core1();
+}
+
+void multicore_lockout_victim_init(void)
+{
+}
+
+void __sev(void)
+{
+  core1_event = true;
+  hal_shim_run_core1();
+}
+
+void __wfe(void)
+{
+  if (!on_core1)
+    return; // O núcleo 0 nunca dorme: o tempo dele é o relógio virtual
+  if (core1_event)
+  {
+    core1_event = false;
+    return;
+  }
+  core1_yield(CORE1_WFE);
+}
+
+void tight_loop_contents(void)
+{
+  if (on_core1)
+    core1_yield(CORE1_SPIN);
+  else
+    hal_shim_run_core1();
+}
+
+void stdio_init_all(void)
+{
+}
+
+bool stdio_usb_connected(void)
+{
+  return true; // A saída do simulador sempre tem quem leia (stdout ou o pty de host/usb_link.c)
+}
+
+int getchar_timeout_us(uint32_t timeout_us)
+{
+  (void)timeout_us;
+  int c = usb_link_getchar();
+  return c < 0 ? PICO_ERROR_TIMEOUT : c;
+}
+
+uint32_t time_us_32(void)
+{
+  return (uint32_t)vclock_now_us();
+}
+
+uint64_t time_us_64(void)
+{
+  return vclock_now_us();
+}
+
+absolute_time_t get_absolute_time(void)
+{
+  return vclock_now_us();
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t)
+{
+  return (uint32_t)(t / 1000);
+}
+
+void sleep_ms(uint32_t ms)
+{
+  vclock_advance_us((uint64_t)ms * 1000);
+}
+
+void sleep_us(uint64_t us)
+{
+  vclock_advance_us(us);
+}
+
+void gpio_init(uint gpio)
+{
+  (void)gpio;
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+  (void)gpio;
+  (void)out;
+}
+
+void gpio_pull_up(uint gpio)
+{
+  (void)gpio;
+}
+
+bool gpio_get(uint gpio)
+{
+  (void)gpio;
+  return true; // Entradas em pull-up e soltas: os toques do roteiro são só bordas
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+  (void)gpio;
+  (void)fn;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback)
+{
+  if (gpio >= HAL_GPIO_COUNT)
+    return;
+  if (enabled)
+    gpio_irq_mask[gpio] |= event_mask;
+  else
+    gpio_irq_mask[gpio] &= ~event_mask;
+  gpio_callback = callback; // Um callback por núcleo, como no SDK
+}
+
+void hal_shim_gpio_edge(unsigned int gpio, uint32_t event_mask)
+{
+  if (gpio < HAL_GPIO_COUNT && gpio_callback && (gpio_irq_mask[gpio] & event_mask))
+    gpio_callback(gpio, gpio_irq_mask[gpio] & event_mask);
+}
+
+void adc_init(void)
+{
+}
+
+void adc_gpio_init(uint gpio)
+{
+  (void)gpio;
+}
+
+void adc_select_input(uint input)
+{
+  adc_input = input < HAL_ADC_INPUTS ? input : 0;
+}
+
+uint16_t adc_read(void)
+{
+  return adc_values[adc_input];
+}
+
+void hal_shim_set_adc(unsigned int input, uint16_t value)
+{
+  if (input < HAL_ADC_INPUTS)
+    adc_values[input] = value & 0x0FFF;
+}
+
+uint16_t hal_shim_get_adc(unsigned int input)
+{
+  return input < HAL_ADC_INPUTS ? adc_values[input] : 0;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate)
+{
+  (void)i2c;
+  return baudrate;
+}
+
+void hal_shim_set_reset_handler(void (*handler)(void))
+{
+  reset_handler = handler;
+}
+
+void reset_usb_boot(uint32_t usb_activity_gpio_pin_mask, uint32_t disable_interface_mask)
+{
+  (void)usb_activity_gpio_pin_mask;
+  (void)disable_interface_mask;
+  if (reset_handler)
+    reset_handler();
+  exit(0);
+}
@@ -0,0 +1,18 @@
+#ifndef HAL_SHIM_H
+#define HAL_SHIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Camada que substitui o SDK do Pico no host (cabeçalhos em host/pico e
+// host/hardware). Estas funções são o lado "de fora": o simulador as usa
+// para mexer nas entradas da placa e nas interrupções.
+
+void hal_shim_set_adc(unsigned int input, uint16_t value);          // Valor devolvido por adc_read()
+uint16_t hal_shim_get_adc(unsigned int input);                       // Tensão atual da entrada (aquisição simulada)
+void hal_shim_gpio_edge(unsigned int gpio, uint32_t event_mask);     // Chama o callback de IRQ do GPIO
+void hal_shim_core1_irq(void);                                       // IRQ no núcleo 1: acorda o __wfe()
+void hal_shim_run_core1(void);                                       // Dá a vez ao núcleo 1, se ele puder andar
+void hal_shim_set_reset_handler(void (*handler)(void));              // Chamado por reset_usb_boot()
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef HOST_HARDWARE_ADC_H
+#define HOST_HARDWARE_ADC_H
+
+#include "pico/types.h"
+
+// Leituras avulsas do ADC (joystick); os valores vêm de hal_shim_set_adc().
+// O microfone é lido pela aquisição, substituída por host/acquisition_replay.c
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+uint16_t adc_read(void);
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef HOST_HARDWARE_CLOCKS_H
+#define HOST_HARDWARE_CLOCKS_H
+
+#include "pico/types.h"
+
+// Nada a configurar no host: o relógio do sistema é o de host/virtual_clock.h
+
+#endif
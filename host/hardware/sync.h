@@ -0,0 +1,9 @@
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include "pico/types.h"
+
+void __sev(void);
+void __wfe(void); // No núcleo 1 simulado devolve a vez até o próximo evento
+
+#endif
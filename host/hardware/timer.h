@@ -0,0 +1,9 @@
+#ifndef HOST_HARDWARE_TIMER_H
+#define HOST_HARDWARE_TIMER_H
+
+#include "pico/types.h"
+
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+
+#endif
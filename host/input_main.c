@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "input.h"
+
+// Passa um roteiro de entradas por lib/input.c no mesmo ritmo de task_input
+// e imprime em CSV os eventos gerados, para conferir debounce, histerese e a
+// aceleração da repetição sem a placa. Com um CSV esperado (linhas com # são
+// comentários), compara evento a evento em vez de imprimir e sai com 1 se
+// algo não bate; host/input_script.txt e host/input_expected.csv cobrem
+// toque curto, trepidação, botão mantido, repetição e histerese.
+//
+// Uso: detector_input roteiro.txt [esperado.csv]
+//
+// O roteiro usa o formato do detector_sim, "<ms> <ação> [valor]" em ordem de tempo:
+//   a | b | joy [ms]  borda de toque no botão; com ms, o botão fica pressionado tanto tempo
+//   x <0..4095>       posiciona o eixo X do joystick; y idem
+//   quit              encerra (sem ele, termina 1 s depois da última ação)
+
+#define INPUT_TOOL_PERIOD_MS 10 // INPUT_PERIOD_MS de DetectorRuido.c
+#define INPUT_TOOL_TAIL_MS 1000
+
+typedef struct
+{
+  uint32_t t_ms;
+  char action[8];
+  unsigned int value;
+  int fields;
+} script_line_t;
+
+static const char *const key_names[INPUT_KEYS] = {"a", "b", "joy", "esquerda", "direita", "cima", "baixo"};
+
+static FILE *expected; // CSV esperado (NULL: imprime)
+static unsigned long expected_line, mismatches;
+
+// Próxima linha útil do CSV esperado, sem o fim de linha (vazia no fim do arquivo)
+static const char *next_expected(void)
+{
+  static char line[128];
+  while (fgets(line, sizeof(line), expected))
+  {
+    expected_line++;
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] != '\0' && line[0] != '#')
+      return line;
+  }
+  return "";
+}
+
+static void output(const char *line)
+{
+  if (!expected)
+  {
+    puts(line);
+    return;
+  }
+  const char *want = next_expected();
+  if (strcmp(line, want) != 0 && mismatches++ < 10)
+    printf("linha %lu: obtido \"%s\", esperado \"%s\": ERRO\n", expected_line, line, want);
+}
+
+static int button_key(const char *name)
+{
+  for (int k = 0; k < INPUT_BUTTONS; k++)
+    if (strcmp(name, key_names[k]) == 0)
+      return k;
+  return -1;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2 || argc > 3)
+  {
+    fprintf(stderr, "uso: %s roteiro.txt [esperado.csv]\n", argv[0]);
+    return 2;
+  }
+  FILE *f = fopen(argv[1], "r");
+  if (!f)
+  {
+    fprintf(stderr, "%s: nao foi possivel abrir %s\n", argv[0], argv[1]);
+    return 1;
+  }
+
+  script_line_t *script = NULL;
+  size_t len = 0, capacity = 0;
+  char line[128];
+  unsigned int line_no = 0;
+  while (fgets(line, sizeof(line), f))
+  {
+    line_no++;
+    if (line[strspn(line, " \t\r\n")] == '\0' || line[strspn(line, " \t")] == '#')
+      continue;
+    script_line_t sl = {0};
+    unsigned long t_ms;
+    sl.fields = sscanf(line, "%lu %7s %u", &t_ms, sl.action, &sl.value);
+    sl.t_ms = (uint32_t)t_ms;
+    bool valid = sl.fields >= 2 && (button_key(sl.action) >= 0 || strcmp(sl.action, "quit") == 0 ||
+                                    (sl.fields == 3 && (strcmp(sl.action, "x") == 0 || strcmp(sl.action, "y") == 0)));
+    if (!valid || (len && sl.t_ms < script[len - 1].t_ms))
+    {
+      fprintf(stderr, "%s:%u: %s\n", argv[1], line_no, valid ? "tempo fora de ordem" : "ação inválida");
+      fclose(f);
+      return 1;
+    }
+    if (len == capacity)
+    {
+      capacity = capacity ? 2 * capacity : 64;
+      script = realloc(script, capacity * sizeof(*script));
+    }
+    script[len++] = sl;
+  }
+  fclose(f);
+  if (argc == 3 && !(expected = fopen(argv[2], "r")))
+  {
+    fprintf(stderr, "%s: nao foi possivel abrir %s\n", argv[0], argv[2]);
+    return 1;
+  }
+
+  input_t in;
+  input_init(&in);
+  uint16_t joy[2] = {2048, 2048};
+  uint32_t held_until[INPUT_BUTTONS] = {0};
+  uint32_t end_ms = (len ? script[len - 1].t_ms : 0) + INPUT_TOOL_TAIL_MS;
+  size_t next = 0;
+  unsigned long events = 0;
+
+  char text[64];
+  output("tempo_ms,tecla,tipo,repeticao");
+  for (uint32_t now = 0; now <= end_ms; now += INPUT_TOOL_PERIOD_MS)
+  {
+    // Ações até este instante, como se tivessem chegado entre dois polls
+    while (next < len && script[next].t_ms <= now)
+    {
+      const script_line_t *sl = &script[next++];
+      int key = button_key(sl->action);
+      if (key >= 0)
+      {
+        input_button_edge(&in, (input_key_t)key);
+        if (sl->fields == 3)
+          held_until[key] = sl->t_ms + sl->value;
+      }
+      else if (strcmp(sl->action, "x") == 0 || strcmp(sl->action, "y") == 0)
+      {
+        joy[sl->action[0] == 'y'] = (uint16_t)(sl->value > 4095 ? 4095 : sl->value);
+      }
+      else
+      {
+        end_ms = now;
+      }
+    }
+
+    uint32_t buttons = 0;
+    for (int k = 0; k < INPUT_BUTTONS; k++)
+      if (now < held_until[k])
+        buttons |= 1u << k;
+    input_poll(&in, now, buttons, joy);
+
+    input_event_t ev;
+    while (input_get_event(&in, &ev))
+    {
+      events++;
+      snprintf(text, sizeof(text), "%lu,%s,%s,%u", (unsigned long)ev.time_ms, key_names[ev.key],
+               ev.type == INPUT_PRESS ? "toque" : "repeticao", ev.repeat);
+      output(text);
+    }
+  }
+  free(script);
+
+  fprintf(stderr, "%lu eventos, %lu descartados com a fila cheia\n", events, (unsigned long)input_dropped(&in));
+  if (!expected)
+    return 0;
+  const char *extra = next_expected();
+  if (extra[0] != '\0')
+  {
+    printf("linha %lu: esperado \"%s\", nenhum evento: ERRO\n", expected_line, extra);
+    mismatches++;
+  }
+  fclose(expected);
+  bool ok = mismatches == 0 && input_dropped(&in) == 0;
+  printf("%lu eventos conferidos com %s: %s\n", events, argv[2], ok ? "ok" : "ERRO");
+  printf("%s\n", ok ? "ok" : "FALHOU");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,7 @@
+#include "instr.h"
+#include "virtual_clock.h"
+
+uint32_t instr_backend_now_us(void)
+{
+  return (uint32_t)vclock_now_us();
+}
@@ -0,0 +1,48 @@
+#include <string.h>
+#include "led_matrix.h"
+#include "led_matrix_host.h"
+
+static uint32_t words_pushed;
+static uint32_t last_frame[LED_MATRIX_PIXELS];
+static void (*frame_hook)(const uint32_t *frame);
+
+void led_matrix_host_reset(void)
+{
+  words_pushed = 0;
+  memset(last_frame, 0, sizeof(last_frame));
+}
+
+uint32_t led_matrix_host_words(void)
+{
+  return words_pushed;
+}
+
+const uint32_t *led_matrix_host_frame(void)
+{
+  return last_frame;
+}
+
+void led_matrix_host_set_frame_hook(void (*hook)(const uint32_t *frame))
+{
+  frame_hook = hook;
+}
+
+void led_matrix_backend_init(unsigned int pin)
+{
+  (void)pin;
+}
+
+void led_matrix_backend_send(const uint32_t *words, size_t len)
+{
+  if (len > LED_MATRIX_PIXELS)
+    len = LED_MATRIX_PIXELS;
+  memcpy(last_frame, words, len * sizeof(uint32_t));
+  words_pushed += (uint32_t)len;
+  if (frame_hook)
+    frame_hook(last_frame);
+}
+
+bool led_matrix_backend_busy(void)
+{
+  return false;
+}
@@ -0,0 +1,14 @@
+#ifndef LED_MATRIX_HOST_H
+#define LED_MATRIX_HOST_H
+
+#include <stdint.h>
+
+// Backend da matriz de LEDs para o host: conta as palavras que iriam para a
+// PIO e guarda o último quadro, sem temporização (nunca fica ocupado).
+
+void led_matrix_host_reset(void);
+uint32_t led_matrix_host_words(void);
+const uint32_t *led_matrix_host_frame(void); // LED_MATRIX_PIXELS palavras GRB << 8
+void led_matrix_host_set_frame_hook(void (*hook)(const uint32_t *frame)); // Chamado a cada quadro enviado
+
+#endif
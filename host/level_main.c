@@ -0,0 +1,206 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "acquisition.h"
+#include "acquisition_replay.h"
+#include "noise_level.h"
+
+// Confere o motor de nível (lib/noise_level.c) contra valores analíticos.
+// Grava fixtures WAV e .raw com sinais conhecidos (silêncio, senos de 1 kHz
+// em vários níveis, um seno com o DC do microfone deslocado e metade de
+// silêncio) e os reproduz pela mesma aquisição simulada e pela remoção de DC
+// do núcleo 1; no fim, compara o RMS da janela e o Leq em códigos do ADC
+// (até LEVEL_TOOL_RMS_TOL códigos) e em dBFS (até LEVEL_TOOL_DB_TOL_X10) com
+// o esperado. Confere também level_isqrt64 contra a raiz exata e
+// level_dbfs_x10 contra 10·log10 em toda a faixa. O custo por amostra no
+// RP2040 sai do caso level_block do detector_bench. Sai com 1 se algo não bate.
+//
+// Uso: detector_level [dir_fixtures]
+
+#define LEVEL_TOOL_RATE 8000
+#define LEVEL_TOOL_SECONDS 2
+#define LEVEL_TOOL_SAMPLES (LEVEL_TOOL_RATE * LEVEL_TOOL_SECONDS)
+#define LEVEL_TOOL_RMS_TOL 1     // Códigos (a raiz é truncada e o seno é quantizado)
+#define LEVEL_TOOL_DB_TOL_X10 1  // 0,1 dB
+
+typedef struct
+{
+  const char *name;
+  bool raw;           // Códigos crus do ADC em vez de WAV
+  double amplitude;   // Pico do seno de 1 kHz em códigos (0: silêncio)
+  double offset;      // Deslocamento do DC em códigos (só nos crus)
+  bool half_silence;  // A segunda metade é silêncio (o Leq cai 3 dB, o RMS final é 0)
+} fixture_t;
+
+static const fixture_t fixtures[] = {
+    {"silencio.wav", false, 0.0, 0.0, false},
+    {"seno_1k_-3dbfs.wav", false, 2047.0, 0.0, false},
+    {"seno_1k_-20dbfs.wav", false, 2048.0 * M_SQRT2 * 0.1, 0.0, false},
+    {"seno_1k_-40dbfs.wav", false, 2048.0 * M_SQRT2 * 0.01, 0.0, false},
+    {"seno_1k_dc_deslocado.raw", true, 1000.0, -350.0, false},
+    {"seno_1k_meio_silencio.wav", false, 1000.0, 0.0, true},
+};
+
+static uint16_t codes[LEVEL_TOOL_SAMPLES];
+static int16_t mic_block[ACQ_BLOCK_SAMPLES];
+static int errors;
+
+static void put_le(FILE *f, uint32_t v, int bytes)
+{
+  for (int i = 0; i < bytes; i++)
+    fputc((int)((v >> (8 * i)) & 0xFF), f);
+}
+
+// Códigos do ADC de uma fixture; o WAV leva cada código como (código - 2048)·16,
+// que acquisition_replay.c converte de volta sem perda
+static bool write_fixture(const fixture_t *fx, const char *path)
+{
+  for (uint32_t n = 0; n < LEVEL_TOOL_SAMPLES; n++)
+  {
+    bool silent = fx->half_silence && n >= LEVEL_TOOL_SAMPLES / 2;
+    double v = 2048.0 + fx->offset + (silent ? 0.0 : fx->amplitude * sin(2.0 * M_PI * 1000.0 * n / LEVEL_TOOL_RATE));
+    long code = lround(v);
+    codes[n] = (uint16_t)(code < 0 ? 0 : code > 4095 ? 4095 : code);
+  }
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  if (!fx->raw)
+  {
+    fwrite("RIFF", 1, 4, f);
+    put_le(f, 36 + LEVEL_TOOL_SAMPLES * 2, 4);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put_le(f, 16, 4);
+    put_le(f, 1, 2);
+    put_le(f, 1, 2);
+    put_le(f, LEVEL_TOOL_RATE, 4);
+    put_le(f, LEVEL_TOOL_RATE * 2, 4);
+    put_le(f, 2, 2);
+    put_le(f, 16, 2);
+    fwrite("data", 1, 4, f);
+    put_le(f, LEVEL_TOOL_SAMPLES * 2, 4);
+  }
+  for (uint32_t n = 0; n < LEVEL_TOOL_SAMPLES; n++)
+    put_le(f, fx->raw ? codes[n] : (uint32_t)(uint16_t)(int16_t)((codes[n] - 2048) * 16), 2);
+  return fclose(f) == 0;
+}
+
+// RMS esperado dos códigos gravados sem o DC: o da janela final (os últimos
+// LEVEL_WINDOW_BLOCKS blocos inteiros) e o de todos os blocos (Leq)
+static void expected_levels(const fixture_t *fx, double *rms, double *leq)
+{
+  uint32_t blocks = LEVEL_TOOL_SAMPLES / ACQ_BLOCK_SAMPLES;
+  double center = 2048.0 + fx->offset;
+  double all = 0, window = 0;
+  for (uint32_t n = 0; n < blocks * ACQ_BLOCK_SAMPLES; n++)
+  {
+    double e = (codes[n] - center) * (codes[n] - center);
+    all += e;
+    if (n >= (blocks - LEVEL_WINDOW_BLOCKS) * ACQ_BLOCK_SAMPLES)
+      window += e;
+  }
+  *rms = sqrt(window / (LEVEL_WINDOW_BLOCKS * ACQ_BLOCK_SAMPLES));
+  *leq = sqrt(all / (blocks * ACQ_BLOCK_SAMPLES));
+}
+
+static int16_t expected_dbfs_x10(double rms)
+{
+  return rms > 0 ? (int16_t)lround(200.0 * log10(rms / 2048.0)) : INT16_MIN;
+}
+
+static void check_fixture(const fixture_t *fx, const char *dir)
+{
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s", dir, fx->name);
+  if (!write_fixture(fx, path) || !acq_replay_open(path))
+  {
+    printf("%s: nao foi possivel gravar a fixture\n", fx->name);
+    errors++;
+    return;
+  }
+  dc_blocker_t dc;
+  noise_level_t level;
+  dc_blocker_init(&dc);
+  noise_level_init(&level);
+  acq_init(LEVEL_TOOL_RATE);
+  acq_start();
+  while (acq_replay_pump(1))
+  {
+    acq_block_t block;
+    while (acq_get_block(&block))
+    {
+      dc_blocker_process(&dc, block.samples, mic_block, block.len);
+      acq_release_block(&block);
+      noise_level_process(&level, mic_block, block.len);
+    }
+  }
+  acq_stop();
+  acq_replay_close();
+
+  double rms, leq;
+  expected_levels(fx, &rms, &leq);
+  int16_t leq_db = noise_level_leq_dbfs_x10(&level);
+  int16_t leq_db_expected = expected_dbfs_x10(leq);
+  bool ok = fabs(noise_level_rms(&level) - rms) <= LEVEL_TOOL_RMS_TOL &&
+            fabs(noise_level_leq(&level) - leq) <= LEVEL_TOOL_RMS_TOL &&
+            (leq_db == INT16_MIN ? leq_db_expected == INT16_MIN : abs(leq_db - leq_db_expected) <= LEVEL_TOOL_DB_TOL_X10);
+  printf("%-26s RMS %u (esperado %.1f), Leq %u (esperado %.1f), Leq %d (esperado %d) decimos de dBFS: %s\n", fx->name,
+         noise_level_rms(&level), rms, noise_level_leq(&level), leq, leq_db, leq_db_expected, ok ? "ok" : "ERRO");
+  errors += !ok;
+}
+
+static void check_isqrt(void)
+{
+  int bad = 0;
+  uint64_t x = 1;
+  for (int i = 0; i < 200000; i++)
+  {
+    // Quadrados perfeitos, vizinhos e valores espalhados por toda a faixa de 64 bits
+    uint64_t values[3] = {x, (uint64_t)i * i, (uint64_t)i * i - 1};
+    for (int k = 0; k < 3; k++)
+    {
+      uint64_t r = level_isqrt64(values[k]);
+      if (r * r > values[k] || (r < 0xFFFFFFFFu && (r + 1) * (r + 1) <= values[k]))
+        bad++;
+    }
+    x = x * 6364136223846793005ull + 1442695040888963407ull;
+    x >>= (unsigned)(i % 64);
+  }
+  bad += level_isqrt64(UINT64_MAX) != 0xFFFFFFFFu || level_isqrt64(0) != 0;
+  printf("level_isqrt64: %d erros em 600002 valores: %s\n", bad, bad ? "ERRO" : "ok");
+  errors += bad != 0;
+}
+
+static void check_dbfs(void)
+{
+  // Quadrado médio de 1 código² a 4 vezes o fundo de escala, em passos de ~0,01 dB
+  int worst = 0;
+  for (double ms = 1.0; ms < 4.0 * 2048.0 * 2048.0; ms *= 1.0023)
+  {
+    uint64_t v = (uint64_t)ms;
+    int expected = (int)lround(100.0 * log10((double)v / (2048.0 * 2048.0)));
+    int error = abs(level_dbfs_x10(v) - expected);
+    if (error > worst)
+      worst = error;
+  }
+  bool ok = worst <= LEVEL_TOOL_DB_TOL_X10 && level_dbfs_x10(0) == INT16_MIN &&
+            level_dbfs_x10(2048ull * 2048ull) == 0;
+  printf("level_dbfs_x10: maior erro %d decimo(s) de dB de -72 a +6 dBFS: %s\n", worst, ok ? "ok" : "ERRO");
+  errors += !ok;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 2)
+  {
+    fprintf(stderr, "uso: %s [dir_fixtures]\n", argv[0]);
+    return 2;
+  }
+  const char *dir = argc == 2 ? argv[1] : ".";
+  for (size_t i = 0; i < sizeof(fixtures) / sizeof(fixtures[0]); i++)
+    check_fixture(&fixtures[i], dir);
+  check_isqrt();
+  check_dbfs();
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
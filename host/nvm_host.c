@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nvm.h"
+#include "nvm_host.h"
+
+static uint8_t flash[NVM_REGION_BYTES];
+static bool initialized;
+static const char *image_path;
+static bool powered = true;
+static bool cut_armed;
+static uint32_t cut_budget;
+static void (*cut_handler)(void);
+static uint32_t erase_counts[NVM_REGION_BYTES / NVM_SECTOR_BYTES];
+
+static void ensure_init(void)
+{
+  if (!initialized)
+  {
+    memset(flash, 0xFF, sizeof(flash));
+    initialized = true;
+  }
+}
+
+static void save_image(void)
+{
+  if (!image_path)
+    return;
+  FILE *f = fopen(image_path, "wb");
+  if (!f)
+    return;
+  fwrite(flash, 1, sizeof(flash), f);
+  fclose(f);
+}
+
+bool nvm_host_open(const char *path)
+{
+  ensure_init();
+  image_path = path;
+  FILE *f = fopen(path, "rb");
+  if (!f)
+  {
+    save_image(); // Primeira execução: começa com a flash apagada
+    return true;
+  }
+  size_t n = fread(flash, 1, sizeof(flash), f);
+  fclose(f);
+  if (n != sizeof(flash))
+  {
+    fprintf(stderr, "%s: imagem com %zu bytes, esperados %d\n", path, n, NVM_REGION_BYTES);
+    return false;
+  }
+  return true;
+}
+
+void nvm_host_reset(void)
+{
+  memset(flash, 0xFF, sizeof(flash));
+  memset(erase_counts, 0, sizeof(erase_counts));
+  initialized = true;
+  image_path = NULL;
+  powered = true;
+  cut_armed = false;
+}
+
+void nvm_host_power_cut(uint32_t after_bytes, void (*handler)(void))
+{
+  cut_armed = true;
+  cut_budget = after_bytes;
+  cut_handler = handler;
+}
+
+void nvm_host_power_on(void)
+{
+  powered = true;
+  cut_armed = false;
+}
+
+uint32_t nvm_host_erase_count(int sector)
+{
+  return sector >= 0 && sector < NVM_REGION_BYTES / NVM_SECTOR_BYTES ? erase_counts[sector] : 0;
+}
+
+// Aplica a operação byte a byte, na ordem do chip, até a energia acabar
+static void apply(uint32_t offset, const uint8_t *data, size_t len, bool erase)
+{
+  ensure_init();
+  if (!powered)
+    return;
+  for (size_t i = 0; i < len; i++)
+  {
+    uint8_t *cell = &flash[offset + i];
+    uint8_t target = erase ? 0xFF : (uint8_t)(*cell & data[i]);
+    if (cut_armed && cut_budget-- == 0)
+    {
+      // Célula pela metade: só parte dos bits chegou ao valor novo
+      *cell = erase ? (uint8_t)(*cell | 0x0F) : (uint8_t)(*cell & (target | 0x0F));
+      powered = false;
+      save_image();
+      if (cut_handler)
+        cut_handler();
+      return;
+    }
+    *cell = target;
+  }
+  save_image();
+}
+
+const uint8_t *nvm_backend_region(void)
+{
+  ensure_init();
+  return flash;
+}
+
+void nvm_backend_erase(uint32_t offset)
+{
+  if (offset % NVM_SECTOR_BYTES || offset >= NVM_REGION_BYTES)
+  {
+    fprintf(stderr, "nvm: apagamento desalinhado em 0x%lx\n", (unsigned long)offset);
+    abort();
+  }
+  if (powered)
+    erase_counts[offset / NVM_SECTOR_BYTES]++;
+  apply(offset, NULL, NVM_SECTOR_BYTES, true);
+}
+
+void nvm_backend_program(uint32_t offset, const uint8_t *page)
+{
+  if (offset % NVM_PAGE_BYTES || offset >= NVM_REGION_BYTES)
+  {
+    fprintf(stderr, "nvm: gravação desalinhada em 0x%lx\n", (unsigned long)offset);
+    abort();
+  }
+  apply(offset, page, NVM_PAGE_BYTES, false);
+}
@@ -0,0 +1,24 @@
+#ifndef NVM_HOST_H
+#define NVM_HOST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Emulador da flash NOR da região de lib/nvm.h no host: apagar põe o setor
+// em 0xFF e gravar só leva bits de 1 para 0, como no chip real. A imagem pode
+// ser persistida em arquivo para os dados sobreviverem entre execuções do
+// simulador, e uma queda de energia pode ser provocada no meio de uma
+// gravação para testar a recuperação.
+
+bool nvm_host_open(const char *path); // Carrega a imagem (se existir) e salva após cada operação
+void nvm_host_reset(void);            // Flash apagada, sem arquivo e com energia
+
+// Depois de mais after_bytes bytes gravados ou apagados a energia cai no meio
+// da operação: o byte em curso fica pela metade, o handler é chamado e as
+// operações seguintes são ignoradas até nvm_host_power_on()
+void nvm_host_power_cut(uint32_t after_bytes, void (*handler)(void));
+void nvm_host_power_on(void);
+
+uint32_t nvm_host_erase_count(int sector); // Apagamentos do setor da região (desgaste)
+
+#endif
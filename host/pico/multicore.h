@@ -0,0 +1,14 @@
+#ifndef HOST_PICO_MULTICORE_H
+#define HOST_PICO_MULTICORE_H
+
+#include "pico/types.h"
+
+// O núcleo 1 roda como corrotina do núcleo 0 (host/hal_shim.c): ganha a vez
+// no __sev(), depois de cada alarme do relógio virtual e quando o núcleo 0
+// espera em tight_loop_contents()
+void multicore_launch_core1(void (*entry)(void));
+
+// A corrotina nunca roda junto com o núcleo 0, então o lockout não tem o que fazer
+void multicore_lockout_victim_init(void);
+
+#endif
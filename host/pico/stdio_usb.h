@@ -0,0 +1,9 @@
+#ifndef HOST_PICO_STDIO_USB_H
+#define HOST_PICO_STDIO_USB_H
+
+#include "pico/types.h"
+
+// Terminal USB do firmware no host (implementação em host/hal_shim.c)
+bool stdio_usb_connected(void);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+#include "pico/types.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+// Subconjunto do pico/stdlib.h usado pelo firmware compilado no host; as
+// funções ficam em host/hal_shim.c e andam no relógio de host/virtual_clock.h
+
+#define PICO_ERROR_TIMEOUT (-1)
+
+void stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us); // Lê do link de host/usb_link.h, sem esperar
+
+// No núcleo 1 simulado devolve a vez ao núcleo 0; no núcleo 0 deixa o núcleo 1 andar
+void tight_loop_contents(void);
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef HOST_PICO_TIME_H
+#define HOST_PICO_TIME_H
+
+#include "pico/types.h"
+#include "hardware/timer.h"
+
+absolute_time_t get_absolute_time(void);
+uint32_t to_ms_since_boot(absolute_time_t t);
+void sleep_ms(uint32_t ms); // Avança o relógio virtual, disparando os alarmes no caminho
+void sleep_us(uint64_t us);
+
+#endif
@@ -0,0 +1,51 @@
+#include "scheduler.h"
+#include "scheduler_host.h"
+#include "virtual_clock.h"
+
+static int tick_alarm = -1;
+static volatile bool tick_pending;
+
+void sched_host_reset(uint32_t start_us)
+{
+  vclock_reset(start_us);
+  tick_alarm = -1;
+  tick_pending = false;
+}
+
+uint32_t sched_host_now_us(void)
+{
+  return (uint32_t)vclock_now_us();
+}
+
+void sched_host_consume_us(uint32_t us)
+{
+  vclock_advance_us(us);
+}
+
+static uint64_t tick_callback(void *user)
+{
+  // Ticks perdidos enquanto as tarefas rodavam colapsam em um só, como a flag do firmware
+  tick_pending = true;
+  return (uint64_t)(uintptr_t)user;
+}
+
+uint32_t sched_backend_now_us(void)
+{
+  return (uint32_t)vclock_now_us();
+}
+
+void sched_backend_start(uint32_t tick_us)
+{
+  vclock_cancel_alarm(tick_alarm);
+  tick_pending = false;
+  tick_alarm = vclock_add_alarm(tick_us, tick_callback, (void *)(uintptr_t)tick_us);
+}
+
+void sched_backend_wait_tick(void)
+{
+  // Pula direto para o próximo alarme (tick, DMA, SOS...) em vez de esperar em tempo real
+  uint64_t next;
+  while (!tick_pending && vclock_next_deadline(&next))
+    vclock_advance_to(next);
+  tick_pending = false;
+}
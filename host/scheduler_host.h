@@ -0,0 +1,15 @@
+#ifndef SCHEDULER_HOST_H
+#define SCHEDULER_HOST_H
+
+#include <stdint.h>
+
+// Backend do escalonador para o host: o tick é um alarme do relógio virtual
+// (host/virtual_clock.h). Esperar o tick avança o relógio até ele, disparando
+// no caminho os demais alarmes; as tarefas simulam o seu custo com
+// sched_host_consume_us(). sched_host_reset() reinicia o relógio compartilhado.
+
+void sched_host_reset(uint32_t start_us);
+uint32_t sched_host_now_us(void);
+void sched_host_consume_us(uint32_t us);
+
+#endif
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include "scheduler.h"
+#include "scheduler_host.h"
+
+// Confere o escalonador (lib/scheduler.c) no relógio virtual
+// (host/scheduler_host.c), com o relógio de 32 bits dando a volta no meio:
+//  - tarefas de períodos diferentes, sem sobrecarga, uma delas com o período
+//    do tick: cada execução começa no máximo o custo das tarefas de maior
+//    prioridade depois da sua liberação (a primeira no primeiro tick), sem
+//    acumular deriva, e nenhum prazo é perdido;
+//  - uma execução mais longa que um período (e menor que dois): um prazo
+//    perdido e nenhuma liberação descartada;
+//  - uma execução mais longa que dois períodos: um prazo perdido e uma
+//    liberação descartada, em vez de a tarefa rodar duas vezes seguidas.
+// Em todos os casos as execuções mais as liberações descartadas cobrem todas
+// as liberações, e a tarefa volta à sua fase depois do atraso. Sai com 1 se
+// algo não bate.
+//
+// Uso: detector_scheduler
+
+#define SCHED_TOOL_TICK_US 1000
+#define SCHED_TOOL_START_US (UINT32_MAX - 50000) // O relógio de 32 bits dá a volta logo no início
+#define SCHED_TOOL_SPAN_US 200000
+#define SCHED_TOOL_MAX_TASKS 3
+#define SCHED_TOOL_MAX_RUNS 256
+
+typedef struct
+{
+  uint32_t period_us;
+  uint32_t cost_us;
+  uint32_t long_run; // Execução (a partir de 1) que custa long_cost_us; 0: nenhuma
+  uint32_t long_cost_us;
+} tool_task_t;
+
+typedef struct
+{
+  const char *name;
+  tool_task_t tasks[SCHED_TOOL_MAX_TASKS];
+  size_t count;
+  uint32_t misses, skipped; // Esperados em cada tarefa
+} sched_case_t;
+
+static const sched_case_t cases[] = {
+    {"tres periodos", {{1000, 100, 0, 0}, {5000, 300, 0, 0}, {20000, 50, 0, 0}}, 3, 0, 0},
+    {"estouro de um periodo", {{4000, 200, 6, 5000}}, 1, 1, 0},
+    {"estouro de dois periodos", {{4000, 200, 6, 10500}}, 1, 1, 1},
+};
+
+static const tool_task_t *current;
+static sched_task_t tasks[SCHED_TOOL_MAX_TASKS];
+static uint32_t starts[SCHED_TOOL_MAX_TASKS][SCHED_TOOL_MAX_RUNS];
+static uint32_t run_count[SCHED_TOOL_MAX_TASKS];
+static int errors;
+
+static void run_task(int i)
+{
+  if (run_count[i] < SCHED_TOOL_MAX_RUNS)
+    starts[i][run_count[i]] = sched_host_now_us();
+  run_count[i]++;
+  const tool_task_t *t = &current[i];
+  sched_host_consume_us(run_count[i] == t->long_run ? t->long_cost_us : t->cost_us);
+}
+
+static void task0(void)
+{
+  run_task(0);
+}
+
+static void task1(void)
+{
+  run_task(1);
+}
+
+static void task2(void)
+{
+  run_task(2);
+}
+
+static void (*const runs[SCHED_TOOL_MAX_TASKS])(void) = {task0, task1, task2};
+
+static void check_case(const sched_case_t *c)
+{
+  current = c->tasks;
+  for (size_t i = 0; i < c->count; i++)
+  {
+    tasks[i] = (sched_task_t){"tarefa", runs[i], c->tasks[i].period_us};
+    run_count[i] = 0;
+  }
+  sched_host_reset(SCHED_TOOL_START_US);
+  sched_init(tasks, c->count, SCHED_TOOL_TICK_US);
+  while (sched_host_now_us() - SCHED_TOOL_START_US < SCHED_TOOL_SPAN_US)
+    sched_run_pending();
+
+  uint32_t higher_cost = 0; // Custo das tarefas de maior prioridade, que podem rodar antes no mesmo tick
+  for (size_t i = 0; i < c->count; i++)
+  {
+    const tool_task_t *t = &c->tasks[i];
+    sched_task_t *s = &tasks[i];
+    uint32_t releases = (SCHED_TOOL_SPAN_US - SCHED_TOOL_TICK_US) / t->period_us + 1; // Até o último tick
+    bool ok = s->runs == run_count[i] && s->misses == c->misses && s->skipped == c->skipped &&
+              s->runs + s->skipped == releases;
+
+    // Sem atraso, a execução k começa perto da liberação k (é impresso o maior
+    // atraso); depois de um, só a fase da última execução é conferida
+    uint32_t worst = 0;
+    for (uint32_t k = 0; k < run_count[i] && k < SCHED_TOOL_MAX_RUNS; k++)
+    {
+      uint32_t offset = starts[i][k] - SCHED_TOOL_START_US - SCHED_TOOL_TICK_US;
+      if (c->misses)
+      {
+        if (k == run_count[i] - 1)
+        {
+          worst = offset % t->period_us;
+          ok = ok && worst <= higher_cost;
+        }
+        continue;
+      }
+      uint32_t delay = offset - k * t->period_us;
+      if ((int32_t)delay < 0 || delay > higher_cost)
+        ok = false;
+      worst = delay > worst ? delay : worst;
+    }
+    printf("%-26s periodo %5lu us: %3lu execucoes, %lu prazos perdidos (esperado %lu), %lu liberacoes descartadas "
+           "(esperado %lu), atraso %lu us: %s\n",
+           c->name, (unsigned long)t->period_us, (unsigned long)s->runs, (unsigned long)s->misses,
+           (unsigned long)c->misses, (unsigned long)s->skipped, (unsigned long)c->skipped, (unsigned long)worst,
+           ok ? "ok" : "ERRO");
+    errors += !ok;
+    higher_cost += t->cost_us;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    fprintf(stderr, "uso: %s\n", argv[0]);
+    return 2;
+  }
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    check_case(&cases[i]);
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
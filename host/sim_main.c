@@ -0,0 +1,356 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "acquisition.h"
+#include "acquisition_replay.h"
+#include "hal_shim.h"
+#include "led_matrix.h"
+#include "led_matrix_host.h"
+#include "ssd1306_host.h"
+#include "usb_link.h"
+#include "event_log.h"
+#include "nvm_host.h"
+#include "virtual_clock.h"
+#include "hardware/gpio.h"
+
+// Simulador do firmware completo no host: DetectorRuido.c é compilado com
+// main renomeado para detector_main e roda sobre host/hal_shim.c. O tempo é
+// o do relógio virtual, então a simulação anda bem mais rápido que o real.
+//
+// Uso: detector_sim [-a audio.wav|.raw] [-s roteiro.txt] [-f dir_quadros] [-l leds.txt] [-t segundos]
+//                    [-p link_usb] [-r fator] [-e flash.bin] [-c bytes]
+//
+// O roteiro tem uma ação por linha, "<ms> <ação> [valor]", em ordem de tempo:
+//   a | b | joy     pressiona o botão A, o B ou o do joystick
+//   x <0..4095>     posiciona o eixo X do joystick (ADC0); y idem para o ADC1
+//   quit            encerra a simulação
+// Linhas vazias e as iniciadas por '#' são ignoradas. O áudio começa a tocar
+// quando o firmware inicia a aquisição e a simulação termina um segundo depois
+// do fim do arquivo, no "quit", no botão B (BOOTSEL) ou no limite de -t.
+//
+// Com -p a saída USB do firmware vai para um pseudo-terminal, acessível pelo
+// link simbólico indicado, e as ferramentas de tools/ conectam nele como numa
+// placa real. -r prende o relógio virtual ao real (1 = tempo real, 2 = o dobro
+// da velocidade); sem ele o leitor do pty não acompanha e o firmware descarta
+// blocos do streaming, como faria com um host lento.
+//
+// -e guarda a região persistente da flash (lib/nvm.h: registro de eventos e
+// configurações) em um arquivo, que sobrevive entre execuções como a flash
+// entre boots. -c derruba a energia
+// depois de tantos bytes gravados ou apagados nesta execução: a simulação
+// termina no meio da operação e a próxima execução com o mesmo -e mostra a
+// recuperação.
+
+int detector_main(void);
+
+#define SIM_SAMPLE_RATE 8000 // SAMPLES_PER_SECOND do firmware
+#define SIM_BLOCK_US ((uint64_t)ACQ_BLOCK_SAMPLES * 1000000 / SIM_SAMPLE_RATE)
+#define SIM_TAIL_US 1000000  // Tempo simulado depois do fim do áudio
+#define SIM_LINK_POLL_US 1000 // Intervalo dos quadros USB full speed
+
+// Pinos de DetectorRuido.c
+#define SIM_BTN_A_PIN 5
+#define SIM_BTN_B_PIN 6
+#define SIM_BTN_JOY_PIN 22
+
+typedef enum
+{
+  SIM_PRESS,
+  SIM_ADC,
+  SIM_QUIT
+} sim_action_t;
+
+typedef struct
+{
+  uint64_t t_us;
+  sim_action_t action;
+  unsigned int arg;   // Pino do botão ou entrada do ADC
+  uint16_t value;     // Valor do ADC
+} sim_event_t;
+
+static sim_event_t *script;
+static size_t script_len, script_next;
+static const char *frames_dir;
+static FILE *leds_file;
+static uint32_t display_frames, led_frames;
+static struct timespec wall_start;
+static double pace_factor;
+
+static bool load_script(const char *path)
+{
+  FILE *f = fopen(path, "r");
+  if (!f)
+    return false;
+
+  char line[128];
+  unsigned int line_no = 0;
+  size_t capacity = 0;
+  while (fgets(line, sizeof(line), f))
+  {
+    line_no++;
+    char name[16];
+    unsigned long t_ms;
+    unsigned int value = 0;
+    int fields = sscanf(line, "%lu %15s %u", &t_ms, name, &value);
+    if (line[strspn(line, " \t\r\n")] == '\0' || line[strspn(line, " \t")] == '#')
+      continue;
+
+    sim_event_t ev = {(uint64_t)t_ms * 1000, SIM_PRESS, 0, 0};
+    if (fields >= 2 && strcmp(name, "a") == 0)
+      ev.arg = SIM_BTN_A_PIN;
+    else if (fields >= 2 && strcmp(name, "b") == 0)
+      ev.arg = SIM_BTN_B_PIN;
+    else if (fields >= 2 && strcmp(name, "joy") == 0)
+      ev.arg = SIM_BTN_JOY_PIN;
+    else if (fields == 3 && (strcmp(name, "x") == 0 || strcmp(name, "y") == 0))
+      ev = (sim_event_t){(uint64_t)t_ms * 1000, SIM_ADC, name[0] == 'x' ? 0 : 1, (uint16_t)value};
+    else if (fields >= 2 && strcmp(name, "quit") == 0)
+      ev.action = SIM_QUIT;
+    else
+    {
+      fprintf(stderr, "%s:%u: ação inválida\n", path, line_no);
+      fclose(f);
+      return false;
+    }
+    if (script_len && ev.t_us < script[script_len - 1].t_us)
+    {
+      fprintf(stderr, "%s:%u: tempo fora de ordem\n", path, line_no);
+      fclose(f);
+      return false;
+    }
+
+    if (script_len == capacity)
+    {
+      capacity = capacity ? 2 * capacity : 64;
+      script = realloc(script, capacity * sizeof(*script));
+    }
+    script[script_len++] = ev;
+  }
+  fclose(f);
+  return true;
+}
+
+static void sim_finish(void)
+{
+  struct timespec wall_end;
+  clock_gettime(CLOCK_MONOTONIC, &wall_end);
+  double wall_s = (double)(wall_end.tv_sec - wall_start.tv_sec) + (wall_end.tv_nsec - wall_start.tv_nsec) / 1e9;
+  double sim_s = (double)vclock_now_us() / 1e6;
+
+  acq_stats_t acq;
+  acq_get_stats(&acq);
+  led_matrix_stats_t leds;
+  led_matrix_get_stats(&leds);
+
+  fflush(stdout);
+  usb_link_poll();
+  fprintf(stderr, "Simulados %.3f s em %.3f s (%.0fx)\n", sim_s, wall_s, wall_s > 0 ? sim_s / wall_s : 0.0);
+  fprintf(stderr, "Audio: %lu blocos, %lu perdidos\n", (unsigned long)acq.blocks, (unsigned long)acq.overruns);
+  fprintf(stderr, "Display: %lu quadros, %lu bytes no I2C\n", (unsigned long)display_frames,
+          (unsigned long)ssd1306_host_bus_bytes());
+  fprintf(stderr, "LEDs: %lu quadros enviados, %lu repetidos omitidos\n", (unsigned long)leds.frames_sent,
+          (unsigned long)leds.frames_skipped);
+  event_log_stats_t log;
+  event_log_get_stats(&log);
+  fprintf(stderr, "Registro: %lu eventos na flash, %u na fila, %lu interrompidos, %lu páginas gravadas, %lu setores apagados\n",
+          (unsigned long)log.records, log.pending, (unsigned long)log.torn, (unsigned long)log.page_writes,
+          (unsigned long)log.erases);
+  if (leds_file)
+    fclose(leds_file);
+}
+
+static void power_cut(void)
+{
+  fprintf(stderr, "Queda de energia simulada durante uma operação na flash\n");
+  sim_finish();
+  exit(0);
+}
+
+static uint64_t quit_alarm(void *user)
+{
+  (void)user;
+  sim_finish();
+  exit(0);
+}
+
+// Interrupções de fim de bloco do DMA da aquisição (IRQ do núcleo 1)
+static uint64_t dma_alarm(void *user)
+{
+  (void)user;
+  if (acq_replay_pump(1))
+    hal_shim_core1_irq();
+  if (acq_replay_eof())
+  {
+    vclock_add_alarm(SIM_TAIL_US, quit_alarm, NULL);
+    return 0;
+  }
+  return SIM_BLOCK_US;
+}
+
+// Drena o FIFO da CDC e, com -r, espera o relógio real alcançar o virtual
+static uint64_t link_alarm(void *user)
+{
+  (void)user;
+  usb_link_poll();
+  if (pace_factor > 0)
+  {
+    double target_s = (double)vclock_now_us() / 1e6 / pace_factor;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double wall_s = (double)(now.tv_sec - wall_start.tv_sec) + (now.tv_nsec - wall_start.tv_nsec) / 1e9;
+    if (target_s > wall_s)
+      usleep((useconds_t)((target_s - wall_s) * 1e6));
+  }
+  return SIM_LINK_POLL_US;
+}
+
+static uint64_t script_alarm(void *user)
+{
+  (void)user;
+  uint64_t now = vclock_now_us();
+  while (script_next < script_len && script[script_next].t_us <= now)
+  {
+    const sim_event_t *ev = &script[script_next++];
+    if (ev->action == SIM_PRESS)
+      hal_shim_gpio_edge(ev->arg, GPIO_IRQ_EDGE_FALL);
+    else if (ev->action == SIM_ADC)
+      hal_shim_set_adc(ev->arg, ev->value);
+    else
+      quit_alarm(NULL);
+  }
+  return script_next < script_len ? script[script_next].t_us - now : 0;
+}
+
+// Quadro do display em PBM binário (P4), com os pixels acesos em preto
+static void dump_display(void)
+{
+  display_frames++;
+  if (!frames_dir)
+    return;
+
+  char path[512];
+  snprintf(path, sizeof(path), "%s/display_%06lu_%lums.pbm", frames_dir, (unsigned long)display_frames,
+           (unsigned long)(vclock_now_us() / 1000));
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return;
+  const uint8_t *gddram = ssd1306_host_gddram();
+  fprintf(f, "P4\n%d %d\n", SSD1306_HOST_COLUMNS, SSD1306_HOST_PAGES * 8);
+  for (int y = 0; y < SSD1306_HOST_PAGES * 8; y++)
+  {
+    uint8_t row[SSD1306_HOST_COLUMNS / 8] = {0};
+    for (int x = 0; x < SSD1306_HOST_COLUMNS; x++)
+    {
+      if (gddram[(y >> 3) * SSD1306_HOST_COLUMNS + x] & (1u << (y & 7)))
+        row[x >> 3] |= (uint8_t)(0x80u >> (x & 7));
+    }
+    fwrite(row, 1, sizeof(row), f);
+  }
+  fclose(f);
+}
+
+// Quadro da matriz em texto: instante e as 25 cores em RRGGBB, linha a linha da matriz
+static void dump_leds(const uint32_t *frame)
+{
+  led_frames++;
+  if (!leds_file)
+    return;
+
+  fprintf(leds_file, "%lu:", (unsigned long)(vclock_now_us() / 1000));
+  for (int i = 0; i < LED_MATRIX_PIXELS; i++)
+  {
+    uint32_t grb = frame[i] >> 8;
+    uint32_t rgb = ((grb >> 8) & 0xFF) << 16 | ((grb >> 16) & 0xFF) << 8 | (grb & 0xFF);
+    fprintf(leds_file, "%s%06lX", (i % 5 == 0 && i) ? " | " : " ", (unsigned long)rgb);
+  }
+  fputc('\n', leds_file);
+}
+
+int main(int argc, char **argv)
+{
+  const char *audio_path = NULL, *script_path = NULL, *leds_path = NULL, *link_path = NULL;
+  const char *flash_path = NULL;
+  long cut_bytes = -1;
+  double limit_s = 0;
+  int opt;
+  while ((opt = getopt(argc, argv, "a:s:f:l:t:p:r:e:c:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'a': audio_path = optarg; break;
+    case 's': script_path = optarg; break;
+    case 'f': frames_dir = optarg; break;
+    case 'l': leds_path = optarg; break;
+    case 't': limit_s = atof(optarg); break;
+    case 'p': link_path = optarg; break;
+    case 'r': pace_factor = atof(optarg); break;
+    case 'e': flash_path = optarg; break;
+    case 'c': cut_bytes = atol(optarg); break;
+    default:
+      fprintf(stderr, "uso: %s [-a audio] [-s roteiro] [-f dir_quadros] [-l leds.txt] [-t segundos]"
+                      " [-p link_usb] [-r fator] [-e flash.bin] [-c bytes]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (!audio_path && limit_s <= 0 && !script_path)
+  {
+    fprintf(stderr, "%s: informe o áudio (-a), o roteiro (-s) ou o limite de tempo (-t)\n", argv[0]);
+    return 2;
+  }
+
+  vclock_reset(0);
+  if (audio_path)
+  {
+    if (!acq_replay_open(audio_path))
+    {
+      fprintf(stderr, "%s: %s\n", audio_path, strerror(errno));
+      return 1;
+    }
+    uint32_t rate = acq_replay_sample_rate();
+    if (rate && rate != SIM_SAMPLE_RATE)
+      fprintf(stderr, "%s: taxa de %lu Hz tocada como %d Hz\n", audio_path, (unsigned long)rate, SIM_SAMPLE_RATE);
+    vclock_add_alarm(SIM_BLOCK_US, dma_alarm, NULL);
+  }
+  if (script_path)
+  {
+    errno = 0;
+    if (!load_script(script_path))
+    {
+      if (errno)
+        fprintf(stderr, "%s: %s\n", script_path, strerror(errno));
+      return 1;
+    }
+    if (script_len)
+      vclock_add_alarm(script[0].t_us, script_alarm, NULL);
+  }
+  if (leds_path && !(leds_file = fopen(leds_path, "w")))
+  {
+    fprintf(stderr, "%s: %s\n", leds_path, strerror(errno));
+    return 1;
+  }
+  if (limit_s > 0)
+    vclock_add_alarm((uint64_t)(limit_s * 1e6), quit_alarm, NULL);
+  if (link_path)
+  {
+    if (!usb_link_open_pty(link_path))
+    {
+      fprintf(stderr, "%s: %s\n", link_path, strerror(errno));
+      return 1;
+    }
+  }
+  if (flash_path && !nvm_host_open(flash_path))
+    return 1;
+  if (cut_bytes >= 0)
+    nvm_host_power_cut((uint32_t)cut_bytes, power_cut);
+  if (link_path || pace_factor > 0)
+    vclock_add_alarm(SIM_LINK_POLL_US, link_alarm, NULL);
+
+  ssd1306_host_set_frame_hook(dump_display);
+  led_matrix_host_set_frame_hook(dump_leds);
+  hal_shim_set_reset_handler(sim_finish);
+  clock_gettime(CLOCK_MONOTONIC, &wall_start);
+  return detector_main(); // Só retorna pelos alarmes acima ou pelo BOOTSEL
+}
@@ -0,0 +1,71 @@
+#include "sos.h"
+#include "sos_host.h"
+#include "virtual_clock.h"
+
+static int alarm_id = -1;
+static bool tone;
+static sos_host_event_t events[SOS_HOST_MAX_EVENTS];
+static size_t event_count;
+
+void sos_host_reset(void)
+{
+  vclock_reset(0);
+  alarm_id = -1;
+  tone = false;
+  event_count = 0;
+}
+
+void sos_host_advance(uint32_t ms)
+{
+  vclock_advance_us((uint64_t)ms * 1000);
+}
+
+uint32_t sos_host_now_ms(void)
+{
+  return (uint32_t)(vclock_now_us() / 1000);
+}
+
+size_t sos_host_events(const sos_host_event_t **out)
+{
+  *out = events;
+  return event_count;
+}
+
+static uint64_t sos_alarm(void *user)
+{
+  (void)user;
+  uint32_t next = sos_step_from_alarm();
+  if (next == 0)
+    alarm_id = -1;
+  return (uint64_t)next * 1000;
+}
+
+void sos_backend_init(unsigned int pin, uint32_t tone_hz)
+{
+  (void)pin;
+  (void)tone_hz;
+}
+
+void sos_backend_tone(bool on)
+{
+  if (on == tone)
+    return;
+  tone = on;
+  if (event_count < SOS_HOST_MAX_EVENTS)
+  {
+    events[event_count].t_ms = sos_host_now_ms();
+    events[event_count++].tone = on;
+  }
+}
+
+void sos_backend_start_timer(uint32_t first_ms)
+{
+  vclock_cancel_alarm(alarm_id);
+  alarm_id = vclock_add_alarm((uint64_t)first_ms * 1000, sos_alarm, NULL);
+}
+
+void sos_backend_stop_timer(void)
+{
+  vclock_cancel_alarm(alarm_id);
+  alarm_id = -1;
+}
@@ -0,0 +1,25 @@
+#ifndef SOS_HOST_H
+#define SOS_HOST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Backend do SOS para o host: um alarme do relógio virtual
+// (host/virtual_clock.h) substitui o timer do RP2040 e cada mudança do tom é
+// registrada com o seu instante. sos_host_reset() reinicia o relógio compartilhado.
+
+#define SOS_HOST_MAX_EVENTS 256
+
+typedef struct
+{
+  uint32_t t_ms; // Instante virtual da mudança
+  bool tone;     // Tom ligado depois dela
+} sos_host_event_t;
+
+void sos_host_reset(void);
+void sos_host_advance(uint32_t ms);
+uint32_t sos_host_now_ms(void);
+size_t sos_host_events(const sos_host_event_t **events);
+
+#endif
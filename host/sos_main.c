@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include "sos.h"
+#include "sos_host.h"
+
+// Confere o sequenciador do SOS (lib/sos.c) no relógio virtual
+// (host/sos_host.c): cada borda do tom tem de cair no instante exato que sai
+// das durações de ponto, traço e pausas, por SOS_TOOL_CYCLES ciclos; o
+// período do ciclo completo e a contagem de sos_cycles() têm de bater; e
+// sos_stop() no meio de um traço desliga o tom na hora e nenhuma borda
+// aparece depois. Usa os tempos do firmware e um conjunto de durações
+// ímpares, que não se confundem entre si. Sai com 1 se algo não bate.
+//
+// Uso: detector_sos
+
+#define SOS_TOOL_CYCLES 3
+#define SOS_TOOL_EDGES (SOS_MAX_STEPS * SOS_TOOL_CYCLES + 1) // Mais o início do ciclo seguinte
+
+typedef struct
+{
+  const char *name;
+  sos_timing_t timing;
+} sos_case_t;
+
+static const sos_case_t cases[] = {
+    {"tempos do firmware", {200, 800, 125, 250, 3000}},
+    {"duracoes impares", {37, 111, 23, 59, 401}},
+};
+
+static int errors;
+
+// Duração de cada passo de um ciclo, como o ... --- ... deve soar
+static uint32_t step_ms(const sos_timing_t *t, int step)
+{
+  int letter = step / 6;
+  if (step % 2 == 0)
+    return letter == 1 ? t->dash_ms : t->dot_ms;
+  uint32_t gap = t->gap_ms;
+  if (step % 6 == 5)
+    gap += letter < 2 ? t->letter_gap_ms : t->cycle_gap_ms;
+  return gap;
+}
+
+static void check_edges(const sos_case_t *c)
+{
+  const sos_timing_t *t = &c->timing;
+  uint32_t period = 0;
+  for (int s = 0; s < SOS_MAX_STEPS; s++)
+    period += step_ms(t, s);
+
+  sos_host_reset();
+  sos_init(0, 2000, t);
+  sos_start();
+  sos_host_advance(period * SOS_TOOL_CYCLES);
+
+  const sos_host_event_t *events;
+  size_t count = sos_host_events(&events);
+  uint32_t expected = 0, bad = 0;
+  for (size_t i = 0; i < SOS_TOOL_EDGES && i < count; i++)
+  {
+    bool tone = i % 2 == 0;
+    if (events[i].t_ms != expected || events[i].tone != tone)
+    {
+      if (!bad)
+        printf("  borda %lu: %s em %lu ms, esperado %s em %lu ms\n", (unsigned long)i,
+               events[i].tone ? "liga" : "desliga", (unsigned long)events[i].t_ms, tone ? "liga" : "desliga",
+               (unsigned long)expected);
+      bad++;
+    }
+    expected += step_ms(t, (int)(i % SOS_MAX_STEPS));
+  }
+  bool ok = count == SOS_TOOL_EDGES && !bad;
+  printf("%-20s %lu bordas (esperado %d), %lu fora do instante: %s\n", c->name, (unsigned long)count, SOS_TOOL_EDGES,
+         (unsigned long)bad, ok ? "ok" : "ERRO");
+  errors += !ok;
+
+  // Início de cada ciclo: a borda de subida do primeiro ponto
+  bool period_ok = count == SOS_TOOL_EDGES && sos_cycles() == SOS_TOOL_CYCLES;
+  for (int k = 1; period_ok && k <= SOS_TOOL_CYCLES; k++)
+    period_ok = events[k * SOS_MAX_STEPS].t_ms - events[(k - 1) * SOS_MAX_STEPS].t_ms == period;
+  printf("%-20s periodo de %lu ms, %lu ciclos: %s\n", c->name, (unsigned long)period, (unsigned long)sos_cycles(),
+         period_ok ? "ok" : "ERRO");
+  errors += !period_ok;
+
+  // Parada no meio do primeiro traço do ciclo seguinte
+  uint32_t stop_at = sos_host_now_ms() + step_ms(t, 0) + step_ms(t, 1) + t->dot_ms * 2 + t->gap_ms * 2 +
+                     t->letter_gap_ms + t->dash_ms / 2;
+  sos_host_advance(stop_at - sos_host_now_ms());
+  bool was_on = sos_host_events(&events) % 2 == 1; // A primeira borda liga o tom
+  sos_stop();
+  count = sos_host_events(&events);
+  sos_host_advance(period * 2);
+  bool stop_ok = was_on && !sos_active() && !events[count - 1].tone && events[count - 1].t_ms == stop_at &&
+                 sos_host_events(&events) == count;
+  printf("%-20s parada no meio do traco: %s\n", c->name, stop_ok ? "ok" : "ERRO");
+  errors += !stop_ok;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    fprintf(stderr, "uso: %s\n", argv[0]);
+    return 2;
+  }
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    check_edges(&cases[i]);
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
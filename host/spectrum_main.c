@@ -0,0 +1,226 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "acquisition.h"
+#include "spectrum.h"
+
+// Confere o analisador de bandas (lib/spectrum.c) contra uma referência em
+// ponto flutuante duplo: a cada quadro, a mesma janela de Hann sobre as
+// últimas SPECTRUM_FFT_SIZE amostras, uma DFT direta, a soma das raias de cada
+// banda (com os intervalos recalculados das frequências centrais, como em
+// tools/gen_fft_tables.py) e a mesma média exponencial entre quadros. Os sinais
+// vão de um seno a -50 dBFS a vários tons somados com ruído, em blocos do
+// tamanho dos da aquisição. Compara o nível de cada banda de oitava e de terço
+// de oitava até SPECTRUM_TOOL_TOL_X10, nas bandas a até SPECTRUM_TOOL_RANGE_X10
+// abaixo da potência do quadro inteiro (abaixo disso manda o ruído de
+// arredondamento da FFT de 16 bits) e acima de SPECTRUM_TOOL_FLOOR_X10 (a
+// resolução da média Q8). Confere também as frequências centrais. O custo de
+// um quadro no RP2040 sai do caso spectrum_frame do detector_bench. Sai com 1
+// se algo não bate.
+//
+// Uso: detector_spectrum
+
+#define SPECTRUM_TOOL_RATE 8000
+#define SPECTRUM_TOOL_BLOCKS 40
+#define SPECTRUM_TOOL_TOL_X10 5      // 0,5 dB
+#define SPECTRUM_TOOL_RANGE_X10 500  // 50 dB abaixo da potência do quadro
+#define SPECTRUM_TOOL_FLOOR_X10 -700 // dBFS
+
+#define FFT_N SPECTRUM_FFT_SIZE
+
+typedef struct
+{
+  double freq;
+  int level_x10; // Em décimos de dBFS (o quadrado médio de 2048 é 0 dBFS)
+} tone_t;
+
+typedef struct
+{
+  const char *name;
+  tone_t tones[4];
+  int tone_count;
+  int noise_x10; // Ruído branco uniforme (0: sem ruído)
+} signal_t;
+
+static const signal_t signals[] = {
+    {"seno de 1 kHz a -10 dBFS", {{1000.0, -100}}, 1, 0},
+    {"seno de 440 Hz a -50 dBFS", {{440.0, -500}}, 1, 0},
+    {"seno de 2,9 kHz a -3 dBFS", {{2900.0, -30}}, 1, 0},
+    {"quatro tons de 63 Hz a 2,5 kHz",
+     {{63.0, -60}, {250.0, -200}, {1000.0, -150}, {2500.0, -300}}, 4, 0},
+    {"ruido branco a -20 dBFS", {{0}}, 0, -200},
+    {"tom de 160 Hz sobre ruido", {{160.0, -100}}, 1, -300},
+};
+
+typedef struct
+{
+  uint16_t first, last; // Raias da banda
+  double ms;            // Média quadrática suavizada, em códigos²
+} ref_band_t;
+
+static ref_band_t ref_octave[SPECTRUM_MAX_BANDS], ref_third[SPECTRUM_MAX_BANDS];
+static double window[FFT_N], power[FFT_N / 2];
+static double frame_ms; // Potência de todas as raias, com a suavização das bandas
+static int16_t history[FFT_N];
+static int16_t block[ACQ_BLOCK_SAMPLES];
+static spectrum_t spectrum;
+static int errors;
+
+// Raias cujo centro cai em [fc/r, fc·r); uma banda vazia usa a raia mais próxima
+static void band_bins(ref_band_t *bands, uint8_t count, double first_center, double ratio, double half_ratio,
+                      spectrum_bands_t kind)
+{
+  double df = (double)SPECTRUM_TOOL_RATE / FFT_N;
+  for (uint8_t b = 0; b < count; b++)
+  {
+    double fc = first_center * pow(ratio, b);
+    bands[b].first = 0;
+    bands[b].last = 0;
+    for (uint16_t k = 1; k < FFT_N / 2; k++)
+    {
+      if (k * df >= fc / half_ratio && k * df < fc * half_ratio)
+      {
+        if (!bands[b].first)
+          bands[b].first = k;
+        bands[b].last = k;
+      }
+    }
+    if (!bands[b].first)
+    {
+      long k = lround(fc / df);
+      bands[b].first = bands[b].last = (uint16_t)(k < 1 ? 1 : k > FFT_N / 2 - 1 ? FFT_N / 2 - 1 : k);
+    }
+    if (fabs(spectrum_band_center_hz(kind, b) - fc) > 0.5) // 62,5 Hz arredonda para 62 no gerador
+    {
+      printf("Centro da banda %u: %u Hz, esperado %.1f Hz: ERRO\n", b, spectrum_band_center_hz(kind, b), fc);
+      errors++;
+    }
+  }
+}
+
+// Quadro de referência: janela de Hann periódica, DFT direta e |X[k]|²
+static void reference_frame(bool first_frame)
+{
+  double total = 0;
+  for (uint16_t k = 1; k < FFT_N / 2; k++)
+  {
+    double re = 0, im = 0;
+    for (uint16_t n = 0; n < FFT_N; n++)
+    {
+      double v = history[n] * window[n];
+      double a = 2.0 * M_PI * (double)((uint32_t)k * n % FFT_N) / FFT_N;
+      re += v * cos(a);
+      im -= v * sin(a);
+    }
+    power[k] = re * re + im * im;
+    total += power[k];
+  }
+  total *= 16.0 / (3.0 * FFT_N * FFT_N);
+  frame_ms = first_frame ? total : frame_ms + (total - frame_ms) / (1 << SPECTRUM_SMOOTHING_SHIFT);
+}
+
+// ms = P · 16 / (3·N²) para a janela de Hann, com a suavização do analisador
+static void reference_bands(ref_band_t *bands, uint8_t count, bool first_frame)
+{
+  for (uint8_t b = 0; b < count; b++)
+  {
+    double sum = 0;
+    for (uint16_t k = bands[b].first; k <= bands[b].last; k++)
+      sum += power[k];
+    double band = sum * 16.0 / (3.0 * FFT_N * FFT_N);
+    if (first_frame)
+      bands[b].ms = band;
+    else
+      bands[b].ms += (band - bands[b].ms) / (1 << SPECTRUM_SMOOTHING_SHIFT);
+  }
+}
+
+// Maior desvio em décimos de dB nas bandas acima do ruído da FFT e da resolução da média
+static int compare_bands(const ref_band_t *bands, spectrum_bands_t kind)
+{
+  int16_t levels[SPECTRUM_MAX_BANDS];
+  spectrum_band_levels(&spectrum, kind, levels);
+  double frame_x10 = 100.0 * log10(frame_ms / (2048.0 * 2048.0));
+  double floor_x10 = fmax(frame_x10 - SPECTRUM_TOOL_RANGE_X10, SPECTRUM_TOOL_FLOOR_X10);
+  int worst = 0;
+  for (uint8_t b = 0; b < spectrum_band_count(kind); b++)
+  {
+    double expected = bands[b].ms > 0 ? 100.0 * log10(bands[b].ms / (2048.0 * 2048.0)) : -HUGE_VAL;
+    if (expected < floor_x10)
+      continue;
+    int error = levels[b] == INT16_MIN ? INT16_MAX : (int)lround(fabs(levels[b] - expected));
+    if (error > worst)
+      worst = error;
+  }
+  return worst;
+}
+
+static void check_signal(const signal_t *sig)
+{
+  spectrum_init(&spectrum);
+  uint32_t seed = 2463534242u;
+  double noise_amplitude = sig->noise_x10 ? 2048.0 * sqrt(3.0) * pow(10.0, sig->noise_x10 / 200.0) : 0.0;
+  int worst_octave = 0, worst_third = 0;
+  uint32_t frames = 0;
+  for (uint32_t b = 0; b < SPECTRUM_TOOL_BLOCKS; b++)
+  {
+    for (size_t n = 0; n < ACQ_BLOCK_SAMPLES; n++)
+    {
+      double t = (double)(b * ACQ_BLOCK_SAMPLES + n) / SPECTRUM_TOOL_RATE;
+      double v = 0;
+      for (int i = 0; i < sig->tone_count; i++)
+      {
+        double amplitude = 2048.0 * M_SQRT2 * pow(10.0, sig->tones[i].level_x10 / 200.0);
+        v += amplitude * sin(2.0 * M_PI * sig->tones[i].freq * t + i);
+      }
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+      v += noise_amplitude * (2.0 * seed / 4294967296.0 - 1.0);
+      long code = lround(v);
+      block[n] = (int16_t)(code < -2048 ? -2048 : code > 2047 ? 2047 : code);
+    }
+    spectrum_process(&spectrum, block, ACQ_BLOCK_SAMPLES);
+
+    // O mesmo histórico deslizante (blocos de N/2: 50% de sobreposição)
+    for (size_t n = 0; n < FFT_N - ACQ_BLOCK_SAMPLES; n++)
+      history[n] = history[n + ACQ_BLOCK_SAMPLES];
+    for (size_t n = 0; n < ACQ_BLOCK_SAMPLES; n++)
+      history[FFT_N - ACQ_BLOCK_SAMPLES + n] = block[n];
+    if ((b + 1) * ACQ_BLOCK_SAMPLES < FFT_N)
+      continue;
+
+    reference_frame(frames == 0);
+    reference_bands(ref_octave, spectrum_band_count(SPECTRUM_OCTAVE), frames == 0);
+    reference_bands(ref_third, spectrum_band_count(SPECTRUM_THIRD_OCTAVE), frames == 0);
+    frames++;
+    int e = compare_bands(ref_octave, SPECTRUM_OCTAVE);
+    worst_octave = e > worst_octave ? e : worst_octave;
+    e = compare_bands(ref_third, SPECTRUM_THIRD_OCTAVE);
+    worst_third = e > worst_third ? e : worst_third;
+  }
+  bool ok = spectrum.frames == frames && worst_octave <= SPECTRUM_TOOL_TOL_X10 && worst_third <= SPECTRUM_TOOL_TOL_X10;
+  printf("%-32s %lu quadros, maior desvio %d.%d dB nas oitavas e %d.%d dB nos tercos: %s\n", sig->name,
+         (unsigned long)frames, worst_octave / 10, worst_octave % 10, worst_third / 10, worst_third % 10,
+         ok ? "ok" : "ERRO");
+  errors += !ok;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    fprintf(stderr, "uso: %s\n", argv[0]);
+    return 2;
+  }
+  for (uint16_t n = 0; n < FFT_N; n++)
+    window[n] = 0.5 * (1.0 - cos(2.0 * M_PI * n / FFT_N));
+  band_bins(ref_octave, spectrum_band_count(SPECTRUM_OCTAVE), 1000.0 / 32.0, 2.0, M_SQRT2, SPECTRUM_OCTAVE);
+  band_bins(ref_third, spectrum_band_count(SPECTRUM_THIRD_OCTAVE), 1000.0 * pow(10.0, -1.5), pow(10.0, 0.1),
+            pow(2.0, 1.0 / 6.0), SPECTRUM_THIRD_OCTAVE);
+
+  for (size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); i++)
+    check_signal(&signals[i]);
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,141 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spsc_ring.h"
+
+// Teste de estresse de lib/spsc_ring.c com duas threads, como os dois núcleos
+// do RP2040: o produtor publica registros numerados por uma fila pequena (que
+// passa quase todo o tempo cheia ou vazia) e o consumidor confere que nenhum
+// se perdeu, repetiu, saiu de ordem ou chegou pela metade (o conteúdo inteiro
+// é derivado do número). Antes, numa thread só, confere a contagem de perdas:
+// spsc_ring_push conta a fila cheia em dropped, spsc_ring_try_push não. Sai com
+// 1 se algo não bate; roda também sob o ThreadSanitizer (-fsanitize=thread).
+//
+// Uso: detector_spsc [registros]
+
+#define SPSC_TOOL_CAPACITY 8
+#define SPSC_TOOL_WORDS 6 // Registro de 24 bytes: uma cópia não atômica
+
+typedef struct
+{
+  uint32_t seq;
+  uint32_t payload[SPSC_TOOL_WORDS - 1];
+} record_t;
+
+static spsc_ring_t ring;
+static record_t storage[SPSC_TOOL_CAPACITY];
+static uint32_t total;
+static uint32_t producer_spins; // Tentativas com a fila cheia
+static uint32_t consumer_spins; // Tentativas com a fila vazia
+static uint32_t bad_seq, bad_payload;
+
+static void fill(record_t *r, uint32_t seq)
+{
+  r->seq = seq;
+  uint32_t x = seq * 2654435761u + 1;
+  for (int i = 0; i < SPSC_TOOL_WORDS - 1; i++)
+  {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    r->payload[i] = x;
+  }
+}
+
+static void *producer(void *arg)
+{
+  (void)arg;
+  record_t r;
+  for (uint32_t seq = 0; seq < total; seq++)
+  {
+    fill(&r, seq);
+    while (!spsc_ring_try_push(&ring, &r))
+    {
+      producer_spins++;
+      sched_yield(); // Com uma CPU só, a outra thread precisa rodar para a fila andar
+    }
+  }
+  return NULL;
+}
+
+static void *consumer(void *arg)
+{
+  (void)arg;
+  record_t r, expected;
+  for (uint32_t seq = 0; seq < total; seq++)
+  {
+    while (!spsc_ring_pop(&ring, &r))
+    {
+      consumer_spins++;
+      sched_yield();
+    }
+    fill(&expected, seq);
+    if (r.seq != seq)
+      bad_seq++;
+    else if (memcmp(&r, &expected, sizeof(r)) != 0)
+      bad_payload++;
+  }
+  return NULL;
+}
+
+// Fila cheia e vazia numa thread só: contagem de perdas e ordem depois de dar a volta
+static int check_single_thread(void)
+{
+  int errors = 0;
+  record_t r;
+  spsc_ring_init(&ring, storage, sizeof(record_t), SPSC_TOOL_CAPACITY);
+  for (uint32_t seq = 0; seq < SPSC_TOOL_CAPACITY; seq++)
+  {
+    fill(&r, seq);
+    errors += !spsc_ring_push(&ring, &r);
+  }
+  errors += spsc_ring_count(&ring) != SPSC_TOOL_CAPACITY;
+  errors += spsc_ring_push(&ring, &r);     // Cheia: recusado e contado
+  errors += spsc_ring_try_push(&ring, &r); // Cheia: recusado sem contar
+  errors += spsc_ring_try_push(&ring, &r);
+  errors += ring.dropped != 1;
+  for (uint32_t seq = 0; seq < 3 * SPSC_TOOL_CAPACITY; seq++)
+  {
+    record_t expected;
+    fill(&expected, seq);
+    errors += !spsc_ring_pop(&ring, &r) || memcmp(&r, &expected, sizeof(r)) != 0;
+    fill(&r, seq + SPSC_TOOL_CAPACITY);
+    errors += !spsc_ring_try_push(&ring, &r);
+  }
+  errors += ring.dropped != 1;
+  errors += spsc_ring_init(&ring, storage, sizeof(record_t), 6); // Capacidade que não é potência de 2
+  printf("Uma thread (cheia, vazia, volta no indice, perdas contadas so no push): %s\n", errors ? "ERRO" : "ok");
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 2)
+  {
+    fprintf(stderr, "uso: %s [registros]\n", argv[0]);
+    return 2;
+  }
+  total = argc == 2 ? (uint32_t)strtoul(argv[1], NULL, 10) : 2000000;
+  int errors = check_single_thread();
+
+  spsc_ring_init(&ring, storage, sizeof(record_t), SPSC_TOOL_CAPACITY);
+  pthread_t threads[2];
+  if (pthread_create(&threads[0], NULL, consumer, NULL) != 0 || pthread_create(&threads[1], NULL, producer, NULL) != 0)
+  {
+    fprintf(stderr, "nao foi possivel criar as threads\n");
+    return 2;
+  }
+  pthread_join(threads[0], NULL);
+  pthread_join(threads[1], NULL);
+
+  bool ok = bad_seq == 0 && bad_payload == 0 && spsc_ring_count(&ring) == 0 && ring.dropped == 0;
+  printf("Duas threads: %lu registros por uma fila de %d, %lu fora de ordem, %lu corrompidos, %lu perdas contadas "
+         "(fila cheia %lu vezes, vazia %lu vezes): %s\n",
+         (unsigned long)total, SPSC_TOOL_CAPACITY, (unsigned long)bad_seq, (unsigned long)bad_payload,
+         (unsigned long)ring.dropped, (unsigned long)producer_spins, (unsigned long)consumer_spins, ok ? "ok" : "ERRO");
+  errors += !ok;
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
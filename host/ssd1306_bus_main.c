@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "ssd1306.h"
+#include "ssd1306_host.h"
+
+// Confere o envio só das janelas alteradas (lib/ssd1306.c) contra o modelo do
+// controlador de host/ssd1306_host.c:
+//  - o primeiro quadro vai inteiro (1034 bytes no barramento: 10 de
+//    cabeçalho da janela e 1024 de dados); um quadro igual não põe nada;
+//  - casos de custo conhecido: um pixel, uma coluna inteira, uma linha de
+//    uma página e um glifo;
+//  - em sequências aleatórias de desenho, a GDDRAM do modelo fica igual ao
+//    ram_buffer depois de cada envio, o bus_bytes do driver bate com os bytes
+//    que o modelo recebeu e nenhum quadro custa mais que o quadro inteiro.
+// Sai com 1 se algo não bate.
+//
+// Uso: detector_ssd1306_bus [quadros_aleatorios]
+
+#define BUS_TOOL_FULL_FRAME (10 + WIDTH * HEIGHT / 8)
+
+static ssd1306_t ssd;
+static int errors;
+
+static bool gddram_matches(void)
+{
+  const uint8_t *gddram = ssd1306_host_gddram();
+  for (uint8_t x = 0; x < WIDTH; x++)
+  {
+    for (uint8_t p = 0; p < HEIGHT / 8; p++)
+    {
+      if (gddram[p * SSD1306_HOST_COLUMNS + x] != ssd.ram_buffer[(x << 3) + p + 1])
+        return false;
+    }
+  }
+  return true;
+}
+
+// Envia o quadro e devolve os bytes que o driver contou; confere a contagem do
+// modelo e a GDDRAM
+static uint32_t send(void)
+{
+  uint32_t driver = ssd.bus_bytes;
+  uint32_t model = ssd1306_host_bus_bytes();
+  ssd1306_send_data(&ssd);
+  driver = ssd.bus_bytes - driver;
+  model = ssd1306_host_bus_bytes() - model;
+  if (driver != model || !gddram_matches())
+  {
+    printf("Envio de %lu bytes (modelo: %lu), GDDRAM %s: ERRO\n", (unsigned long)driver, (unsigned long)model,
+           gddram_matches() ? "igual" : "diferente");
+    errors++;
+  }
+  return driver;
+}
+
+static void check_cost(const char *what, uint32_t bytes, uint32_t expected)
+{
+  bool ok = bytes == expected;
+  printf("%-40s %4lu bytes (esperado %lu): %s\n", what, (unsigned long)bytes, (unsigned long)expected,
+         ok ? "ok" : "ERRO");
+  errors += !ok;
+}
+
+static void check_known_costs(void)
+{
+  ssd1306_draw_string(&ssd, "Monitoramento", 0, 40);
+  check_cost("Primeiro quadro (inteiro)", send(), BUS_TOOL_FULL_FRAME);
+  check_cost("Quadro igual", send(), 0);
+
+  ssd1306_pixel(&ssd, 100, 20, true);
+  check_cost("Um pixel", send(), 10 + 1);
+  ssd1306_pixel(&ssd, 100, 20, true);
+  check_cost("Pixel que ja estava aceso", send(), 0);
+
+  // As 8 páginas de uma coluna: uma janela de altura total sai mais barata que 8
+  ssd1306_vline(&ssd, 64, 0, HEIGHT - 1, true);
+  check_cost("Uma coluna inteira", send(), 10 + 8);
+
+  ssd1306_hline(&ssd, 0, WIDTH - 1, 3, true);
+  check_cost("Uma linha de uma pagina", send(), 10 + WIDTH); // A coluna 64 já acesa vai no meio da janela
+
+  // "A" -> "B" na página alinhada: só as colunas do glifo que mudam
+  ssd1306_draw_char(&ssd, 'A', 16, 48);
+  send();
+  ssd1306_draw_char(&ssd, 'B', 16, 48);
+  uint32_t changed = 0, lo = WIDTH, hi = 0;
+  for (uint8_t x = 16; x < 24; x++)
+  {
+    if (ssd.ram_buffer[(x << 3) + 6 + 1] != ssd.shadow[(x << 3) + 6])
+    {
+      changed++;
+      lo = x < lo ? x : lo;
+      hi = x;
+    }
+  }
+  check_cost("Um glifo trocado", send(), changed ? 10 + (hi - lo + 1) : 0);
+
+  ssd1306_fill(&ssd, true);
+  check_cost("Tela inteira acesa", send(), BUS_TOOL_FULL_FRAME);
+}
+
+// Operações de desenho aleatórias entre envios
+static void check_random(uint32_t frames)
+{
+  uint32_t seed = 1;
+  uint32_t worst = 0, total = 0;
+  int before = errors;
+  for (uint32_t f = 0; f < frames; f++)
+  {
+    int ops = 1 + rand_r(&seed) % 6;
+    for (int i = 0; i < ops; i++)
+    {
+      uint8_t x = rand_r(&seed) % WIDTH, y = rand_r(&seed) % HEIGHT;
+      uint8_t w = 1 + rand_r(&seed) % 40, h = 1 + rand_r(&seed) % 24;
+      bool value = rand_r(&seed) & 1;
+      switch (rand_r(&seed) % 7)
+      {
+      case 0:
+        ssd1306_pixel(&ssd, x, y, value);
+        break;
+      case 1:
+        ssd1306_rect(&ssd, y, x, w, h, value, rand_r(&seed) & 1);
+        break;
+      case 2:
+        ssd1306_line(&ssd, x, y, rand_r(&seed) % WIDTH, rand_r(&seed) % HEIGHT, value);
+        break;
+      case 3:
+        ssd1306_draw_string(&ssd, (rand_r(&seed) & 1) ? "dB 72" : "Leq", x & ~7, y & ~7);
+        break;
+      case 4:
+        ssd1306_draw_char(&ssd, (char)('0' + rand_r(&seed) % 10), x, y);
+        break;
+      case 5:
+        ssd1306_scroll_left(&ssd, x, WIDTH - 1, 0, y >> 3, 1 + rand_r(&seed) % 4);
+        break;
+      default:
+        if (rand_r(&seed) % 16 == 0)
+          ssd1306_fill(&ssd, value);
+        break;
+      }
+    }
+    uint32_t bytes = send();
+    total += bytes;
+    worst = bytes > worst ? bytes : worst;
+  }
+  bool ok = errors == before && worst <= BUS_TOOL_FULL_FRAME;
+  printf("%lu quadros aleatorios: media %lu bytes, maior %lu bytes, GDDRAM e contagem iguais ao modelo: %s\n",
+         (unsigned long)frames, (unsigned long)(frames ? total / frames : 0), (unsigned long)worst, ok ? "ok" : "ERRO");
+  errors += worst > BUS_TOOL_FULL_FRAME;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 2)
+  {
+    fprintf(stderr, "uso: %s [quadros_aleatorios]\n", argv[0]);
+    return 2;
+  }
+  uint32_t frames = argc == 2 ? (uint32_t)strtoul(argv[1], NULL, 10) : 2000;
+  ssd1306_host_reset();
+  ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, NULL); // O modelo do host não usa a porta I2C
+  ssd1306_config(&ssd);
+  check_known_costs();
+  check_random(frames);
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1306.h"
+#include "ssd1306_host.h"
+
+// Confere o fluxo de palavras que ssd1306_send_data_async entrega ao DMA
+// (tx_words, no formato do IC_DATA_CMD) contra a sequência bloqueante de
+// antes, em que cada janela ia como seis comandos avulsos (controle 0x80 e um
+// byte, uma transação cada) seguidos de uma transação de dados (controle 0x40):
+//  - o fluxo de cada quadro se decompõe exatamente em janelas: controle 0x00
+//    (com RESTART, menos na primeira), SET_COL_ADDR x0 x1 SET_PAGE_ADDR p0
+//    p1, RESTART com controle 0x40 e os dados da janela, com o STOP só na
+//    última palavra e nenhum outro bit além do byte;
+//  - depois do envio pelo fluxo, a GDDRAM do modelo (host/ssd1306_host.c) é
+//    igual ao ram_buffer;
+//  - as mesmas janelas, reenviadas num modelo zerado pela sequência bloqueante
+//    antiga, deixam a GDDRAM igual quadro a quadro.
+// Imprime também os bytes no barramento das duas formas. Sai com 1 se algo
+// não bate.
+//
+// Uso: detector_ssd1306_dma [quadros]
+
+#define DMA_TOOL_GDDRAM (SSD1306_HOST_PAGES * SSD1306_HOST_COLUMNS)
+
+typedef struct
+{
+  uint16_t *words; // Cópia de tx_words
+  size_t len;
+  uint8_t gddram[DMA_TOOL_GDDRAM]; // Modelo depois do envio pelo fluxo
+} frame_log_t;
+
+static ssd1306_t ssd;
+static int errors;
+
+static bool gddram_matches_buffer(void)
+{
+  const uint8_t *gddram = ssd1306_host_gddram();
+  for (uint8_t x = 0; x < WIDTH; x++)
+  {
+    for (uint8_t p = 0; p < HEIGHT / 8; p++)
+    {
+      if (gddram[p * SSD1306_HOST_COLUMNS + x] != ssd.ram_buffer[(x << 3) + p + 1])
+        return false;
+    }
+  }
+  return true;
+}
+
+// Decompõe o fluxo em janelas; com replay, reenvia cada uma como a sequência
+// bloqueante antiga. Retorna o número de janelas (-1 se o fluxo é inválido).
+static int parse_stream(const uint16_t *words, size_t len, bool replay)
+{
+  static const uint8_t commands[6] = {SET_COL_ADDR, 0, 0, SET_PAGE_ADDR, 0, 0};
+  int windows = 0;
+  size_t i = 0;
+  while (i < len)
+  {
+    if (i + 8 > len || words[i] != (windows ? SSD1306_TX_RESTART : 0) || words[i + 7] != (SSD1306_TX_RESTART | 0x40))
+      return -1;
+    uint8_t bytes[6];
+    for (int c = 0; c < 6; c++)
+    {
+      if (words[i + 1 + c] > 0xFF || (c % 3 == 0 && words[i + 1 + c] != commands[c]))
+        return -1;
+      bytes[c] = (uint8_t)words[i + 1 + c];
+    }
+    uint8_t x0 = bytes[1], x1 = bytes[2], p0 = bytes[4], p1 = bytes[5];
+    if (x0 > x1 || x1 >= WIDTH || p0 > p1 || p1 >= HEIGHT / 8)
+      return -1;
+    size_t count = (size_t)(x1 - x0 + 1) * (p1 - p0 + 1);
+    i += 8;
+    if (i + count > len)
+      return -1;
+
+    uint8_t data[1 + DMA_TOOL_GDDRAM];
+    data[0] = 0x40;
+    for (size_t n = 0; n < count; n++, i++)
+    {
+      bool last = i == len - 1;
+      if ((words[i] & ~0xFF) != (last ? SSD1306_TX_STOP : 0))
+        return -1;
+      data[1 + n] = (uint8_t)words[i];
+    }
+    if (replay)
+    {
+      for (int c = 0; c < 6; c++)
+      {
+        uint8_t command[2] = {0x80, bytes[c]};
+        ssd1306_transport_write_blocking(&ssd, command, 2);
+      }
+      ssd1306_transport_write_blocking(&ssd, data, 1 + count);
+    }
+    windows++;
+  }
+  return windows;
+}
+
+static void draw_random(uint32_t *seed)
+{
+  int ops = 1 + rand_r(seed) % 5;
+  for (int i = 0; i < ops; i++)
+  {
+    uint8_t x = rand_r(seed) % WIDTH, y = rand_r(seed) % HEIGHT;
+    bool value = rand_r(seed) & 1;
+    switch (rand_r(seed) % 6)
+    {
+    case 0:
+      ssd1306_pixel(&ssd, x, y, value);
+      break;
+    case 1:
+      ssd1306_rect(&ssd, y, x, 1 + rand_r(seed) % 48, 1 + rand_r(seed) % 32, value, rand_r(seed) & 1);
+      break;
+    case 2:
+      ssd1306_line(&ssd, x, y, rand_r(seed) % WIDTH, rand_r(seed) % HEIGHT, value);
+      break;
+    case 3:
+      ssd1306_draw_string(&ssd, "Pico 85 dB", x & ~7, y & ~7);
+      break;
+    case 4:
+      ssd1306_scroll_left(&ssd, 0, WIDTH - 1, y >> 3, HEIGHT / 8 - 1, 1 + rand_r(seed) % 8);
+      break;
+    default:
+      if (rand_r(seed) % 8 == 0)
+        ssd1306_fill(&ssd, value);
+      break;
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 2)
+  {
+    fprintf(stderr, "uso: %s [quadros]\n", argv[0]);
+    return 2;
+  }
+  uint32_t frames = argc == 2 ? (uint32_t)strtoul(argv[1], NULL, 10) : 500;
+  frame_log_t *log = calloc(frames ? frames : 1, sizeof(frame_log_t));
+  if (!log)
+    return 2;
+
+  // Envio pelo fluxo do DMA
+  ssd1306_host_reset();
+  ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, NULL); // O modelo do host não usa a porta I2C
+  ssd1306_config(&ssd);
+  uint32_t config_bytes = ssd1306_host_bus_bytes();
+  uint32_t seed = 7, logged = 0, windows = 0, bad_streams = 0, bad_frames = 0;
+  for (uint32_t f = 0; f < frames; f++)
+  {
+    draw_random(&seed);
+    uint32_t before = ssd.bus_bytes;
+    ssd1306_send_data(&ssd);
+    bad_frames += !gddram_matches_buffer();
+    if (ssd.bus_bytes == before)
+      continue; // Quadro igual: nada no barramento
+    frame_log_t *entry = &log[logged++];
+    entry->len = ssd.tx_len;
+    entry->words = malloc(ssd.tx_len * sizeof(uint16_t));
+    memcpy(entry->words, ssd.tx_words, ssd.tx_len * sizeof(uint16_t));
+    memcpy(entry->gddram, ssd1306_host_gddram(), DMA_TOOL_GDDRAM);
+    int w = parse_stream(entry->words, entry->len, false);
+    if (w < 0)
+      bad_streams++;
+    else
+      windows += w;
+  }
+  uint32_t stream_bytes = ssd1306_host_bus_bytes() - config_bytes;
+  printf("Fluxo do DMA: %lu quadros enviados, %lu janelas, %lu fluxos mal formados, %lu quadros com a GDDRAM "
+         "diferente do ram_buffer: %s\n",
+         (unsigned long)logged, (unsigned long)windows, (unsigned long)bad_streams, (unsigned long)bad_frames,
+         bad_streams || bad_frames ? "ERRO" : "ok");
+  errors += bad_streams || bad_frames;
+
+  // As mesmas janelas pela sequência bloqueante antiga, a partir do mesmo estado inicial
+  ssd1306_host_reset();
+  ssd1306_config(&ssd);
+  uint32_t mismatches = 0;
+  for (uint32_t f = 0; f < logged; f++)
+  {
+    parse_stream(log[f].words, log[f].len, true);
+    mismatches += memcmp(ssd1306_host_gddram(), log[f].gddram, DMA_TOOL_GDDRAM) != 0;
+    free(log[f].words);
+  }
+  uint32_t blocking_bytes = ssd1306_host_bus_bytes() - config_bytes;
+  printf("Sequencia bloqueante: %lu quadros com a GDDRAM diferente da do fluxo: %s\n", (unsigned long)mismatches,
+         mismatches ? "ERRO" : "ok");
+  errors += mismatches != 0;
+  printf("Bytes no barramento: %lu pelo fluxo, %lu pela sequencia bloqueante\n", (unsigned long)stream_bytes,
+         (unsigned long)blocking_bytes);
+  free(log);
+
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,324 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1306.h"
+#include "ssd1306_host.h"
+#include "font.h"
+
+// Quadro de ouro das primitivas de desenho (lib/ssd1306.c): cada operação é
+// repetida num bitmap de referência pelos algoritmos de um pixel por vez de
+// antes da escrita byte a byte, com recorte nas bordas do painel, e o
+// ram_buffer tem de ficar igual ao bitmap depois de cada uma. De tempos em
+// tempos o quadro é enviado ao modelo do controlador (host/ssd1306_host.c),
+// e a GDDRAM também tem de ficar igual, o que confere as marcas de colunas
+// sujas. As coordenadas vão além do painel, e os círculos e linhas saem por
+// todas as bordas (coordenadas negativas dão a volta em uint8_t): nada pode
+// ser escrito fora do ram_buffer nem das marcas de sujeira. O custo de cada
+// primitiva sai dos casos ssd1306_* do detector_bench. Sai com 1 se algo não
+// bate.
+//
+// Uso: detector_ssd1306_golden [operacoes]
+
+#define GOLDEN_TOOL_COORD 160 // Coordenadas sorteadas em 0..159: parte fora do painel
+#define GOLDEN_TOOL_SIZE 96   // Lados de 1..95 (left + width cabe em uint8_t)
+#define GOLDEN_TOOL_SEND_EVERY 7
+
+static ssd1306_t ssd;
+static bool reference[HEIGHT][WIDTH];
+static int errors;
+
+static void ref_pixel(int x, int y, bool value)
+{
+  if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT)
+    reference[y][x] = value;
+}
+
+static void ref_rect(int top, int left, int width, int height, bool value, bool fill)
+{
+  for (int x = left; x < left + width; x++)
+  {
+    ref_pixel(x, top, value);
+    ref_pixel(x, top + height - 1, value);
+  }
+  for (int y = top; y < top + height; y++)
+  {
+    ref_pixel(left, y, value);
+    ref_pixel(left + width - 1, y, value);
+  }
+  for (int x = left + 1; fill && x < left + width - 1; x++)
+  {
+    for (int y = top + 1; y < top + height - 1; y++)
+      ref_pixel(x, y, value);
+  }
+}
+
+// Bresenham; com uint8_t como na API, para as coordenadas que dão a volta
+static void ref_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value)
+{
+  int dx = abs(x1 - x0), dy = abs(y1 - y0);
+  int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+  int err = dx - dy;
+  while (true)
+  {
+    ref_pixel(x0, y0, value);
+    if (x0 == x1 && y0 == y1)
+      break;
+    int e2 = err * 2;
+    if (e2 > -dy)
+    {
+      err -= dy;
+      x0 += sx;
+    }
+    if (e2 < dx)
+    {
+      err += dx;
+      y0 += sy;
+    }
+  }
+}
+
+static void ref_hline(int x0, int x1, int y, bool value)
+{
+  for (int x = x0; x <= x1; x++)
+    ref_pixel(x, y, value);
+}
+
+static void ref_vline(int x, int y0, int y1, bool value)
+{
+  for (int y = y0; y <= y1; y++)
+    ref_pixel(x, y, value);
+}
+
+static void ref_glyph(char c, int x, int y, bool invert)
+{
+  int index = 0;
+  if (c >= 'A' && c <= 'Z')
+    index = c - 'A' + 11;
+  else if (c >= '0' && c <= '9')
+    index = c - '0' + 1;
+  else if (c >= 'a' && c <= 'z')
+    index = c - 'a' + 37;
+  else if (c == ':')
+    index = 63;
+  else if (c == '-')
+    index = 64;
+  else if (c == '.')
+    index = 65;
+  for (int i = 0; i < 8; i++)
+  {
+    uint8_t column = font[index * 8 + i] ^ (invert ? 0xFF : 0x00);
+    for (int j = 0; j < 8; j++)
+      ref_pixel(x + i, y + j, column & (1 << j));
+  }
+}
+
+static void ref_string(const char *str, uint8_t x, uint8_t y)
+{
+  while (*str)
+  {
+    ref_glyph(*str++, x, y, false);
+    x += 8;
+    if (x + 8 >= WIDTH)
+    {
+      x = 0;
+      y += 8;
+    }
+    if (y + 8 >= HEIGHT)
+      break;
+  }
+}
+
+static void ref_circle(uint8_t x0, uint8_t y0, uint8_t r, bool value)
+{
+  int x = r, y = 0, err = 0;
+  while (x >= y)
+  {
+    ref_pixel((uint8_t)(x0 + x), (uint8_t)(y0 + y), value);
+    ref_pixel((uint8_t)(x0 + y), (uint8_t)(y0 + x), value);
+    ref_pixel((uint8_t)(x0 - y), (uint8_t)(y0 + x), value);
+    ref_pixel((uint8_t)(x0 - x), (uint8_t)(y0 + y), value);
+    ref_pixel((uint8_t)(x0 - x), (uint8_t)(y0 - y), value);
+    ref_pixel((uint8_t)(x0 - y), (uint8_t)(y0 - x), value);
+    ref_pixel((uint8_t)(x0 + y), (uint8_t)(y0 - x), value);
+    ref_pixel((uint8_t)(x0 + x), (uint8_t)(y0 - y), value);
+    if (err <= 0)
+    {
+      y++;
+      err += 2 * y + 1;
+    }
+    if (err > 0)
+    {
+      x--;
+      err -= 2 * x + 1;
+    }
+  }
+}
+
+static bool buffer_matches(void)
+{
+  for (int y = 0; y < HEIGHT; y++)
+  {
+    for (int x = 0; x < WIDTH; x++)
+    {
+      bool on = ssd.ram_buffer[(x << 3) + (y >> 3) + 1] & (1 << (y & 7));
+      if (on != reference[y][x])
+        return false;
+    }
+  }
+  // O byte de controle e as marcas de sujeira também não podem ter sido atropelados
+  for (uint8_t p = 0; p < ssd.pages; p++)
+  {
+    if (ssd.dirty_x0[p] <= ssd.dirty_x1[p] && ssd.dirty_x1[p] >= WIDTH)
+      return false;
+  }
+  return ssd.ram_buffer[0] == 0x40;
+}
+
+static bool gddram_matches(void)
+{
+  const uint8_t *gddram = ssd1306_host_gddram();
+  for (int y = 0; y < HEIGHT; y++)
+  {
+    for (int x = 0; x < WIDTH; x++)
+    {
+      if ((bool)(gddram[(y >> 3) * SSD1306_HOST_COLUMNS + x] & (1 << (y & 7))) != reference[y][x])
+        return false;
+    }
+  }
+  return true;
+}
+
+// Operações nomeadas que têm de acertar mesmo saindo do painel
+static void check_clipping(void)
+{
+  static const struct
+  {
+    const char *name;
+    uint8_t x, y, r;
+  } circles[] = {
+      {"circulo no canto superior esquerdo", 2, 2, 20},
+      {"circulo no canto inferior direito", 120, 60, 30},
+      {"circulo maior que o painel", 64, 32, 90},
+  };
+  for (size_t i = 0; i < sizeof(circles) / sizeof(circles[0]); i++)
+  {
+    ssd1306_circle(&ssd, circles[i].x, circles[i].y, circles[i].r, true);
+    ref_circle(circles[i].x, circles[i].y, circles[i].r, true);
+    bool ok = buffer_matches();
+    printf("%-40s %s\n", circles[i].name, ok ? "ok" : "ERRO");
+    errors += !ok;
+  }
+
+  ssd1306_pixel(&ssd, WIDTH, 0, true);
+  ssd1306_pixel(&ssd, 0, HEIGHT, true);
+  ssd1306_pixel(&ssd, 255, 255, true);
+  ssd1306_line(&ssd, 100, 10, 200, 90, true);
+  ref_line(100, 10, 200, 90, true);
+  ssd1306_line(&ssd, 250, 70, 20, 30, true);
+  ref_line(250, 70, 20, 30, true);
+  ssd1306_send_data(&ssd);
+  bool ok = buffer_matches() && gddram_matches();
+  printf("%-40s %s\n", "pixels e linhas fora do painel", ok ? "ok" : "ERRO");
+  errors += !ok;
+}
+
+static void check_random(uint32_t operations)
+{
+  static const char *const strings[] = {"Monitoramento", "Leq 72.5 dB", "L10:", "-12.3", "xyz ABC 09"};
+  uint32_t seed = 3, bad_ops = 0, bad_sends = 0, sends = 0;
+  for (uint32_t i = 0; i < operations; i++)
+  {
+    uint8_t x = rand_r(&seed) % GOLDEN_TOOL_COORD, y = rand_r(&seed) % GOLDEN_TOOL_COORD;
+    uint8_t w = 1 + rand_r(&seed) % (GOLDEN_TOOL_SIZE - 1), h = 1 + rand_r(&seed) % (GOLDEN_TOOL_SIZE - 1);
+    uint8_t x1 = rand_r(&seed) % GOLDEN_TOOL_COORD, y1 = rand_r(&seed) % GOLDEN_TOOL_COORD;
+    bool value = rand_r(&seed) & 1;
+    switch (rand_r(&seed) % 10)
+    {
+    case 0:
+      ssd1306_pixel(&ssd, x, y, value);
+      ref_pixel(x, y, value);
+      break;
+    case 1:
+    {
+      bool fill = rand_r(&seed) & 1;
+      ssd1306_rect(&ssd, y, x, w, h, value, fill);
+      ref_rect(y, x, w, h, value, fill);
+      break;
+    }
+    case 2:
+      ssd1306_line(&ssd, x, y, x1, y1, value);
+      ref_line(x, y, x1, y1, value);
+      break;
+    case 3:
+      ssd1306_hline(&ssd, x < x1 ? x : x1, x < x1 ? x1 : x, y % HEIGHT, value);
+      ref_hline(x < x1 ? x : x1, x < x1 ? x1 : x, y % HEIGHT, value);
+      break;
+    case 4:
+      ssd1306_vline(&ssd, x % WIDTH, y < y1 ? y : y1, y < y1 ? y1 : y, value);
+      ref_vline(x % WIDTH, y < y1 ? y : y1, y < y1 ? y1 : y, value);
+      break;
+    case 5:
+    {
+      char c = (char)(' ' + rand_r(&seed) % 96);
+      ssd1306_draw_char(&ssd, c, x, y);
+      ref_glyph(c, x, y, false);
+      break;
+    }
+    case 6:
+    {
+      char c = (char)('0' + rand_r(&seed) % 10);
+      ssd1306_draw_inverted_digit(&ssd, c, x, y);
+      ref_glyph(c, x, y, true);
+      break;
+    }
+    case 7:
+    {
+      const char *str = strings[rand_r(&seed) % (sizeof(strings) / sizeof(strings[0]))];
+      ssd1306_draw_string(&ssd, str, x % WIDTH, y % HEIGHT);
+      ref_string(str, x % WIDTH, y % HEIGHT);
+      break;
+    }
+    case 8:
+      ssd1306_circle(&ssd, x, y, h % 48, value);
+      ref_circle(x, y, h % 48, value);
+      break;
+    default:
+      if (rand_r(&seed) % 8 == 0)
+      {
+        ssd1306_fill(&ssd, value);
+        ref_rect(0, 0, WIDTH, HEIGHT, value, true);
+      }
+      break;
+    }
+    bad_ops += !buffer_matches();
+    if (i % GOLDEN_TOOL_SEND_EVERY == 0)
+    {
+      ssd1306_send_data(&ssd);
+      sends++;
+      bad_sends += !gddram_matches();
+    }
+  }
+  printf("%lu operacoes aleatorias: %lu com o quadro diferente da referencia, %lu de %lu envios com a GDDRAM "
+         "diferente: %s\n",
+         (unsigned long)operations, (unsigned long)bad_ops, (unsigned long)bad_sends, (unsigned long)sends,
+         bad_ops || bad_sends ? "ERRO" : "ok");
+  errors += bad_ops || bad_sends;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 2)
+  {
+    fprintf(stderr, "uso: %s [operacoes]\n", argv[0]);
+    return 2;
+  }
+  uint32_t operations = argc == 2 ? (uint32_t)strtoul(argv[1], NULL, 10) : 20000;
+  ssd1306_host_reset();
+  ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, NULL); // O modelo do host não usa a porta I2C
+  ssd1306_config(&ssd);
+  ssd1306_send_data(&ssd);
+  check_clipping();
+  check_random(operations);
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,191 @@
+#include <string.h>
+#include "ssd1306.h"
+#include "ssd1306_host.h"
+
+static uint8_t gddram[SSD1306_HOST_PAGES * SSD1306_HOST_COLUMNS];
+static uint8_t mem_mode = 2; // Modo de página, padrão após o reset
+static uint8_t col_start, col_end = SSD1306_HOST_COLUMNS - 1, col;
+static uint8_t page_start, page_end = SSD1306_HOST_PAGES - 1, page;
+static uint8_t pending_cmd, pending_args, arg_index, args[2];
+static uint32_t transactions, bus_bytes;
+static void (*frame_hook)(void);
+
+static uint8_t command_args(uint8_t cmd)
+{
+  switch (cmd)
+  {
+  case SET_COL_ADDR:
+  case SET_PAGE_ADDR:
+    return 2;
+  case SET_CONTRAST:
+  case SET_MEM_ADDR:
+  case SET_MUX_RATIO:
+  case SET_DISP_OFFSET:
+  case SET_COM_PIN_CFG:
+  case SET_DISP_CLK_DIV:
+  case SET_PRECHARGE:
+  case SET_VCOM_DESEL:
+  case SET_CHARGE_PUMP:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+static void host_command(uint8_t byte)
+{
+  if (pending_args == 0)
+  {
+    pending_cmd = byte;
+    pending_args = command_args(byte);
+    arg_index = 0;
+    return;
+  }
+  args[arg_index++] = byte;
+  if (arg_index < pending_args)
+    return;
+  pending_args = 0;
+
+  switch (pending_cmd)
+  {
+  case SET_MEM_ADDR:
+    mem_mode = args[0] & 0x03;
+    break;
+  case SET_COL_ADDR:
+    col_start = col = args[0] & 0x7F;
+    col_end = args[1] & 0x7F;
+    break;
+  case SET_PAGE_ADDR:
+    page_start = page = args[0] & 0x07;
+    page_end = args[1] & 0x07;
+    break;
+  default:
+    break;
+  }
+}
+
+static void host_data(uint8_t byte)
+{
+  gddram[page * SSD1306_HOST_COLUMNS + col] = byte;
+  if (mem_mode == 1) // Vertical
+  {
+    if (page++ >= page_end)
+    {
+      page = page_start;
+      col = (col >= col_end) ? col_start : col + 1;
+    }
+  }
+  else if (mem_mode == 0) // Horizontal
+  {
+    if (col++ >= col_end)
+    {
+      col = col_start;
+      page = (page >= page_end) ? page_start : page + 1;
+    }
+  }
+  else if (col < col_end) // Página
+  {
+    col++;
+  }
+}
+
+// Uma transação: byte de controle (Co, D/C) e o que ele governa
+static void host_transaction(const uint8_t *bytes, size_t len)
+{
+  transactions++;
+  bus_bytes += len + 1;
+  size_t i = 0;
+  while (i < len)
+  {
+    uint8_t control = bytes[i++];
+    bool data = control & 0x40;
+    if (!(control & 0x80))
+    {
+      // Co = 0: todos os bytes restantes são do mesmo tipo
+      for (; i < len; i++)
+        data ? host_data(bytes[i]) : host_command(bytes[i]);
+    }
+    else if (i < len)
+    {
+      data ? host_data(bytes[i]) : host_command(bytes[i]);
+      i++;
+    }
+  }
+}
+
+void ssd1306_host_reset(void)
+{
+  memset(gddram, 0, sizeof(gddram));
+  mem_mode = 2;
+  col_start = col = 0;
+  col_end = SSD1306_HOST_COLUMNS - 1;
+  page_start = page = 0;
+  page_end = SSD1306_HOST_PAGES - 1;
+  pending_args = 0;
+  transactions = 0;
+  bus_bytes = 0;
+}
+
+const uint8_t *ssd1306_host_gddram(void)
+{
+  return gddram;
+}
+
+uint32_t ssd1306_host_transactions(void)
+{
+  return transactions;
+}
+
+uint32_t ssd1306_host_bus_bytes(void)
+{
+  return bus_bytes;
+}
+
+void ssd1306_host_set_frame_hook(void (*hook)(void))
+{
+  frame_hook = hook;
+}
+
+void ssd1306_transport_init(ssd1306_t *ssd)
+{
+  ssd->dma_channel = -1;
+}
+
+bool ssd1306_transport_busy(ssd1306_t *ssd)
+{
+  (void)ssd;
+  return false; // O "envio" termina dentro de write_async
+}
+
+void ssd1306_transport_write_blocking(ssd1306_t *ssd, const uint8_t *data, size_t len)
+{
+  (void)ssd;
+  host_transaction(data, len);
+}
+
+void ssd1306_transport_write_async(ssd1306_t *ssd, const uint16_t *words, size_t len)
+{
+  // Quebra o fluxo em transações nas flags de RESTART e STOP, como o controlador I2C
+  uint8_t bytes[SSD1306_HOST_PAGES * SSD1306_HOST_COLUMNS + 16];
+  size_t n = 0;
+  (void)ssd;
+  for (size_t i = 0; i < len; i++)
+  {
+    if ((words[i] & SSD1306_TX_RESTART) && n)
+    {
+      host_transaction(bytes, n);
+      n = 0;
+    }
+    if (n < sizeof(bytes))
+      bytes[n++] = (uint8_t)words[i];
+    if (words[i] & SSD1306_TX_STOP)
+    {
+      host_transaction(bytes, n);
+      n = 0;
+    }
+  }
+  if (n)
+    host_transaction(bytes, n);
+  if (frame_hook)
+    frame_hook();
+}
@@ -0,0 +1,20 @@
+#ifndef SSD1306_HOST_H
+#define SSD1306_HOST_H
+
+#include <stdint.h>
+
+// Transporte do SSD1306 para o host: em vez do I2C, cada transação é
+// interpretada por um modelo do controlador (comandos de endereçamento e
+// escrita na GDDRAM). Comparar a GDDRAM resultante com o ram_buffer verifica
+// que o fluxo de bytes assíncrono desenha o mesmo que o envio bloqueante.
+
+#define SSD1306_HOST_COLUMNS 128
+#define SSD1306_HOST_PAGES 8
+
+void ssd1306_host_reset(void);
+const uint8_t *ssd1306_host_gddram(void); // [página * 128 + coluna]
+uint32_t ssd1306_host_transactions(void);
+uint32_t ssd1306_host_bus_bytes(void);    // Inclui o byte de endereço de cada transação
+void ssd1306_host_set_frame_hook(void (*hook)(void)); // Chamado após cada envio assíncrono
+
+#endif
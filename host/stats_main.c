@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "acquisition.h"
+#include "acquisition_replay.h"
+#include "level_stats.h"
+#include "noise_level.h"
+#include "weighting.h"
+
+// Confere os percentis de lib/level_stats.c contra a ordenação exata: guarda
+// o RMS de todos os blocos de cada intervalo e, quando o intervalo fecha,
+// ordena e compara L10/L50/L90 com a classe do valor exato na mesma posição
+// (têm que ser iguais) e Lmax/Lmin com os extremos (exatos). Imprime também
+// o maior desvio dos percentis para o valor exato sem classes (menor que
+// 0,5 dB). Sem arquivo, começa por um minuto com uma sequência conhecida,
+// cujos L10/L50/L90/Lmax/Lmin esperados estão em known_expected, e segue com
+// níveis pseudoaleatórios por 31 minutos e um nível constante que satura os
+// contadores; com uma gravação, o RMS vem do mesmo caminho do núcleo 1
+// (remoção de DC, ponderação A e Fast). Sai com 1 se algo não bate.
+//
+// Uso: detector_stats [audio.wav|.raw]
+
+#define STATS_TOOL_RATE 8000
+#define STATS_TOOL_MAX_BLOCKS 140000 // Maior intervalo verificado (o de saturação tem 120000 blocos)
+
+static uint16_t blocks[LEVEL_STATS_INTERVALS][STATS_TOOL_MAX_BLOCKS];
+static uint32_t counts[LEVEL_STATS_INTERVALS];
+static level_stats_t stats;
+static int16_t mic_block[ACQ_BLOCK_SAMPLES];
+static int errors;
+static int worst_x10; // Maior desvio de um percentil para o valor exato sem classes
+
+static int compare_desc(const void *a, const void *b)
+{
+  return (int)*(const uint16_t *)b - (int)*(const uint16_t *)a;
+}
+
+static int16_t dbfs_x10(uint16_t rms)
+{
+  return rms ? level_dbfs_x10((uint64_t)rms * rms) : INT16_MIN;
+}
+
+// Compara o intervalo que acabou de fechar com os blocos guardados dele
+static void check_interval(level_stats_interval_t interval)
+{
+  static const uint8_t percents[3] = {10, 50, 90};
+  static const char *const names[LEVEL_STATS_INTERVALS] = {"1min", "15min"};
+  level_stats_result_t r;
+  uint16_t *v = blocks[interval];
+  uint32_t n = counts[interval];
+  if (!level_stats_get(&stats, interval, false, &r))
+  {
+    printf("%s: intervalo fechado sem resultado\n", names[interval]);
+    errors++;
+    return;
+  }
+  qsort(v, n, sizeof(v[0]), compare_desc);
+  int16_t got[3] = {r.l10, r.l50, r.l90};
+  int16_t expected[3];
+  bool ok = r.blocks == n && r.lmax == dbfs_x10(v[0]) && r.lmin == dbfs_x10(v[n - 1]);
+  for (int i = 0; i < 3; i++)
+  {
+    uint16_t exact = v[n * percents[i] / 100];
+    expected[i] = level_stats_bin_dbfs_x10(level_stats_bin(exact));
+    ok = ok && got[i] == expected[i];
+    int16_t exact_db = dbfs_x10(exact);
+    if (exact_db != INT16_MIN && exact_db >= LEVEL_STATS_DB_MIN_X10 && exact_db - got[i] > worst_x10)
+      worst_x10 = exact_db - got[i];
+  }
+  printf("%s #%lu: %lu blocos, L10 %d L50 %d L90 %d (exato %d %d %d), Lmax %d Lmin %d (decimos de dBFS): %s\n",
+         names[interval], (unsigned long)level_stats_completed(&stats, interval), (unsigned long)n, got[0], got[1],
+         got[2], expected[0], expected[1], expected[2], r.lmax, r.lmin, ok ? "ok" : "ERRO");
+  errors += !ok;
+}
+
+static void add(uint16_t rms)
+{
+  uint32_t before[LEVEL_STATS_INTERVALS];
+  for (int i = 0; i < LEVEL_STATS_INTERVALS; i++)
+  {
+    before[i] = level_stats_completed(&stats, (level_stats_interval_t)i);
+    if (counts[i] < STATS_TOOL_MAX_BLOCKS)
+      blocks[i][counts[i]++] = rms;
+  }
+  level_stats_add(&stats, rms);
+  for (int i = 0; i < LEVEL_STATS_INTERVALS; i++)
+  {
+    if (level_stats_completed(&stats, (level_stats_interval_t)i) != before[i])
+    {
+      check_interval((level_stats_interval_t)i);
+      counts[i] = 0;
+    }
+  }
+}
+
+static void reset(uint32_t samples_per_block, uint32_t rate)
+{
+  level_stats_init(&stats, samples_per_block, rate);
+  for (int i = 0; i < LEVEL_STATS_INTERVALS; i++)
+    counts[i] = 0;
+}
+
+static int run_file(const char *path)
+{
+  if (!acq_replay_open(path))
+  {
+    fprintf(stderr, "nao foi possivel abrir %s\n", path);
+    return 2;
+  }
+  uint32_t rate = acq_replay_sample_rate();
+  if (rate == 0)
+    rate = STATS_TOOL_RATE;
+  dc_blocker_t dc;
+  weighting_filter_t weighting;
+  time_weighting_t time_weighting;
+  dc_blocker_init(&dc);
+  weighting_filter_init(&weighting, WEIGHTING_A, rate);
+  time_weighting_init(&time_weighting, TIME_WEIGHTING_FAST, rate);
+  reset(ACQ_BLOCK_SAMPLES, rate);
+  acq_init(rate);
+  acq_start();
+  while (!acq_replay_eof())
+  {
+    acq_replay_pump(1);
+    acq_block_t block;
+    while (acq_get_block(&block))
+    {
+      dc_blocker_process(&dc, block.samples, mic_block, block.len);
+      acq_release_block(&block);
+      weighting_filter_process(&weighting, mic_block, block.len);
+      time_weighting_process(&time_weighting, mic_block, block.len);
+      add(time_weighting_rms(&time_weighting));
+    }
+  }
+  acq_replay_close();
+  if (level_stats_completed(&stats, LEVEL_STATS_MINUTE) == 0)
+    printf("gravacao mais curta que 1 minuto: nenhum intervalo fechado\n");
+  return 0;
+}
+
+// Um minuto (1875 blocos) de níveis conhecidos, embaralhados: 1 bloco a -3,0
+// dBFS (RMS 1450), 93 a -10,0 (648), 375 a -20,0 (205), 938 a -40,2 (20), 467
+// a -60,2 (2) e 1 a -66,2 (1). Em ordem decrescente, as posições dos
+// percentis (187, 937 e 1687) caem no meio dos patamares de -20,0, -40,2 e
+// -60,2 dBFS, e os percentis são o limite de baixo das classes deles. Lmax
+// e Lmin saem de level_dbfs_x10, que arredonda para baixo (-66,23 é -663)
+static const struct
+{
+  uint16_t rms;
+  uint16_t count;
+} known_levels[] = {{1450, 1}, {648, 93}, {205, 375}, {20, 938}, {2, 467}, {1, 1}};
+static const level_stats_result_t known_expected = {-200, -405, -605, -30, -663, 1875};
+
+static void check_known(void)
+{
+  reset(ACQ_BLOCK_SAMPLES, STATS_TOOL_RATE);
+  uint32_t total = 0;
+  for (size_t i = 0; i < sizeof(known_levels) / sizeof(known_levels[0]); i++)
+    total += known_levels[i].count;
+  for (uint32_t b = 0; b < total; b++)
+  {
+    uint32_t k = b * 7919u % total; // Permutação: 7919 é primo com 1875
+    size_t i = 0;
+    while (k >= known_levels[i].count)
+      k -= known_levels[i++].count;
+    add(known_levels[i].rms);
+  }
+  level_stats_result_t r = {0};
+  bool closed = level_stats_get(&stats, LEVEL_STATS_MINUTE, false, &r);
+  const level_stats_result_t *e = &known_expected;
+  bool ok = closed && r.l10 == e->l10 && r.l50 == e->l50 && r.l90 == e->l90 && r.lmax == e->lmax &&
+            r.lmin == e->lmin && r.blocks == e->blocks;
+  printf("Sequencia conhecida: L10 %d L50 %d L90 %d Lmax %d Lmin %d em %lu blocos (esperado %d %d %d %d %d em %lu): "
+         "%s\n",
+         r.l10, r.l50, r.l90, r.lmax, r.lmin, (unsigned long)r.blocks, e->l10, e->l50, e->l90, e->lmax, e->lmin,
+         (unsigned long)e->blocks, ok ? "ok" : "ERRO");
+  errors += !ok;
+}
+
+static void run_synthetic(void)
+{
+  check_known();
+
+  // Níveis log-uniformes de -66 a 0 dBFS, com trechos de silêncio (RMS 0) e picos
+  uint32_t seed = 1;
+  uint32_t total = 31 * 60 * STATS_TOOL_RATE / ACQ_BLOCK_SAMPLES;
+  reset(ACQ_BLOCK_SAMPLES, STATS_TOOL_RATE);
+  for (uint32_t b = 0; b < total; b++)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    uint32_t shift = (seed >> 8) % 11;
+    uint16_t rms = (uint16_t)((1u << shift) + ((seed >> 16) & ((1u << shift) - 1)));
+    if ((seed >> 28) == 0)
+      rms = 0;
+    add(rms);
+  }
+
+  // Um nível constante por mais blocos do que um contador de 16 bits aguenta
+  // (blocos de 1 amostra a 2 kHz: 120000 blocos por minuto)
+  reset(1, 2000);
+  for (uint32_t b = 0; b < 120000; b++)
+    add(300);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 2)
+  {
+    fprintf(stderr, "uso: %s [audio.wav|.raw]\n", argv[0]);
+    return 2;
+  }
+  if (argc == 2)
+  {
+    int rc = run_file(argv[1]);
+    if (rc)
+      return rc;
+  }
+  else
+    run_synthetic();
+
+  printf("Maior desvio de um percentil para o valor exato: %d.%d dB (classes de %d.%d dB)\n", worst_x10 / 10,
+         worst_x10 % 10, LEVEL_STATS_BIN_X10 / 10, LEVEL_STATS_BIN_X10 % 10);
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,244 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "acquisition.h"
+#include "tone_bank.h"
+
+// Passa tons sintéticos pelo banco de detectores de tom (lib/tone_bank.c),
+// em blocos do tamanho dos da aquisição, e confere para cada detector:
+//  - o nível medido de um tom na frequência do detector (fase e frequência
+//    fora do centro da raia quaisquer), a até TONE_TOOL_LEVEL_TOL_X10 do nível
+//    injetado;
+//  - um tom acima do limiar ativa o detector no bloco TONE_BANK_HOLD_BLOCKS, e
+//    não antes; um tom abaixo do limiar nunca ativa;
+//  - um tom forte a três raias ou mais de todos os detectores não ativa nenhum;
+//  - a onda quadrada do buzzer sozinha ativa os detectores mascaráveis e só
+//    eles; com o SOS tocando, não ativa os detectores sobre ele, os outros
+//    continuam detectando, e a máscara dura
+//    TONE_BANK_MASK_TAIL_BLOCKS blocos depois do fim do SOS.
+// Sai com 1 se algo não bate.
+//
+// Uso: detector_tone [frequencia_do_buzzer_hz]
+
+#define TONE_TOOL_RATE 8000
+#define TONE_TOOL_BUZZER_HZ 2000
+#define TONE_TOOL_LEVEL_TOL_X10 10 // 1 dB
+#define TONE_TOOL_LOUD_X10 -60     // Nível do tom fora de frequência (-6 dBFS)
+#define TONE_TOOL_BLOCKS 20        // Blocos de cada caso de ativação
+
+typedef struct
+{
+  double freq;
+  double amplitude; // Em códigos do ADC
+  double phase;
+  bool square;      // Onda quadrada (o buzzer, com as harmônicas ímpares)
+} tone_t;
+
+static int16_t block[ACQ_BLOCK_SAMPLES];
+static tone_bank_t bank;
+static int errors;
+
+// Amplitude de um seno com o nível dado em décimos de dBFS (na escala do nível
+// do microfone, o quadrado médio de 2048 é 0 dBFS)
+static double amplitude_for(int level_x10)
+{
+  return 2048.0 * sqrt(2.0) * pow(10.0, level_x10 / 200.0);
+}
+
+// Soma os tons no bloco seguinte, arredondando como o bloco sem DC do núcleo 1
+static void synthesize(const tone_t *tones, int count, uint32_t index)
+{
+  for (size_t n = 0; n < ACQ_BLOCK_SAMPLES; n++)
+  {
+    double t = (double)(index * ACQ_BLOCK_SAMPLES + n) / TONE_TOOL_RATE;
+    double v = 0;
+    for (int i = 0; i < count; i++)
+    {
+      double s = sin(2.0 * M_PI * tones[i].freq * t + tones[i].phase);
+      v += tones[i].amplitude * (tones[i].square ? (s >= 0 ? 1.0 : -1.0) : s);
+    }
+    long code = lround(v);
+    block[n] = (int16_t)(code < -2048 ? -2048 : code > 2047 ? 2047 : code);
+  }
+}
+
+// Roda blocks blocos dos tons e devolve o bloco (1 em diante) em que cada
+// detector ficou ativo pela primeira vez (0: nunca)
+static void run(const tone_t *tones, int count, uint32_t blocks, bool mask, uint32_t *first_active)
+{
+  tone_bank_reset(&bank);
+  for (uint8_t d = 0; d < tone_bank_count(); d++)
+    first_active[d] = 0;
+  for (uint32_t b = 0; b < blocks; b++)
+  {
+    synthesize(tones, count, b);
+    uint8_t active = tone_bank_process(&bank, block, ACQ_BLOCK_SAMPLES, mask);
+    for (uint8_t d = 0; d < tone_bank_count(); d++)
+    {
+      if ((active & (1u << d)) && !first_active[d])
+        first_active[d] = b + 1;
+    }
+  }
+}
+
+static void check(bool ok, const char *what, uint8_t d)
+{
+  printf("%-8s %s: %s\n", tone_bank_name(d), what, ok ? "ok" : "ERRO");
+  errors += !ok;
+}
+
+// Nível medido contra o injetado, em frequências e fases espalhadas pela raia
+static void check_levels(uint8_t d)
+{
+  static const double offsets[] = {0.0, -7.0, 5.5, 11.0};
+  static const int levels_x10[] = {-100, -250, -400};
+  int worst = 0;
+  for (size_t o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++)
+  {
+    for (size_t l = 0; l < sizeof(levels_x10) / sizeof(levels_x10[0]); l++)
+    {
+      for (int p = 0; p < 4; p++)
+      {
+        tone_t tone = {tone_bank_freq_hz(d) + offsets[o], amplitude_for(levels_x10[l]), p * 0.7, false};
+        synthesize(&tone, 1, 0);
+        tone_bank_process(&bank, block, ACQ_BLOCK_SAMPLES, false);
+        int error = abs(bank.level_x10[d] - levels_x10[l]);
+        if (error > worst)
+          worst = error;
+      }
+    }
+  }
+  char what[64];
+  snprintf(what, sizeof(what), "nivel a ate 11 Hz do centro, maior erro %d.%d dB", worst / 10, worst % 10);
+  check(worst <= TONE_TOOL_LEVEL_TOL_X10, what, d);
+}
+
+// Acima do limiar ativa exatamente no bloco TONE_BANK_HOLD_BLOCKS; abaixo nunca
+static void check_threshold(uint8_t d)
+{
+  uint32_t first[TONE_BANK_MAX_DETECTORS];
+  tone_t tone = {tone_bank_freq_hz(d), amplitude_for(tone_bank_threshold_x10(d) + 30), 0.3, false};
+  run(&tone, 1, TONE_TOOL_BLOCKS, false, first);
+  check(first[d] == TONE_BANK_HOLD_BLOCKS, "3 dB acima do limiar ativa no bloco de confirmacao", d);
+
+  tone.amplitude = amplitude_for(tone_bank_threshold_x10(d) - 30);
+  run(&tone, 1, TONE_TOOL_BLOCKS, false, first);
+  check(first[d] == 0, "3 dB abaixo do limiar nao ativa", d);
+}
+
+// Um tom forte a três raias ou mais de todos os detectores não ativa nenhum
+static void check_selectivity(void)
+{
+  double bin = (double)TONE_TOOL_RATE / ACQ_BLOCK_SAMPLES;
+  int tested = 0, false_alarms = 0;
+  for (double f = 60.0; f < TONE_TOOL_RATE / 2 - 60.0; f += 37.0)
+  {
+    bool far = true;
+    for (uint8_t d = 0; d < tone_bank_count(); d++)
+      far = far && fabs(f - tone_bank_freq_hz(d)) >= 3 * bin;
+    if (!far)
+      continue;
+    uint32_t first[TONE_BANK_MAX_DETECTORS];
+    tone_t tone = {f, amplitude_for(TONE_TOOL_LOUD_X10), 0.0, false};
+    run(&tone, 1, TONE_BANK_HOLD_BLOCKS + 2, false, first);
+    tested++;
+    for (uint8_t d = 0; d < tone_bank_count(); d++)
+    {
+      if (first[d])
+      {
+        printf("%-8s ativado por um tom em %.0f Hz\n", tone_bank_name(d), f);
+        false_alarms++;
+      }
+    }
+  }
+  printf("Seletividade: %d tons a %d.%d dBFS a 3 raias ou mais dos detectores, %d ativacoes: %s\n", tested,
+         TONE_TOOL_LOUD_X10 / 10, -TONE_TOOL_LOUD_X10 % 10, false_alarms, false_alarms ? "ERRO" : "ok");
+  errors += false_alarms != 0;
+}
+
+// O buzzer (onda quadrada) com o SOS tocando, junto de um tom em cada
+// detector que não está sobre ele
+static void check_mask(uint32_t buzzer_hz)
+{
+  tone_t tones[1 + TONE_BANK_MAX_DETECTORS];
+  int count = 0;
+  // Fase fora dos cruzamentos por zero: uma amostra em sin = 0 sairia com o sinal errado pelo arredondamento
+  tones[count++] = (tone_t){buzzer_hz, amplitude_for(-60), 0.25, true};
+  for (uint8_t d = 0; d < tone_bank_count(); d++)
+  {
+    if (!(bank.maskable & (1u << d)))
+      tones[count++] = (tone_t){tone_bank_freq_hz(d), amplitude_for(tone_bank_threshold_x10(d) + 60), d * 0.9, false};
+  }
+
+  // Sem o SOS, o buzzer ativa os detectores sobre ele e só eles: um detector
+  // que o buzzer ativa fora da máscara dispararia com o próprio SOS
+  uint32_t first[TONE_BANK_MAX_DETECTORS];
+  run(tones, 1, TONE_TOOL_BLOCKS, false, first);
+  for (uint8_t d = 0; d < tone_bank_count(); d++)
+  {
+    if (bank.maskable & (1u << d))
+      check(first[d] != 0, "buzzer sem o SOS ativa", d);
+    else
+      check(first[d] == 0, "buzzer sozinho nao ativa fora da mascara", d);
+  }
+
+  // Com o SOS, só os outros detectores ativam
+  run(tones, count, TONE_TOOL_BLOCKS, true, first);
+  for (uint8_t d = 0; d < tone_bank_count(); d++)
+  {
+    if (bank.maskable & (1u << d))
+      check(first[d] == 0, "buzzer com o SOS mascarado", d);
+    else
+      check(first[d] == TONE_BANK_HOLD_BLOCKS, "ativa com o buzzer mascarado tocando junto", d);
+  }
+
+  // O SOS para no bloco TONE_TOOL_BLOCKS e o buzzer continua (o eco, no
+  // pior caso): a máscara segue por TONE_BANK_MASK_TAIL_BLOCKS blocos e depois
+  // a confirmação recomeça do zero
+  tone_bank_reset(&bank);
+  uint32_t released = 0;
+  for (uint32_t b = 0; b < 2 * TONE_TOOL_BLOCKS; b++)
+  {
+    synthesize(tones, 1, b);
+    uint8_t active = tone_bank_process(&bank, block, ACQ_BLOCK_SAMPLES, b < TONE_TOOL_BLOCKS);
+    if ((active & bank.maskable) && !released)
+      released = b + 1;
+  }
+  if (bank.maskable)
+  {
+    char what[64];
+    snprintf(what, sizeof(what), "volta a ativar no bloco %lu depois do fim do SOS",
+             (unsigned long)(released - TONE_TOOL_BLOCKS));
+    check(released == TONE_TOOL_BLOCKS + TONE_BANK_MASK_TAIL_BLOCKS + TONE_BANK_HOLD_BLOCKS, what,
+          (uint8_t)__builtin_ctz(bank.maskable));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 2)
+  {
+    fprintf(stderr, "uso: %s [frequencia_do_buzzer_hz]\n", argv[0]);
+    return 2;
+  }
+  uint32_t buzzer_hz = argc == 2 ? (uint32_t)strtoul(argv[1], NULL, 10) : TONE_TOOL_BUZZER_HZ;
+  tone_bank_init(&bank, buzzer_hz);
+
+  printf("%u detectores, buzzer em %lu Hz\n", tone_bank_count(), (unsigned long)buzzer_hz);
+  for (uint8_t d = 0; d < tone_bank_count(); d++)
+  {
+    int t = tone_bank_threshold_x10(d);
+    printf("%-8s %u Hz, limiar %s%d.%d dBFS%s\n", tone_bank_name(d), tone_bank_freq_hz(d), t < 0 ? "-" : "",
+           abs(t) / 10, abs(t) % 10, (bank.maskable & (1u << d)) ? ", mascarado durante o SOS" : "");
+  }
+  for (uint8_t d = 0; d < tone_bank_count(); d++)
+  {
+    check_levels(d);
+    check_threshold(d);
+  }
+  check_selectivity();
+  check_mask(buzzer_hz);
+
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,122 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "usb_link.h"
+
+#define USB_LINK_RX_BYTES 64
+
+static int master_fd = -1;
+static int slave_fd = -1; // Mantido aberto: o pty não dá EIO entre conexões do leitor
+static uint8_t fifo[USB_LINK_FIFO_BYTES];
+static size_t fifo_head, fifo_count; // fifo_head: próximo byte a sair
+static uint8_t rx[USB_LINK_RX_BYTES];
+static size_t rx_head, rx_count;
+static char *link_path;
+
+static ssize_t stdout_cookie_write(void *cookie, const char *buf, size_t size)
+{
+  (void)cookie;
+  usb_link_write((const uint8_t *)buf, size);
+  return (ssize_t)size;
+}
+
+static void remove_link(void)
+{
+  unlink(link_path); // O escravo some junto com o processo
+}
+
+bool usb_link_open_pty(const char *symlink_path)
+{
+  master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master_fd < 0 || grantpt(master_fd) < 0 || unlockpt(master_fd) < 0)
+    return false;
+  const char *slave_name = ptsname(master_fd);
+  slave_fd = open(slave_name, O_RDWR | O_NOCTTY);
+  if (slave_fd < 0)
+    return false;
+
+  // Modo cru nos dois sentidos: os quadros binários passam sem tradução
+  struct termios tio;
+  tcgetattr(slave_fd, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(slave_fd, TCSANOW, &tio);
+  fcntl(master_fd, F_SETFL, fcntl(master_fd, F_GETFL) | O_NONBLOCK);
+
+  if (symlink_path)
+  {
+    unlink(symlink_path);
+    if (symlink(slave_name, symlink_path) < 0)
+      return false;
+    link_path = strdup(symlink_path);
+    atexit(remove_link);
+  }
+  fprintf(stderr, "Link USB simulado em %s\n", symlink_path ? symlink_path : slave_name);
+
+  // O printf do firmware passa a usar o mesmo FIFO dos quadros
+  static cookie_io_functions_t io = {.write = stdout_cookie_write};
+  FILE *link = fopencookie(NULL, "w", io);
+  if (!link)
+    return false;
+  setvbuf(link, NULL, _IOLBF, 256);
+  stdout = link;
+  return true;
+}
+
+void usb_link_poll(void)
+{
+  if (master_fd < 0)
+    return;
+
+  while (fifo_count)
+  {
+    size_t chunk = fifo_count;
+    if (fifo_head + chunk > USB_LINK_FIFO_BYTES)
+      chunk = USB_LINK_FIFO_BYTES - fifo_head;
+    ssize_t n = write(master_fd, fifo + fifo_head, chunk);
+    if (n <= 0)
+      break; // EAGAIN: o leitor ainda não consumiu o que está no pty
+    fifo_head = (fifo_head + (size_t)n) % USB_LINK_FIFO_BYTES;
+    fifo_count -= (size_t)n;
+  }
+
+  while (rx_count < USB_LINK_RX_BYTES)
+  {
+    uint8_t c;
+    if (read(master_fd, &c, 1) != 1)
+      break;
+    rx[(rx_head + rx_count++) % USB_LINK_RX_BYTES] = c;
+  }
+}
+
+void usb_link_write(const uint8_t *data, size_t len)
+{
+  if (master_fd < 0)
+  {
+    fwrite(data, 1, len, stdout);
+    return;
+  }
+  for (size_t i = 0; i < len && fifo_count < USB_LINK_FIFO_BYTES; i++)
+    fifo[(fifo_head + fifo_count++) % USB_LINK_FIFO_BYTES] = data[i];
+}
+
+size_t usb_link_space(void)
+{
+  if (master_fd < 0)
+    return SIZE_MAX;
+  return USB_LINK_FIFO_BYTES - fifo_count;
+}
+
+int usb_link_getchar(void)
+{
+  if (rx_count == 0)
+    return -1;
+  uint8_t c = rx[rx_head];
+  rx_head = (rx_head + 1) % USB_LINK_RX_BYTES;
+  rx_count--;
+  return c;
+}
@@ -0,0 +1,23 @@
+#ifndef USB_LINK_H
+#define USB_LINK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// USB CDC simulada para o simulador. Sem usb_link_open_pty() tudo vai direto
+// para stdout, sem limite de espaço. Com ela, o printf e os quadros passam por
+// um FIFO do tamanho do FIFO de transmissão do firmware, drenado para um
+// pseudo-terminal por usb_link_poll(); o que o outro lado do pty escreve
+// chega por getchar_timeout_us(). Um leitor lento enche o FIFO e exercita a
+// contrapressão do streaming exatamente como a CDC real.
+
+#define USB_LINK_FIFO_BYTES 2048 // CFG_TUD_CDC_TX_BUFSIZE do firmware
+
+bool usb_link_open_pty(const char *symlink_path); // Cria o pty e o link simbólico para o escravo
+void usb_link_poll(void);
+void usb_link_write(const uint8_t *data, size_t len); // O que não cabe é perdido, como no stdio USB
+size_t usb_link_space(void);
+int usb_link_getchar(void); // -1 sem dados
+
+#endif
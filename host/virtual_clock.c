@@ -0,0 +1,99 @@
+#include <stddef.h>
+#include "virtual_clock.h"
+
+typedef struct
+{
+  bool active;
+  uint64_t deadline_us;
+  vclock_callback_t callback;
+  void *user;
+} vclock_alarm_t;
+
+static uint64_t now_us;
+static vclock_alarm_t alarms[VCLOCK_MAX_ALARMS];
+static void (*after_alarm_hook)(void);
+
+void vclock_reset(uint64_t start_us)
+{
+  now_us = start_us;
+  for (int i = 0; i < VCLOCK_MAX_ALARMS; i++)
+    alarms[i].active = false;
+}
+
+uint64_t vclock_now_us(void)
+{
+  return now_us;
+}
+
+// Alarme ativo de menor prazo; empates vão para o de menor índice (o mais antigo)
+static int earliest_alarm(void)
+{
+  int best = -1;
+  for (int i = 0; i < VCLOCK_MAX_ALARMS; i++)
+  {
+    if (alarms[i].active && (best < 0 || alarms[i].deadline_us < alarms[best].deadline_us))
+      best = i;
+  }
+  return best;
+}
+
+void vclock_advance_to(uint64_t t_us)
+{
+  int i;
+  while ((i = earliest_alarm()) >= 0 && alarms[i].deadline_us <= t_us)
+  {
+    if (alarms[i].deadline_us > now_us)
+      now_us = alarms[i].deadline_us;
+    uint64_t next = alarms[i].callback(alarms[i].user);
+    // O callback pode ter cancelado ou reaproveitado o próprio slot
+    if (alarms[i].active && alarms[i].deadline_us <= now_us)
+    {
+      if (next == 0)
+        alarms[i].active = false;
+      else
+        alarms[i].deadline_us += next;
+    }
+    if (after_alarm_hook)
+      after_alarm_hook();
+  }
+  if (t_us > now_us)
+    now_us = t_us;
+}
+
+void vclock_advance_us(uint64_t us)
+{
+  vclock_advance_to(now_us + us);
+}
+
+bool vclock_next_deadline(uint64_t *t_us)
+{
+  int i = earliest_alarm();
+  if (i < 0)
+    return false;
+  *t_us = alarms[i].deadline_us;
+  return true;
+}
+
+int vclock_add_alarm(uint64_t delay_us, vclock_callback_t callback, void *user)
+{
+  for (int i = 0; i < VCLOCK_MAX_ALARMS; i++)
+  {
+    if (!alarms[i].active)
+    {
+      alarms[i] = (vclock_alarm_t){true, now_us + delay_us, callback, user};
+      return i;
+    }
+  }
+  return -1;
+}
+
+void vclock_cancel_alarm(int id)
+{
+  if (id >= 0 && id < VCLOCK_MAX_ALARMS)
+    alarms[id].active = false;
+}
+
+void vclock_set_after_alarm_hook(void (*hook)(void))
+{
+  after_alarm_hook = hook;
+}
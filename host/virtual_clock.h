@@ -0,0 +1,29 @@
+#ifndef VIRTUAL_CLOCK_H
+#define VIRTUAL_CLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Relógio virtual em µs compartilhado pelos backends do host. O tempo só anda
+// quando alguém chama vclock_advance_*(); os alarmes vencidos no caminho são
+// disparados em ordem, cada um no seu instante exato, como as IRQs do timer.
+
+#define VCLOCK_MAX_ALARMS 16
+
+// Retorna 0 para encerrar o alarme ou o atraso em µs até o próximo disparo,
+// contado a partir do instante em que este venceu (como repeating_timer)
+typedef uint64_t (*vclock_callback_t)(void *user);
+
+void vclock_reset(uint64_t start_us);
+uint64_t vclock_now_us(void);
+void vclock_advance_us(uint64_t us);
+void vclock_advance_to(uint64_t t_us);
+bool vclock_next_deadline(uint64_t *t_us);
+
+int vclock_add_alarm(uint64_t delay_us, vclock_callback_t callback, void *user); // -1 sem espaço
+void vclock_cancel_alarm(int id);
+
+// Chamado depois de cada alarme disparado (o simulador usa para dar a vez ao núcleo 1)
+void vclock_set_after_alarm_hook(void (*hook)(void));
+
+#endif
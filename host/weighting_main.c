@@ -0,0 +1,132 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "acquisition.h"
+#include "weighting.h"
+
+// Varre senos pelas ponderações A e C em ponto fixo (lib/weighting.c, seções
+// de generated/weighting_coeffs.h) a 8 kHz, em blocos do tamanho dos da
+// aquisição, e compara o ganho medido em cada frequência de terço de oitava
+// de 10 Hz a 3,15 kHz com os valores nominais da IEC 61672-1 e os limites de
+// aceitação da classe 1. O ganho é a razão entre os RMS de saída e de entrada
+// depois de o filtro assentar, com a média da saída removida (o arredondamento
+// para 16 bits não entra como ganho). Sai com 1 se algum ponto fica fora dos
+// limites. O custo por amostra no RP2040 sai do caso
+// weighting_block do detector_bench.
+//
+// Uso: detector_weighting
+
+#define WEIGHTING_TOOL_RATE 8000
+#define WEIGHTING_TOOL_AMPLITUDE 4000.0 // Pico do seno em códigos (perto do fundo de escala do bloco sem DC)
+#define WEIGHTING_TOOL_SETTLE_S 2       // Descartado enquanto as seções assentam
+#define WEIGHTING_TOOL_MEASURE_S 4
+
+typedef struct
+{
+  double nominal; // Frequência nominal (a exata é 1000·10^(n/10))
+  double a_db;    // Ponderações nominais da IEC 61672-1
+  double c_db;
+  double tol_plus; // Limites de aceitação da classe 1 (INFINITY: sem limite de baixo)
+  double tol_minus;
+} iec_point_t;
+
+static const iec_point_t iec_points[] = {
+    {10, -70.4, -14.3, 3.5, INFINITY},
+    {12.5, -63.4, -11.2, 3.0, INFINITY},
+    {16, -56.7, -8.5, 2.5, 4.5},
+    {20, -50.5, -6.2, 2.5, 2.5},
+    {25, -44.7, -4.4, 2.0, 2.0},
+    {31.5, -39.4, -3.0, 1.5, 1.5},
+    {40, -34.6, -2.0, 1.0, 1.0},
+    {50, -30.2, -1.3, 1.0, 1.0},
+    {63, -26.2, -0.8, 1.0, 1.0},
+    {80, -22.5, -0.5, 1.0, 1.0},
+    {100, -19.1, -0.3, 1.0, 1.0},
+    {125, -16.1, -0.2, 1.0, 1.0},
+    {160, -13.4, -0.1, 1.0, 1.0},
+    {200, -10.9, 0.0, 1.0, 1.0},
+    {250, -8.6, 0.0, 1.0, 1.0},
+    {315, -6.6, 0.0, 1.0, 1.0},
+    {400, -4.8, 0.0, 1.0, 1.0},
+    {500, -3.2, 0.0, 1.0, 1.0},
+    {630, -1.9, 0.0, 1.0, 1.0},
+    {800, -0.8, 0.0, 1.0, 1.0},
+    {1000, 0.0, 0.0, 0.7, 0.7},
+    {1250, 0.6, 0.0, 1.0, 1.0},
+    {1600, 1.0, -0.1, 1.0, 1.0},
+    {2000, 1.2, -0.2, 1.0, 1.0},
+    {2500, 1.3, -0.3, 1.0, 1.0},
+    {3150, 1.2, -0.5, 1.0, 1.0},
+};
+
+static int16_t block[ACQ_BLOCK_SAMPLES];
+static int errors;
+
+// Ganho em dB de um seno na frequência f pela ponderação
+static double measure_gain(freq_weighting_t weighting, double f)
+{
+  weighting_filter_t filter;
+  weighting_filter_init(&filter, weighting, WEIGHTING_TOOL_RATE);
+  uint32_t settle = WEIGHTING_TOOL_SETTLE_S * WEIGHTING_TOOL_RATE;
+  uint32_t total = settle + WEIGHTING_TOOL_MEASURE_S * WEIGHTING_TOOL_RATE;
+  double in_energy = 0, out_sum = 0, out_energy = 0;
+  uint32_t measured = 0;
+  for (uint32_t start = 0; start < total; start += ACQ_BLOCK_SAMPLES)
+  {
+    for (size_t n = 0; n < ACQ_BLOCK_SAMPLES; n++)
+    {
+      double v = WEIGHTING_TOOL_AMPLITUDE * sin(2.0 * M_PI * f * (start + n) / WEIGHTING_TOOL_RATE);
+      block[n] = (int16_t)lround(v);
+      if (start >= settle)
+        in_energy += (double)block[n] * block[n];
+    }
+    weighting_filter_process(&filter, block, ACQ_BLOCK_SAMPLES);
+    if (start < settle)
+      continue;
+    for (size_t n = 0; n < ACQ_BLOCK_SAMPLES; n++)
+    {
+      out_sum += block[n];
+      out_energy += (double)block[n] * block[n];
+    }
+    measured += ACQ_BLOCK_SAMPLES;
+  }
+  double mean = out_sum / measured;
+  double out_ac = out_energy / measured - mean * mean;
+  return 10.0 * log10(out_ac / (in_energy / measured));
+}
+
+// Ganho medido contra o nominal nas duas ponderações
+static void check_point(const iec_point_t *p, double *worst)
+{
+  static const freq_weighting_t weightings[2] = {WEIGHTING_A, WEIGHTING_C};
+  double nominal[2] = {p->a_db, p->c_db};
+  double exact = 1000.0 * pow(10.0, round(10.0 * log10(p->nominal / 1000.0)) / 10.0);
+  bool ok = true;
+  printf("%6g Hz", p->nominal);
+  for (int w = 0; w < 2; w++)
+  {
+    double measured = measure_gain(weightings[w], exact);
+    double deviation = measured - nominal[w];
+    ok = ok && deviation <= p->tol_plus && deviation >= -p->tol_minus;
+    if (fabs(deviation) > fabs(worst[w]))
+      worst[w] = deviation;
+    printf("  %c %7.2f dB (IEC %5.1f, desvio %+.2f)", w ? 'C' : 'A', measured, nominal[w], deviation);
+  }
+  printf(": %s\n", ok ? "ok" : "ERRO");
+  errors += !ok;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    fprintf(stderr, "uso: %s\n", argv[0]);
+    return 2;
+  }
+  double worst[2] = {0, 0};
+  for (size_t i = 0; i < sizeof(iec_points) / sizeof(iec_points[0]); i++)
+    check_point(&iec_points[i], worst);
+  printf("Maior desvio da IEC 61672-1: A %+.2f dB, C %+.2f dB\n", worst[0], worst[1]);
+  printf("%s\n", errors ? "FALHOU" : "ok");
+  return errors ? 1 : 0;
+}
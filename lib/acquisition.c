@@ -0,0 +1,133 @@
+#include <stdatomic.h>
+#include "acquisition.h"
+#include "instr.h"
+
+// O bloco de número N sempre ocupa ring[N % ACQ_NUM_BLOCKS]. O backend grava o
+// bloco blocks_done e já tem o bloco blocks_done + 1 armado; os demais podem
+// ser lidos pelo consumidor até serem reaproveitados pelo DMA.
+static uint16_t ring[ACQ_NUM_BLOCKS][ACQ_BLOCK_SAMPLES];
+static volatile uint32_t blocks_done = 0; // Escrito somente pela interrupção do backend
+static uint32_t read_seq = 0;             // Próximo bloco a ser entregue ao consumidor
+static uint32_t overruns = 0;
+static volatile uint32_t isr_overruns = 0; // Perdas vistas pelo backend (escrito somente pela interrupção)
+static volatile bool running = false;
+// Joystick publicado pela interrupção e lido pelo outro núcleo: aux_seq é
+// ímpar durante a escrita, e o leitor repete se ela mudou no meio
+static volatile uint16_t aux_values[ACQ_AUX_CHANNELS] = {2048, 2048};
+static _Atomic uint32_t aux_seq = 0;
+#ifdef DETECTOR_INSTR
+static uint32_t last_block_us; // Fim do bloco anterior (0 logo após acq_start)
+#endif
+
+uint16_t *acq_block_buffer(uint32_t seq)
+{
+  return ring[seq % ACQ_NUM_BLOCKS];
+}
+
+uint16_t *acq_block_done_from_isr(void)
+{
+  // Um bloco terminou; devolve o buffer que o canal recém-liberado deve armar
+  uint32_t done = blocks_done + 1;
+  blocks_done = done;
+#ifdef DETECTOR_INSTR
+  // Intervalo entre interrupções de fim de bloco: taxa de amostragem real e jitter
+  uint32_t now = instr_backend_now_us();
+  if (last_block_us)
+    INSTR_RECORD(INSTR_BLOCK_PERIOD, now - last_block_us);
+  last_block_us = now ? now : 1;
+#endif
+  return acq_block_buffer(done + 1);
+}
+
+void acq_overrun_from_isr(void)
+{
+  isr_overruns++;
+}
+
+void acq_aux_done_from_isr(const uint16_t values[ACQ_AUX_CHANNELS])
+{
+  uint32_t seq = atomic_load_explicit(&aux_seq, memory_order_relaxed);
+  atomic_store_explicit(&aux_seq, seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  for (int i = 0; i < ACQ_AUX_CHANNELS; i++)
+    aux_values[i] = values[i];
+  // release: os valores ficam visíveis antes da sequência par
+  atomic_store_explicit(&aux_seq, seq + 2, memory_order_release);
+}
+
+void acq_init(uint32_t sample_rate_hz)
+{
+  acq_backend_init(sample_rate_hz);
+}
+
+void acq_start(void)
+{
+  acq_backend_stop();
+  blocks_done = 0;
+  read_seq = 0;
+  overruns = 0;
+  isr_overruns = 0;
+  INSTR_ONLY(last_block_us = 0;)
+  static const uint16_t centered[ACQ_AUX_CHANNELS] = {2048, 2048};
+  acq_aux_done_from_isr(centered); // Joystick centrado até a primeira média (o outro núcleo pode estar lendo)
+  running = true;
+  acq_backend_start();
+}
+
+void acq_stop(void)
+{
+  acq_backend_stop();
+  running = false;
+}
+
+bool acq_get_block(acq_block_t *block)
+{
+  uint32_t done = blocks_done;
+  uint32_t lag = done - read_seq;
+  if (lag == 0)
+    return false;
+
+  // Blocos que o DMA já voltou a ocupar são descartados e contados como perda
+  if (lag > ACQ_NUM_BLOCKS - 1)
+  {
+    uint32_t lost = lag - (ACQ_NUM_BLOCKS - 1);
+    overruns += lost;
+    read_seq += lost;
+  }
+
+  block->samples = acq_block_buffer(read_seq);
+  block->len = ACQ_BLOCK_SAMPLES;
+  block->seq = read_seq;
+  return true;
+}
+
+void acq_release_block(const acq_block_t *block)
+{
+  // Se o DMA alcançou o bloco durante o processamento, os dados foram corrompidos
+  if (blocks_done - block->seq > ACQ_NUM_BLOCKS - 1)
+    overruns++;
+  read_seq = block->seq + 1;
+}
+
+void acq_get_stats(acq_stats_t *stats)
+{
+  stats->blocks = blocks_done;
+  stats->overruns = overruns + isr_overruns;
+}
+
+void acq_read_aux(uint16_t values[ACQ_AUX_CHANNELS])
+{
+  if (!running)
+  {
+    acq_backend_read_aux(values);
+    return;
+  }
+  uint32_t seq;
+  do
+  {
+    seq = atomic_load_explicit(&aux_seq, memory_order_acquire);
+    for (int i = 0; i < ACQ_AUX_CHANNELS; i++)
+      values[i] = aux_values[i];
+    atomic_thread_fence(memory_order_acquire);
+  } while ((seq & 1) || seq != atomic_load_explicit(&aux_seq, memory_order_relaxed));
+}
@@ -0,0 +1,52 @@
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Aquisição contínua do microfone: o ADC roda livre e o DMA grava as amostras
+// em um anel de blocos. O detector consome blocos completos e nunca lê o ADC
+// diretamente. No RP2040 o ADC faz round robin entre o joystick e o microfone
+// com DECIMATOR_RATIO vezes a taxa pedida (lib/decimator.h), e os blocos já
+// chegam decimados; o joystick sai da mesma conversão, pela média de cada
+// trecho (acq_read_aux()).
+
+#define ACQ_BLOCK_SAMPLES 256 // Amostras por bloco (32 ms a 8 kHz)
+#define ACQ_NUM_BLOCKS 4      // Blocos no anel (o DMA ocupa dois: um gravando, um armado)
+#define ACQ_AUX_CHANNELS 2    // Joystick X (ADC0) e Y (ADC1)
+
+typedef struct
+{
+  const uint16_t *samples; // Amostras em códigos do ADC (0 a 4095)
+  size_t len;              // Quantidade de amostras no bloco
+  uint32_t seq;            // Número do bloco desde acq_start()
+} acq_block_t;
+
+typedef struct
+{
+  uint32_t blocks;   // Blocos completados pelo DMA desde acq_start()
+  uint32_t overruns; // Blocos perdidos porque o consumidor não acompanhou ou a interrupção do DMA atrasou
+} acq_stats_t;
+
+void acq_init(uint32_t sample_rate_hz);
+void acq_start(void);
+void acq_stop(void);
+bool acq_get_block(acq_block_t *block);
+void acq_release_block(const acq_block_t *block);
+void acq_get_stats(acq_stats_t *stats);
+// Joystick: com a aquisição rodando, a média mais recente do round robin;
+// parada, uma rajada sobreamostrada lida na hora (bloqueia por ~0,1 ms)
+void acq_read_aux(uint16_t values[ACQ_AUX_CHANNELS]);
+
+// Interface entre o núcleo do anel e o backend de hardware (RP2040 ou host)
+uint16_t *acq_block_buffer(uint32_t seq);
+uint16_t *acq_block_done_from_isr(void);
+void acq_aux_done_from_isr(const uint16_t values[ACQ_AUX_CHANNELS]);
+void acq_overrun_from_isr(void); // O backend perdeu amostras e recomeçou o bloco em andamento
+void acq_backend_init(uint32_t sample_rate_hz);
+void acq_backend_start(void);
+void acq_backend_stop(void);
+void acq_backend_read_aux(uint16_t values[ACQ_AUX_CHANNELS]); // Só com a aquisição parada
+
+#endif
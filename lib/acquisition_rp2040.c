@@ -0,0 +1,165 @@
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "acquisition.h"
+#include "decimator.h"
+#include "nvm.h"
+
+#define ACQ_ADC_INPUT 2           // Microfone no GPIO28 (ADC2)
+#define ACQ_ADC_CLOCK_HZ 48000000 // O ADC do RP2040 é alimentado pelo clk_adc de 48 MHz
+#define ACQ_RR_MASK 0x7u          // Round robin: joystick X (ADC0), Y (ADC1) e microfone (ADC2)
+#define ACQ_RR_CHANNELS 3
+#define ACQ_AUX_BURST 16 // Conversões por canal na leitura avulsa do joystick
+
+// O round robin começa na entrada selecionada e segue em ordem crescente, então
+// cada quadro do buffer cru é {ADC0, ADC1, ADC2}
+#define ACQ_RAW_OUTPUTS 64 // Saídas por trecho cru: 8 ms a 8 kHz
+#define ACQ_RAW_FRAMES (ACQ_RAW_OUTPUTS * DECIMATOR_RATIO)
+#define ACQ_RAW_SAMPLES (ACQ_RAW_FRAMES * ACQ_RR_CHANNELS)
+
+_Static_assert(ACQ_BLOCK_SAMPLES % ACQ_RAW_OUTPUTS == 0, "o bloco deve ser múltiplo das saídas de um trecho cru");
+// A interrupção de um canal tem de rearmá-lo antes de o outro terminar o
+// trecho; o maior atraso dela é a gravação de uma página da flash com o núcleo
+// 1 parado (lib/nvm.h). Com folga de 2x a 8 kHz:
+_Static_assert(ACQ_RAW_OUTPUTS * 1000000ull / 8000 >= 2ull * NVM_PROGRAM_MAX_US,
+               "o trecho cru deve durar mais que o bloqueio da flash");
+
+// Dois canais encadeados em ping-pong sobre buffers crus: enquanto um grava, o
+// outro já está armado, então o FIFO do ADC nunca fica sem destino. A
+// interrupção decima o trecho que acabou direto no bloco do anel. Se ela
+// atrasa mais que um trecho, o encadeamento já reiniciou o canal com o
+// endereço de escrita no fim do buffer dele (o DMA não o recarrega), e ele
+// passa a gravar no buffer seguinte ou além de raw[]; o atraso é detectado
+// pelo canal já ocupado ou pelo fim do outro pendente, e o ping-pong recomeça
+// do zero, com o bloco em andamento contado como perdido.
+static uint dma_chan[2];
+static uint16_t raw[2][ACQ_RAW_SAMPLES];
+static uint32_t sample_rate = 8000;
+static decimator_t mic_decimator;
+static uint32_t out_seq; // Bloco do anel sendo preenchido pela decimação
+static size_t out_fill;  // Amostras já gravadas nele
+
+// Para o ADC e os dois canais juntos, para que um não dispare o outro pelo encadeamento
+static void pingpong_abort(void)
+{
+  adc_run(false);
+  dma_hw->abort = (1u << dma_chan[0]) | (1u << dma_chan[1]);
+  while (dma_hw->abort)
+    tight_loop_contents();
+  dma_channel_acknowledge_irq0(dma_chan[0]);
+  dma_channel_acknowledge_irq0(dma_chan[1]);
+}
+
+// Arma os dois canais do início dos buffers e liga o round robin a partir do ADC0
+static void pingpong_start(void)
+{
+  // Período de cada conversão = (1 + div) ciclos do clock do ADC; o round robin
+  // divide a taxa total entre os três canais
+  adc_set_clkdiv((float)ACQ_ADC_CLOCK_HZ / (sample_rate * DECIMATOR_RATIO * ACQ_RR_CHANNELS) - 1.0f);
+  adc_select_input(0);
+  adc_set_round_robin(ACQ_RR_MASK);
+  adc_fifo_setup(true, true, 1, false, false); // FIFO com DREQ a cada amostra, 12 bits
+  adc_fifo_drain();
+
+  dma_channel_set_write_addr(dma_chan[0], raw[0], false);
+  dma_channel_set_trans_count(dma_chan[0], ACQ_RAW_SAMPLES, false);
+  dma_channel_set_write_addr(dma_chan[1], raw[1], false);
+  dma_channel_set_trans_count(dma_chan[1], ACQ_RAW_SAMPLES, false);
+  dma_channel_start(dma_chan[0]);
+
+  adc_run(true);
+}
+
+static void acq_dma_isr(void)
+{
+  for (int i = 0; i < 2; i++)
+  {
+    if (!dma_channel_get_irq0_status(dma_chan[i]))
+      continue;
+    if (dma_channel_is_busy(dma_chan[i]) || dma_channel_get_irq0_status(dma_chan[i ^ 1]))
+    {
+      // Atrasada: o canal já regrava a partir do fim do buffer. Os trechos
+      // crus não valem mais; o bloco em andamento recomeça com o decimador zerado
+      pingpong_abort();
+      decimator_init(&mic_decimator);
+      out_fill = 0;
+      acq_overrun_from_isr();
+      pingpong_start();
+      return;
+    }
+    dma_channel_acknowledge_irq0(dma_chan[i]);
+    // Rearma o canal sem disparar; ele será iniciado pelo encadeamento. O outro
+    // canal já grava no outro buffer, então este pode ser lido até o próximo fim.
+    dma_channel_set_write_addr(dma_chan[i], raw[i], false);
+
+    uint16_t aux[ACQ_AUX_CHANNELS];
+    for (int c = 0; c < ACQ_AUX_CHANNELS; c++)
+      aux[c] = decimator_average(&raw[i][c], ACQ_RAW_FRAMES, ACQ_RR_CHANNELS);
+    acq_aux_done_from_isr(aux);
+
+    uint16_t *out = acq_block_buffer(out_seq) + out_fill;
+    out_fill += decimator_process(&mic_decimator, &raw[i][ACQ_ADC_INPUT], ACQ_RAW_FRAMES, ACQ_RR_CHANNELS, out);
+    if (out_fill == ACQ_BLOCK_SAMPLES)
+    {
+      acq_block_done_from_isr();
+      out_seq++;
+      out_fill = 0;
+    }
+  }
+}
+
+void acq_backend_init(uint32_t sample_rate_hz)
+{
+  sample_rate = sample_rate_hz;
+  dma_chan[0] = dma_claim_unused_channel(true);
+  dma_chan[1] = dma_claim_unused_channel(true);
+  for (int i = 0; i < 2; i++)
+  {
+    dma_channel_config c = dma_channel_get_default_config(dma_chan[i]);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    channel_config_set_chain_to(&c, dma_chan[i ^ 1]);
+    dma_channel_configure(dma_chan[i], &c, raw[i], &adc_hw->fifo, ACQ_RAW_SAMPLES, false);
+    dma_channel_set_irq0_enabled(dma_chan[i], true);
+  }
+
+  irq_set_exclusive_handler(DMA_IRQ_0, acq_dma_isr);
+  irq_set_enabled(DMA_IRQ_0, true);
+}
+
+void acq_backend_start(void)
+{
+  decimator_init(&mic_decimator);
+  out_seq = 0;
+  out_fill = 0;
+  pingpong_start();
+}
+
+void acq_backend_stop(void)
+{
+  pingpong_abort();
+
+  // Libera o ADC para leituras avulsas (joystick) fora do monitoramento
+  adc_set_round_robin(0);
+  adc_fifo_setup(false, false, 0, false, false);
+  adc_fifo_drain();
+}
+
+void acq_backend_read_aux(uint16_t values[ACQ_AUX_CHANNELS])
+{
+  // Conversões avulsas, um canal de cada vez (2 µs cada), sem o FIFO: numa
+  // rajada em round robin pelo FIFO, uma interrupção no meio o estoura e as
+  // leituras seguintes caem no canal errado. A média de ACQ_AUX_BURST leituras
+  // por canal tira o ruído do joystick.
+  for (int c = 0; c < ACQ_AUX_CHANNELS; c++)
+  {
+    uint32_t sum = 0;
+    adc_select_input(c);
+    for (int n = 0; n < ACQ_AUX_BURST; n++)
+      sum += adc_read();
+    values[c] = (uint16_t)((sum + ACQ_AUX_BURST / 2) / ACQ_AUX_BURST);
+  }
+}
@@ -0,0 +1,95 @@
+#include "adpcm.h"
+
+// Tabelas do padrão IMA: passo de quantização e ajuste do índice por código
+static const int16_t step_table[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+    544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+    2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+    9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+static const int8_t index_table[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+void adpcm_init(adpcm_state_t *s)
+{
+  s->predictor = 0;
+  s->index = 0;
+}
+
+// Reconstrói a amostra a partir do código, igual no codificador e no decodificador
+static inline void update(int32_t *predictor, int32_t *index, uint8_t code)
+{
+  int32_t step = step_table[*index];
+  int32_t diff = step >> 3;
+  if (code & 4)
+    diff += step;
+  if (code & 2)
+    diff += step >> 1;
+  if (code & 1)
+    diff += step >> 2;
+  int32_t p = (code & 8) ? *predictor - diff : *predictor + diff;
+  *predictor = p < INT16_MIN ? INT16_MIN : p > INT16_MAX ? INT16_MAX : p;
+  int32_t i = *index + index_table[code & 7];
+  *index = i < 0 ? 0 : i > 88 ? 88 : i;
+}
+
+static inline uint8_t encode_sample(int32_t *predictor, int32_t *index, int32_t sample)
+{
+  int32_t step = step_table[*index];
+  int32_t diff = sample - *predictor;
+  uint8_t code = 0;
+  if (diff < 0)
+  {
+    code = 8;
+    diff = -diff;
+  }
+  // Aproximação sucessiva de diff / step em 3 bits
+  if (diff >= step)
+  {
+    code |= 4;
+    diff -= step;
+  }
+  if (diff >= step >> 1)
+  {
+    code |= 2;
+    diff -= step >> 1;
+  }
+  if (diff >= step >> 2)
+    code |= 1;
+  update(predictor, index, code);
+  return code;
+}
+
+size_t adpcm_encode_block(adpcm_state_t *s, const uint16_t *codes, size_t count, uint8_t *out)
+{
+  int32_t predictor = s->predictor, index = s->index;
+  out[0] = (uint8_t)predictor;
+  out[1] = (uint8_t)((uint16_t)predictor >> 8);
+  out[2] = (uint8_t)index;
+  out[3] = 0;
+  uint8_t *p = out + ADPCM_HEADER_BYTES;
+  for (size_t i = 0; i < count; i += 2)
+  {
+    uint8_t lo = encode_sample(&predictor, &index, ((int32_t)(codes[i] & 0x0FFF) - 2048) * 16);
+    uint8_t hi = i + 1 < count ? encode_sample(&predictor, &index, ((int32_t)(codes[i + 1] & 0x0FFF) - 2048) * 16) : 0;
+    *p++ = (uint8_t)(lo | (hi << 4));
+  }
+  s->predictor = (int16_t)predictor;
+  s->index = (uint8_t)index;
+  return (size_t)(p - out);
+}
+
+size_t adpcm_decode_block(const uint8_t *in, size_t count, int16_t *out)
+{
+  int32_t predictor = (int16_t)(in[0] | (in[1] << 8));
+  int32_t index = in[2] > 88 ? 88 : in[2];
+  const uint8_t *p = in + ADPCM_HEADER_BYTES;
+  for (size_t i = 0; i < count; i++)
+  {
+    uint8_t code = (i & 1) ? *p++ >> 4 : *p & 0x0F;
+    update(&predictor, &index, code);
+    out[i] = (int16_t)predictor;
+  }
+  return count;
+}
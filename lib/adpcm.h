@@ -0,0 +1,33 @@
+#ifndef ADPCM_H
+#define ADPCM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// IMA-ADPCM (DVI) em ponto fixo, por tabela e sem alocação: 4 bits por
+// amostra de 16 bits, 4:1 contra PCM de 16 bits e 3:1 contra os códigos de
+// 12 bits empacotados. Cada bloco começa com o estado do codificador
+// (preditor de 16 bits LE, índice do passo, um byte reservado) e segue com
+// uma amostra por nibble, o nibble baixo primeiro, então decodifica sozinho:
+// um bloco perdido no streaming não estraga os seguintes. O estado continua
+// de um bloco para o outro no codificador, sem o transitório de recomeçar.
+//
+// As amostras de entrada são códigos do ADC (0 a 4095), levados a PCM de 16
+// bits centrado como no WAV das ferramentas ((código - 2048) << 4).
+
+#define ADPCM_HEADER_BYTES 4
+#define ADPCM_BLOCK_BYTES(samples) (ADPCM_HEADER_BYTES + ((samples) + 1) / 2)
+
+typedef struct
+{
+  int16_t predictor; // Última amostra reconstruída
+  uint8_t index;     // Índice na tabela de passos (0 a 88)
+} adpcm_state_t;
+
+void adpcm_init(adpcm_state_t *s);
+// Codifica count códigos do ADC em out (ADPCM_BLOCK_BYTES(count) bytes); devolve os bytes escritos
+size_t adpcm_encode_block(adpcm_state_t *s, const uint16_t *codes, size_t count, uint8_t *out);
+// Decodifica um bloco de count amostras em PCM de 16 bits; devolve as amostras escritas
+size_t adpcm_decode_block(const uint8_t *in, size_t count, int16_t *out);
+
+#endif
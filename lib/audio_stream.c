@@ -0,0 +1,71 @@
+#include "audio_stream.h"
+
+#define AUDIO_STREAM_PAYLOAD_MAX (AUDIO_STREAM_HEADER_BYTES + AUDIO_STREAM_MAX_SAMPLES * 3 / 2)
+
+_Static_assert(AUDIO_STREAM_PAYLOAD_MAX <= FRAME_MAX_PAYLOAD, "bloco de áudio grande demais para um quadro");
+_Static_assert(AUDIO_STREAM_MAX_SAMPLES % 2 == 0, "o empacotamento usa pares de amostras");
+
+static uint8_t frame[FRAME_BYTES(AUDIO_STREAM_PAYLOAD_MAX)];
+static uint8_t *const payload = frame + FRAME_HEADER_BYTES;
+static audio_stream_stats_t stats;
+static uint8_t stream_format = AUDIO_STREAM_PACKED12;
+static adpcm_state_t encoder;
+
+void audio_stream_reset(uint8_t format)
+{
+  stats.blocks_sent = 0;
+  stats.blocks_dropped = 0;
+  stream_format = format == AUDIO_STREAM_ADPCM ? AUDIO_STREAM_ADPCM : AUDIO_STREAM_PACKED12;
+  adpcm_init(&encoder);
+}
+
+void audio_stream_pack12(const uint16_t *samples, size_t count, uint8_t *out)
+{
+  for (size_t i = 0; i + 1 < count; i += 2)
+  {
+    uint16_t a = samples[i] & 0x0FFF;
+    uint16_t b = samples[i + 1] & 0x0FFF;
+    *out++ = (uint8_t)a;
+    *out++ = (uint8_t)((a >> 8) | (b << 4));
+    *out++ = (uint8_t)(b >> 4);
+  }
+}
+
+bool audio_stream_send_block(uint32_t seq, const uint16_t *samples, size_t count)
+{
+  if (count > AUDIO_STREAM_MAX_SAMPLES)
+    count = AUDIO_STREAM_MAX_SAMPLES;
+  count &= ~(size_t)1;
+  uint16_t len = (uint16_t)(AUDIO_STREAM_HEADER_BYTES +
+                            (stream_format == AUDIO_STREAM_ADPCM ? ADPCM_BLOCK_BYTES(count) : count * 3 / 2));
+
+  // Contrapressão: ou o quadro inteiro cabe no link agora, ou o bloco é descartado
+  if (frame_backend_space() < (size_t)FRAME_BYTES(len))
+  {
+    stats.blocks_dropped++;
+    return false;
+  }
+
+  uint32_t dropped = stats.blocks_dropped;
+  for (int i = 0; i < 4; i++)
+  {
+    payload[i] = (uint8_t)(seq >> (8 * i));
+    payload[4 + i] = (uint8_t)(dropped >> (8 * i));
+  }
+  payload[8] = (uint8_t)count;
+  payload[9] = (uint8_t)(count >> 8);
+  payload[10] = stream_format;
+  if (stream_format == AUDIO_STREAM_ADPCM)
+    adpcm_encode_block(&encoder, samples, count, payload + AUDIO_STREAM_HEADER_BYTES);
+  else
+    audio_stream_pack12(samples, count, payload + AUDIO_STREAM_HEADER_BYTES);
+
+  frame_send(FRAME_AUDIO, frame, len);
+  stats.blocks_sent++;
+  return true;
+}
+
+void audio_stream_get_stats(audio_stream_stats_t *s)
+{
+  *s = stats;
+}
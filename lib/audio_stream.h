@@ -0,0 +1,39 @@
+#ifndef AUDIO_STREAM_H
+#define AUDIO_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "adpcm.h"
+#include "frame.h"
+
+// Streaming das amostras cruas do microfone em quadros FRAME_AUDIO, um por
+// bloco de aquisição. Dados do quadro:
+//
+//   seq (32 bits) | descartados (32 bits) | amostras (16 bits) | formato (8 bits) | amostras empacotadas
+//
+// tudo em little-endian. No formato AUDIO_STREAM_PACKED12 cada par de
+// códigos de 12 bits (a, b) ocupa 3 bytes: a[7:0], b[3:0]:a[11:8], b[11:4];
+// no AUDIO_STREAM_ADPCM vem um bloco de lib/adpcm.h (4 bits por amostra, o
+// codificador continua de um bloco para o outro e cada bloco traz o estado).
+// As amostras são lidas direto do buffer do DMA e empacotadas já dentro do
+// quadro. Se o link não tem espaço para o quadro inteiro, o bloco é
+// descartado e contado, sem nunca esperar: a aquisição não para.
+
+#define AUDIO_STREAM_PACKED12 1
+#define AUDIO_STREAM_ADPCM 2
+#define AUDIO_STREAM_HEADER_BYTES 11
+#define AUDIO_STREAM_MAX_SAMPLES 256
+
+typedef struct
+{
+  uint32_t blocks_sent;
+  uint32_t blocks_dropped; // Sem espaço no link (contraprova: saltos de seq no receptor)
+} audio_stream_stats_t;
+
+void audio_stream_reset(uint8_t format); // Zera os contadores e escolhe o formato dos blocos
+bool audio_stream_send_block(uint32_t seq, const uint16_t *samples, size_t count);
+void audio_stream_get_stats(audio_stream_stats_t *stats);
+void audio_stream_pack12(const uint16_t *samples, size_t count, uint8_t *out);
+
+#endif
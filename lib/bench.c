@@ -0,0 +1,355 @@
+#include <stdio.h>
+#include "bench.h"
+#include "acquisition.h"
+#include "adpcm.h"
+#include "decimator.h"
+#include "led_matrix.h"
+#include "noise_level.h"
+#include "spectrum.h"
+#include "tone_bank.h"
+#include "weighting.h"
+
+#define BENCH_SAMPLE_RATE 8000 // Taxa do firmware, para os coeficientes dos filtros
+#define BENCH_DECIM_OUTPUTS 64 // Um trecho cru do round robin (lib/acquisition_rp2040.c)
+#define BENCH_DECIM_CHANNELS 3
+
+typedef struct
+{
+  const char *name;
+  uint32_t iterations;
+  uint32_t items_per_op;
+  void (*prepare)(uint32_t i); // Fora da medida (pode ser NULL)
+  void (*run)(uint32_t i);
+  const char *metric;
+  uint32_t (*metric_counter)(void);
+} bench_case_t;
+
+static ssd1306_t *bench_ssd;
+
+// Estado do caminho de detecção, como no núcleo 1
+static dc_blocker_t bench_dc;
+static weighting_filter_t bench_weighting;
+static noise_level_t bench_level;
+static time_weighting_t bench_time_weighting;
+static uint16_t bench_samples[ACQ_BLOCK_SAMPLES];
+static int16_t bench_block[ACQ_BLOCK_SAMPLES];
+static volatile uint32_t bench_alerts; // Mantém a comparação viva no otimizador
+static decimator_t bench_decimator;
+static uint16_t bench_raw[BENCH_DECIM_OUTPUTS * DECIMATOR_RATIO * BENCH_DECIM_CHANNELS];
+static uint16_t bench_decimated[BENCH_DECIM_OUTPUTS];
+static adpcm_state_t bench_adpcm;
+static uint8_t bench_adpcm_block[ADPCM_BLOCK_BYTES(ACQ_BLOCK_SAMPLES)];
+static tone_bank_t bench_tones;
+static uint32_t bench_tone_detectors; // Detectores processados (métrica do tone_bank_block)
+static spectrum_t bench_spectrum;
+static int16_t bench_band_levels[SPECTRUM_MAX_BANDS];
+
+static void clear_display(uint32_t i)
+{
+  (void)i;
+  ssd1306_fill(bench_ssd, false);
+}
+
+static void alternate_fill(uint32_t i)
+{
+  ssd1306_fill(bench_ssd, i & 1);
+}
+
+static void run_fill(uint32_t i)
+{
+  ssd1306_fill(bench_ssd, !(i & 1));
+}
+
+static void run_draw_string(uint32_t i)
+{
+  (void)i;
+  ssd1306_draw_string(bench_ssd, "Monitoramento", 0, 40);
+}
+
+static void run_inverted_digit(uint32_t i)
+{
+  ssd1306_draw_inverted_digit(bench_ssd, (char)('0' + i % 10), 40 + (i % 4) * 8, 0);
+}
+
+static void run_rect_fill(uint32_t i)
+{
+  // Retângulo preenchido fora do alinhamento de página, aceso e apagado alternadamente
+  ssd1306_rect(bench_ssd, 13, 20 + (i % 4), 48, 30, i & 1, true);
+}
+
+static void run_line_circle(uint32_t i)
+{
+  // Os caminhos que ainda passam por ssd1306_pixel: diagonal e círculo parcialmente fora do painel
+  ssd1306_line(bench_ssd, 0, 63, 127, (uint8_t)(i % 64), !(i & 1));
+  ssd1306_circle(bench_ssd, 110, 40, 30, i & 1);
+}
+
+static void change_glyph(uint32_t i)
+{
+  ssd1306_draw_char(bench_ssd, (i & 1) ? 'A' : 'B', 64, 24);
+}
+
+static void run_send_data(uint32_t i)
+{
+  (void)i;
+  ssd1306_send_data(bench_ssd);
+}
+
+static uint32_t bus_bytes(void)
+{
+  return bench_ssd->bus_bytes;
+}
+
+static void wait_leds(uint32_t i)
+{
+  (void)i;
+  led_matrix_flush();
+}
+
+static void run_leds_change(uint32_t i)
+{
+  // Mesmo caminho de set_all_leds() no firmware
+  uint8_t level = (i & 1) ? 10 : 0;
+  led_matrix_fill(level, 0, 10 - level);
+  led_matrix_show();
+}
+
+static void run_leds_same(uint32_t i)
+{
+  (void)i;
+  led_matrix_fill(0, 0, 10);
+  led_matrix_show();
+}
+
+static uint32_t led_words(void)
+{
+  led_matrix_stats_t stats;
+  led_matrix_get_stats(&stats);
+  return stats.words_sent;
+}
+
+static void run_level_block(uint32_t i)
+{
+  // Só o motor de nível (remoção de DC, RMS da janela e Leq), sem as ponderações
+  (void)i;
+  dc_blocker_process(&bench_dc, bench_samples, bench_block, ACQ_BLOCK_SAMPLES);
+  noise_level_process(&bench_level, bench_block, ACQ_BLOCK_SAMPLES);
+  bench_alerts += noise_level_rms(&bench_level) > 3000;
+}
+
+static void load_mic_block(uint32_t i)
+{
+  // A ponderação trabalha no lugar: cada iteração parte de um bloco sem DC novo
+  (void)i;
+  dc_blocker_process(&bench_dc, bench_samples, bench_block, ACQ_BLOCK_SAMPLES);
+}
+
+static void run_weighting_block(uint32_t i)
+{
+  // Só as seções da ponderação A, o passo que o threshold_path soma ao level_block
+  (void)i;
+  weighting_filter_process(&bench_weighting, bench_block, ACQ_BLOCK_SAMPLES);
+}
+
+static void run_threshold_block(uint32_t i)
+{
+  (void)i;
+  dc_blocker_process(&bench_dc, bench_samples, bench_block, ACQ_BLOCK_SAMPLES);
+  weighting_filter_process(&bench_weighting, bench_block, ACQ_BLOCK_SAMPLES);
+  noise_level_process(&bench_level, bench_block, ACQ_BLOCK_SAMPLES);
+  time_weighting_process(&bench_time_weighting, bench_block, ACQ_BLOCK_SAMPLES);
+  uint16_t rms = time_weighting_rms(&bench_time_weighting);
+  if (rms < 100 || rms > 3000)
+    bench_alerts++;
+}
+
+static void run_decimator_chunk(uint32_t i)
+{
+  // O que a interrupção do DMA faz a cada trecho: decima o microfone e tira a média do joystick
+  (void)i;
+  size_t frames = BENCH_DECIM_OUTPUTS * DECIMATOR_RATIO;
+  decimator_process(&bench_decimator, &bench_raw[2], frames, BENCH_DECIM_CHANNELS, bench_decimated);
+  bench_alerts += decimator_average(&bench_raw[0], frames, BENCH_DECIM_CHANNELS);
+  bench_alerts += decimator_average(&bench_raw[1], frames, BENCH_DECIM_CHANNELS);
+}
+
+static void run_adpcm_block(uint32_t i)
+{
+  // Um bloco de aquisição no streaming em ADPCM; ciclos por amostra = cycles_per_op / items_per_op
+  (void)i;
+  adpcm_encode_block(&bench_adpcm, bench_samples, ACQ_BLOCK_SAMPLES, bench_adpcm_block);
+}
+
+static void run_tone_bank_block(uint32_t i)
+{
+  // O banco de detectores de tom num bloco; ciclos por detector por amostra =
+  // cycles_per_op / items_per_op / metric_per_op
+  (void)i;
+  bench_alerts += tone_bank_process(&bench_tones, bench_block, ACQ_BLOCK_SAMPLES, false);
+  bench_tone_detectors += tone_bank_count();
+}
+
+static void run_spectrum_frame(uint32_t i)
+{
+  // Um bloco de N/2 amostras completa um quadro: FFT, raias e as duas agregações em bandas
+  (void)i;
+  spectrum_process(&bench_spectrum, bench_block, ACQ_BLOCK_SAMPLES);
+  spectrum_band_levels(&bench_spectrum, SPECTRUM_THIRD_OCTAVE, bench_band_levels);
+  bench_alerts += bench_band_levels[0] > 0;
+}
+
+static uint32_t spectrum_frames(void)
+{
+  return bench_spectrum.frames;
+}
+
+static uint32_t tone_detectors(void)
+{
+  return bench_tone_detectors;
+}
+
+static const bench_case_t bench_cases[] = {
+    {"ssd1306_fill", 200, 1, NULL, run_fill, NULL, NULL},
+    {"ssd1306_draw_string", 200, 13, clear_display, run_draw_string, NULL, NULL},
+    {"draw_inverted_digit", 500, 1, NULL, run_inverted_digit, NULL, NULL},
+    {"ssd1306_rect_fill", 200, 1, NULL, run_rect_fill, NULL, NULL},
+    {"ssd1306_line_circle", 200, 2, NULL, run_line_circle, NULL, NULL},
+    {"ssd1306_send_data_full", 20, 1, alternate_fill, run_send_data, "bus_bytes", bus_bytes},
+    {"ssd1306_send_data_glyph", 100, 1, change_glyph, run_send_data, "bus_bytes", bus_bytes},
+    {"set_all_leds_change", 50, 1, wait_leds, run_leds_change, "led_words", led_words},
+    {"set_all_leds_same", 50, 1, wait_leds, run_leds_same, "led_words", led_words},
+    {"level_block", 200, ACQ_BLOCK_SAMPLES, NULL, run_level_block, NULL, NULL},
+    {"weighting_block", 200, ACQ_BLOCK_SAMPLES, load_mic_block, run_weighting_block, NULL, NULL},
+    {"threshold_path", 100, ACQ_BLOCK_SAMPLES, NULL, run_threshold_block, NULL, NULL},
+    {"decimator_chunk", 200, BENCH_DECIM_OUTPUTS, NULL, run_decimator_chunk, NULL, NULL},
+    {"adpcm_encode_block", 200, ACQ_BLOCK_SAMPLES, NULL, run_adpcm_block, NULL, NULL},
+    {"tone_bank_block", 200, ACQ_BLOCK_SAMPLES, NULL, run_tone_bank_block, "tone_detectors", tone_detectors},
+    {"spectrum_frame", 50, ACQ_BLOCK_SAMPLES, NULL, run_spectrum_frame, "fft_frames", spectrum_frames},
+};
+
+static void bench_setup_detection(void)
+{
+  // Ruído pseudoaleatório em torno do ponto de polarização do microfone
+  uint32_t seed = 12345;
+  for (size_t i = 0; i < ACQ_BLOCK_SAMPLES; i++)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    bench_samples[i] = (uint16_t)(2048 + ((int32_t)(seed >> 22) - 512));
+  }
+  dc_blocker_init(&bench_dc);
+  weighting_filter_init(&bench_weighting, WEIGHTING_A, BENCH_SAMPLE_RATE);
+  noise_level_init(&bench_level);
+  time_weighting_init(&bench_time_weighting, TIME_WEIGHTING_FAST, BENCH_SAMPLE_RATE);
+
+  for (size_t i = 0; i < sizeof(bench_raw) / sizeof(bench_raw[0]); i++)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    bench_raw[i] = (uint16_t)(2048 + ((int32_t)(seed >> 22) - 512));
+  }
+  decimator_init(&bench_decimator);
+  adpcm_init(&bench_adpcm);
+  tone_bank_init(&bench_tones, 0); // Sobre o bloco que o threshold_path deixa em bench_block
+  spectrum_init(&bench_spectrum);
+  spectrum_process(&bench_spectrum, bench_block, ACQ_BLOCK_SAMPLES); // Meio histórico: cada iteração fecha um quadro
+}
+
+size_t bench_run_all(ssd1306_t *ssd, bench_result_t *results, size_t max_results, uint32_t max_iterations)
+{
+  bench_ssd = ssd;
+  bench_backend_init();
+  bench_setup_detection();
+
+  // Custo da própria medida, descontado de cada iteração
+  uint32_t overhead = UINT32_MAX;
+  for (int i = 0; i < 16; i++)
+  {
+    uint32_t start = bench_backend_ticks();
+    uint32_t t = bench_backend_elapsed(start);
+    if (t < overhead)
+      overhead = t;
+  }
+
+  size_t count = 0;
+  for (size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]) && count < max_results; c++)
+  {
+    const bench_case_t *bc = &bench_cases[c];
+    bench_result_t *r = &results[count++];
+    r->name = bc->name;
+    r->iterations = max_iterations && max_iterations < bc->iterations ? max_iterations : bc->iterations;
+    r->items_per_op = bc->items_per_op;
+    r->total_ticks = 0;
+    r->metric = bc->metric;
+
+    // A iteração 0 aquece caches e estado (quadro anterior, filtros) e fica fora do resultado
+    if (bc->prepare)
+      bc->prepare(0);
+    bc->run(0);
+
+    uint32_t metric_start = bc->metric_counter ? bc->metric_counter() : 0;
+    for (uint32_t i = 1; i <= r->iterations; i++)
+    {
+      if (bc->prepare)
+        bc->prepare(i);
+      uint32_t start = bench_backend_ticks();
+      bc->run(i);
+      uint32_t t = bench_backend_elapsed(start);
+      r->total_ticks += t > overhead ? t - overhead : 0;
+    }
+    r->metric_total = bc->metric_counter ? bc->metric_counter() - metric_start : 0;
+  }
+
+  ssd1306_fill(ssd, false);
+  ssd1306_send_data(ssd);
+  return count;
+}
+
+void bench_print(const bench_result_t *results, size_t count, bench_format_t format)
+{
+  uint32_t tick_hz = bench_backend_tick_hz();
+  uint32_t cpu_hz = bench_backend_cpu_hz();
+  const char *platform = bench_backend_platform();
+
+  if (format == BENCH_CSV)
+    printf("platform,name,iterations,items_per_op,ns_per_op,cycles_per_op,ns_per_item,metric,metric_per_op\n");
+  else
+    printf("{\"platform\":\"%s\",\"tick_hz\":%lu,\"cpu_hz\":%lu,\"results\":[\n", platform, (unsigned long)tick_hz,
+           (unsigned long)cpu_hz);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    const bench_result_t *r = &results[i];
+    double ticks_per_op = (double)r->total_ticks / r->iterations;
+    double ns_per_op = ticks_per_op * 1e9 / tick_hz;
+    double cycles_per_op = cpu_hz ? ticks_per_op * cpu_hz / tick_hz : 0;
+    double ns_per_item = ns_per_op / r->items_per_op;
+    double metric_per_op = (double)r->metric_total / r->iterations;
+
+    if (format == BENCH_CSV)
+    {
+      printf("%s,%s,%lu,%lu,%.1f,", platform, r->name, (unsigned long)r->iterations, (unsigned long)r->items_per_op,
+             ns_per_op);
+      if (cpu_hz)
+        printf("%.0f", cycles_per_op);
+      printf(",%.1f,%s,", ns_per_item, r->metric ? r->metric : "");
+      if (r->metric)
+        printf("%.1f", metric_per_op);
+      printf("\n");
+    }
+    else
+    {
+      printf("  {\"name\":\"%s\",\"iterations\":%lu,\"items_per_op\":%lu,\"ns_per_op\":%.1f,", r->name,
+             (unsigned long)r->iterations, (unsigned long)r->items_per_op, ns_per_op);
+      if (cpu_hz)
+        printf("\"cycles_per_op\":%.0f,", cycles_per_op);
+      else
+        printf("\"cycles_per_op\":null,");
+      printf("\"ns_per_item\":%.1f", ns_per_item);
+      if (r->metric)
+        printf(",\"%s_per_op\":%.1f", r->metric, metric_per_op);
+      printf("}%s\n", i + 1 < count ? "," : "");
+    }
+  }
+
+  if (format == BENCH_JSON)
+    printf("]}\n");
+}
@@ -0,0 +1,46 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ssd1306.h"
+
+// Micro-benchmarks dos caminhos quentes (display, LEDs e detecção). O mesmo
+// código roda no host e no firmware; só a contagem de tempo vem do backend
+// (SysTick em ciclos no RP2040, relógio monotônico em ns no host). Cada
+// iteração é cronometrada sozinha, com o preparo fora da medida e o custo da
+// própria medida descontado.
+
+#define BENCH_MAX_RESULTS 20
+
+typedef enum
+{
+  BENCH_CSV,
+  BENCH_JSON
+} bench_format_t;
+
+typedef struct
+{
+  const char *name;
+  uint32_t iterations;
+  uint32_t items_per_op;  // Glifos, amostras... para o custo por item
+  uint64_t total_ticks;   // Soma das iterações, no tick do backend
+  const char *metric;     // Contador extra por operação (NULL se não houver)
+  uint32_t metric_total;
+} bench_result_t;
+
+// Usa o display já inicializado (o conteúdo é apagado) e a matriz de LEDs.
+// max_iterations limita as iterações de cada caso (0: as da tabela)
+size_t bench_run_all(ssd1306_t *ssd, bench_result_t *results, size_t max_results, uint32_t max_iterations);
+void bench_print(const bench_result_t *results, size_t count, bench_format_t format);
+
+// Interface com o backend (lib/bench_rp2040.c no firmware, host/bench_host.c no host)
+void bench_backend_init(void);
+uint32_t bench_backend_ticks(void);
+uint32_t bench_backend_elapsed(uint32_t start); // Ticks desde start, tratando o estouro do contador
+uint32_t bench_backend_tick_hz(void);
+uint32_t bench_backend_cpu_hz(void);           // 0 se os ciclos da CPU não são conhecidos
+const char *bench_backend_platform(void);
+
+#endif
@@ -0,0 +1,40 @@
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#include "bench.h"
+
+#define SYSTICK_MASK 0x00FFFFFFu // Contador decrescente de 24 bits
+
+void bench_backend_init(void)
+{
+  // SysTick no clock do processador: resolução de um ciclo, estoura a cada 134 ms a 125 MHz
+  systick_hw->csr = 0;
+  systick_hw->rvr = SYSTICK_MASK;
+  systick_hw->cvr = 0;
+  systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+}
+
+uint32_t bench_backend_ticks(void)
+{
+  return ~systick_hw->cvr & SYSTICK_MASK; // Crescente, para a subtração ficar natural
+}
+
+uint32_t bench_backend_elapsed(uint32_t start)
+{
+  return (bench_backend_ticks() - start) & SYSTICK_MASK;
+}
+
+uint32_t bench_backend_tick_hz(void)
+{
+  return clock_get_hz(clk_sys);
+}
+
+uint32_t bench_backend_cpu_hz(void)
+{
+  return clock_get_hz(clk_sys);
+}
+
+const char *bench_backend_platform(void)
+{
+  return "rp2040";
+}
@@ -0,0 +1,170 @@
+#include <string.h>
+#include "capture.h"
+#include "audio_stream.h"
+
+_Static_assert(CAPTURE_SAMPLES % 2 == 0 && CAPTURE_POST_SAMPLES > 0, "a captura usa pares de amostras");
+_Static_assert(CAPTURE_HEADER_BYTES + CAPTURE_CHUNK_SAMPLES * 3 / 2 <= FRAME_MAX_PAYLOAD,
+               "trecho da captura grande demais para um quadro");
+
+static uint8_t frame[FRAME_BYTES(CAPTURE_HEADER_BYTES + CAPTURE_CHUNK_SAMPLES * 3 / 2)];
+static uint8_t *const payload = frame + FRAME_HEADER_BYTES;
+
+void capture_init(capture_t *c)
+{
+  memset(c, 0, sizeof(*c));
+  atomic_init(&c->state, CAPTURE_ARMED);
+}
+
+void capture_restart(capture_t *c)
+{
+  if (atomic_load_explicit(&c->state, memory_order_acquire) == CAPTURE_READY)
+    return;
+  c->write_pos = 0;
+  c->filled = 0;
+  c->post_left = 0;
+  atomic_store_explicit(&c->state, CAPTURE_ARMED, memory_order_relaxed);
+}
+
+static void put_sample(uint8_t *ring, uint32_t pos, uint16_t code)
+{
+  uint8_t *p = &ring[pos / 2 * 3];
+  code &= 0x0FFF;
+  if (pos & 1)
+  {
+    p[1] = (uint8_t)((p[1] & 0x0F) | (code << 4));
+    p[2] = (uint8_t)(code >> 4);
+  }
+  else
+  {
+    p[0] = (uint8_t)code;
+    p[1] = (uint8_t)((p[1] & 0xF0) | (code >> 8));
+  }
+}
+
+static void freeze(capture_t *c, uint32_t total)
+{
+  c->info.total = total;
+  c->info.number++;
+  // release: o anel e as informações ficam visíveis para o núcleo 0 antes do estado
+  atomic_store_explicit(&c->state, CAPTURE_READY, memory_order_release);
+}
+
+void capture_push(capture_t *c, const uint16_t *samples, size_t count)
+{
+  uint8_t state = atomic_load_explicit(&c->state, memory_order_acquire);
+  if (state == CAPTURE_READY)
+    return;
+  if (state == CAPTURE_POST && count > c->post_left)
+    count = c->post_left; // O resto do bloco já não pertence à janela
+
+  uint32_t pos = c->write_pos;
+  for (size_t i = 0; i < count; i++)
+  {
+    put_sample(c->ring, pos, samples[i]);
+    if (++pos == CAPTURE_SAMPLES)
+      pos = 0;
+  }
+  c->write_pos = pos;
+  c->filled = c->filled + count > CAPTURE_SAMPLES ? CAPTURE_SAMPLES : c->filled + (uint32_t)count;
+
+  if (state == CAPTURE_POST)
+  {
+    c->post_left -= (uint32_t)count;
+    if (c->post_left == 0)
+      freeze(c, c->info.trigger + CAPTURE_POST_SAMPLES);
+  }
+}
+
+void capture_trigger(capture_t *c, uint32_t back, uint32_t block_seq)
+{
+  if (atomic_load_explicit(&c->state, memory_order_acquire) != CAPTURE_ARMED)
+  {
+    c->dropped_triggers++;
+    return;
+  }
+  if (back > c->filled)
+    back = c->filled;
+  if (back > CAPTURE_POST_SAMPLES)
+    back = CAPTURE_POST_SAMPLES; // Não acontece com blocos menores que a janela posterior
+  uint32_t pre = c->filled - back;
+  c->info.trigger = pre < CAPTURE_PRE_SAMPLES ? pre : CAPTURE_PRE_SAMPLES;
+  c->info.block_seq = block_seq;
+  c->post_left = CAPTURE_POST_SAMPLES - back;
+  if (c->post_left == 0)
+    freeze(c, c->info.trigger + CAPTURE_POST_SAMPLES);
+  else
+    atomic_store_explicit(&c->state, CAPTURE_POST, memory_order_relaxed);
+}
+
+void capture_stop(capture_t *c)
+{
+  if (atomic_load_explicit(&c->state, memory_order_acquire) != CAPTURE_POST)
+    return;
+  c->dropped_triggers++; // Janela posterior incompleta
+  freeze(c, c->info.trigger + CAPTURE_POST_SAMPLES - c->post_left);
+}
+
+bool capture_get_info(capture_t *c, capture_info_t *info)
+{
+  if (atomic_load_explicit(&c->state, memory_order_acquire) != CAPTURE_READY)
+    return false;
+  *info = c->info;
+  return true;
+}
+
+uint16_t capture_sample(const capture_t *c, uint32_t index)
+{
+  // A captura termina na posição de escrita: as total últimas amostras do anel
+  uint32_t pos = (c->write_pos + CAPTURE_SAMPLES - c->info.total + index) % CAPTURE_SAMPLES;
+  const uint8_t *p = &c->ring[pos / 2 * 3];
+  if (pos & 1)
+    return (uint16_t)((p[1] >> 4) | (p[2] << 4));
+  return (uint16_t)(p[0] | ((p[1] & 0x0F) << 8));
+}
+
+bool capture_send_chunk(capture_t *c, uint32_t pos, uint32_t count, uint8_t format)
+{
+  if (count > CAPTURE_CHUNK_SAMPLES)
+    count = CAPTURE_CHUNK_SAMPLES;
+  bool adpcm = format == CAPTURE_FORMAT_ADPCM;
+  uint16_t len = (uint16_t)(CAPTURE_HEADER_BYTES + (adpcm ? ADPCM_BLOCK_BYTES(count) : (count + 1) / 2 * 3));
+  if (frame_backend_space() < (size_t)FRAME_BYTES(len))
+    return false;
+
+  uint32_t header[4] = {c->info.number, c->info.trigger, c->info.total, pos};
+  for (int w = 0; w < 4; w++)
+    for (int i = 0; i < 4; i++)
+      payload[4 * w + i] = (uint8_t)(header[w] >> (8 * i));
+  payload[16] = (uint8_t)count;
+  payload[17] = (uint8_t)(count >> 8);
+  payload[18] = adpcm ? CAPTURE_FORMAT_ADPCM : CAPTURE_FORMAT_PACKED12;
+
+  // Desempacota do anel (a captura pode começar numa amostra ímpar) e reempacota alinhado
+  uint16_t samples[CAPTURE_CHUNK_SAMPLES];
+  for (uint32_t i = 0; i < count; i++)
+    samples[i] = capture_sample(c, pos + i);
+  if (adpcm)
+  {
+    if (pos == 0)
+      adpcm_init(&c->send_adpcm);
+    adpcm_encode_block(&c->send_adpcm, samples, count, payload + CAPTURE_HEADER_BYTES);
+  }
+  else
+  {
+    if (count & 1)
+      samples[count] = 0; // Par completado com zero; "amostras" diz quantas valem
+    audio_stream_pack12(samples, count + (count & 1), payload + CAPTURE_HEADER_BYTES);
+  }
+
+  frame_send(FRAME_CAPTURE, frame, len);
+  return true;
+}
+
+void capture_release(capture_t *c)
+{
+  // O núcleo 1 não mexe no anel congelado: os contadores podem ser zerados daqui
+  c->write_pos = 0;
+  c->filled = 0;
+  c->post_left = 0;
+  atomic_store_explicit(&c->state, CAPTURE_ARMED, memory_order_release);
+}
@@ -0,0 +1,92 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "adpcm.h"
+#include "frame.h"
+
+// Captura do áudio em volta de um alarme: as últimas amostras do microfone
+// ficam num anel empacotado em 12 bits (2 amostras em 3 bytes, como em
+// lib/audio_stream.h). No gatilho, as CAPTURE_PRE_MS anteriores são mantidas
+// e o anel continua só até completar CAPTURE_POST_MS depois dele; então a
+// captura congela até ser baixada pela USB e rearmada com capture_release().
+//
+// O núcleo 1 grava (capture_restart/push/trigger/stop) e o núcleo 0 lê a
+// captura congelada (capture_get_info/send_chunk/release): enquanto o estado
+// é CAPTURE_READY o núcleo 1 não toca no anel, então a monitoração continua
+// durante o download. Um alarme com a captura congelada não é capturado.
+//
+// Quadros FRAME_CAPTURE, em little-endian:
+//
+//   número (32 bits) | pré-gatilho (32 bits) | total (32 bits) | posição (32 bits) |
+//   amostras (16 bits) | formato (8 bits) | amostras empacotadas
+//
+// O formato é o mesmo dos quadros de lib/audio_stream.h: 12 bits empacotados
+// (a amostra exata) ou ADPCM (um terço dos bytes na USB). O anel continua em
+// 12 bits: a captura é a prova do alarme e a comparação com o sinal é exata.
+// "pré-gatilho" é o índice, na captura, da primeira amostra do bloco que
+// disparou o alarme; "posição" é o índice da primeira amostra do quadro.
+
+#ifndef CAPTURE_PRE_MS
+#define CAPTURE_PRE_MS 1000 // Janela antes do gatilho
+#endif
+#ifndef CAPTURE_POST_MS
+#define CAPTURE_POST_MS 500 // Janela a partir do gatilho
+#endif
+#define CAPTURE_SAMPLE_RATE 8000 // SAMPLES_PER_SECOND do firmware
+#define CAPTURE_PRE_SAMPLES ((uint32_t)CAPTURE_PRE_MS * CAPTURE_SAMPLE_RATE / 1000)
+#define CAPTURE_POST_SAMPLES ((uint32_t)CAPTURE_POST_MS * CAPTURE_SAMPLE_RATE / 1000)
+#define CAPTURE_SAMPLES (CAPTURE_PRE_SAMPLES + CAPTURE_POST_SAMPLES)
+#define CAPTURE_FORMAT_PACKED12 1
+#define CAPTURE_FORMAT_ADPCM 2
+#define CAPTURE_HEADER_BYTES 19
+#define CAPTURE_CHUNK_SAMPLES 256 // Amostras por quadro
+
+typedef enum
+{
+  CAPTURE_ARMED,   // Anel girando, à espera de um gatilho
+  CAPTURE_POST,    // Gatilho recebido, completando a janela posterior
+  CAPTURE_READY    // Congelada até capture_release()
+} capture_state_t;
+
+typedef struct
+{
+  uint32_t number;     // Capturas congeladas desde o boot (a primeira é 1)
+  uint32_t trigger;    // Índice da amostra do gatilho na captura (= amostras pré-gatilho)
+  uint32_t total;      // Amostras na captura
+  uint32_t block_seq;  // Bloco de aquisição que disparou (acq_block_t.seq)
+} capture_info_t;
+
+typedef struct
+{
+  uint8_t ring[CAPTURE_SAMPLES * 3 / 2];
+  _Atomic uint8_t state; // capture_state_t
+  uint32_t write_pos;    // Próxima posição do anel, em amostras
+  uint32_t filled;       // Amostras válidas no anel (satura em CAPTURE_SAMPLES)
+  uint32_t post_left;    // Amostras que faltam na janela posterior
+  capture_info_t info;
+  uint32_t dropped_triggers; // Alarmes com a captura congelada ou parada no meio
+  adpcm_state_t send_adpcm;  // Codificador do download em ADPCM, de um quadro para o outro
+} capture_t;
+
+void capture_init(capture_t *c);
+// Núcleo 1: nova aquisição (amostras descontínuas); uma captura congelada é mantida
+void capture_restart(capture_t *c);
+void capture_push(capture_t *c, const uint16_t *samples, size_t count);
+// O gatilho fica back amostras antes da posição de escrita (o início do último bloco gravado)
+void capture_trigger(capture_t *c, uint32_t back, uint32_t block_seq);
+// Aquisição parada: uma janela posterior incompleta é congelada como está
+void capture_stop(capture_t *c);
+
+// Núcleo 0
+bool capture_get_info(capture_t *c, capture_info_t *info); // false se não há captura congelada
+uint16_t capture_sample(const capture_t *c, uint32_t index);
+// Envia count amostras a partir de pos num quadro no formato dado; false (nada enviado) se não
+// cabem no link agora. Em ADPCM os quadros precisam ir em ordem a partir da posição 0.
+bool capture_send_chunk(capture_t *c, uint32_t pos, uint32_t count, uint8_t format);
+void capture_release(capture_t *c);
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-16/CCITT-FALSE (polinômio 0x1021, valor inicial 0xFFFF, sem reflexão),
+// o mesmo do binascii.crc_hqx do Python usado pelos decodificadores em tools/
+
+#define CRC16_INIT 0xFFFF
+
+uint16_t crc16_update(uint16_t crc, const void *data, size_t len);
+
+#endif
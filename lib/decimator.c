@@ -0,0 +1,84 @@
+#include <string.h>
+#include "decimator.h"
+#include "decimator_coeffs.h"
+
+#define DECIMATOR_MID (2048u * DECIMATOR_CIC_RATIO * DECIMATOR_CIC_RATIO * DECIMATOR_CIC_RATIO * DECIMATOR_CIC_RATIO)
+
+_Static_assert(DECIMATOR_CIC_ORDER == 4 && DECIMATOR_CIC_RATIO * DECIMATOR_FIR_RATIO == DECIMATOR_RATIO,
+               "decimator_coeffs.h não corresponde a decimator.h");
+_Static_assert(2 * DECIMATOR_FIR_TAPS == sizeof(((decimator_t *)0)->fir_history) / sizeof(int32_t),
+               "histórico do FIR com tamanho errado");
+
+void decimator_init(decimator_t *d)
+{
+  memset(d, 0, sizeof(*d));
+}
+
+// Uma saída do CIC: centrada em zero e reduzida para caber em 16 bits com sinal
+static inline int32_t cic_output(decimator_t *d)
+{
+  uint32_t x = d->integrator[3];
+  for (int i = 0; i < 4; i++)
+  {
+    uint32_t y = x - d->comb[i];
+    d->comb[i] = x;
+    x = y;
+  }
+  return (int32_t)(x - DECIMATOR_MID) >> DECIMATOR_CIC_SHIFT;
+}
+
+static inline uint16_t fir_output(const decimator_t *d)
+{
+  // Janela contígua: fir_history[pos .. pos + TAPS - 1], da mais antiga à mais nova
+  const int32_t *x = &d->fir_history[d->fir_pos];
+  int32_t acc = 1 << (DECIMATOR_COEF_SHIFT - 1);
+  for (int k = 0; k < DECIMATOR_FIR_TAPS / 2; k++)
+    acc += (x[k] + x[DECIMATOR_FIR_TAPS - 1 - k]) * decimator_fir[k];
+  acc += x[DECIMATOR_FIR_TAPS / 2] * decimator_fir[DECIMATOR_FIR_TAPS / 2];
+  int32_t code = (acc >> DECIMATOR_COEF_SHIFT) + 2048;
+  return (uint16_t)(code < 0 ? 0 : code > 4095 ? 4095 : code);
+}
+
+size_t decimator_process(decimator_t *d, const uint16_t *raw, size_t count, size_t stride, uint16_t *out)
+{
+  uint32_t i0 = d->integrator[0], i1 = d->integrator[1], i2 = d->integrator[2], i3 = d->integrator[3];
+  uint8_t phase = d->cic_phase;
+  size_t produced = 0;
+  for (size_t n = 0; n < count; n++, raw += stride)
+  {
+    i0 += *raw;
+    i1 += i0;
+    i2 += i1;
+    i3 += i2;
+    if (++phase < DECIMATOR_CIC_RATIO)
+      continue;
+    phase = 0;
+
+    d->integrator[3] = i3;
+    int32_t y = cic_output(d);
+    d->fir_history[d->fir_pos] = y;
+    d->fir_history[d->fir_pos + DECIMATOR_FIR_TAPS] = y;
+    if (++d->fir_pos == DECIMATOR_FIR_TAPS)
+      d->fir_pos = 0;
+    if (++d->fir_phase < DECIMATOR_FIR_RATIO)
+      continue;
+    d->fir_phase = 0;
+    out[produced++] = fir_output(d);
+  }
+  d->integrator[0] = i0;
+  d->integrator[1] = i1;
+  d->integrator[2] = i2;
+  d->integrator[3] = i3;
+  d->cic_phase = phase;
+  return produced;
+}
+
+uint16_t decimator_average(const uint16_t *raw, size_t count, size_t stride)
+{
+  if (count == 0)
+    return 0;
+  uint32_t sum = 0;
+  for (size_t n = 0; n < count; n++, raw += stride)
+    sum += *raw;
+  return (uint16_t)((sum + count / 2) / count);
+}
@@ -0,0 +1,44 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Decimação do microfone sobreamostrado, em ponto fixo: um CIC de ordem 4 que
+// divide por 6 seguido de um FIR simétrico de 31 taps que divide por 2 e
+// compensa a queda do CIC na banda passante (tools/gen_decimator_coeffs.py).
+// A 8 kHz na saída, a entrada é de 96 kS/s e a banda até 3,2 kHz fica entre
+// -0,13 e +0,03 dB (a queda é na borda), com o que dobraria sobre ela
+// atenuado em 47 dB ou mais (medido pelo host/decim_main.c).
+//
+// Com o ruído do próprio ADC servindo de dither, a média de 12 amostras por
+// saída reduz o ruído na banda em 10·log10(12) ≈ 10,8 dB, cerca de 1,8 bit
+// efetivo a mais. A saída continua em códigos de 12 bits arredondados (o
+// formato dos blocos de lib/acquisition.h); o arredondamento soma o ruído de
+// quantização ideal de 0,29 código RMS, que limita o ganho quando o ADC é
+// pouco ruidoso (host/decim_main.c: +1,7 bit com 2 códigos RMS de ruído na
+// entrada, +0,9 bit com 0,5). Custo: 4 somas por amostra crua no
+// CIC, 4 subtrações a cada 6 e 16 multiplicações por saída no FIR (os taps
+// simétricos são somados antes da multiplicação).
+
+#define DECIMATOR_RATIO 12 // Amostras cruas por amostra de saída
+
+typedef struct
+{
+  uint32_t integrator[4]; // Integradores do CIC (aritmética modular de 32 bits)
+  uint32_t comb[4];       // Atrasos dos pentes
+  uint8_t cic_phase;      // Amostras cruas desde a última saída do CIC
+  uint8_t fir_phase;      // Saídas do CIC desde a última saída do FIR
+  uint8_t fir_pos;
+  int32_t fir_history[62]; // Saídas do CIC, duplicadas para leitura contígua
+} decimator_t;
+
+void decimator_init(decimator_t *d);
+// Consome count amostras cruas tomadas de stride em stride (canal do
+// microfone num buffer intercalado do round robin) e grava as saídas em out;
+// devolve quantas foram gravadas (count / DECIMATOR_RATIO, conforme a fase)
+size_t decimator_process(decimator_t *d, const uint16_t *raw, size_t count, size_t stride, uint16_t *out);
+// Média arredondada de count amostras (de stride em stride): canais lentos como o joystick
+uint16_t decimator_average(const uint16_t *raw, size_t count, size_t stride);
+
+#endif
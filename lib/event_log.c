@@ -0,0 +1,376 @@
+#include <string.h>
+#include "event_log.h"
+#include "crc.h"
+
+// Cabeçalho do setor (slot 0): magia | geração | versão | ... | CRC
+#define EVENT_LOG_MAGIC 0x474C5645u // "EVLG"
+#define EVENT_LOG_VERSION 1
+#define EVENT_LOG_CRC_OFFSET (EVENT_LOG_RECORD_BYTES - 2)
+
+_Static_assert(EVENT_LOG_SECTOR_BYTES % EVENT_LOG_PAGE_BYTES == 0, "setor deve ter páginas inteiras");
+_Static_assert(EVENT_LOG_PAGE_BYTES % EVENT_LOG_RECORD_BYTES == 0, "página deve ter registros inteiros");
+_Static_assert(NVM_EVENT_LOG_OFFSET + EVENT_LOG_SECTORS * EVENT_LOG_SECTOR_BYTES <= NVM_SETTINGS_OFFSET,
+               "registro de eventos invade a região seguinte");
+
+static int cur_sector;          // Setor físico em gravação
+static uint32_t cur_generation;
+static uint16_t cur_slot;       // Próximo slot livre do setor atual
+static bool next_erased;        // O setor seguinte está pronto para o rodízio
+static uint32_t next_seq;
+static uint16_t boot;
+static event_record_t queue[EVENT_LOG_QUEUE];
+static uint8_t queue_head, queue_count;
+static bool pending_timer;
+static uint32_t pending_since_ms;
+static event_log_stats_t stats;
+static uint8_t page[EVENT_LOG_PAGE_BYTES];
+
+static void put16(uint8_t *p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+  put16(p, (uint16_t)v);
+  put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+  return get16(p) | (uint32_t)get16(p + 2) << 16;
+}
+
+static const uint8_t *sector_ptr(int sector)
+{
+  return nvm_backend_region() + NVM_EVENT_LOG_OFFSET + (uint32_t)sector * EVENT_LOG_SECTOR_BYTES;
+}
+
+static bool is_erased(const uint8_t *p, size_t len)
+{
+  for (size_t i = 0; i < len; i++)
+  {
+    if (p[i] != 0xFF)
+      return false;
+  }
+  return true;
+}
+
+static void seal(uint8_t *slot)
+{
+  put16(slot + EVENT_LOG_CRC_OFFSET, crc16_update(CRC16_INIT, slot, EVENT_LOG_CRC_OFFSET));
+}
+
+static bool sealed(const uint8_t *slot)
+{
+  return get16(slot + EVENT_LOG_CRC_OFFSET) == crc16_update(CRC16_INIT, slot, EVENT_LOG_CRC_OFFSET);
+}
+
+static void encode_header(uint32_t generation, uint8_t *slot)
+{
+  memset(slot, 0, EVENT_LOG_RECORD_BYTES);
+  put32(slot, EVENT_LOG_MAGIC);
+  put32(slot + 4, generation);
+  slot[8] = EVENT_LOG_VERSION;
+  seal(slot);
+}
+
+static bool decode_header(const uint8_t *slot, uint32_t *generation)
+{
+  if (!sealed(slot) || get32(slot) != EVENT_LOG_MAGIC || slot[8] != EVENT_LOG_VERSION)
+    return false;
+  *generation = get32(slot + 4);
+  return true;
+}
+
+static void encode_record(const event_record_t *r, uint8_t *slot)
+{
+  memset(slot, 0, EVENT_LOG_RECORD_BYTES);
+  put32(slot, r->seq);
+  put16(slot + 4, r->boot);
+  slot[6] = r->type;
+  slot[7] = r->flags;
+  put32(slot + 8, r->time_ms);
+  put32(slot + 12, r->duration_ms);
+  put16(slot + 16, r->level);
+  put16(slot + 18, r->peak);
+  put16(slot + 20, r->leq);
+  put16(slot + 22, r->threshold_min);
+  put16(slot + 24, r->threshold_max);
+  slot[26] = r->tones; // Zero nos registros anteriores aos detectores de tom
+  seal(slot);
+}
+
+static bool decode_record(const uint8_t *slot, event_record_t *r)
+{
+  if (!sealed(slot))
+    return false;
+  r->seq = get32(slot);
+  r->boot = get16(slot + 4);
+  r->type = slot[6];
+  r->flags = slot[7];
+  r->time_ms = get32(slot + 8);
+  r->duration_ms = get32(slot + 12);
+  r->level = get16(slot + 16);
+  r->peak = get16(slot + 18);
+  r->leq = get16(slot + 20);
+  r->threshold_min = get16(slot + 22);
+  r->threshold_max = get16(slot + 24);
+  r->tones = slot[26];
+  return true;
+}
+
+// Registros válidos de um setor com cabeçalho válido
+static uint32_t count_records(int sector)
+{
+  const uint8_t *sec = sector_ptr(sector);
+  uint32_t generation, count = 0;
+  event_record_t r;
+  if (!decode_header(sec, &generation))
+    return 0;
+  for (int slot = 1; slot < EVENT_LOG_SLOTS_PER_SECTOR; slot++)
+  {
+    if (decode_record(sec + slot * EVENT_LOG_RECORD_BYTES, &r))
+      count++;
+  }
+  return count;
+}
+
+static int next_sector(void)
+{
+  return (cur_sector + 1) % EVENT_LOG_SECTORS;
+}
+
+static void erase_next(void)
+{
+  int sector = next_sector();
+  stats.records -= count_records(sector); // O histórico mais antigo sai do rodízio
+  nvm_backend_erase(NVM_EVENT_LOG_OFFSET + (uint32_t)sector * EVENT_LOG_SECTOR_BYTES);
+  stats.erases++;
+  next_erased = true;
+}
+
+// Setor físico que é o k-ésimo mais antigo entre os de cabeçalho válido (-1 se não há)
+static int sector_by_age(uint8_t k)
+{
+  uint32_t gens[EVENT_LOG_SECTORS];
+  int phys[EVENT_LOG_SECTORS];
+  int n = 0;
+  for (int s = 0; s < EVENT_LOG_SECTORS; s++)
+  {
+    uint32_t generation;
+    if (!decode_header(sector_ptr(s), &generation))
+      continue;
+    int i = n++;
+    while (i > 0 && gens[i - 1] > generation)
+    {
+      gens[i] = gens[i - 1];
+      phys[i] = phys[i - 1];
+      i--;
+    }
+    gens[i] = generation;
+    phys[i] = s;
+  }
+  return k < n ? phys[k] : -1;
+}
+
+void event_log_init(void)
+{
+  memset(&stats, 0, sizeof(stats));
+  queue_head = queue_count = 0;
+  pending_timer = false;
+
+  // O setor atual é o de maior geração; sem nenhum, o primeiro a abrir é o 0
+  int best = -1;
+  uint32_t best_generation = 0, max_seq = 0;
+  uint16_t max_boot = 0;
+  bool any = false;
+  for (int s = 0; s < EVENT_LOG_SECTORS; s++)
+  {
+    const uint8_t *sec = sector_ptr(s);
+    uint32_t generation;
+    if (!decode_header(sec, &generation))
+    {
+      if (!is_erased(sec, EVENT_LOG_RECORD_BYTES))
+        stats.torn++; // Primeira página do setor interrompida
+      continue;
+    }
+    if (best < 0 || generation > best_generation)
+    {
+      best = s;
+      best_generation = generation;
+    }
+    for (int slot = 1; slot < EVENT_LOG_SLOTS_PER_SECTOR; slot++)
+    {
+      const uint8_t *p = sec + slot * EVENT_LOG_RECORD_BYTES;
+      event_record_t r;
+      if (is_erased(p, EVENT_LOG_RECORD_BYTES))
+        continue;
+      if (!decode_record(p, &r))
+      {
+        stats.torn++;
+        continue;
+      }
+      stats.records++;
+      if (!any || r.seq > max_seq)
+        max_seq = r.seq;
+      if (!any || r.boot > max_boot)
+        max_boot = r.boot;
+      any = true;
+    }
+  }
+
+  if (best < 0)
+  {
+    // Região vazia: um setor "cheio" antes do 0 faz a primeira gravação abrir o 0
+    cur_sector = EVENT_LOG_SECTORS - 1;
+    cur_generation = 0;
+    cur_slot = EVENT_LOG_SLOTS_PER_SECTOR;
+  }
+  else
+  {
+    // Continua depois do último slot usado; um registro interrompido no meio não é reaproveitado
+    const uint8_t *sec = sector_ptr(best);
+    cur_sector = best;
+    cur_generation = best_generation;
+    cur_slot = EVENT_LOG_SLOTS_PER_SECTOR;
+    while (cur_slot > 1 && is_erased(sec + (cur_slot - 1) * EVENT_LOG_RECORD_BYTES, EVENT_LOG_RECORD_BYTES))
+      cur_slot--;
+  }
+  next_seq = any ? max_seq + 1 : 0;
+  boot = any ? (uint16_t)(max_boot + 1) : 0;
+
+  next_erased = is_erased(sector_ptr(next_sector()), EVENT_LOG_SECTOR_BYTES);
+}
+
+bool event_log_append(event_record_t *record)
+{
+  if (queue_count == EVENT_LOG_QUEUE)
+  {
+    stats.dropped++;
+    return false;
+  }
+  record->seq = next_seq++;
+  record->boot = boot;
+  queue[(queue_head + queue_count) % EVENT_LOG_QUEUE] = *record;
+  queue_count++;
+  return true;
+}
+
+// Grava a página do próximo slot com o que couber da fila; falso se o setor
+// seguinte ainda precisa ser apagado
+static bool write_batch(void)
+{
+  if (cur_slot >= EVENT_LOG_SLOTS_PER_SECTOR)
+  {
+    if (!next_erased)
+      return false;
+    cur_sector = next_sector();
+    cur_generation++;
+    cur_slot = 1;
+    next_erased = is_erased(sector_ptr(next_sector()), EVENT_LOG_SECTOR_BYTES);
+  }
+
+  // A imagem parte do conteúdo atual: os slots já gravados são reprogramados iguais
+  uint16_t first = (uint16_t)(cur_slot - cur_slot % EVENT_LOG_SLOTS_PER_PAGE);
+  uint32_t offset = (uint32_t)cur_sector * EVENT_LOG_SECTOR_BYTES + first * EVENT_LOG_RECORD_BYTES;
+  memcpy(page, nvm_backend_region() + NVM_EVENT_LOG_OFFSET + offset, EVENT_LOG_PAGE_BYTES);
+  if (first == 0 && is_erased(page, EVENT_LOG_RECORD_BYTES))
+    encode_header(cur_generation, page);
+
+  while (queue_count && cur_slot < first + EVENT_LOG_SLOTS_PER_PAGE)
+  {
+    encode_record(&queue[queue_head], page + (cur_slot - first) * EVENT_LOG_RECORD_BYTES);
+    queue_head = (queue_head + 1) % EVENT_LOG_QUEUE;
+    queue_count--;
+    cur_slot++;
+    stats.records++;
+  }
+  nvm_backend_program(NVM_EVENT_LOG_OFFSET + offset, page);
+  stats.page_writes++;
+  return true;
+}
+
+void event_log_service(uint32_t now_ms, bool idle)
+{
+  if (idle && !next_erased)
+    erase_next();
+  if (!queue_count)
+  {
+    pending_timer = false;
+    return;
+  }
+  if (!pending_timer)
+  {
+    pending_timer = true;
+    pending_since_ms = now_ms;
+  }
+
+  // Durante a aquisição só uma página por chamada, e só com o lote completo ou antigo
+  uint16_t room = cur_slot >= EVENT_LOG_SLOTS_PER_SECTOR ? EVENT_LOG_SLOTS_PER_PAGE - 1
+                                                         : EVENT_LOG_SLOTS_PER_PAGE - cur_slot % EVENT_LOG_SLOTS_PER_PAGE;
+  bool wrote = false;
+  if (idle)
+  {
+    while (queue_count && write_batch())
+    {
+      wrote = true;
+      if (!next_erased)
+        erase_next();
+    }
+  }
+  else if (queue_count >= room || now_ms - pending_since_ms >= EVENT_LOG_FLUSH_MS)
+  {
+    wrote = write_batch();
+  }
+  if (!queue_count)
+    pending_timer = false;
+  else if (wrote)
+    pending_since_ms = now_ms; // O restante forma o próximo lote
+}
+
+void event_log_flush(void)
+{
+  event_log_service(0, true);
+}
+
+uint16_t event_log_boot(void)
+{
+  return boot;
+}
+
+void event_log_get_stats(event_log_stats_t *s)
+{
+  *s = stats;
+  s->pending = queue_count;
+}
+
+void event_log_iter_begin(event_log_iter_t *it)
+{
+  it->sector = 0;
+  it->slot = 1;
+}
+
+bool event_log_iter_next(event_log_iter_t *it, event_record_t *record)
+{
+  int phys;
+  while ((phys = sector_by_age(it->sector)) >= 0)
+  {
+    const uint8_t *sec = sector_ptr(phys);
+    while (it->slot < EVENT_LOG_SLOTS_PER_SECTOR)
+    {
+      const uint8_t *p = sec + it->slot++ * EVENT_LOG_RECORD_BYTES;
+      if (!is_erased(p, EVENT_LOG_RECORD_BYTES) && decode_record(p, record))
+        return true;
+    }
+    it->sector++;
+    it->slot = 1;
+  }
+  return false;
+}
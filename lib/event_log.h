@@ -0,0 +1,87 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "nvm.h"
+
+// Registro persistente dos incidentes (fora do range ou tom detectado), só de
+// acréscimo, na região NVM_EVENT_LOG_OFFSET da flash (lib/nvm.h), dividida em
+// setores de 4 KB usados em rodízio (nivelamento de desgaste): cada setor
+// começa com um cabeçalho com o número de geração e o restante guarda
+// registros de 32 bytes, cada um com o próprio CRC. Um registro com o CRC
+// errado é uma gravação interrompida por queda de energia: é ignorado na
+// leitura e o espaço não é reaproveitado.
+//
+// Os registros ficam numa fila em RAM e são gravados em lotes de uma página
+// (a página é reprogramada com os registros anteriores intactos). O setor
+// seguinte ao atual é mantido apagado, então durante a aquisição só acontecem
+// gravações de página (alguns ms com o núcleo 1 parado); apagar um setor (até
+// centenas de ms) fica para quando a aquisição está parada. Por isso cabem no
+// histórico EVENT_LOG_SECTORS - 1 setores.
+
+#define EVENT_LOG_PAGE_BYTES NVM_PAGE_BYTES
+#define EVENT_LOG_SECTOR_BYTES NVM_SECTOR_BYTES
+#define EVENT_LOG_SECTORS 4
+#define EVENT_LOG_RECORD_BYTES 32
+#define EVENT_LOG_SLOTS_PER_PAGE (EVENT_LOG_PAGE_BYTES / EVENT_LOG_RECORD_BYTES)
+#define EVENT_LOG_SLOTS_PER_SECTOR (EVENT_LOG_SECTOR_BYTES / EVENT_LOG_RECORD_BYTES) // O primeiro é o cabeçalho
+#define EVENT_LOG_QUEUE 16      // Registros em RAM à espera da gravação
+#define EVENT_LOG_FLUSH_MS 5000 // Espera máxima por um lote maior durante a aquisição
+
+typedef enum
+{
+  EVENT_OUT_OF_RANGE = 1,
+  EVENT_TONE = 2 // Disparado por um detector de tom (lib/tone_bank.h)
+} event_type_t;
+
+// Como o incidente terminou
+#define EVENT_FLAG_BOOTSEL 0x01 // Interrompido pelo botão B (não reconhecido com o A)
+
+typedef struct
+{
+  uint32_t seq;         // Número do registro, crescente por toda a vida da região
+  uint16_t boot;        // Boot em que o incidente ocorreu (não há relógio de tempo real)
+  uint8_t type;         // event_type_t
+  uint8_t flags;        // EVENT_FLAG_*
+  uint32_t time_ms;     // Início do incidente, em ms desde o boot
+  uint32_t duration_ms; // Do disparo até o reconhecimento
+  uint16_t level;       // RMS ponderado que disparou o alerta
+  uint16_t peak;        // Maior RMS durante o incidente
+  uint16_t leq;         // Leq da monitoração no disparo
+  uint16_t threshold_min;
+  uint16_t threshold_max;
+  uint8_t tones;        // EVENT_TONE: detectores ativos no disparo (bit i: detector i)
+} event_record_t;
+
+typedef struct
+{
+  uint32_t records;     // Registros válidos na flash
+  uint32_t torn;        // Registros e cabeçalhos com CRC errado (gravações interrompidas)
+  uint32_t dropped;     // Registros perdidos com a fila em RAM cheia
+  uint32_t page_writes; // Gravações de página desde o boot
+  uint32_t erases;      // Setores apagados desde o boot
+  uint8_t pending;      // Registros na fila em RAM
+} event_log_stats_t;
+
+// Posição de leitura, dos registros mais antigos para os mais novos
+typedef struct
+{
+  uint8_t sector; // Índice na ordem de geração (0 = setor mais antigo)
+  uint16_t slot;
+} event_log_iter_t;
+
+// Recupera o estado a partir da flash, só lendo (não atrasa o início da
+// aquisição); um setor a apagar fica para event_log_service() ociosa
+void event_log_init(void);
+bool event_log_append(event_record_t *record); // Preenche seq e boot; falso com a fila cheia
+void event_log_service(uint32_t now_ms, bool idle); // idle: aquisição parada, apagar é permitido
+void event_log_flush(void);                     // Grava tudo agora (antes de um reset)
+uint16_t event_log_boot(void);
+void event_log_get_stats(event_log_stats_t *stats);
+
+void event_log_iter_begin(event_log_iter_t *it);
+bool event_log_iter_next(event_log_iter_t *it, event_record_t *record);
+
+#endif
@@ -1,4 +1,4 @@
-static uint8_t font[] = {
+static const uint8_t font[] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // Nothing
     0x3e, 0x41, 0x41, 0x49, 0x41, 0x41, 0x3e, 0x00, // 0
     0x00, 0x00, 0x42, 0x7f, 0x40, 0x00, 0x00, 0x00, // 1
@@ -63,4 +63,6 @@ static uint8_t font[] = {
     0x0c, 0x50, 0x50, 0x50, 0x50, 0x3c, 0x00, 0x00, // y
     0x44, 0x64, 0x54, 0x4c, 0x44, 0x00, 0x00, 0x00, // z
     0x00, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, // :
+    0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x00, // -
+    0x00, 0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00, // .
 };
\ No newline at end of file
@@ -0,0 +1,20 @@
+#include "frame.h"
+#include "crc.h"
+
+bool frame_send(uint8_t type, uint8_t *frame, uint16_t len)
+{
+  if (len > FRAME_MAX_PAYLOAD)
+    return false;
+
+  frame[0] = FRAME_SYNC0;
+  frame[1] = FRAME_SYNC1;
+  frame[2] = type;
+  frame[3] = (uint8_t)len;
+  frame[4] = (uint8_t)(len >> 8);
+  uint16_t crc = crc16_update(CRC16_INIT, frame + 2, 3 + len);
+  frame[FRAME_HEADER_BYTES + len] = (uint8_t)crc;
+  frame[FRAME_HEADER_BYTES + len + 1] = (uint8_t)(crc >> 8);
+
+  frame_backend_write(frame, FRAME_BYTES(len));
+  return true;
+}
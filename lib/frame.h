@@ -0,0 +1,40 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Registros binários enquadrados, enviados pela mesma USB CDC do printf:
+//
+//   0xA5 0x5A | tipo | tamanho (16 bits LE) | dados | CRC-16 (LE)
+//
+// O CRC (lib/crc.h) cobre tipo, tamanho e dados. Texto e quadros podem se
+// intercalar no fluxo: o decodificador procura a sincronia e descarta o que
+// não fecha o CRC.
+
+#define FRAME_SYNC0 0xA5
+#define FRAME_SYNC1 0x5A
+#define FRAME_HEADER_BYTES 5
+#define FRAME_TRAILER_BYTES 2
+#define FRAME_MAX_PAYLOAD 1024
+
+typedef enum
+{
+  FRAME_TELEMETRY = 0x01, // lib/instr.h
+  FRAME_AUDIO = 0x02,     // lib/audio_stream.h
+  FRAME_CAPTURE = 0x03,   // lib/capture.h
+} frame_type_t;
+
+#define FRAME_BYTES(payload_len) (FRAME_HEADER_BYTES + (payload_len) + FRAME_TRAILER_BYTES)
+
+// frame tem FRAME_BYTES(len) bytes, com os dados já em frame + FRAME_HEADER_BYTES;
+// o cabeçalho e o CRC são preenchidos no lugar e o quadro sai numa única
+// escrita, para não ser intercalado com o texto ou com quadros do outro núcleo
+bool frame_send(uint8_t type, uint8_t *frame, uint16_t len);
+
+// Saída dos bytes (stdio USB sem tradução de \n no RP2040, host/usb_link.c no host)
+void frame_backend_write(const uint8_t *data, size_t len);
+size_t frame_backend_space(void); // Bytes que cabem agora sem bloquear (0 sem conexão)
+
+#endif
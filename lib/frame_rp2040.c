@@ -0,0 +1,17 @@
+#include "pico/stdlib.h"
+#include "tusb.h"
+#include "frame.h"
+
+void frame_backend_write(const uint8_t *data, size_t len)
+{
+  // Sem tradução de \n para \r\n, que corromperia os dados binários
+  stdio_put_string((const char *)data, (int)len, false, false);
+}
+
+size_t frame_backend_space(void)
+{
+  // Espaço livre no FIFO de transmissão da CDC (CFG_TUD_CDC_TX_BUFSIZE, ver CMakeLists.txt)
+  if (!tud_cdc_connected())
+    return 0;
+  return tud_cdc_write_available();
+}
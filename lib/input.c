@@ -0,0 +1,107 @@
+#include <string.h>
+#include "input.h"
+
+_Static_assert((INPUT_QUEUE_LEN & (INPUT_QUEUE_LEN - 1)) == 0, "INPUT_QUEUE_LEN deve ser potência de 2");
+
+void input_init(input_t *in)
+{
+  memset(in, 0, sizeof(*in));
+  spsc_ring_init(&in->queue, in->storage, sizeof(input_event_t), INPUT_QUEUE_LEN);
+}
+
+void input_button_edge(input_t *in, input_key_t key)
+{
+  if (key < INPUT_BUTTONS)
+    in->edge[key] = 1;
+}
+
+static void emit(input_t *in, input_key_t key, input_event_type_t type, uint16_t repeat, uint32_t now_ms)
+{
+  input_event_t ev = {(uint8_t)key, (uint8_t)type, repeat, now_ms};
+  spsc_ring_push(&in->queue, &ev); // Fila cheia: o evento é contado em queue.dropped
+}
+
+static void poll_button(input_t *in, input_key_t key, bool active, uint32_t now_ms)
+{
+  // Uma borda marcada conta como pressionado mesmo que o botão já tenha sido solto
+  if (in->edge[key])
+  {
+    in->edge[key] = 0;
+    active = true;
+  }
+  if (active)
+  {
+    in->last_active_ms[key] = now_ms;
+    if (!in->down[key])
+    {
+      in->down[key] = true;
+      emit(in, key, INPUT_PRESS, 0, now_ms);
+    }
+  }
+  else if (in->down[key] && now_ms - in->last_active_ms[key] >= INPUT_RELEASE_MS)
+  {
+    in->down[key] = false; // Trepidação na soltura só reinicia a contagem acima
+  }
+}
+
+static void poll_direction(input_t *in, input_key_t key, bool active, uint32_t now_ms)
+{
+  int d = key - INPUT_BUTTONS;
+  if (!active)
+  {
+    in->down[key] = false;
+    return;
+  }
+  if (!in->down[key])
+  {
+    in->down[key] = true;
+    in->repeats[d] = 0;
+    in->repeat_interval_ms[d] = INPUT_REPEAT_START_MS;
+    in->next_repeat_ms[d] = now_ms + INPUT_REPEAT_DELAY_MS;
+    emit(in, key, INPUT_PRESS, 0, now_ms);
+    return;
+  }
+  if ((int32_t)(now_ms - in->next_repeat_ms[d]) < 0)
+    return;
+
+  // Mantém a cadência a partir do instante previsto, não do poll que atrasou
+  in->next_repeat_ms[d] += in->repeat_interval_ms[d];
+  if ((int32_t)(now_ms - in->next_repeat_ms[d]) >= 0)
+    in->next_repeat_ms[d] = now_ms + in->repeat_interval_ms[d];
+  uint16_t next = in->repeat_interval_ms[d] - in->repeat_interval_ms[d] / 4;
+  in->repeat_interval_ms[d] = next < INPUT_REPEAT_MIN_MS ? INPUT_REPEAT_MIN_MS : next;
+  if (in->repeats[d] < UINT16_MAX)
+    in->repeats[d]++;
+  emit(in, key, INPUT_REPEAT, in->repeats[d], now_ms);
+}
+
+// Um eixo com histerese: cada direção aciona no limiar e solta mais perto do centro
+static bool axis_active(bool down, uint16_t value, bool high)
+{
+  if (high)
+    return value > (down ? INPUT_AXIS_HIGH - INPUT_AXIS_HYSTERESIS : INPUT_AXIS_HIGH);
+  return value < (down ? INPUT_AXIS_LOW + INPUT_AXIS_HYSTERESIS : INPUT_AXIS_LOW);
+}
+
+void input_poll(input_t *in, uint32_t now_ms, uint32_t buttons_down, const uint16_t joy[2])
+{
+  for (int k = 0; k < INPUT_BUTTONS; k++)
+    poll_button(in, (input_key_t)k, (buttons_down >> k) & 1, now_ms);
+
+  uint16_t x = joy ? joy[0] : 2048;
+  uint16_t y = joy ? joy[1] : 2048;
+  poll_direction(in, INPUT_KEY_LEFT, axis_active(in->down[INPUT_KEY_LEFT], x, false), now_ms);
+  poll_direction(in, INPUT_KEY_RIGHT, axis_active(in->down[INPUT_KEY_RIGHT], x, true), now_ms);
+  poll_direction(in, INPUT_KEY_UP, axis_active(in->down[INPUT_KEY_UP], y, false), now_ms);
+  poll_direction(in, INPUT_KEY_DOWN, axis_active(in->down[INPUT_KEY_DOWN], y, true), now_ms);
+}
+
+bool input_get_event(input_t *in, input_event_t *ev)
+{
+  return spsc_ring_pop(&in->queue, ev);
+}
+
+uint32_t input_dropped(const input_t *in)
+{
+  return in->queue.dropped;
+}
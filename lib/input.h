@@ -0,0 +1,73 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "spsc_ring.h"
+
+// Entrada da interface sem esperas: input_poll() amostra botões e joystick em
+// ritmo fixo (task_input) e publica eventos numa fila sem travas. A
+// interrupção dos botões só marca a borda com input_button_edge(), para que
+// um toque mais curto que o período não se perca; o debounce é feito no poll,
+// com o tempo de quem chama. Os eixos do joystick viram quatro direções com
+// histerese, e uma direção mantida repete cada vez mais rápido.
+
+#define INPUT_QUEUE_LEN 8           // Eventos pendentes (potência de 2)
+#define INPUT_RELEASE_MS 50         // Botão solto por este tempo antes de aceitar outro toque
+#define INPUT_AXIS_LOW 1000         // Direção acionada abaixo deste código...
+#define INPUT_AXIS_HIGH 3000        // ...ou acima deste
+#define INPUT_AXIS_HYSTERESIS 300   // e solta só ao voltar tanto assim para o centro
+#define INPUT_REPEAT_DELAY_MS 400   // Direção mantida: primeira repetição
+#define INPUT_REPEAT_START_MS 200   // Intervalo da segunda repetição
+#define INPUT_REPEAT_MIN_MS 40      // Intervalo mínimo; cada repetição encurta o anterior em 1/4
+
+typedef enum
+{
+  INPUT_KEY_A,     // Botão A
+  INPUT_KEY_B,     // Botão B
+  INPUT_KEY_JOY,   // Botão do joystick
+  INPUT_KEY_LEFT,  // Eixo X abaixo de INPUT_AXIS_LOW
+  INPUT_KEY_RIGHT, // Eixo X acima de INPUT_AXIS_HIGH
+  INPUT_KEY_UP,    // Eixo Y abaixo de INPUT_AXIS_LOW
+  INPUT_KEY_DOWN,  // Eixo Y acima de INPUT_AXIS_HIGH
+  INPUT_KEYS
+} input_key_t;
+
+#define INPUT_BUTTONS 3 // As primeiras teclas são os botões; as outras, as direções
+
+typedef enum
+{
+  INPUT_PRESS, // Tecla acionada
+  INPUT_REPEAT // Direção ainda mantida (só direções repetem)
+} input_event_type_t;
+
+typedef struct
+{
+  uint8_t key;     // input_key_t
+  uint8_t type;    // input_event_type_t
+  uint16_t repeat; // Repetições desde o acionamento (0 no INPUT_PRESS)
+  uint32_t time_ms;
+} input_event_t;
+
+typedef struct
+{
+  spsc_ring_t queue;
+  input_event_t storage[INPUT_QUEUE_LEN];
+  volatile uint8_t edge[INPUT_BUTTONS]; // Bordas marcadas pela interrupção
+  bool down[INPUT_KEYS];
+  uint32_t last_active_ms[INPUT_BUTTONS]; // Último poll com o botão pressionado
+  uint32_t next_repeat_ms[INPUT_KEYS - INPUT_BUTTONS];
+  uint16_t repeat_interval_ms[INPUT_KEYS - INPUT_BUTTONS];
+  uint16_t repeats[INPUT_KEYS - INPUT_BUTTONS];
+} input_t;
+
+void input_init(input_t *in);
+// Chamada pela interrupção do GPIO na borda de acionamento de um botão
+void input_button_edge(input_t *in, input_key_t key);
+// Amostra: buttons_down tem o bit (1 << tecla) de cada botão pressionado agora;
+// joy são os eixos X e Y (0 a 4095), ou NULL com o joystick indisponível (centrado)
+void input_poll(input_t *in, uint32_t now_ms, uint32_t buttons_down, const uint16_t joy[2]);
+bool input_get_event(input_t *in, input_event_t *ev);
+uint32_t input_dropped(const input_t *in);
+
+#endif
@@ -0,0 +1,97 @@
+#include "instr.h"
+#include "frame.h"
+
+// Registro: versão, uptime em ms, quantidades e então temporizadores e contadores
+#define INSTR_HEADER_BYTES 8
+#define INSTR_TIMER_BYTES (4 * 4 + 2 * INSTR_HIST_BINS)
+#define INSTR_REPORT_BYTES (INSTR_HEADER_BYTES + INSTR_TIMER_COUNT * INSTR_TIMER_BYTES + INSTR_COUNTER_COUNT * 4)
+
+_Static_assert(INSTR_REPORT_BYTES <= FRAME_MAX_PAYLOAD, "registro de telemetria grande demais para um quadro");
+
+static instr_timer_t timers[INSTR_TIMER_COUNT];
+static uint32_t counters[INSTR_COUNTER_COUNT];
+
+static uint8_t hist_bin(uint32_t us)
+{
+  uint8_t bin = 0;
+  while (us && bin < INSTR_HIST_BINS - 1)
+  {
+    us >>= 1;
+    bin++;
+  }
+  return bin;
+}
+
+void instr_record(instr_timer_id_t id, uint32_t us)
+{
+  instr_timer_t *t = &timers[id];
+  if (t->count == 0 || us < t->min_us)
+    t->min_us = us;
+  if (us > t->max_us)
+    t->max_us = us;
+  t->count++;
+  t->total_us += us;
+  uint16_t *bin = &t->hist[hist_bin(us)];
+  if (*bin != UINT16_MAX)
+    (*bin)++;
+}
+
+void instr_count(instr_counter_id_t id, uint32_t n)
+{
+  counters[id] += n;
+}
+
+void instr_set(instr_counter_id_t id, uint32_t value)
+{
+  counters[id] = value;
+}
+
+const instr_timer_t *instr_timer(instr_timer_id_t id)
+{
+  return &timers[id];
+}
+
+uint32_t instr_counter(instr_counter_id_t id)
+{
+  return counters[id];
+}
+
+static uint8_t *put16(uint8_t *p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  return p + 2;
+}
+
+static uint8_t *put32(uint8_t *p, uint32_t v)
+{
+  p = put16(p, (uint16_t)v);
+  return put16(p, (uint16_t)(v >> 16));
+}
+
+bool instr_send_report(void)
+{
+  static uint8_t frame[FRAME_BYTES(INSTR_REPORT_BYTES)];
+  uint8_t *report = frame + FRAME_HEADER_BYTES;
+  uint8_t *p = report;
+  *p++ = INSTR_VERSION;
+  p = put32(p, instr_backend_now_us() / 1000);
+  *p++ = INSTR_TIMER_COUNT;
+  *p++ = INSTR_COUNTER_COUNT;
+  *p++ = INSTR_HIST_BINS;
+
+  for (int i = 0; i < INSTR_TIMER_COUNT; i++)
+  {
+    const instr_timer_t *t = &timers[i];
+    p = put32(p, t->count);
+    p = put32(p, t->total_us);
+    p = put32(p, t->min_us);
+    p = put32(p, t->max_us);
+    for (int b = 0; b < INSTR_HIST_BINS; b++)
+      p = put16(p, t->hist[b]);
+  }
+  for (int i = 0; i < INSTR_COUNTER_COUNT; i++)
+    p = put32(p, counters[i]);
+
+  return frame_send(FRAME_TELEMETRY, frame, (uint16_t)(p - report));
+}
@@ -0,0 +1,80 @@
+#ifndef INSTR_H
+#define INSTR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Instrumentação dos caminhos quentes: temporizadores com contagem, soma,
+// mínimo, máximo e histograma log2 em µs, e contadores simples. Os valores
+// são acumulados desde o boot (o decodificador calcula as diferenças) e
+// exportados por instr_send_report() como um quadro FRAME_TELEMETRY.
+//
+// Sem DETECTOR_INSTR as macros abaixo não geram código nenhum. Cada
+// temporizador deve ser escrito por um só núcleo; o relatório do outro
+// núcleo pode ver um registro pela metade, o que basta para telemetria.
+//
+// A ordem dos enums e o formato do registro são os de tools/decode_telemetry.py.
+
+#define INSTR_VERSION 1
+#define INSTR_HIST_BINS 16 // Bin 0: < 1 µs; bin k: [2^(k-1), 2^k) µs; o último acumula o resto
+
+typedef enum
+{
+  INSTR_BLOCK_PERIOD,     // Intervalo entre blocos de áudio (taxa real e jitter, núcleo 1)
+  INSTR_BLOCK_DSP,        // Processamento de um bloco (núcleo 1)
+  INSTR_SCHED_PERIOD,     // Intervalo entre passadas do escalonador (jitter do laço)
+  INSTR_SCHED_PASS,       // Duração de uma passada do escalonador
+  INSTR_DISPLAY_UPDATE,   // update_display()
+  INSTR_DISPLAY_TRANSFER, // Envio de um quadro ao SSD1306, do enfileiramento ao fim do DMA
+  INSTR_LEDS,             // led_matrix_show()
+  INSTR_BUZZER,           // Passo do SOS no alarme
+  INSTR_TIMER_COUNT
+} instr_timer_id_t;
+
+typedef enum
+{
+  INSTR_SCHED_OVERRUNS, // Passadas mais longas que o tick
+  INSTR_DISPLAY_BYTES,  // Bytes enviados ao SSD1306
+  INSTR_ACQ_BLOCKS,     // Blocos de áudio completados pelo DMA
+  INSTR_ACQ_OVERRUNS,   // Blocos perdidos por atraso do consumidor
+  INSTR_LEVEL_DROPS,    // Resultados do núcleo 1 descartados com a fila cheia
+  INSTR_COUNTER_COUNT
+} instr_counter_id_t;
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t total_us;
+  uint32_t min_us;
+  uint32_t max_us;
+  uint16_t hist[INSTR_HIST_BINS]; // Satura em 65535
+} instr_timer_t;
+
+#ifdef DETECTOR_INSTR
+#define INSTR_TIME_BEGIN(var) uint32_t var = instr_backend_now_us()
+#define INSTR_TIME_END(id, var) instr_record((id), instr_backend_now_us() - (var))
+#define INSTR_RECORD(id, us) instr_record((id), (us))
+#define INSTR_COUNT(id, n) instr_count((id), (n))
+#define INSTR_SET(id, value) instr_set((id), (value))
+#define INSTR_ONLY(stmt) stmt
+#else
+#define INSTR_TIME_BEGIN(var) ((void)0)
+#define INSTR_TIME_END(id, var) ((void)0)
+#define INSTR_RECORD(id, us) ((void)0)
+#define INSTR_COUNT(id, n) ((void)0)
+#define INSTR_SET(id, value) ((void)0)
+#define INSTR_ONLY(stmt)
+#endif
+
+void instr_record(instr_timer_id_t id, uint32_t us);
+void instr_count(instr_counter_id_t id, uint32_t n);
+void instr_set(instr_counter_id_t id, uint32_t value);
+const instr_timer_t *instr_timer(instr_timer_id_t id);
+uint32_t instr_counter(instr_counter_id_t id);
+bool instr_send_report(void);
+
+// Relógio em µs (time_us_32 no RP2040, relógio virtual no host)
+uint32_t instr_backend_now_us(void);
+
+#endif
@@ -0,0 +1,7 @@
+#include "pico/stdlib.h"
+#include "instr.h"
+
+uint32_t instr_backend_now_us(void)
+{
+  return time_us_32();
+}
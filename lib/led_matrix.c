@@ -0,0 +1,82 @@
+#include <string.h>
+#include "led_matrix.h"
+#include "instr.h"
+
+static uint32_t frame[LED_MATRIX_PIXELS];  // Quadro sendo desenhado (GRB << 8)
+static uint32_t shadow[LED_MATRIX_PIXELS]; // Último quadro enviado; o DMA lê daqui
+static bool shadow_valid;                  // Falso até o primeiro envio (estado dos LEDs desconhecido)
+static led_matrix_stats_t stats;
+
+static inline uint32_t led_matrix_word(uint8_t r, uint8_t g, uint8_t b)
+{
+  // Ordem GRB nos 24 bits mais altos, como a PIO desloca os bits
+  return ((uint32_t)g << 24) | ((uint32_t)r << 16) | ((uint32_t)b << 8);
+}
+
+void led_matrix_init(unsigned int pin)
+{
+  memset(frame, 0, sizeof(frame));
+  shadow_valid = false;
+  memset(&stats, 0, sizeof(stats));
+  led_matrix_backend_init(pin);
+}
+
+void led_matrix_set(unsigned int index, uint8_t r, uint8_t g, uint8_t b)
+{
+  if (index < LED_MATRIX_PIXELS)
+    frame[index] = led_matrix_word(r, g, b);
+}
+
+void led_matrix_fill(uint8_t r, uint8_t g, uint8_t b)
+{
+  uint32_t word = led_matrix_word(r, g, b);
+  for (int i = 0; i < LED_MATRIX_PIXELS; i++)
+    frame[i] = word;
+}
+
+// Retorna false se o envio anterior (ou o seu reset) ainda não terminou; o
+// quadro continua pendente e pode ser tentado de novo na próxima chamada.
+static bool show_frame(void)
+{
+  if (shadow_valid && memcmp(frame, shadow, sizeof(frame)) == 0)
+  {
+    stats.frames_skipped++;
+    return true;
+  }
+  if (led_matrix_backend_busy())
+    return false;
+
+  memcpy(shadow, frame, sizeof(frame));
+  shadow_valid = true;
+  led_matrix_backend_send(shadow, LED_MATRIX_PIXELS);
+  stats.frames_sent++;
+  stats.words_sent += LED_MATRIX_PIXELS;
+  return true;
+}
+
+bool led_matrix_show(void)
+{
+  INSTR_TIME_BEGIN(start);
+  bool done = show_frame();
+  INSTR_TIME_END(INSTR_LEDS, start);
+  return done;
+}
+
+bool led_matrix_busy(void)
+{
+  return led_matrix_backend_busy();
+}
+
+void led_matrix_flush(void)
+{
+  // Espera o quadro atual chegar aos LEDs (envio e reset), para antes de um reboot
+  while (!led_matrix_show())
+    ;
+  while (led_matrix_backend_busy())
+    ;
+}
+
+void led_matrix_get_stats(led_matrix_stats_t *out)
+{
+  *out = stats;
+}
@@ -0,0 +1,36 @@
+#ifndef LED_MATRIX_H
+#define LED_MATRIX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Matriz 5x5 de LEDs WS2812. O quadro desenhado fica em RAM; led_matrix_show()
+// só envia se ele difere do último quadro enviado, por DMA para a máquina de
+// estados PIO. O intervalo de reset (latch) é contado em tempo, sem esperas.
+
+#define LED_MATRIX_PIXELS 25
+#define LED_MATRIX_WORD_US 30   // 24 bits a 800 kHz
+#define LED_MATRIX_RESET_US 300 // Reset mais longo entre as versões de WS2812
+
+typedef struct
+{
+  uint32_t frames_sent;    // Quadros enviados aos LEDs
+  uint32_t frames_skipped; // Quadros iguais ao anterior, não enviados
+  uint32_t words_sent;     // Palavras de 24 bits colocadas na PIO
+} led_matrix_stats_t;
+
+void led_matrix_init(unsigned int pin);
+void led_matrix_set(unsigned int index, uint8_t r, uint8_t g, uint8_t b);
+void led_matrix_fill(uint8_t r, uint8_t g, uint8_t b);
+bool led_matrix_show(void);
+bool led_matrix_busy(void);
+void led_matrix_flush(void);
+void led_matrix_get_stats(led_matrix_stats_t *stats);
+
+// Interface entre o núcleo e o backend (PIO + DMA no RP2040, contador no host)
+void led_matrix_backend_init(unsigned int pin);
+void led_matrix_backend_send(const uint32_t *words, size_t len);
+bool led_matrix_backend_busy(void);
+
+#endif
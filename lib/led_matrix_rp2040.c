@@ -0,0 +1,40 @@
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "ws2812.pio.h"
+#include "led_matrix.h"
+
+#define LED_MATRIX_FREQ_HZ 800000
+
+static PIO led_pio = pio0;
+static uint led_sm;
+static uint led_dma;
+static uint64_t latch_until_us; // Fim do envio atual mais o reset dos WS2812
+
+void led_matrix_backend_init(unsigned int pin)
+{
+  uint offset = pio_add_program(led_pio, &ws2812_program);
+  led_sm = pio_claim_unused_sm(led_pio, true);
+  ws2812_program_init(led_pio, led_sm, offset, pin, LED_MATRIX_FREQ_HZ, false);
+
+  led_dma = dma_claim_unused_channel(true);
+  dma_channel_config c = dma_channel_get_default_config(led_dma);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, pio_get_dreq(led_pio, led_sm, true));
+  dma_channel_configure(led_dma, &c, &led_pio->txf[led_sm], NULL, 0, false);
+  latch_until_us = 0;
+}
+
+void led_matrix_backend_send(const uint32_t *words, size_t len)
+{
+  // A PIO consome uma palavra a cada 30 µs; o reset começa quando a última sai
+  latch_until_us = time_us_64() + len * LED_MATRIX_WORD_US + LED_MATRIX_RESET_US;
+  dma_channel_transfer_from_buffer_now(led_dma, words, len);
+}
+
+bool led_matrix_backend_busy(void)
+{
+  return dma_channel_is_busy(led_dma) || time_us_64() < latch_until_us;
+}
@@ -0,0 +1,111 @@
+#include <string.h>
+#include "level_history.h"
+#include "noise_level.h"
+
+_Static_assert(sizeof(level_history_t) <= LEVEL_HISTORY_MAX_BYTES, "histórico de nível acima do orçamento de RAM");
+
+static uint8_t encode(uint64_t mean_square)
+{
+  if (mean_square == 0)
+    return 1;
+  int32_t code = (level_dbfs_x10(mean_square) - LEVEL_HISTORY_DB_MIN_X10) / 5 + 1;
+  return (uint8_t)(code < 1 ? 1 : code > 255 ? 255 : code);
+}
+
+static void tier_reset_acc(level_tier_state_t *t)
+{
+  t->acc_min = UINT16_MAX;
+  t->acc_max = 0;
+  t->acc_energy = 0;
+  t->acc_blocks = 0;
+  t->closed = 0;
+}
+
+// Grava a célula em curso da resolução (se recebeu algum bloco) e zera os acumuladores
+static void tier_close(level_tier_state_t *t)
+{
+  if (t->acc_blocks)
+  {
+    level_cell_t *cell = &t->cells[t->head];
+    cell->min = encode((uint64_t)t->acc_min * t->acc_min);
+    cell->max = encode((uint64_t)t->acc_max * t->acc_max);
+    cell->mean = encode(t->acc_energy / t->acc_blocks);
+    t->head = (uint16_t)((t->head + 1) % t->len);
+    t->pushed++;
+  }
+  tier_reset_acc(t);
+}
+
+void level_history_init(level_history_t *h, uint32_t samples_per_block, uint32_t sample_rate)
+{
+  memset(h, 0, sizeof(*h));
+  level_cell_t *cells[LEVEL_TIERS] = {h->seconds, h->minutes, h->quarters};
+  const uint16_t lens[LEVEL_TIERS] = {LEVEL_HISTORY_SECONDS, LEVEL_HISTORY_MINUTES, LEVEL_HISTORY_QUARTERS};
+  const uint8_t children[LEVEL_TIERS] = {0, 60, 15};
+  for (int i = 0; i < LEVEL_TIERS; i++)
+  {
+    h->tiers[i].cells = cells[i];
+    h->tiers[i].len = lens[i];
+    h->tiers[i].children = children[i];
+    tier_reset_acc(&h->tiers[i]);
+  }
+  h->samples_per_block = samples_per_block;
+  h->sample_rate = sample_rate;
+}
+
+void level_history_add(level_history_t *h, uint16_t rms)
+{
+  uint64_t energy = (uint64_t)rms * rms;
+  for (int i = 0; i < LEVEL_TIERS; i++)
+  {
+    level_tier_state_t *t = &h->tiers[i];
+    if (rms < t->acc_min)
+      t->acc_min = rms;
+    if (rms > t->acc_max)
+      t->acc_max = rms;
+    t->acc_energy += energy;
+    t->acc_blocks++;
+  }
+
+  h->samples += h->samples_per_block;
+  if (h->samples < h->sample_rate)
+    return;
+  h->samples -= h->sample_rate; // O resto vai para o segundo seguinte
+
+  // Cascata: o segundo sempre fecha; o minuto a cada 60 segundos e o quarto
+  // de hora a cada 15 minutos. Os acumuladores de cima já viram os mesmos
+  // blocos, então só contam os filhos fechados
+  tier_close(&h->tiers[LEVEL_TIER_SECOND]);
+  for (int i = LEVEL_TIER_MINUTE; i < LEVEL_TIERS; i++)
+  {
+    level_tier_state_t *t = &h->tiers[i];
+    if (++t->closed < t->children)
+      break;
+    tier_close(t);
+  }
+}
+
+uint16_t level_history_count(const level_history_t *h, level_tier_t tier)
+{
+  const level_tier_state_t *t = &h->tiers[tier];
+  return t->pushed < t->len ? (uint16_t)t->pushed : t->len;
+}
+
+uint32_t level_history_pushed(const level_history_t *h, level_tier_t tier)
+{
+  return h->tiers[tier].pushed;
+}
+
+bool level_history_get(const level_history_t *h, level_tier_t tier, uint16_t age, level_cell_t *cell)
+{
+  const level_tier_state_t *t = &h->tiers[tier];
+  if (age >= level_history_count(h, tier))
+    return false;
+  *cell = t->cells[(t->head + t->len - 1 - age) % t->len];
+  return true;
+}
+
+int16_t level_history_dbfs_x10(uint8_t code)
+{
+  return code ? (int16_t)(LEVEL_HISTORY_DB_MIN_X10 + (code - 1) * 5) : INT16_MIN;
+}
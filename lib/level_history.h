@@ -0,0 +1,72 @@
+#ifndef LEVEL_HISTORY_H
+#define LEVEL_HISTORY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Histórico do nível em RAM, em três resoluções com redução em cascata:
+// mínimo, média energética (Leq) e máximo por segundo, por minuto e por 15
+// minutos, cada resolução num buffer circular de tamanho fixo. Cada bloco
+// atualiza os três acumuladores (O(1)); ao fechar um segundo, um minuto ou um
+// quarto de hora, a célula correspondente é gravada sobre a mais antiga.
+//
+// As células guardam o nível em passos de 0,5 dB num byte cada (0 = vazia),
+// então o histórico ocupa 3 · (128 + 120 + 96) = 1032 bytes de células, mais
+// cerca de 140 bytes de estado e acumuladores; o total é verificado na
+// compilação contra LEVEL_HISTORY_MAX_BYTES. O tempo contado é o de
+// monitoração, dado pelas amostras dos blocos: as pausas na configuração não
+// aparecem no histórico.
+
+#define LEVEL_HISTORY_SECONDS 128  // Último 2 min 8 s (uma coluna do display por segundo)
+#define LEVEL_HISTORY_MINUTES 120  // Últimas 2 h
+#define LEVEL_HISTORY_QUARTERS 96  // Últimas 24 h, em células de 15 minutos
+#define LEVEL_HISTORY_MAX_BYTES 1280
+#define LEVEL_HISTORY_DB_MIN_X10 -1270 // Nível da célula de código 1, em décimos de dBFS (255 = 0 dBFS)
+
+typedef enum
+{
+  LEVEL_TIER_SECOND,
+  LEVEL_TIER_MINUTE,
+  LEVEL_TIER_QUARTER,
+  LEVEL_TIERS
+} level_tier_t;
+
+typedef struct
+{
+  uint8_t min, mean, max; // Códigos de 0,5 dB (0 = sem dados)
+} level_cell_t;
+
+typedef struct
+{
+  level_cell_t *cells;
+  uint16_t len;
+  uint16_t head;     // Próxima célula a gravar
+  uint32_t pushed;   // Células gravadas desde o início (quem desenha compara com o que já mostrou)
+  uint8_t children;  // Células da resolução anterior por célula desta
+  uint8_t closed;    // Células da resolução anterior já somadas a esta
+  uint16_t acc_min;  // Acumuladores da célula em curso (RMS em códigos do ADC)
+  uint16_t acc_max;
+  uint64_t acc_energy;
+  uint32_t acc_blocks;
+} level_tier_state_t;
+
+typedef struct
+{
+  level_cell_t seconds[LEVEL_HISTORY_SECONDS];
+  level_cell_t minutes[LEVEL_HISTORY_MINUTES];
+  level_cell_t quarters[LEVEL_HISTORY_QUARTERS];
+  level_tier_state_t tiers[LEVEL_TIERS];
+  uint32_t samples_per_block;
+  uint32_t sample_rate;
+  uint32_t samples; // Amostras do segundo em curso
+} level_history_t;
+
+void level_history_init(level_history_t *h, uint32_t samples_per_block, uint32_t sample_rate);
+void level_history_add(level_history_t *h, uint16_t rms); // Um bloco, RMS em códigos do ADC
+uint16_t level_history_count(const level_history_t *h, level_tier_t tier);
+uint32_t level_history_pushed(const level_history_t *h, level_tier_t tier);
+// age 0 é a célula mais nova; falso se ainda não existe
+bool level_history_get(const level_history_t *h, level_tier_t tier, uint16_t age, level_cell_t *cell);
+int16_t level_history_dbfs_x10(uint8_t code); // INT16_MIN para o código 0
+
+#endif
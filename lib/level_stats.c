@@ -0,0 +1,123 @@
+#include <string.h>
+#include "level_stats.h"
+#include "noise_level.h"
+
+_Static_assert(sizeof(level_stats_t) <= LEVEL_STATS_MAX_BYTES, "níveis estatísticos acima do orçamento de RAM");
+_Static_assert(LEVEL_STATS_BINS <= 256, "a classe cabe num byte");
+
+static const uint16_t interval_seconds[LEVEL_STATS_INTERVALS] = {60, 15 * 60};
+
+static void interval_reset(level_stats_state_t *st)
+{
+  memset(st->bins, 0, sizeof(st->bins));
+  st->samples = 0;
+  st->blocks = 0;
+  st->acc_min = UINT16_MAX;
+  st->acc_max = 0;
+}
+
+static int16_t rms_dbfs_x10(uint16_t rms)
+{
+  return rms ? level_dbfs_x10((uint64_t)rms * rms) : INT16_MIN;
+}
+
+uint8_t level_stats_bin(uint16_t rms)
+{
+  int32_t db = rms_dbfs_x10(rms);
+  if (db < LEVEL_STATS_DB_MIN_X10)
+    return 0;
+  int32_t bin = (db - LEVEL_STATS_DB_MIN_X10) / LEVEL_STATS_BIN_X10;
+  return (uint8_t)(bin >= LEVEL_STATS_BINS ? LEVEL_STATS_BINS - 1 : bin);
+}
+
+int16_t level_stats_bin_dbfs_x10(uint8_t bin)
+{
+  return (int16_t)(LEVEL_STATS_DB_MIN_X10 + bin * LEVEL_STATS_BIN_X10);
+}
+
+// Percentis numa varredura de cima para baixo: LN é a classe em que a contagem
+// acumulada passa da posição floor(N% · total) na ordem decrescente
+static void compute(const level_stats_state_t *st, level_stats_result_t *r)
+{
+  static const uint8_t percents[3] = {10, 50, 90};
+  int16_t *outs[3] = {&r->l10, &r->l50, &r->l90};
+  uint32_t total = 0;
+  for (int b = 0; b < LEVEL_STATS_BINS; b++)
+    total += st->bins[b]; // Com uma classe saturada, o total é o que o histograma ainda representa
+
+  uint32_t ranks[3];
+  for (int i = 0; i < 3; i++)
+    ranks[i] = total * percents[i] / 100;
+  uint32_t cumulative = 0;
+  int next = 0;
+  for (int b = LEVEL_STATS_BINS - 1; b >= 0 && next < 3; b--)
+  {
+    cumulative += st->bins[b];
+    while (next < 3 && cumulative > ranks[next])
+      *outs[next++] = level_stats_bin_dbfs_x10((uint8_t)b);
+  }
+  while (next < 3)
+    *outs[next++] = INT16_MIN; // Histograma vazio
+
+  r->lmax = rms_dbfs_x10(st->acc_max);
+  r->lmin = rms_dbfs_x10(st->acc_min);
+  r->blocks = st->blocks;
+}
+
+void level_stats_init(level_stats_t *s, uint32_t samples_per_block, uint32_t sample_rate)
+{
+  memset(s, 0, sizeof(*s));
+  for (int i = 0; i < LEVEL_STATS_INTERVALS; i++)
+  {
+    s->intervals[i].length = interval_seconds[i] * sample_rate;
+    interval_reset(&s->intervals[i]);
+  }
+  s->samples_per_block = samples_per_block;
+}
+
+void level_stats_add(level_stats_t *s, uint16_t rms)
+{
+  uint8_t bin = level_stats_bin(rms);
+  for (int i = 0; i < LEVEL_STATS_INTERVALS; i++)
+  {
+    level_stats_state_t *st = &s->intervals[i];
+    if (st->bins[bin] != UINT16_MAX)
+      st->bins[bin]++;
+    if (rms < st->acc_min)
+      st->acc_min = rms;
+    if (rms > st->acc_max)
+      st->acc_max = rms;
+    st->blocks++;
+    st->samples += s->samples_per_block;
+    if (st->samples >= st->length)
+    {
+      // O bloco que completa o intervalo fica nele; o resto das amostras vai para o seguinte
+      uint32_t carry = st->samples - st->length;
+      compute(st, &st->last);
+      st->completed++;
+      interval_reset(st);
+      st->samples = carry;
+    }
+  }
+}
+
+bool level_stats_get(const level_stats_t *s, level_stats_interval_t interval, bool current, level_stats_result_t *r)
+{
+  const level_stats_state_t *st = &s->intervals[interval];
+  if (current)
+  {
+    if (st->blocks == 0)
+      return false;
+    compute(st, r);
+    return true;
+  }
+  if (st->completed == 0)
+    return false;
+  *r = st->last;
+  return true;
+}
+
+uint32_t level_stats_completed(const level_stats_t *s, level_stats_interval_t interval)
+{
+  return s->intervals[interval].completed;
+}
@@ -0,0 +1,67 @@
+#ifndef LEVEL_STATS_H
+#define LEVEL_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Níveis estatísticos (L10, L50, L90) e extremos (Lmax, Lmin) do nível por
+// intervalos consecutivos de 1 e de 15 minutos, sem guardar os blocos: cada
+// intervalo tem um histograma do nível em classes de 0,5 dB (espaçadas em log
+// na amplitude) de -70 a 0 dBFS, com contadores de 16 bits que saturam em vez
+// de dar a volta. Cada bloco soma 1 numa classe (O(1)); os percentis saem de
+// uma varredura das classes, feita só quando um intervalo fecha ou a tela
+// pede o intervalo em curso. LN é o nível excedido em N% dos blocos.
+//
+// Memória fixa: 2 · 140 classes · 2 bytes = 560 bytes de histogramas, mais
+// 76 bytes de estado e resultados (636 bytes); o total é verificado na
+// compilação contra LEVEL_STATS_MAX_BYTES. Os percentis têm a resolução da
+// classe: o valor é o limite de baixo da classe (até 0,5 dB abaixo do exato);
+// Lmax e Lmin são exatos. Como em lib/level_history.h, o tempo é o de
+// monitoração, dado pelas amostras dos blocos.
+
+#define LEVEL_STATS_DB_MIN_X10 -700 // Limite de baixo da primeira classe, em décimos de dBFS
+#define LEVEL_STATS_BIN_X10 5       // Largura da classe: 0,5 dB
+#define LEVEL_STATS_BINS 140        // Até 0 dBFS; abaixo de -70 dBFS conta na primeira classe
+#define LEVEL_STATS_MAX_BYTES 640
+
+typedef enum
+{
+  LEVEL_STATS_MINUTE,
+  LEVEL_STATS_QUARTER, // 15 minutos
+  LEVEL_STATS_INTERVALS
+} level_stats_interval_t;
+
+typedef struct
+{
+  int16_t l10, l50, l90; // Décimos de dBFS
+  int16_t lmax, lmin;
+  uint32_t blocks;       // Blocos no intervalo (0: sem dados)
+} level_stats_result_t;
+
+typedef struct
+{
+  uint16_t bins[LEVEL_STATS_BINS];
+  uint32_t length;      // Amostras por intervalo
+  uint32_t samples;     // Amostras do intervalo em curso
+  uint32_t blocks;      // Blocos do intervalo em curso
+  uint16_t acc_min;     // RMS extremos do intervalo em curso, em códigos do ADC
+  uint16_t acc_max;
+  uint32_t completed;   // Intervalos fechados desde o início
+  level_stats_result_t last; // Último intervalo fechado
+} level_stats_state_t;
+
+typedef struct
+{
+  level_stats_state_t intervals[LEVEL_STATS_INTERVALS];
+  uint32_t samples_per_block;
+} level_stats_t;
+
+void level_stats_init(level_stats_t *s, uint32_t samples_per_block, uint32_t sample_rate);
+void level_stats_add(level_stats_t *s, uint16_t rms); // Um bloco, RMS em códigos do ADC
+// Intervalo em curso (current) ou o último fechado; falso se ainda não tem blocos
+bool level_stats_get(const level_stats_t *s, level_stats_interval_t interval, bool current, level_stats_result_t *r);
+uint32_t level_stats_completed(const level_stats_t *s, level_stats_interval_t interval);
+uint8_t level_stats_bin(uint16_t rms); // Classe do histograma para um RMS
+int16_t level_stats_bin_dbfs_x10(uint8_t bin); // Limite de baixo da classe
+
+#endif
@@ -0,0 +1,122 @@
+#include "noise_floor.h"
+#include "noise_level.h"
+
+#define NOISE_FLOOR_RMS_MAX 4095 // Maior RMS possível de um bloco, em códigos do ADC
+
+static uint32_t next_random(noise_floor_t *nf)
+{
+  uint32_t x = nf->rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  nf->rng = x;
+  return x;
+}
+
+static int16_t rms_dbfs_x10(uint16_t rms)
+{
+  if (rms == 0)
+    return NOISE_FLOOR_MIN_DBFS_X10;
+  int16_t db = level_dbfs_x10((uint64_t)rms * rms);
+  return db < NOISE_FLOOR_MIN_DBFS_X10 ? NOISE_FLOOR_MIN_DBFS_X10 : db;
+}
+
+// Frugal-2U: sobe com probabilidade q quando a amostra está acima e desce com
+// probabilidade 1 - q quando está abaixo, com o passo crescendo enquanto o
+// sentido se mantém e voltando a 1 quando a estimativa passa da amostra
+static void frugal_update(noise_floor_t *nf, int16_t x)
+{
+  uint32_t draw = next_random(nf) >> 16;
+  int32_t m = nf->quantile;
+  int32_t step = nf->step;
+
+  if (x > m && draw < NOISE_FLOOR_QUANTILE_Q16)
+  {
+    step += nf->sign > 0 ? 1 : -1;
+    m += step > 0 ? step : 1;
+    nf->sign = 1;
+    if (m > x)
+    {
+      step += x - m;
+      m = x;
+    }
+  }
+  else if (x < m && draw >= NOISE_FLOOR_QUANTILE_Q16)
+  {
+    step += nf->sign < 0 ? 1 : -1;
+    m -= step > 0 ? step : 1;
+    nf->sign = -1;
+    if (m < x)
+    {
+      step += m - x;
+      m = x;
+    }
+  }
+  if ((m - x) * nf->sign < 0 && step > 1)
+    step = 1;
+
+  nf->quantile = (int16_t)m;
+  nf->step = (int16_t)(step < INT16_MIN ? INT16_MIN : step > INT16_MAX ? INT16_MAX : step);
+}
+
+void noise_floor_init(noise_floor_t *nf, uint32_t blocks_per_second)
+{
+  nf->quantile = 0;
+  nf->step = 1;
+  nf->sign = 1;
+  nf->rng = 0x2545F491u;
+  nf->floor_q16 = 0;
+  nf->fall_alpha_q16 = (int32_t)(65536 / (NOISE_FLOOR_FALL_S * blocks_per_second));
+  nf->rise_alpha_q16 = (int32_t)(65536 / (NOISE_FLOOR_RISE_S * blocks_per_second));
+  nf->blocks = 0;
+  nf->warmup_blocks = NOISE_FLOOR_WARMUP_S * blocks_per_second;
+}
+
+void noise_floor_update(noise_floor_t *nf, uint16_t rms)
+{
+  int16_t x = rms_dbfs_x10(rms);
+  if (nf->blocks == 0)
+    nf->quantile = x; // Semeia com o primeiro bloco
+  frugal_update(nf, x);
+
+  int32_t target = (int32_t)nf->quantile << 16;
+  if (nf->blocks < nf->warmup_blocks)
+  {
+    nf->floor_q16 = target; // Durante o aprendizado inicial o piso é o próprio quantil
+    nf->blocks++;
+    return;
+  }
+  int32_t alpha = target < nf->floor_q16 ? nf->fall_alpha_q16 : nf->rise_alpha_q16;
+  nf->floor_q16 += (int32_t)(((int64_t)(target - nf->floor_q16) * alpha) >> 16);
+  if (nf->blocks != UINT32_MAX)
+    nf->blocks++;
+}
+
+bool noise_floor_ready(const noise_floor_t *nf)
+{
+  return nf->blocks >= nf->warmup_blocks;
+}
+
+int16_t noise_floor_dbfs_x10(const noise_floor_t *nf)
+{
+  return (int16_t)(nf->floor_q16 >> 16);
+}
+
+uint16_t noise_floor_threshold(const noise_floor_t *nf, int16_t margin_x10)
+{
+  int32_t target = noise_floor_dbfs_x10(nf) + margin_x10;
+  // Menor RMS com nível >= alvo: busca binária sobre a mesma conversão do
+  // nível medido, então o limiar é coerente com a comparação (12 passos)
+  uint16_t lo = 0, hi = NOISE_FLOOR_RMS_MAX;
+  if (rms_dbfs_x10(hi) < target)
+    return hi;
+  while (lo < hi)
+  {
+    uint16_t mid = (uint16_t)((lo + hi) / 2);
+    if (rms_dbfs_x10(mid) >= target)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return lo;
+}
@@ -0,0 +1,49 @@
+#ifndef NOISE_FLOOR_H
+#define NOISE_FLOOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Aprendizado do ruído de fundo para o modo adaptativo: o range de detecção
+// passa a ser uma margem em torno do piso aprendido, em vez de valores fixos.
+// Memória constante e custo O(1) por bloco, sem histórico de amostras:
+//
+// - Um estimador frugal (Frugal-2U, de Ma, Muthukrishnan e Sandler) acompanha
+//   o quantil NOISE_FLOOR_QUANTILE_Q16 do nível por bloco, em décimos de dBFS.
+//   Picos curtos (vozes, batidas) quase não o movem, e o passo cresce enquanto
+//   ele anda no mesmo sentido, então mudanças do fundo são seguidas.
+// - Duas médias exponenciais suavizam a estimativa: o piso desce com a
+//   constante rápida e sobe com a lenta, para que um aumento gradual do ruído
+//   não seja absorvido antes de disparar o alerta.
+//
+// Quem chama deixa de chamar noise_floor_update() durante um alerta, o que
+// congela o aprendizado.
+
+#define NOISE_FLOOR_QUANTILE_Q16 6554 // Quantil de 10% (o L90 da acústica), em Q16
+#define NOISE_FLOOR_FALL_S 2          // Constante de tempo da descida do piso (s)
+#define NOISE_FLOOR_RISE_S 60         // Constante de tempo da subida do piso (s)
+#define NOISE_FLOOR_WARMUP_S 10       // Aprendizado inicial, sem piso válido (s)
+#define NOISE_FLOOR_MIN_DBFS_X10 -800 // Nível atribuído a um bloco em silêncio absoluto (RMS 0)
+
+typedef struct
+{
+  int16_t quantile;       // Estimativa frugal do quantil, em décimos de dBFS
+  int16_t step;           // Passo do estimador, em décimos de dB
+  int8_t sign;            // Sentido do último passo (+1 ou -1)
+  uint32_t rng;           // Estado do xorshift32 dos sorteios do estimador
+  int32_t floor_q16;      // Piso suavizado, em décimos de dBFS (Q16)
+  int32_t fall_alpha_q16; // Peso de cada bloco na descida do piso
+  int32_t rise_alpha_q16; // Peso de cada bloco na subida do piso
+  uint32_t blocks;        // Blocos aprendidos
+  uint32_t warmup_blocks;
+} noise_floor_t;
+
+void noise_floor_init(noise_floor_t *nf, uint32_t blocks_per_second);
+void noise_floor_update(noise_floor_t *nf, uint16_t rms); // Um bloco, RMS em códigos do ADC
+bool noise_floor_ready(const noise_floor_t *nf);          // Passou o aprendizado inicial
+int16_t noise_floor_dbfs_x10(const noise_floor_t *nf);
+// RMS, em códigos do ADC, do nível margin_x10 décimos de dB acima (ou abaixo,
+// se negativo) do piso; fica entre 0 e o fundo de escala
+uint16_t noise_floor_threshold(const noise_floor_t *nf, int16_t margin_x10);
+
+#endif
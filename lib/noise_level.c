@@ -0,0 +1,143 @@
+#include <string.h>
+#include "noise_level.h"
+
+// log2(1 + i/32) em Q16, para a parte fracionária do logaritmo
+static const uint16_t log2_frac_table[33] = {
+    0, 2909, 5732, 8473, 11136, 13727, 16248, 18704,
+    21098, 23433, 25711, 27936, 30109, 32234, 34312, 36346,
+    38336, 40286, 42196, 44068, 45904, 47705, 49472, 51207,
+    52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047,
+    65535,
+};
+
+void dc_blocker_init(dc_blocker_t *dc)
+{
+  dc->dc = 0;
+  dc->primed = false;
+}
+
+void dc_blocker_process(dc_blocker_t *dc, const uint16_t *in, int16_t *out, size_t len)
+{
+  if (len == 0)
+    return;
+  if (!dc->primed)
+  {
+    // Semeia com a primeira amostra para evitar um transitório longo na partida
+    dc->dc = (int32_t)in[0] << 16;
+    dc->primed = true;
+  }
+
+  // Passa-altas de um polo: dc += (x - dc) / 2^DC_BLOCKER_SHIFT
+  int32_t acc = dc->dc;
+  for (size_t i = 0; i < len; i++)
+  {
+    int32_t x = (int32_t)in[i] << 16;
+    out[i] = (int16_t)(in[i] - ((acc + 0x8000) >> 16));
+    acc += (x - acc) >> DC_BLOCKER_SHIFT;
+  }
+  dc->dc = acc;
+}
+
+void noise_level_init(noise_level_t *lvl)
+{
+  memset(lvl, 0, sizeof(*lvl));
+}
+
+void noise_level_process(noise_level_t *lvl, const int16_t *x, size_t len)
+{
+  // Soma dos quadrados do bloco: |x| <= 4095, então x² cabe em 32 bits
+  uint64_t energy = 0;
+  uint32_t peak = 0;
+  for (size_t i = 0; i < len; i++)
+  {
+    int32_t s = x[i];
+    uint32_t a = (uint32_t)(s < 0 ? -s : s);
+    energy += (uint32_t)(s * s);
+    if (a > peak)
+      peak = a;
+  }
+
+  // Janela deslizante: substitui o bloco mais antigo pelo atual
+  lvl->window_energy += energy - lvl->slot_energy[lvl->slot];
+  lvl->window_samples += (uint32_t)len - lvl->slot_samples[lvl->slot];
+  lvl->slot_energy[lvl->slot] = energy;
+  lvl->slot_samples[lvl->slot] = (uint32_t)len;
+  lvl->slot = (uint8_t)((lvl->slot + 1) % LEVEL_WINDOW_BLOCKS);
+
+  lvl->leq_energy += energy;
+  lvl->leq_samples += len;
+
+  lvl->peak = (uint16_t)peak;
+  lvl->rms = lvl->window_samples ? (uint16_t)level_isqrt64(lvl->window_energy / lvl->window_samples) : 0;
+}
+
+void noise_level_reset_leq(noise_level_t *lvl)
+{
+  lvl->leq_energy = 0;
+  lvl->leq_samples = 0;
+}
+
+uint16_t noise_level_rms(const noise_level_t *lvl)
+{
+  return lvl->rms;
+}
+
+uint16_t noise_level_leq(const noise_level_t *lvl)
+{
+  // Amplitude RMS equivalente a toda a energia acumulada, em códigos do ADC
+  return lvl->leq_samples ? (uint16_t)level_isqrt64(lvl->leq_energy / lvl->leq_samples) : 0;
+}
+
+int16_t noise_level_leq_dbfs_x10(const noise_level_t *lvl)
+{
+  return lvl->leq_samples ? level_dbfs_x10(lvl->leq_energy / lvl->leq_samples) : INT16_MIN;
+}
+
+uint32_t level_isqrt64(uint64_t x)
+{
+  // Raiz quadrada inteira bit a bit (arredondada para baixo)
+  uint64_t root = 0;
+  uint64_t bit = 1ull << 62;
+  while (bit > x)
+    bit >>= 2;
+  while (bit)
+  {
+    if (x >= root + bit)
+    {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+int32_t level_log2_q16(uint64_t x)
+{
+  if (x == 0)
+    return INT32_MIN;
+
+  // Parte inteira pela posição do bit mais significativo
+  int32_t msb = 63 - __builtin_clzll(x);
+  // Mantissa normalizada em Q16, no intervalo [1, 2)
+  uint32_t mant = msb >= 16 ? (uint32_t)(x >> (msb - 16)) : (uint32_t)(x << (16 - msb));
+  uint32_t frac = mant & 0xFFFF;
+  uint32_t idx = frac >> 11;    // 32 segmentos
+  uint32_t rem = frac & 0x7FF;  // Posição dentro do segmento (11 bits)
+  uint32_t lo = log2_frac_table[idx];
+  uint32_t hi = log2_frac_table[idx + 1];
+  return (msb << 16) + (int32_t)(lo + (((hi - lo) * rem) >> 11));
+}
+
+int16_t level_dbfs_x10(uint64_t mean_square)
+{
+  if (mean_square == 0)
+    return INT16_MIN;
+  // 10·log10(x) = 3,0103·log2(x); em décimos de dB: log2_q16 · 30,103 / 65536
+  int32_t log2_rel = level_log2_q16(mean_square) - (LEVEL_FULL_SCALE_LOG2 << 16);
+  return (int16_t)(((int64_t)log2_rel * 30825) >> 26);
+}
@@ -0,0 +1,50 @@
+#ifndef NOISE_LEVEL_H
+#define NOISE_LEVEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Motor de nível de ruído por blocos, somente com aritmética inteira:
+// remoção de DC, RMS em janela deslizante e nível equivalente contínuo (Leq).
+// Não há divisão por amostra; as divisões e raízes ocorrem uma vez por bloco.
+
+#define DC_BLOCKER_SHIFT 10      // Constante de tempo de 1024 amostras (~1,2 Hz de corte a 8 kHz)
+#define LEVEL_WINDOW_BLOCKS 4    // Blocos na janela do RMS (128 ms com blocos de 32 ms)
+#define LEVEL_FULL_SCALE_LOG2 22 // log2(2048²): amplitude de fundo de escala do ADC de 12 bits ao quadrado
+#define LEVEL_RMS_MAX 2048       // RMS de uma onda quadrada de fundo de escala: o maior nível sem DC
+
+typedef struct
+{
+  int32_t dc;  // Estimativa do nível DC em Q16 (código do ADC << 16)
+  bool primed; // A estimativa já foi semeada com a primeira amostra
+} dc_blocker_t;
+
+typedef struct
+{
+  uint64_t slot_energy[LEVEL_WINDOW_BLOCKS]; // Soma dos quadrados de cada bloco da janela
+  uint32_t slot_samples[LEVEL_WINDOW_BLOCKS];
+  uint64_t window_energy;
+  uint32_t window_samples;
+  uint8_t slot;
+  uint64_t leq_energy; // Energia acumulada desde o último reset do Leq
+  uint64_t leq_samples;
+  uint16_t rms;  // RMS da janela, em códigos do ADC
+  uint16_t peak; // Pico absoluto do último bloco
+} noise_level_t;
+
+void dc_blocker_init(dc_blocker_t *dc);
+void dc_blocker_process(dc_blocker_t *dc, const uint16_t *in, int16_t *out, size_t len);
+
+void noise_level_init(noise_level_t *lvl);
+void noise_level_process(noise_level_t *lvl, const int16_t *x, size_t len);
+void noise_level_reset_leq(noise_level_t *lvl);
+uint16_t noise_level_rms(const noise_level_t *lvl);
+uint16_t noise_level_leq(const noise_level_t *lvl);
+int16_t noise_level_leq_dbfs_x10(const noise_level_t *lvl);
+
+uint32_t level_isqrt64(uint64_t x);
+int32_t level_log2_q16(uint64_t x);
+int16_t level_dbfs_x10(uint64_t mean_square);
+
+#endif
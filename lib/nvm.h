@@ -0,0 +1,28 @@
+#ifndef NVM_H
+#define NVM_H
+
+#include <stdint.h>
+
+// Região reservada no fim da flash para dados que sobrevivem ao reset,
+// dividida entre os módulos. A flash é NOR: apagar põe um setor inteiro em
+// 0xFF (até centenas de ms) e gravar uma página só leva bits de 1 para 0, então
+// uma página pode ser reprogramada com o mesmo conteúdo mais dados novos em
+// bytes ainda apagados.
+
+#define NVM_PAGE_BYTES 256
+#define NVM_SECTOR_BYTES 4096
+#define NVM_EVENT_LOG_OFFSET 0                        // lib/event_log.h (4 setores)
+#define NVM_SETTINGS_OFFSET (4 * NVM_SECTOR_BYTES)    // lib/settings.h (2 setores)
+#define NVM_REGION_BYTES (6 * NVM_SECTOR_BYTES)
+// Pior caso de uma gravação de página (tPP máximo da flash do Pico, com a
+// entrada e a saída do bloqueio do núcleo 1). Apagar leva até centenas de ms e
+// só acontece com a aquisição parada (lib/event_log.h, lib/settings.h)
+#define NVM_PROGRAM_MAX_US 3000
+
+// Interface com o backend (lib/nvm_rp2040.c no firmware, host/nvm_host.c no host).
+// Os deslocamentos são relativos ao início da região e alinhados a página ou setor.
+const uint8_t *nvm_backend_region(void); // Leitura direta (XIP no RP2040)
+void nvm_backend_erase(uint32_t offset);
+void nvm_backend_program(uint32_t offset, const uint8_t *page);
+
+#endif
@@ -0,0 +1,50 @@
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "nvm.h"
+
+// Região no fim da flash, longe do programa (que começa no início)
+#define NVM_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - NVM_REGION_BYTES)
+
+_Static_assert(NVM_PAGE_BYTES == FLASH_PAGE_SIZE, "página da NVM difere da flash");
+_Static_assert(NVM_SECTOR_BYTES == FLASH_SECTOR_SIZE, "setor da NVM difere da flash");
+
+const uint8_t *nvm_backend_region(void)
+{
+  return (const uint8_t *)(XIP_BASE + NVM_FLASH_OFFSET);
+}
+
+// Enquanto a flash grava, nada pode executar dela: o núcleo 1 fica preso num
+// laço em RAM (multicore_lockout) e as interrupções deste núcleo são
+// desligadas. O DMA da aquisição continua gravando os trechos crus, mas a
+// interrupção que os decima, no núcleo 1, só roda depois: durante a aquisição
+// só há gravações de página, mais curtas que um trecho (NVM_PROGRAM_MAX_US,
+// lib/acquisition_rp2040.c), e um atraso maior é detectado e contado como perda.
+static uint32_t flash_begin(void)
+{
+  if (multicore_lockout_victim_is_initialized(1))
+    multicore_lockout_start_blocking();
+  return save_and_disable_interrupts();
+}
+
+static void flash_end(uint32_t irq)
+{
+  restore_interrupts(irq);
+  if (multicore_lockout_victim_is_initialized(1))
+    multicore_lockout_end_blocking();
+}
+
+void nvm_backend_erase(uint32_t offset)
+{
+  uint32_t irq = flash_begin();
+  flash_range_erase(NVM_FLASH_OFFSET + offset, FLASH_SECTOR_SIZE);
+  flash_end(irq);
+}
+
+void nvm_backend_program(uint32_t offset, const uint8_t *page)
+{
+  uint32_t irq = flash_begin();
+  flash_range_program(NVM_FLASH_OFFSET + offset, page, FLASH_PAGE_SIZE);
+  flash_end(irq);
+}
@@ -0,0 +1,83 @@
+#include "scheduler.h"
+#include "instr.h"
+
+static sched_task_t *task_table;
+static size_t task_count;
+static uint32_t tick_period_us;
+static uint32_t last_pass_us;
+
+void sched_init(sched_task_t *tasks, size_t count, uint32_t tick_us)
+{
+  task_table = tasks;
+  task_count = count;
+  tick_period_us = tick_us;
+  uint32_t now = sched_backend_now_us();
+  last_pass_us = now;
+  // Primeira liberação no primeiro tick: liberada antes, uma tarefa com o
+  // período do tick ficaria um tick atrasada para sempre, perdendo todo prazo
+  for (size_t i = 0; i < count; i++)
+    tasks[i].next_release_us = now + tick_us;
+  sched_reset_stats();
+  sched_backend_start(tick_us);
+}
+
+void sched_reset_stats(void)
+{
+  for (size_t i = 0; i < task_count; i++)
+  {
+    sched_task_t *t = &task_table[i];
+    t->runs = 0;
+    t->misses = 0;
+    t->skipped = 0;
+    t->last_run_us = 0;
+    t->max_run_us = 0;
+    t->total_run_us = 0;
+  }
+}
+
+// Espera o próximo tick e executa, em ordem, todas as tarefas liberadas
+void sched_run_pending(void)
+{
+  sched_backend_wait_tick();
+  uint32_t pass_start = sched_backend_now_us();
+  INSTR_RECORD(INSTR_SCHED_PERIOD, pass_start - last_pass_us);
+  last_pass_us = pass_start;
+
+  for (size_t i = 0; i < task_count; i++)
+  {
+    sched_task_t *t = &task_table[i];
+    uint32_t start = sched_backend_now_us();
+    if ((int32_t)(start - t->next_release_us) < 0)
+      continue;
+
+    t->run();
+
+    uint32_t end = sched_backend_now_us();
+    uint32_t elapsed = end - start;
+    t->runs++;
+    t->last_run_us = elapsed;
+    t->total_run_us += elapsed;
+    if (elapsed > t->max_run_us)
+      t->max_run_us = elapsed;
+
+    // Prazo = próxima liberação; atrasos maiores que um período descartam
+    // liberações em vez de executar a tarefa várias vezes seguidas
+    t->next_release_us += t->period_us;
+    if ((int32_t)(end - t->next_release_us) > 0)
+    {
+      t->misses++;
+      while ((int32_t)(end - t->next_release_us) >= (int32_t)t->period_us)
+      {
+        t->next_release_us += t->period_us;
+        t->skipped++;
+      }
+    }
+  }
+
+#ifdef DETECTOR_INSTR
+  uint32_t pass_us = sched_backend_now_us() - pass_start;
+  INSTR_RECORD(INSTR_SCHED_PASS, pass_us);
+  if (pass_us > tick_period_us)
+    INSTR_COUNT(INSTR_SCHED_OVERRUNS, 1);
+#endif
+}
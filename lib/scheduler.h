@@ -0,0 +1,37 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Escalonador cooperativo de taxa fixa: uma tabela de tarefas, cada uma com
+// o seu período, executadas em ordem de prioridade (a ordem da tabela) a cada
+// tick do timer. Mede o tempo de execução e os prazos perdidos de cada tarefa.
+// O backend do RP2040 usa repeating_timer; o do host, um relógio simulado.
+
+typedef struct
+{
+  const char *name;
+  void (*run)(void);
+  uint32_t period_us;
+  // Preenchidos pelo escalonador
+  uint32_t next_release_us; // Próxima liberação da tarefa
+  uint32_t runs;            // Execuções
+  uint32_t misses;          // Execuções concluídas depois do prazo (a liberação seguinte)
+  uint32_t skipped;         // Liberações descartadas por atraso maior que um período
+  uint32_t last_run_us;     // Duração da última execução
+  uint32_t max_run_us;      // Maior duração observada
+  uint64_t total_run_us;    // Soma das durações, para a média
+} sched_task_t;
+
+void sched_init(sched_task_t *tasks, size_t count, uint32_t tick_us);
+void sched_run_pending(void);
+void sched_reset_stats(void);
+
+// Interface com o backend (timer do RP2040 ou relógio simulado no host)
+uint32_t sched_backend_now_us(void);
+void sched_backend_start(uint32_t tick_us);
+void sched_backend_wait_tick(void);
+
+#endif
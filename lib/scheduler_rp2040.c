@@ -0,0 +1,32 @@
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "scheduler.h"
+
+static repeating_timer_t sched_timer;
+static volatile bool sched_tick;
+
+static bool sched_tick_callback(repeating_timer_t *rt)
+{
+  (void)rt;
+  sched_tick = true;
+  __sev(); // Acorda o núcleo parado em __wfe()
+  return true;
+}
+
+uint32_t sched_backend_now_us(void)
+{
+  return time_us_32();
+}
+
+void sched_backend_start(uint32_t tick_us)
+{
+  // Período negativo: intervalo entre inícios, independente da duração do callback
+  add_repeating_timer_us(-(int64_t)tick_us, sched_tick_callback, NULL, &sched_timer);
+}
+
+void sched_backend_wait_tick(void)
+{
+  while (!sched_tick)
+    __wfe();
+  sched_tick = false;
+}
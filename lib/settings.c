@@ -0,0 +1,140 @@
+#include <string.h>
+#include "settings.h"
+#include "crc.h"
+
+// Registro: magia | versão | tamanho dos dados | seq | dados... | CRC
+#define SETTINGS_MAGIC 0x53474643u // "CFGS"
+#define SETTINGS_DATA_OFFSET 10
+#define SETTINGS_CRC_OFFSET (SETTINGS_RECORD_BYTES - 2)
+#define SETTINGS_DATA_MAX (SETTINGS_CRC_OFFSET - SETTINGS_DATA_OFFSET)
+#define SETTINGS_DATA_V1 4 // threshold_min, threshold_max
+#define SETTINGS_DATA_V2 5 // + mode
+#define SETTINGS_SLOTS (NVM_SECTOR_BYTES / SETTINGS_RECORD_BYTES)
+
+_Static_assert(NVM_SETTINGS_OFFSET + SETTINGS_SECTORS * NVM_SECTOR_BYTES <= NVM_REGION_BYTES,
+               "configuração fora da região NVM");
+
+static uint8_t page[NVM_PAGE_BYTES];
+
+static const uint8_t *slot_ptr(int sector, int slot)
+{
+  return nvm_backend_region() + NVM_SETTINGS_OFFSET + (uint32_t)sector * NVM_SECTOR_BYTES +
+         (uint32_t)slot * SETTINGS_RECORD_BYTES;
+}
+
+static bool slot_erased(const uint8_t *p)
+{
+  for (int i = 0; i < SETTINGS_RECORD_BYTES; i++)
+  {
+    if (p[i] != 0xFF)
+      return false;
+  }
+  return true;
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+  return p[0] | p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static bool slot_valid(const uint8_t *p)
+{
+  uint16_t crc = (uint16_t)(p[SETTINGS_CRC_OFFSET] | p[SETTINGS_CRC_OFFSET + 1] << 8);
+  return crc == crc16_update(CRC16_INIT, p, SETTINGS_CRC_OFFSET) && get32(p) == SETTINGS_MAGIC && p[4] != 0 &&
+         p[5] >= SETTINGS_DATA_V1 && p[5] <= SETTINGS_DATA_MAX;
+}
+
+// Registro vigente (o de maior seq); falso se não há nenhum válido
+static bool find_latest(int *sector, int *slot, uint32_t *seq)
+{
+  bool found = false;
+  for (int s = 0; s < SETTINGS_SECTORS; s++)
+  {
+    for (int i = 0; i < SETTINGS_SLOTS; i++)
+    {
+      const uint8_t *p = slot_ptr(s, i);
+      if (slot_erased(p) || !slot_valid(p))
+        continue;
+      uint32_t candidate = get32(p + 6);
+      if (!found || candidate > *seq)
+      {
+        *sector = s;
+        *slot = i;
+        *seq = candidate;
+        found = true;
+      }
+    }
+  }
+  return found;
+}
+
+// Primeiro slot depois do último usado no setor (SETTINGS_SLOTS se cheio)
+static int free_slot(int sector)
+{
+  int slot = SETTINGS_SLOTS;
+  while (slot > 0 && slot_erased(slot_ptr(sector, slot - 1)))
+    slot--;
+  return slot;
+}
+
+bool settings_load(settings_t *settings)
+{
+  int sector, slot;
+  uint32_t seq;
+  if (!find_latest(&sector, &slot, &seq))
+    return false;
+  const uint8_t *data = slot_ptr(sector, slot) + SETTINGS_DATA_OFFSET;
+  settings->threshold_min = (uint16_t)(data[0] | data[1] << 8);
+  settings->threshold_max = (uint16_t)(data[2] | data[3] << 8);
+  uint8_t len = slot_ptr(sector, slot)[5];
+  settings->mode = len >= SETTINGS_DATA_V2 ? data[4] : SETTINGS_MODE_FIXED;
+  return true;
+}
+
+bool settings_save(const settings_t *settings)
+{
+  settings_t current;
+  if (settings_load(&current) && current.threshold_min == settings->threshold_min &&
+      current.threshold_max == settings->threshold_max && current.mode == settings->mode)
+    return true; // Nada mudou: não gasta a flash
+
+  int sector = 0, slot = 0;
+  uint32_t seq = 0;
+  bool any = find_latest(&sector, &slot, &seq);
+  slot = free_slot(sector);
+  if (slot == SETTINGS_SLOTS)
+  {
+    // Setor cheio: continua no outro, que não tem o registro vigente
+    sector ^= 1;
+    nvm_backend_erase(NVM_SETTINGS_OFFSET + (uint32_t)sector * NVM_SECTOR_BYTES);
+    slot = 0;
+  }
+
+  uint8_t record[SETTINGS_RECORD_BYTES];
+  memset(record, 0, sizeof(record));
+  uint32_t next_seq = any ? seq + 1 : 0;
+  for (int i = 0; i < 4; i++)
+  {
+    record[i] = (uint8_t)(SETTINGS_MAGIC >> (8 * i));
+    record[6 + i] = (uint8_t)(next_seq >> (8 * i));
+  }
+  record[4] = SETTINGS_VERSION;
+  record[5] = SETTINGS_DATA_V2;
+  uint8_t *data = record + SETTINGS_DATA_OFFSET;
+  data[0] = (uint8_t)settings->threshold_min;
+  data[1] = (uint8_t)(settings->threshold_min >> 8);
+  data[2] = (uint8_t)settings->threshold_max;
+  data[3] = (uint8_t)(settings->threshold_max >> 8);
+  data[4] = settings->mode;
+  uint16_t crc = crc16_update(CRC16_INIT, record, SETTINGS_CRC_OFFSET);
+  record[SETTINGS_CRC_OFFSET] = (uint8_t)crc;
+  record[SETTINGS_CRC_OFFSET + 1] = (uint8_t)(crc >> 8);
+
+  // A página é reprogramada com os registros anteriores intactos
+  int first = slot - slot % (NVM_PAGE_BYTES / SETTINGS_RECORD_BYTES);
+  memcpy(page, slot_ptr(sector, first), NVM_PAGE_BYTES);
+  memcpy(page + (slot - first) * SETTINGS_RECORD_BYTES, record, SETTINGS_RECORD_BYTES);
+  nvm_backend_program(NVM_SETTINGS_OFFSET + (uint32_t)sector * NVM_SECTOR_BYTES + (uint32_t)first * SETTINGS_RECORD_BYTES,
+                      page);
+  return slot_valid(slot_ptr(sector, slot)); // Confere o que ficou na flash
+}
@@ -0,0 +1,38 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nvm.h"
+
+// Configuração do detector persistida na região NVM_SETTINGS_OFFSET da flash
+// (lib/nvm.h). Cada gravação acrescenta um registro de 32 bytes com versão,
+// número de sequência e CRC; vale o mais novo com o CRC certo, então uma
+// gravação interrompida deixa o anterior em vigor. Os dois setores são usados
+// em rodízio: só o que não tem o registro vigente é apagado.
+//
+// Campos novos entram no fim dos dados com uma versão maior; um registro mais
+// curto (de uma versão anterior) deixa os campos que não tem nos padrões.
+
+#define SETTINGS_VERSION 2
+#define SETTINGS_SECTORS 2
+#define SETTINGS_RECORD_BYTES 32
+
+typedef enum
+{
+  SETTINGS_MODE_FIXED,   // Range definido pelo usuário
+  SETTINGS_MODE_ADAPTIVE // Range em torno do ruído de fundo aprendido (lib/noise_floor.h)
+} settings_mode_t;
+
+typedef struct
+{
+  uint16_t threshold_min;
+  uint16_t threshold_max;
+  uint8_t mode; // settings_mode_t; versão 2 (padrão SETTINGS_MODE_FIXED)
+} settings_t;
+
+bool settings_load(settings_t *settings); // Falso sem registro válido
+// Só grava se mudou; pode apagar um setor, então deve ser chamada com a aquisição parada
+bool settings_save(const settings_t *settings);
+
+#endif
@@ -0,0 +1,87 @@
+#include "sos.h"
+#include "instr.h"
+
+typedef struct
+{
+  bool tone;
+  uint32_t ms;
+} sos_step_t;
+
+static sos_step_t steps[SOS_MAX_STEPS];
+static volatile uint8_t current;
+static volatile bool active;
+static volatile uint32_t cycles;
+
+void sos_init(unsigned int pin, uint32_t tone_hz, const sos_timing_t *timing)
+{
+  // Três letras de três sinais; as pausas entre letras e ciclos somam-se à do último sinal
+  uint8_t n = 0;
+  for (uint8_t letter = 0; letter < 3; letter++)
+  {
+    for (uint8_t i = 0; i < 3; i++)
+    {
+      steps[n].tone = true;
+      steps[n++].ms = (letter == 1) ? timing->dash_ms : timing->dot_ms;
+      steps[n].tone = false;
+      steps[n++].ms = timing->gap_ms;
+    }
+    steps[n - 1].ms += (letter < 2) ? timing->letter_gap_ms : timing->cycle_gap_ms;
+  }
+  active = false;
+  cycles = 0;
+  sos_backend_init(pin, tone_hz);
+}
+
+void sos_start(void)
+{
+  if (active)
+    return;
+  current = 0;
+  cycles = 0;
+  active = true;
+  sos_backend_tone(steps[0].tone);
+  sos_backend_start_timer(steps[0].ms);
+}
+
+void sos_stop(void)
+{
+  active = false;
+  sos_backend_stop_timer();
+  sos_backend_tone(false);
+}
+
+bool sos_active(void)
+{
+  return active;
+}
+
+uint32_t sos_cycles(void)
+{
+  return cycles;
+}
+
+static uint32_t advance_step(void)
+{
+  if (!active)
+  {
+    sos_backend_tone(false);
+    return 0;
+  }
+  uint8_t next = current + 1;
+  if (next == SOS_MAX_STEPS)
+  {
+    next = 0;
+    cycles++;
+  }
+  current = next;
+  sos_backend_tone(steps[next].tone);
+  return steps[next].ms;
+}
+
+uint32_t sos_step_from_alarm(void)
+{
+  INSTR_TIME_BEGIN(start);
+  uint32_t next = advance_step();
+  INSTR_TIME_END(INSTR_BUZZER, start);
+  return next;
+}
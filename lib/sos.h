@@ -0,0 +1,38 @@
+#ifndef SOS_H
+#define SOS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Sequenciador do alarme SOS (... --- ...). O tom vem de uma fatia PWM e as
+// transições são disparadas por alarmes do timer, então o laço principal
+// nunca espera pelo buzzer. O backend do host usa um relógio virtual.
+
+#define SOS_MAX_STEPS 18 // 9 sinais, cada um seguido de uma pausa
+
+typedef struct
+{
+  uint16_t dot_ms;        // Duração de um ponto
+  uint16_t dash_ms;       // Duração de um traço
+  uint16_t gap_ms;        // Pausa depois de cada sinal
+  uint16_t letter_gap_ms; // Pausa extra entre letras
+  uint16_t cycle_gap_ms;  // Pausa extra entre ciclos completos
+} sos_timing_t;
+
+void sos_init(unsigned int pin, uint32_t tone_hz, const sos_timing_t *timing);
+void sos_start(void);
+void sos_stop(void);
+bool sos_active(void);
+uint32_t sos_cycles(void);
+
+// Chamado pelo alarme do backend: aplica o próximo passo e devolve a sua
+// duração em ms (0 quando o sequenciador foi parado)
+uint32_t sos_step_from_alarm(void);
+
+// Interface entre o sequenciador e o backend (PWM + alarmes no RP2040, relógio virtual no host)
+void sos_backend_init(unsigned int pin, uint32_t tone_hz);
+void sos_backend_tone(bool on);
+void sos_backend_start_timer(uint32_t first_ms);
+void sos_backend_stop_timer(void);
+
+#endif
@@ -0,0 +1,51 @@
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/pwm.h"
+#include "sos.h"
+
+#define SOS_PWM_WRAP 999 // 1000 contagens por período do tom
+
+static uint sos_pin;
+static alarm_id_t sos_alarm;
+
+static int64_t sos_alarm_callback(alarm_id_t id, void *user_data)
+{
+  (void)id;
+  (void)user_data;
+  uint32_t ms = sos_step_from_alarm();
+  if (ms == 0)
+    sos_alarm = 0;
+  // Positivo: reagenda a partir do instante previsto, sem acumular atraso
+  return (int64_t)ms * 1000;
+}
+
+void sos_backend_init(unsigned int pin, uint32_t tone_hz)
+{
+  sos_pin = pin;
+  sos_alarm = 0;
+  gpio_set_function(pin, GPIO_FUNC_PWM);
+  uint slice = pwm_gpio_to_slice_num(pin);
+  pwm_config config = pwm_get_default_config();
+  pwm_config_set_clkdiv(&config, (float)clock_get_hz(clk_sys) / ((float)tone_hz * (SOS_PWM_WRAP + 1)));
+  pwm_config_set_wrap(&config, SOS_PWM_WRAP);
+  pwm_init(slice, &config, true);
+  pwm_set_gpio_level(pin, 0);
+}
+
+void sos_backend_tone(bool on)
+{
+  pwm_set_gpio_level(sos_pin, on ? (SOS_PWM_WRAP + 1) / 2 : 0);
+}
+
+void sos_backend_start_timer(uint32_t first_ms)
+{
+  sos_backend_stop_timer();
+  sos_alarm = add_alarm_in_ms(first_ms, sos_alarm_callback, NULL, true);
+}
+
+void sos_backend_stop_timer(void)
+{
+  if (sos_alarm > 0)
+    cancel_alarm(sos_alarm);
+  sos_alarm = 0;
+}
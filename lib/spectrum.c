@@ -0,0 +1,176 @@
+#include <stdlib.h>
+#include <string.h>
+#include "spectrum.h"
+#include "noise_level.h"
+#include "fft_tables.h"
+
+_Static_assert(FFT_TABLE_SIZE == SPECTRUM_FFT_SIZE, "generated/fft_tables.h foi gerado para outro tamanho de FFT");
+_Static_assert(FFT_THIRD_OCTAVE_BANDS <= SPECTRUM_MAX_BANDS, "SPECTRUM_MAX_BANDS pequeno demais");
+
+#define FFT_HALF (SPECTRUM_FFT_SIZE / 2)
+#define FFT_LOG2_SIZE (SPECTRUM_FFT_SIZE == 512 ? 9 : 8)
+#define FFT_INPUT_LIMIT 16383 // Pico da entrada após a normalização
+#define FFT_STAGE_LIMIT 13573 // 32767 / (1 + √2): maior crescimento de uma borboleta
+#define BAND_Q8_OFFSET_X10 241 // 10·log10(256) em décimos de dB
+
+static int32_t max_abs(const int16_t *a, const int16_t *b, size_t n)
+{
+  int32_t m = 0;
+  for (size_t i = 0; i < n; i++)
+  {
+    int32_t va = abs(a[i]);
+    int32_t vb = b ? abs(b[i]) : 0;
+    if (va > m)
+      m = va;
+    if (vb > m)
+      m = vb;
+  }
+  return m;
+}
+
+// FFT complexa de N/2 pontos, decimação no tempo, entrada já em ordem
+// bit-reversa. Antes de cada estágio os dados são reduzidos o suficiente para
+// que nenhuma borboleta estoure 16 bits; retorna o expoente acumulado.
+static int fft_complex(int16_t *re, int16_t *im)
+{
+  int exponent = 0;
+  for (uint16_t len = 2; len <= FFT_HALF; len <<= 1)
+  {
+    int32_t m = max_abs(re, im, FFT_HALF);
+    int shift = 0;
+    while ((m >> shift) > FFT_STAGE_LIMIT)
+      shift++;
+    exponent += shift;
+
+    uint16_t half = len >> 1;
+    uint16_t step = SPECTRUM_FFT_SIZE / len; // W_len^j = W_N^(j·N/len)
+    for (uint16_t i = 0; i < FFT_HALF; i += len)
+    {
+      for (uint16_t j = 0; j < half; j++)
+      {
+        int32_t c = fft_cos[j * step];
+        int32_t s = fft_sin[j * step];
+        uint16_t a = i + j;
+        uint16_t b = a + half;
+        int32_t ar = re[a] >> shift, ai = im[a] >> shift;
+        int32_t br = re[b] >> shift, bi = im[b] >> shift;
+        // (br + j·bi)(c - j·s)
+        int32_t tr = (br * c + bi * s) >> 15;
+        int32_t ti = (bi * c - br * s) >> 15;
+        re[b] = (int16_t)(ar - tr);
+        im[b] = (int16_t)(ai - ti);
+        re[a] = (int16_t)(ar + tr);
+        im[a] = (int16_t)(ai + ti);
+      }
+    }
+  }
+  return exponent;
+}
+
+static void aggregate_bands(spectrum_t *s, uint64_t *ms, const uint16_t *first, const uint16_t *last,
+                            uint8_t count, int exponent)
+{
+  // ms = P · 16 / (3·N²) para janela de Hann; em Q8 e com o expoente do quadro
+  int shift = 12 + 2 * exponent - 2 * FFT_LOG2_SIZE;
+  for (uint8_t b = 0; b < count; b++)
+  {
+    uint64_t sum = 0;
+    for (uint16_t k = first[b]; k <= last[b]; k++)
+      sum += s->bin_power[k];
+    uint64_t band = (shift >= 0 ? sum << shift : sum >> -shift) / 3;
+
+    if (s->frames == 0)
+      ms[b] = band;
+    else
+      ms[b] = (uint64_t)((int64_t)ms[b] + (((int64_t)band - (int64_t)ms[b]) >> SPECTRUM_SMOOTHING_SHIFT));
+  }
+}
+
+void spectrum_init(spectrum_t *s)
+{
+  memset(s, 0, sizeof(*s));
+}
+
+void spectrum_process(spectrum_t *s, const int16_t *x, size_t len)
+{
+  // Desliza o histórico; com blocos de N/2 amostras cada FFT tem 50% de sobreposição
+  if (len >= SPECTRUM_FFT_SIZE)
+  {
+    memcpy(s->history, x + len - SPECTRUM_FFT_SIZE, sizeof(s->history));
+    s->fill = SPECTRUM_FFT_SIZE;
+  }
+  else
+  {
+    memmove(s->history, s->history + len, (SPECTRUM_FFT_SIZE - len) * sizeof(int16_t));
+    memcpy(s->history + SPECTRUM_FFT_SIZE - len, x, len * sizeof(int16_t));
+    s->fill = (s->fill + len > SPECTRUM_FFT_SIZE) ? SPECTRUM_FFT_SIZE : (uint16_t)(s->fill + len);
+  }
+  if (s->fill < SPECTRUM_FFT_SIZE)
+    return;
+
+  // Normaliza o quadro para usar a faixa de 16 bits antes da janela
+  int32_t peak = max_abs(s->history, NULL, SPECTRUM_FFT_SIZE);
+  int pre_shift = 0;
+  if (peak > FFT_INPUT_LIMIT)
+  {
+    while ((peak >> -pre_shift) > FFT_INPUT_LIMIT)
+      pre_shift--;
+  }
+  else
+  {
+    while (peak && (peak << (pre_shift + 1)) <= FFT_INPUT_LIMIT)
+      pre_shift++;
+  }
+
+  // Janela, empacotamento real->complexo (pares/ímpares) e ordem bit-reversa em uma passada
+  for (uint16_t k = 0; k < FFT_HALF; k++)
+  {
+    uint16_t n = (uint16_t)(2 * fft_bitrev[k]);
+    int32_t even = pre_shift >= 0 ? s->history[n] * (1 << pre_shift) : s->history[n] >> -pre_shift;
+    int32_t odd = pre_shift >= 0 ? s->history[n + 1] * (1 << pre_shift) : s->history[n + 1] >> -pre_shift;
+    s->re[k] = (int16_t)((even * fft_window[n]) >> 15);
+    s->im[k] = (int16_t)((odd * fft_window[n + 1]) >> 15);
+  }
+
+  int exponent = fft_complex(s->re, s->im) - pre_shift;
+
+  // Separa o espectro real: X[k] = Xe[k] + W_N^k·Xo[k]
+  s->bin_power[0] = 0; // DC não entra em nenhuma banda
+  for (uint16_t k = 1; k < FFT_HALF; k++)
+  {
+    int32_t ar = s->re[k], ai = s->im[k];
+    int32_t br = s->re[FFT_HALF - k], bi = s->im[FFT_HALF - k];
+    int32_t xer = (ar + br) >> 1, xei = (ai - bi) >> 1;
+    int32_t xor_ = (ai + bi) >> 1, xoi = (br - ar) >> 1;
+    int32_t c = fft_cos[k], sn = fft_sin[k];
+    int32_t xr = xer + ((c * xor_ + sn * xoi) >> 15);
+    int32_t xi = xei + ((c * xoi - sn * xor_) >> 15);
+    uint32_t mr = (uint32_t)abs(xr), mi = (uint32_t)abs(xi);
+    s->bin_power[k] = (uint64_t)(mr * mr) + (uint64_t)(mi * mi);
+  }
+
+  aggregate_bands(s, s->octave_ms, fft_octave_first_bin, fft_octave_last_bin, FFT_OCTAVE_BANDS, exponent);
+  aggregate_bands(s, s->third_ms, fft_third_octave_first_bin, fft_third_octave_last_bin, FFT_THIRD_OCTAVE_BANDS,
+                  exponent);
+  s->frames++;
+}
+
+uint8_t spectrum_band_count(spectrum_bands_t bands)
+{
+  return bands == SPECTRUM_OCTAVE ? FFT_OCTAVE_BANDS : FFT_THIRD_OCTAVE_BANDS;
+}
+
+uint16_t spectrum_band_center_hz(spectrum_bands_t bands, uint8_t band)
+{
+  if (band >= spectrum_band_count(bands))
+    return 0;
+  return bands == SPECTRUM_OCTAVE ? fft_octave_center_hz[band] : fft_third_octave_center_hz[band];
+}
+
+void spectrum_band_levels(const spectrum_t *s, spectrum_bands_t bands, int16_t *dbfs_x10)
+{
+  const uint64_t *ms = bands == SPECTRUM_OCTAVE ? s->octave_ms : s->third_ms;
+  uint8_t count = spectrum_band_count(bands);
+  for (uint8_t b = 0; b < count; b++)
+    dbfs_x10[b] = ms[b] ? (int16_t)(level_dbfs_x10(ms[b]) - BAND_Q8_OFFSET_X10) : INT16_MIN;
+}
@@ -0,0 +1,41 @@
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Analisador de bandas de oitava e de terço de oitava: FFT real em ponto fixo
+// (radix-2, ponto flutuante em bloco) com janela de Hann e 50% de sobreposição
+// para blocos de N/2 amostras. As tabelas vêm de tools/gen_fft_tables.py.
+
+#ifndef SPECTRUM_FFT_SIZE
+#define SPECTRUM_FFT_SIZE 512 // 256 ou 512 (deve coincidir com generated/fft_tables.h)
+#endif
+#define SPECTRUM_MAX_BANDS 21      // Bandas de terço de oitava de 31,5 Hz a 3,15 kHz
+#define SPECTRUM_SMOOTHING_SHIFT 2 // Média exponencial das bandas entre quadros (1/4)
+
+typedef enum
+{
+  SPECTRUM_OCTAVE,
+  SPECTRUM_THIRD_OCTAVE
+} spectrum_bands_t;
+
+typedef struct
+{
+  int16_t history[SPECTRUM_FFT_SIZE];       // Últimas N amostras sem DC
+  uint16_t fill;                            // Amostras válidas no histórico
+  int16_t re[SPECTRUM_FFT_SIZE / 2];        // Área de trabalho da FFT complexa
+  int16_t im[SPECTRUM_FFT_SIZE / 2];
+  uint64_t bin_power[SPECTRUM_FFT_SIZE / 2]; // |X[k]|² do último quadro (mantissa)
+  uint64_t octave_ms[SPECTRUM_MAX_BANDS];   // Média quadrática por banda, em códigos² Q8
+  uint64_t third_ms[SPECTRUM_MAX_BANDS];
+  uint32_t frames;                          // FFTs calculadas desde spectrum_init()
+} spectrum_t;
+
+void spectrum_init(spectrum_t *s);
+void spectrum_process(spectrum_t *s, const int16_t *x, size_t len);
+uint8_t spectrum_band_count(spectrum_bands_t bands);
+uint16_t spectrum_band_center_hz(spectrum_bands_t bands, uint8_t band);
+void spectrum_band_levels(const spectrum_t *s, spectrum_bands_t bands, int16_t *dbfs_x10);
+
+#endif
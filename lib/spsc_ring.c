@@ -0,0 +1,52 @@
+#include <string.h>
+#include "spsc_ring.h"
+
+bool spsc_ring_init(spsc_ring_t *r, void *storage, uint32_t elem_size, uint32_t capacity)
+{
+  if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+    return false;
+  r->storage = storage;
+  r->elem_size = elem_size;
+  r->capacity = capacity;
+  atomic_init(&r->head, 0);
+  atomic_init(&r->tail, 0);
+  r->dropped = 0;
+  return true;
+}
+
+bool spsc_ring_push(spsc_ring_t *r, const void *item)
+{
+  if (spsc_ring_try_push(r, item))
+    return true;
+  r->dropped++;
+  return false;
+}
+
+bool spsc_ring_try_push(spsc_ring_t *r, const void *item)
+{
+  uint32_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+  uint32_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+  if (head - tail >= r->capacity)
+    return false;
+  memcpy(r->storage + (head & (r->capacity - 1)) * r->elem_size, item, r->elem_size);
+  // release: o item fica visível antes do novo head
+  atomic_store_explicit(&r->head, head + 1, memory_order_release);
+  return true;
+}
+
+bool spsc_ring_pop(spsc_ring_t *r, void *item)
+{
+  uint32_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+  uint32_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+  if (head == tail)
+    return false;
+  memcpy(item, r->storage + (tail & (r->capacity - 1)) * r->elem_size, r->elem_size);
+  // release: a cópia termina antes de o produtor poder reutilizar a posição
+  atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+  return true;
+}
+
+uint32_t spsc_ring_count(spsc_ring_t *r)
+{
+  return atomic_load_explicit(&r->head, memory_order_acquire) - atomic_load_explicit(&r->tail, memory_order_acquire);
+}
@@ -0,0 +1,29 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fila sem travas para um produtor e um consumidor (por exemplo, um em cada
+// núcleo do RP2040). head e tail são contadores de sequência livres: o
+// produtor só escreve head, o consumidor só escreve tail, e a diferença é a
+// ocupação. A capacidade deve ser potência de 2; o armazenamento é do chamador.
+
+typedef struct
+{
+  uint8_t *storage;
+  uint32_t elem_size;
+  uint32_t capacity;
+  _Atomic uint32_t head; // Itens já publicados (escrito só pelo produtor)
+  _Atomic uint32_t tail; // Itens já consumidos (escrito só pelo consumidor)
+  uint32_t dropped;      // Pushes recusados por fila cheia (contado pelo produtor)
+} spsc_ring_t;
+
+bool spsc_ring_init(spsc_ring_t *r, void *storage, uint32_t elem_size, uint32_t capacity);
+bool spsc_ring_push(spsc_ring_t *r, const void *item);     // Com a fila cheia, conta em dropped
+bool spsc_ring_try_push(spsc_ring_t *r, const void *item); // Não conta: para quem vai tentar de novo
+bool spsc_ring_pop(spsc_ring_t *r, void *item);
+uint32_t spsc_ring_count(spsc_ring_t *r);
+
+#endif
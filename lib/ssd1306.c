@@ -1,6 +1,25 @@
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
 
+// Custo fixo de uma janela no barramento: endereço + controle + 6 comandos,
+// depois endereço (RESTART) + controle dos dados
+#define SSD1306_WINDOW_BYTES 10
+
+static void ssd1306_clear_dirty(ssd1306_t *ssd)
+{
+  memset(ssd->dirty_x0, 0xFF, sizeof(ssd->dirty_x0));
+  memset(ssd->dirty_x1, 0x00, sizeof(ssd->dirty_x1));
+}
+
+static inline void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1)
+{
+  if (x0 < ssd->dirty_x0[page])
+    ssd->dirty_x0[page] = x0;
+  if (x1 > ssd->dirty_x1[page])
+    ssd->dirty_x1[page] = x1;
+}
+
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c)
 {
   ssd->width = width;
@@ -12,6 +31,14 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->shadow = calloc(ssd->bufsize - 1, sizeof(uint8_t));
+  ssd->shadow_valid = false;
+  // Pior caso: uma janela por página, cada uma com seus 8 bytes de cabeçalho
+  ssd->tx_words = calloc(ssd->bufsize + ssd->pages * 8, sizeof(uint16_t));
+  ssd->tx_len = 0;
+  ssd->bus_bytes = 0;
+  ssd1306_clear_dirty(ssd);
+  ssd1306_transport_init(ssd);
 }
 
 void ssd1306_config(ssd1306_t *ssd)
@@ -46,78 +73,232 @@ void ssd1306_config(ssd1306_t *ssd)
 void ssd1306_command(ssd1306_t *ssd, uint8_t command)
 {
   ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-      ssd->i2c_port,
-      ssd->address,
-      ssd->port_buffer,
-      2,
-      false);
+  ssd1306_transport_write_blocking(ssd, ssd->port_buffer, 2);
+  ssd->bus_bytes += 3;
 }
 
-void ssd1306_send_data(ssd1306_t *ssd)
+static inline void ssd1306_put(ssd1306_t *ssd, uint16_t word)
 {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-      ssd->i2c_port,
-      ssd->address,
-      ssd->ram_buffer,
-      ssd->bufsize,
-      false);
+  ssd->tx_words[ssd->tx_len++] = word;
 }
 
-void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value)
+// Uma transação de comandos (controle 0x00 seguido dos seis bytes de
+// endereçamento) e, com RESTART, o início da transação de dados.
+static void ssd1306_put_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1)
 {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
-  uint8_t pixel = (y & 0b111);
-  if (value)
-    ssd->ram_buffer[index] |= (1 << pixel);
-  else
-    ssd->ram_buffer[index] &= ~(1 << pixel);
+  ssd1306_put(ssd, (ssd->tx_len ? SSD1306_TX_RESTART : 0) | 0x00);
+  ssd1306_put(ssd, SET_COL_ADDR);
+  ssd1306_put(ssd, x0);
+  ssd1306_put(ssd, x1);
+  ssd1306_put(ssd, SET_PAGE_ADDR);
+  ssd1306_put(ssd, page0);
+  ssd1306_put(ssd, page1);
+  ssd1306_put(ssd, SSD1306_TX_RESTART | 0x40);
 }
 
-void ssd1306_fill(ssd1306_t *ssd, bool value)
+bool ssd1306_busy(ssd1306_t *ssd)
 {
-  for (uint8_t y = 0; y < ssd->height; ++y)
+  return ssd1306_transport_busy(ssd);
+}
+
+// Monta em tx_words somente as colunas que diferem do último quadro enviado e
+// entrega tudo ao transporte em uma única transferência. Cada página suja vira
+// uma janela própria, a menos que uma janela única de altura total custe menos
+// bytes no barramento. Os dados são copiados, então o ram_buffer pode ser
+// redesenhado logo em seguida sem rasgar o quadro em envio.
+bool ssd1306_send_data_async(ssd1306_t *ssd)
+{
+  if (ssd1306_transport_busy(ssd))
+    return false; // Marcas de sujeira ficam para a próxima tentativa
+
+  uint8_t lo[SSD1306_MAX_PAGES], hi[SSD1306_MAX_PAGES];
+  int first_col = ssd->width, last_col = -1;
+  uint32_t page_cost = 0;
+  for (uint8_t p = 0; p < ssd->pages; p++)
   {
-    for (uint8_t x = 0; x < ssd->width; ++x)
+    lo[p] = 0xFF;
+    hi[p] = 0;
+    if (!ssd->shadow_valid)
+    {
+      // Conteúdo do painel desconhecido: envia tudo
+      lo[p] = 0;
+      hi[p] = ssd->width - 1;
+    }
+    else
     {
-      ssd1306_pixel(ssd, x, y, value);
+      for (int x = ssd->dirty_x0[p]; x <= ssd->dirty_x1[p]; x++)
+      {
+        if (ssd->ram_buffer[(x << 3) + p + 1] != ssd->shadow[(x << 3) + p])
+        {
+          if (lo[p] == 0xFF)
+            lo[p] = x;
+          hi[p] = x;
+        }
+      }
     }
+    if (lo[p] > hi[p])
+      continue;
+    page_cost += SSD1306_WINDOW_BYTES + (hi[p] - lo[p] + 1);
+    if (lo[p] < first_col)
+      first_col = lo[p];
+    if (hi[p] > last_col)
+      last_col = hi[p];
+  }
+  ssd1306_clear_dirty(ssd);
+  ssd->shadow_valid = true;
+  if (last_col < 0)
+    return true; // Quadro idêntico ao que já está no display
+
+  ssd->tx_len = 0;
+  uint32_t full_cost = SSD1306_WINDOW_BYTES + (uint32_t)(last_col - first_col + 1) * ssd->pages;
+  if (full_cost <= page_cost)
+  {
+    // Endereçamento vertical: as colunas da janela são contíguas no buffer
+    ssd1306_put_window(ssd, first_col, last_col, 0, ssd->pages - 1);
+    size_t start = (size_t)first_col << 3;
+    size_t len = (size_t)(last_col - first_col + 1) * ssd->pages;
+    for (size_t i = 0; i < len; i++)
+      ssd1306_put(ssd, ssd->ram_buffer[start + i + 1]);
+    memcpy(&ssd->shadow[start], &ssd->ram_buffer[start + 1], len);
   }
+  else
+  {
+    for (uint8_t p = 0; p < ssd->pages; p++)
+    {
+      if (lo[p] > hi[p])
+        continue;
+      ssd1306_put_window(ssd, lo[p], hi[p], p, p);
+      for (int x = lo[p]; x <= hi[p]; x++)
+      {
+        uint8_t v = ssd->ram_buffer[(x << 3) + p + 1];
+        ssd1306_put(ssd, v);
+        ssd->shadow[(x << 3) + p] = v;
+      }
+    }
+  }
+  ssd->tx_words[ssd->tx_len - 1] |= SSD1306_TX_STOP;
+  ssd->bus_bytes += (full_cost <= page_cost) ? full_cost : page_cost;
+  ssd1306_transport_write_async(ssd, ssd->tx_words, ssd->tx_len);
+  return true;
 }
 
-void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill)
+void ssd1306_send_data(ssd1306_t *ssd)
+{
+  while (!ssd1306_send_data_async(ssd))
+    tight_loop_contents();
+  while (ssd1306_transport_busy(ssd))
+    tight_loop_contents();
+}
+
+void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value)
 {
-  for (uint8_t x = left; x < left + width; ++x)
+  // Fora do painel (inclusive coordenadas negativas que deram a volta em line e circle)
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  uint16_t index = (y >> 3) + (x << 3) + 1;
+  uint8_t pixel = (y & 0b111);
+  uint8_t old = ssd->ram_buffer[index];
+  uint8_t updated = value ? (old | (1 << pixel)) : (old & ~(1 << pixel));
+  if (updated != old)
   {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
+    ssd->ram_buffer[index] = updated;
+    ssd1306_mark_dirty(ssd, y >> 3, x, x);
   }
-  for (uint8_t y = top; y < top + height; ++y)
+}
+
+// Grava um byte da memória de vídeo e marca a coluna como suja se ele mudou
+static inline void ssd1306_write_byte(ssd1306_t *ssd, uint8_t x, uint8_t page, uint8_t mask, uint8_t bits)
+{
+  uint8_t *byte = &ssd->ram_buffer[(x << 3) + page + 1];
+  uint8_t updated = (*byte & ~mask) | (bits & mask);
+  if (updated != *byte)
   {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
+    *byte = updated;
+    ssd1306_mark_dirty(ssd, page, x, x);
   }
+}
 
-  if (fill)
+// Liga ou desliga as linhas y0..y1 (inclusive) de uma coluna, um byte por página
+static void ssd1306_column_span(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value)
+{
+  if (x >= ssd->width || y0 > y1 || y0 >= ssd->height)
+    return;
+  if (y1 >= ssd->height)
+    y1 = ssd->height - 1;
+  uint8_t bits = value ? 0xFF : 0x00;
+  for (uint8_t page = y0 >> 3; page <= (y1 >> 3); page++)
   {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x)
+    uint8_t mask = 0xFF;
+    if (page == (y0 >> 3))
+      mask &= 0xFF << (y0 & 7);
+    if (page == (y1 >> 3))
+      mask &= 0xFF >> (7 - (y1 & 7));
+    ssd1306_write_byte(ssd, x, page, mask, bits);
+  }
+}
+
+void ssd1306_fill(ssd1306_t *ssd, bool value)
+{
+  uint8_t bits = value ? 0xFF : 0x00;
+  for (uint8_t page = 0; page < ssd->pages; page++)
+  {
+    // Procura a faixa alterada antes de gravar, para marcar a página uma vez só
+    int lo = -1, hi = -1;
+    for (uint8_t x = 0; x < ssd->width; x++)
     {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y)
+      if (ssd->ram_buffer[(x << 3) + page + 1] != bits)
       {
-        ssd1306_pixel(ssd, x, y, value);
+        if (lo < 0)
+          lo = x;
+        hi = x;
       }
     }
+    if (lo < 0)
+      continue;
+    for (int x = lo; x <= hi; x++)
+      ssd->ram_buffer[(x << 3) + page + 1] = bits;
+    ssd1306_mark_dirty(ssd, page, lo, hi);
+  }
+}
+
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill)
+{
+  if (width == 0 || height == 0)
+    return;
+  uint8_t bottom = top + height - 1;
+  uint8_t right = left + width - 1;
+
+  // Bordas esquerda e direita (e o interior, se preenchido) em colunas inteiras
+  ssd1306_column_span(ssd, left, top, bottom, value);
+  for (uint8_t x = left + 1; x < right; x++)
+  {
+    if (fill)
+    {
+      ssd1306_column_span(ssd, x, top, bottom, value);
+    }
+    else
+    {
+      ssd1306_column_span(ssd, x, top, top, value);
+      ssd1306_column_span(ssd, x, bottom, bottom, value);
+    }
   }
+  if (right != left)
+    ssd1306_column_span(ssd, right, top, bottom, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value)
 {
+  if (y0 == y1)
+  {
+    ssd1306_hline(ssd, x0 < x1 ? x0 : x1, x0 < x1 ? x1 : x0, y0, value);
+    return;
+  }
+  if (x0 == x1)
+  {
+    ssd1306_vline(ssd, x0, y0 < y1 ? y0 : y1, y0 < y1 ? y1 : y0, value);
+    return;
+  }
+
   int dx = abs(x1 - x0);
   int dy = abs(y1 - y0);
 
@@ -151,50 +332,69 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value)
 {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  if (y >= ssd->height)
+    return;
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  uint8_t mask = 1 << (y & 7);
+  uint8_t bits = value ? mask : 0;
+  for (int x = x0; x <= x1; ++x)
+    ssd1306_write_byte(ssd, x, y >> 3, mask, bits);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value)
 {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_column_span(ssd, x, y0, y1, value);
 }
 
-void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+// Índice do glifo em font[] para cada caractere ASCII; os ausentes ficam em 0 (vazio)
+#define GLYPH_RUN2(c, i) [(c)] = (i), [(c) + 1] = (i) + 1
+#define GLYPH_RUN4(c, i) GLYPH_RUN2(c, i), GLYPH_RUN2((c) + 2, (i) + 2)
+#define GLYPH_RUN8(c, i) GLYPH_RUN4(c, i), GLYPH_RUN4((c) + 4, (i) + 4)
+#define GLYPH_RUN10(c, i) GLYPH_RUN8(c, i), GLYPH_RUN2((c) + 8, (i) + 8)
+#define GLYPH_RUN26(c, i) GLYPH_RUN8(c, i), GLYPH_RUN8((c) + 8, (i) + 8), GLYPH_RUN8((c) + 16, (i) + 16), \
+                          GLYPH_RUN2((c) + 24, (i) + 24)
+
+static const uint8_t glyph_index[128] = {
+    GLYPH_RUN10('0', 1),  // '0' = 1
+    GLYPH_RUN26('A', 11), // 'A' = 11
+    GLYPH_RUN26('a', 37), // 'a' = 37
+    [':'] = 63,
+    ['-'] = 64,
+    ['.'] = 65,
+};
+
+// Desenha o glifo de c em uma célula 8x8; invert troca fundo e traço
+static void ssd1306_draw_glyph(ssd1306_t *ssd, char c, uint8_t x, uint8_t y, bool invert)
 {
-  uint16_t index = 0;
-  if (c >= 'A' && c <= 'Z')
-  {
-    index = (c - 'A' + 11) * 8; // 'A' = 11
-  }
-  else if (c >= '0' && c <= '9')
-  {
-    index = (c - '0' + 1) * 8; // '0' = 1
-  }
-  else if (c >= 'a' && c <= 'z')
-  {
-    index = (c - 'a' + 37) * 8; // 'a' = 37
-  }
-  else if (c == ':')
-  {
-    index = 63 * 8; // ':' na posição 63
-  }
-  else
-  {
-    index = 0; // Espaço em branco para caracteres desconhecidos
-  }
+  unsigned char code = (unsigned char)c;
+  const uint8_t *glyph = &font[(code < 128 ? glyph_index[code] : 0) * 8];
+  uint8_t flip = invert ? 0xFF : 0x00;
+  if (y >= ssd->height)
+    return;
 
-  for (uint8_t i = 0; i < 8; ++i)
+  // Cada byte do glifo é uma coluna; fora do alinhamento de página ela ocupa duas páginas
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 7;
+  for (uint8_t i = 0; i < 8 && x + i < ssd->width; ++i)
   {
-    uint8_t line = font[index + i];
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j));
-    }
+    uint8_t column = glyph[i] ^ flip;
+    ssd1306_write_byte(ssd, x + i, page, 0xFF << shift, column << shift);
+    if (shift && page + 1 < ssd->pages)
+      ssd1306_write_byte(ssd, x + i, page + 1, 0xFF >> (8 - shift), column >> (8 - shift));
   }
 }
 
+void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+{
+  ssd1306_draw_glyph(ssd, c, x, y, false);
+}
+
+void ssd1306_draw_inverted_digit(ssd1306_t *ssd, char digit, uint8_t x, uint8_t y)
+{
+  ssd1306_draw_glyph(ssd, digit, x, y, true);
+}
+
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
 {
   while (*str)
@@ -241,4 +441,32 @@ void ssd1306_circle(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t r, bool valu
       err -= 2 * x + 1;
     }
   }
-}
\ No newline at end of file
+}
+
+void ssd1306_scroll_left(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1, uint8_t n)
+{
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  if (page1 >= ssd->pages)
+    page1 = ssd->pages - 1;
+  if (x0 > x1 || page0 > page1 || n == 0)
+    return;
+  if (n > x1 - x0 + 1)
+    n = x1 - x0 + 1;
+
+  uint8_t rows = page1 - page0 + 1;
+  uint8_t *buf = ssd->ram_buffer + 1 + page0;
+  // Endereçamento vertical: cada coluna ocupa 8 bytes seguidos, então com
+  // todas as páginas a rolagem é um único memmove
+  if (rows == SSD1306_MAX_PAGES)
+    memmove(&buf[(size_t)x0 << 3], &buf[(size_t)(x0 + n) << 3], (size_t)(x1 - x0 + 1 - n) << 3);
+  else
+  {
+    for (int x = x0; x + n <= x1; x++)
+      memcpy(&buf[(size_t)x << 3], &buf[(size_t)(x + n) << 3], rows);
+  }
+  for (int x = x1 - n + 1; x <= x1; x++)
+    memset(&buf[(size_t)x << 3], 0, rows);
+  for (uint8_t p = page0; p <= page1; p++)
+    ssd1306_mark_dirty(ssd, p, x0, x1); // O envio só transmite as colunas que de fato mudaram
+}
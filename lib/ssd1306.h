@@ -1,9 +1,18 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 
 #define WIDTH 128
 #define HEIGHT 64
+#define SSD1306_MAX_PAGES 8 // O buffer usa 8 bytes por coluna (endereçamento vertical)
+
+// Flags das palavras de tx_words, no formato do registrador IC_DATA_CMD do
+// RP2040: o byte fica nos bits 0-7
+#define SSD1306_TX_STOP 0x200    // STOP depois deste byte
+#define SSD1306_TX_RESTART 0x400 // RESTART (com novo endereço) antes deste byte
 
 typedef enum {
   SET_CONTRAST = 0x81,
@@ -32,12 +41,22 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  uint8_t *shadow;                          // Conteúdo já enviado ao display (sem o byte de controle)
+  bool shadow_valid;                        // Falso até o primeiro quadro completo ser enviado
+  uint16_t *tx_words;                       // Fluxo de bytes + flags do quadro em envio
+  size_t tx_len;
+  int dma_channel;                          // Canal de DMA do transporte (-1 sem DMA)
+  uint8_t dirty_x0[SSD1306_MAX_PAGES];      // Colunas alteradas por página (x0 > x1: página limpa)
+  uint8_t dirty_x1[SSD1306_MAX_PAGES];
+  uint32_t bus_bytes;                       // Bytes colocados no barramento I2C (inclui endereço)
 } ssd1306_t;
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
+bool ssd1306_send_data_async(ssd1306_t *ssd);
+bool ssd1306_busy(ssd1306_t *ssd);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -46,5 +65,17 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
+void ssd1306_draw_inverted_digit(ssd1306_t *ssd, char digit, uint8_t x, uint8_t y); // Dígito claro em fundo aceso
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
-void ssd1306_circle(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t r, bool value);
\ No newline at end of file
+void ssd1306_circle(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t r, bool value);
+// Desloca as colunas x0..x1 das páginas page0..page1 n colunas para a esquerda
+// e apaga as n da direita (gráficos que rolam sem ser redesenhados)
+void ssd1306_scroll_left(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1, uint8_t n);
+
+// Transporte I2C (lib/ssd1306_rp2040.c no firmware, host/ssd1306_host.c no host)
+void ssd1306_transport_init(ssd1306_t *ssd);
+void ssd1306_transport_write_blocking(ssd1306_t *ssd, const uint8_t *data, size_t len);
+void ssd1306_transport_write_async(ssd1306_t *ssd, const uint16_t *words, size_t len);
+bool ssd1306_transport_busy(ssd1306_t *ssd);
+
+#endif
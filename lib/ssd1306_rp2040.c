@@ -0,0 +1,51 @@
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/i2c.h"
+#include "ssd1306.h"
+
+// Transporte do display no RP2040: os quadros vão por DMA direto para o
+// IC_DATA_CMD do I2C, com as flags de STOP/RESTART já embutidas em cada
+// palavra, e o núcleo fica livre enquanto o barramento trabalha.
+
+void ssd1306_transport_init(ssd1306_t *ssd)
+{
+  ssd->dma_channel = dma_claim_unused_channel(true);
+  i2c_get_hw(ssd->i2c_port)->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+}
+
+bool ssd1306_transport_busy(ssd1306_t *ssd)
+{
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+  {
+    // NACK (display ausente): descarta o resto do quadro e libera o controlador
+    dma_channel_abort(ssd->dma_channel);
+    (void)hw->clr_tx_abrt;
+    return false;
+  }
+  return dma_channel_is_busy(ssd->dma_channel) || !(hw->status & I2C_IC_STATUS_TFE_BITS) ||
+         (hw->status & I2C_IC_STATUS_ACTIVITY_BITS);
+}
+
+void ssd1306_transport_write_blocking(ssd1306_t *ssd, const uint8_t *data, size_t len)
+{
+  while (ssd1306_transport_busy(ssd))
+    tight_loop_contents();
+  i2c_write_blocking(ssd->i2c_port, ssd->address, data, len, false);
+}
+
+void ssd1306_transport_write_async(ssd1306_t *ssd, const uint16_t *words, size_t len)
+{
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  // O endereço de destino só pode ser trocado com o controlador desligado
+  hw->enable = 0;
+  hw->tar = ssd->address;
+  hw->enable = 1;
+
+  dma_channel_config c = dma_channel_get_default_config(ssd->dma_channel);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, i2c_get_dreq(ssd->i2c_port, true));
+  dma_channel_configure(ssd->dma_channel, &c, &hw->data_cmd, words, len, true);
+}
@@ -0,0 +1,112 @@
+#include "tone_bank.h"
+#include "noise_level.h"
+#include "goertzel_coeffs.h"
+
+_Static_assert(TONE_DETECTORS <= TONE_BANK_MAX_DETECTORS, "a máscara dos detectores ocupa um byte");
+_Static_assert(TONE_COEFFS_BLOCK == ACQ_BLOCK_SAMPLES, "goertzel_coeffs.h gerado para outro tamanho de bloco");
+
+// c · s em Q14 só com multiplicações de 32 bits (o Cortex-M0+ não tem a de
+// 64): s é dividido em parte alta e 14 bits baixos, e o resultado é o mesmo
+// de ((int64_t)c * s) >> 14
+static inline int32_t mul_q14(int32_t c, int32_t s)
+{
+  return c * (s >> TONE_COEFF_SHIFT) + ((c * (s & ((1 << TONE_COEFF_SHIFT) - 1))) >> TONE_COEFF_SHIFT);
+}
+
+void tone_bank_init(tone_bank_t *tb, uint32_t mask_hz)
+{
+  tb->maskable = 0;
+  for (int d = 0; d < TONE_DETECTORS && mask_hz; d++)
+  {
+    for (uint32_t h = 1; h <= TONE_BANK_MASK_HARMONICS; h += 2)
+    {
+      // Harmônica rebatida em 0 a fs/2; "perto" é a até duas raias (fs / bloco)
+      uint32_t alias = (mask_hz * h) % TONE_COEFFS_RATE;
+      if (alias > TONE_COEFFS_RATE / 2)
+        alias = TONE_COEFFS_RATE - alias;
+      uint32_t distance = alias > tone_freq_hz[d] ? alias - tone_freq_hz[d] : tone_freq_hz[d] - alias;
+      if (distance * TONE_COEFFS_BLOCK <= 2u * TONE_COEFFS_RATE)
+        tb->maskable |= (uint8_t)(1u << d);
+    }
+  }
+  tone_bank_reset(tb);
+}
+
+void tone_bank_reset(tone_bank_t *tb)
+{
+  for (int d = 0; d < TONE_DETECTORS; d++)
+  {
+    tb->level_x10[d] = INT16_MIN;
+    tb->hold[d] = 0;
+  }
+  tb->masked = 0;
+  tb->active = 0;
+  tb->mask_tail = 0;
+}
+
+uint8_t tone_bank_process(tone_bank_t *tb, const int16_t *x, size_t count, bool mask)
+{
+  if (mask)
+    tb->mask_tail = TONE_BANK_MASK_TAIL_BLOCKS;
+  tb->masked = (mask || tb->mask_tail) ? tb->maskable : 0;
+  if (!mask && tb->mask_tail)
+    tb->mask_tail--;
+
+  if (count > ACQ_BLOCK_SAMPLES)
+    count = ACQ_BLOCK_SAMPLES;
+  for (size_t n = 0; n < count; n++)
+    tb->windowed[n] = (int16_t)((x[n] * tone_window[n]) >> TONE_WINDOW_SHIFT);
+
+  uint8_t active = 0;
+  for (int d = 0; d < TONE_DETECTORS; d++)
+  {
+    // Recursão s[n] = x[n] + c·s[n-1] - s[n-2]; com |x| até 4096 e f ≥ 50 Hz,
+    // o estado fica abaixo de 2^25 em um bloco de 256 amostras
+    int32_t c = tone_coeff[d];
+    int32_t s1 = 0, s2 = 0;
+    for (size_t n = 0; n < count; n++)
+    {
+      int32_t s0 = tb->windowed[n] + mul_q14(c, s1) - s2;
+      s2 = s1;
+      s1 = s0;
+    }
+
+    // |X|² = s1² + s2² - c·s1·s2; com a janela, um seno de amplitude A dá
+    // |X|² = (A·G/2)², G a soma da janela (N/2 na Hann), e o quadrado médio do
+    // tom, A²/2, é 2·|X|²/G²
+    int64_t power = (int64_t)s1 * s1 + (int64_t)s2 * s2 - (int64_t)mul_q14(c, s1) * s2;
+    uint64_t mean_square = power > 0 ? (uint64_t)power * 2 / ((uint64_t)TONE_WINDOW_GAIN * TONE_WINDOW_GAIN) : 0;
+    int16_t level = level_dbfs_x10(mean_square);
+    tb->level_x10[d] = level;
+
+    bool above = level != INT16_MIN && level > tone_threshold_x10[d] && !(tb->masked & (1u << d));
+    if (!above)
+      tb->hold[d] = 0;
+    else if (tb->hold[d] < TONE_BANK_HOLD_BLOCKS)
+      tb->hold[d]++;
+    if (tb->hold[d] >= TONE_BANK_HOLD_BLOCKS)
+      active |= (uint8_t)(1u << d);
+  }
+  tb->active = active;
+  return active;
+}
+
+uint8_t tone_bank_count(void)
+{
+  return TONE_DETECTORS;
+}
+
+uint16_t tone_bank_freq_hz(uint8_t d)
+{
+  return d < TONE_DETECTORS ? tone_freq_hz[d] : 0;
+}
+
+int16_t tone_bank_threshold_x10(uint8_t d)
+{
+  return d < TONE_DETECTORS ? tone_threshold_x10[d] : INT16_MAX;
+}
+
+const char *tone_bank_name(uint8_t d)
+{
+  return d < TONE_DETECTORS ? tone_name[d] : "";
+}
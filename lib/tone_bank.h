@@ -0,0 +1,53 @@
+#ifndef TONE_BANK_H
+#define TONE_BANK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "acquisition.h"
+
+// Banco de detectores de tom (Goertzel em ponto fixo) sobre o bloco do
+// microfone sem DC e sem ponderação. As frequências, os limiares e os nomes
+// vêm de generated/goertzel_coeffs.h (CMake: TONE_DETECTORS). Por bloco, cada
+// detector mede o nível do tom em décimos de dBFS, na escala do nível do
+// microfone (um seno de fundo de escala dá -3 dBFS), depois de uma janela de
+// Hann aplicada uma vez ao bloco para todos os detectores (um tom a três
+// raias da DFT do bloco ou mais fica mais de 30 dB abaixo); fica ativo depois
+// de TONE_BANK_HOLD_BLOCKS blocos seguidos acima do limiar.
+//
+// Mascaramento do buzzer: os detectores a até duas raias da frequência do
+// próprio buzzer ou de uma harmônica ímpar dele (onda quadrada), rebatidas na
+// banda da amostragem, são ignorados enquanto o SOS toca e por
+// TONE_BANK_MASK_TAIL_BLOCKS blocos depois.
+
+#define TONE_BANK_MAX_DETECTORS 8    // Máscara de um byte (verificado contra generated/goertzel_coeffs.h)
+#define TONE_BANK_HOLD_BLOCKS 3      // ~96 ms com blocos de 256 amostras a 8 kHz
+#define TONE_BANK_MASK_HARMONICS 15  // Última harmônica ímpar do buzzer considerada
+#define TONE_BANK_MASK_TAIL_BLOCKS 2 // Blocos mascarados depois do fim do SOS (eco e decaimento)
+
+typedef struct
+{
+  int16_t level_x10[TONE_BANK_MAX_DETECTORS]; // Nível do tom no último bloco (INT16_MIN: sem sinal)
+  uint8_t hold[TONE_BANK_MAX_DETECTORS];       // Blocos seguidos acima do limiar
+  uint8_t maskable;                            // Detectores sobre o buzzer (bit i: detector i)
+  uint8_t masked;                              // Mascarados no último bloco
+  uint8_t active;                              // Ativos no último bloco
+  uint8_t mask_tail;                           // Blocos que ainda faltam mascarar depois do SOS
+  int16_t windowed[ACQ_BLOCK_SAMPLES];         // Bloco com a janela aplicada
+} tone_bank_t;
+
+// mask_hz: frequência do buzzer (0: nada a mascarar)
+void tone_bank_init(tone_bank_t *tb, uint32_t mask_hz);
+// Processa um bloco de até ACQ_BLOCK_SAMPLES amostras; mask diz se o buzzer
+// está tocando. Devolve os detectores ativos
+uint8_t tone_bank_process(tone_bank_t *tb, const int16_t *x, size_t count, bool mask);
+void tone_bank_reset(tone_bank_t *tb); // Zera as contagens (nova monitoração)
+
+// Configuração gerada: número de detectores e, para cada um, frequência,
+// limiar (décimos de dBFS) e nome
+uint8_t tone_bank_count(void);
+uint16_t tone_bank_freq_hz(uint8_t d);
+int16_t tone_bank_threshold_x10(uint8_t d);
+const char *tone_bank_name(uint8_t d);
+
+#endif
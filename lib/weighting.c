@@ -0,0 +1,96 @@
+#include <string.h>
+#include "weighting.h"
+#include "noise_level.h"
+#include "weighting_coeffs.h"
+
+bool weighting_filter_init(weighting_filter_t *f, freq_weighting_t weighting, uint32_t sample_rate_hz)
+{
+  memset(f, 0, sizeof(*f));
+  // Os coeficientes só valem para a taxa em que foram gerados; fora dela fica Z
+  if (weighting != WEIGHTING_Z && sample_rate_hz != WEIGHTING_COEFFS_RATE)
+    return false;
+
+  switch (weighting)
+  {
+  case WEIGHTING_A:
+    f->coeffs = weighting_a_sections;
+    f->sections = sizeof(weighting_a_sections) / sizeof(weighting_a_sections[0]);
+    break;
+  case WEIGHTING_C:
+    f->coeffs = weighting_c_sections;
+    f->sections = sizeof(weighting_c_sections) / sizeof(weighting_c_sections[0]);
+    break;
+  default:
+    f->coeffs = NULL;
+    f->sections = 0;
+    break;
+  }
+  return true;
+}
+
+void weighting_filter_process(weighting_filter_t *f, int16_t *x, size_t len)
+{
+  if (f->sections == 0)
+    return;
+
+  for (size_t n = 0; n < len; n++)
+  {
+    int32_t v = (int32_t)x[n] << WEIGHTING_STATE_SHIFT;
+
+    // Cascata de seções em forma direta I; cada saída alimenta a próxima seção
+    for (uint8_t s = 0; s < f->sections; s++)
+    {
+      const biquad_coeffs_t *c = &f->coeffs[s];
+      int64_t acc = (int64_t)c->b0 * v + (int64_t)c->b1 * f->x1[s] + (int64_t)c->b2 * f->x2[s] -
+                    (int64_t)c->a1 * f->y1[s] - (int64_t)c->a2 * f->y2[s];
+      int32_t y = (int32_t)((acc + (1 << (WEIGHTING_COEF_SHIFT - 1))) >> WEIGHTING_COEF_SHIFT);
+      f->x2[s] = f->x1[s];
+      f->x1[s] = v;
+      f->y2[s] = f->y1[s];
+      f->y1[s] = y;
+      v = y;
+    }
+
+    v = (v + (1 << (WEIGHTING_STATE_SHIFT - 1))) >> WEIGHTING_STATE_SHIFT;
+    if (v > INT16_MAX)
+      v = INT16_MAX;
+    else if (v < INT16_MIN)
+      v = INT16_MIN;
+    x[n] = (int16_t)v;
+  }
+}
+
+void time_weighting_init(time_weighting_t *tw, time_weighting_mode_t mode, uint32_t sample_rate_hz)
+{
+  uint32_t tau_ms = (mode == TIME_WEIGHTING_SLOW) ? 1000 : 125;
+  uint32_t tau_samples = tau_ms * sample_rate_hz / 1000;
+  tw->mean_square = 0;
+  tw->block_max = 0;
+  tw->alpha_q24 = (int32_t)((1u << 24) / (tau_samples ? tau_samples : 1));
+}
+
+void time_weighting_process(time_weighting_t *tw, const int16_t *x, size_t len)
+{
+  // Média exponencial de x²: ms += (x² - ms) · alpha; |x² - ms| < 2^40 e alpha < 2^24
+  int64_t ms = tw->mean_square;
+  int64_t peak = 0;
+  for (size_t n = 0; n < len; n++)
+  {
+    int64_t sq = (int64_t)((int32_t)x[n] * x[n]) << 16;
+    ms += ((sq - ms) * tw->alpha_q24) >> 24;
+    if (ms > peak)
+      peak = ms;
+  }
+  tw->mean_square = ms;
+  tw->block_max = peak;
+}
+
+uint16_t time_weighting_rms(const time_weighting_t *tw)
+{
+  return (uint16_t)level_isqrt64((uint64_t)tw->mean_square >> 16);
+}
+
+uint16_t time_weighting_max_rms(const time_weighting_t *tw)
+{
+  return (uint16_t)level_isqrt64((uint64_t)tw->block_max >> 16);
+}
@@ -0,0 +1,56 @@
+#ifndef WEIGHTING_H
+#define WEIGHTING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Ponderações de frequência (A, C, Z) e de tempo (Fast, Slow) no estilo da
+// IEC 61672, em ponto fixo. Os coeficientes das seções biquad são gerados por
+// tools/gen_weighting_coeffs.py para a taxa de 8 kHz.
+
+#define WEIGHTING_MAX_SECTIONS 3
+#define WEIGHTING_STATE_SHIFT 8 // Bits fracionários extras nos estados do filtro
+
+typedef enum
+{
+  WEIGHTING_Z, // Sem ponderação (filtro desligado)
+  WEIGHTING_A,
+  WEIGHTING_C
+} freq_weighting_t;
+
+typedef enum
+{
+  TIME_WEIGHTING_FAST, // Constante de tempo de 125 ms
+  TIME_WEIGHTING_SLOW  // Constante de tempo de 1 s
+} time_weighting_mode_t;
+
+typedef struct
+{
+  int32_t b0, b1, b2, a1, a2; // Coeficientes em Q28 (a0 = 1)
+} biquad_coeffs_t;
+
+typedef struct
+{
+  const biquad_coeffs_t *coeffs;
+  uint8_t sections;
+  int32_t x1[WEIGHTING_MAX_SECTIONS], x2[WEIGHTING_MAX_SECTIONS]; // Entradas anteriores (Q8)
+  int32_t y1[WEIGHTING_MAX_SECTIONS], y2[WEIGHTING_MAX_SECTIONS]; // Saídas anteriores (Q8)
+} weighting_filter_t;
+
+typedef struct
+{
+  int64_t mean_square; // Média exponencial de x² em Q16
+  int64_t block_max;   // Maior média quadrática dentro do último bloco (Q16)
+  int32_t alpha_q24;   // 1 / (constante de tempo · taxa), em Q24
+} time_weighting_t;
+
+bool weighting_filter_init(weighting_filter_t *f, freq_weighting_t weighting, uint32_t sample_rate_hz);
+void weighting_filter_process(weighting_filter_t *f, int16_t *x, size_t len);
+
+void time_weighting_init(time_weighting_t *tw, time_weighting_mode_t mode, uint32_t sample_rate_hz);
+void time_weighting_process(time_weighting_t *tw, const int16_t *x, size_t len);
+uint16_t time_weighting_rms(const time_weighting_t *tw);
+uint16_t time_weighting_max_rms(const time_weighting_t *tw);
+
+#endif
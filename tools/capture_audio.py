@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""Captura o streaming de áudio do firmware (quadros FRAME_AUDIO) em WAV.
+
+Envia 'S' para ligar o streaming (a monitoração precisa estar ativa para haver
+blocos), ou 'A' com --adpcm para recebê-lo em IMA-ADPCM (lib/adpcm.h, um
+terço dos bytes na USB), grava as amostras em WAV de 16 bits e, no fim (duração atingida,
+Ctrl-C ou fim do fluxo), envia 'P' e relata os saltos na sequência dos blocos,
+o contador de descartes do firmware e os erros de CRC. Os blocos que faltam
+viram silêncio no WAV, para a linha do tempo continuar certa.
+
+Uso: python3 tools/capture_audio.py [-d segundos] [--adpcm] [--text] /dev/ttyACM0 saida.wav
+"""
+import argparse
+import os
+import select
+import struct
+import sys
+import time
+import wave
+
+from frame_stream import FRAME_AUDIO, FrameParser, open_stream
+
+SAMPLE_RATE = 8000  # SAMPLES_PER_SECOND do firmware
+HEADER_FORMAT = "<IIHB"  # seq, descartados, amostras, formato (lib/audio_stream.h)
+HEADER_BYTES = struct.calcsize(HEADER_FORMAT)
+FORMAT_PACKED12 = 1
+FORMAT_ADPCM = 2
+ADC_MIDSCALE = 2048
+ADPCM_HEADER_BYTES = 4
+
+ADPCM_STEPS = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+    107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871,
+    5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623,
+    27086, 29794, 32767]
+ADPCM_INDEX = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def unpack12(data, count):
+    """Desfaz o empacotamento de 2 códigos de 12 bits em 3 bytes."""
+    out = []
+    for i in range(0, count // 2 * 3, 3):
+        b0, b1, b2 = data[i], data[i + 1], data[i + 2]
+        out.append(b0 | (b1 & 0x0F) << 8)
+        out.append(b1 >> 4 | b2 << 4)
+    return out
+
+
+def adpcm_block_bytes(count):
+    return ADPCM_HEADER_BYTES + (count + 1) // 2
+
+
+def decode_adpcm(data, count):
+    """Decodifica um bloco IMA-ADPCM de lib/adpcm.h em amostras PCM de 16 bits."""
+    predictor, index = struct.unpack_from("<hB", data, 0)
+    index = min(index, 88)
+    out = []
+    for i in range(count):
+        byte = data[ADPCM_HEADER_BYTES + i // 2]
+        code = byte >> 4 if i & 1 else byte & 0x0F
+        step = ADPCM_STEPS[index]
+        diff = step >> 3
+        if code & 4:
+            diff += step
+        if code & 2:
+            diff += step >> 1
+        if code & 1:
+            diff += step >> 2
+        predictor = predictor - diff if code & 8 else predictor + diff
+        predictor = max(-32768, min(32767, predictor))
+        index = max(0, min(88, index + ADPCM_INDEX[code & 7]))
+        out.append(predictor)
+    return out
+
+
+def payload_to_pcm16(fmt, data, count):
+    """Amostras de um quadro (12 bits empacotados ou ADPCM) em PCM de 16 bits; None se o tamanho não bate."""
+    if fmt == FORMAT_PACKED12 and len(data) == (count + 1) // 2 * 3:
+        return [(c - ADC_MIDSCALE) << 4 for c in unpack12(data, count + (count & 1))[:count]]
+    if fmt == FORMAT_ADPCM and len(data) == adpcm_block_bytes(count):
+        return decode_adpcm(data, count)
+    return None
+
+
+class Capture:
+    def __init__(self, wav, show_text):
+        self.wav = wav
+        self.show_text = show_text
+        self.parser = FrameParser()
+        self.blocks = 0
+        self.samples = 0
+        self.last_seq = None
+        self.block_samples = 0
+        self.gaps = []  # (primeiro seq perdido, blocos perdidos)
+        self.device_dropped = 0
+        self.bad_blocks = 0
+
+    def feed(self, data):
+        for item in self.parser.feed(data):
+            if item[0] == "text":
+                if self.show_text:
+                    sys.stderr.write(item[1].decode("utf-8", "replace"))
+            elif item[1] == FRAME_AUDIO:
+                self.block(item[2])
+
+    def block(self, payload):
+        if len(payload) < HEADER_BYTES:
+            self.bad_blocks += 1
+            return
+        seq, dropped, count, fmt = struct.unpack_from(HEADER_FORMAT, payload, 0)
+        pcm = payload_to_pcm16(fmt, payload[HEADER_BYTES:], count)
+        if pcm is None:
+            self.bad_blocks += 1
+            return
+        if self.last_seq is not None:
+            missing = (seq - self.last_seq - 1) & 0xFFFFFFFF
+            if missing:
+                self.gaps.append(((self.last_seq + 1) & 0xFFFFFFFF, missing))
+                silence = missing * (self.block_samples or count)
+                self.wav.writeframes(b"\0\0" * silence)
+                self.samples += silence
+        self.wav.writeframes(struct.pack("<%dh" % len(pcm), *pcm))
+        self.samples += len(pcm)
+        self.blocks += 1
+        self.last_seq = seq
+        self.block_samples = count
+        self.device_dropped = dropped
+
+    def report(self, out):
+        lost = sum(n for _, n in self.gaps)
+        out.write("%d blocos recebidos (%.2f s de áudio), %d perdidos em %d saltos\n"
+                  % (self.blocks, self.samples / SAMPLE_RATE, lost, len(self.gaps)))
+        for first, n in self.gaps[:10]:
+            out.write("  seq %d: %d blocos\n" % (first, n))
+        if len(self.gaps) > 10:
+            out.write("  ... mais %d saltos\n" % (len(self.gaps) - 10))
+        out.write("Descartados pelo firmware (sem espaço na USB): %d\n" % self.device_dropped)
+        out.write("Erros de CRC: %d, blocos inválidos: %d\n" % (self.parser.crc_errors, self.bad_blocks))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("port", help="porta serial do firmware (ou o link de detector_sim -p)")
+    ap.add_argument("wav", help="arquivo WAV de saída")
+    ap.add_argument("-d", "--duration", type=float, help="segundos de captura (padrão: até Ctrl-C)")
+    ap.add_argument("--adpcm", action="store_true", help="pede o streaming em ADPCM ('A') em vez de 12 bits ('S')")
+    ap.add_argument("--text", action="store_true", help="repassa o texto do printf para stderr")
+    args = ap.parse_args()
+
+    port = open_stream(args.port, writable=True)
+    wav = wave.open(args.wav, "wb")
+    wav.setnchannels(1)
+    wav.setsampwidth(2)
+    wav.setframerate(SAMPLE_RATE)
+    cap = Capture(wav, args.text)
+
+    port.write(b"A" if args.adpcm else b"S")
+    deadline = time.monotonic() + args.duration if args.duration else None
+    try:
+        while deadline is None or time.monotonic() < deadline:
+            timeout = 0.2 if deadline is None else max(0.0, min(0.2, deadline - time.monotonic()))
+            if not select.select([port], [], [], timeout)[0]:
+                continue
+            try:
+                data = os.read(port.fileno(), 4096)
+            except OSError:
+                data = b""  # EIO: o outro lado do pty fechou
+            if not data:
+                break
+            cap.feed(data)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        try:
+            port.write(b"P")
+        except OSError:
+            pass
+        wav.close()
+    cap.report(sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Decodifica a telemetria binária do firmware (quadros FRAME_TELEMETRY).
+
+Cada registro traz os temporizadores e contadores de lib/instr.h acumulados
+desde o boot; este script mostra a diferença para o registro anterior (média,
+contagem e histograma do período) junto com o mínimo e o máximo desde o boot,
+e calcula a taxa de amostragem real a partir do período dos blocos de áudio.
+O texto do printf que chega intercalado é repassado com --text.
+
+Uso: python3 tools/decode_telemetry.py [--json] [--text] /dev/ttyACM0|arquivo|-
+"""
+import argparse
+import json
+import struct
+import sys
+
+from frame_stream import FRAME_TELEMETRY, open_stream, read_frames
+
+# Mesma ordem dos enums de lib/instr.h
+TIMERS = ["block_period", "block_dsp", "sched_period", "sched_pass", "display_update",
+          "display_transfer", "leds", "buzzer"]
+COUNTERS = ["sched_overruns", "display_bytes", "acq_blocks", "acq_overruns", "level_drops"]
+VERSION = 1
+BLOCK_SAMPLES = 256  # ACQ_BLOCK_SAMPLES
+
+
+def parse_report(payload):
+    version, uptime_ms, n_timers, n_counters, n_bins = struct.unpack_from("<BIBBB", payload, 0)
+    if version != VERSION:
+        raise ValueError("versão %d do registro não suportada" % version)
+    off = 8
+    timers = {}
+    for i in range(n_timers):
+        count, total, tmin, tmax = struct.unpack_from("<4I", payload, off)
+        off += 16
+        hist = list(struct.unpack_from("<%dH" % n_bins, payload, off))
+        off += 2 * n_bins
+        name = TIMERS[i] if i < len(TIMERS) else "timer%d" % i
+        timers[name] = {"count": count, "total_us": total, "min_us": tmin, "max_us": tmax, "hist": hist}
+    counters = {}
+    for i in range(n_counters):
+        name = COUNTERS[i] if i < len(COUNTERS) else "counter%d" % i
+        counters[name] = struct.unpack_from("<I", payload, off)[0]
+        off += 4
+    return {"uptime_ms": uptime_ms, "timers": timers, "counters": counters}
+
+
+def bin_label(k):
+    return "<1" if k == 0 else "%d" % (1 << (k - 1))
+
+
+def summarize(report, previous):
+    """Diferenças em relação ao registro anterior (ou ao boot)."""
+    out = {"uptime_ms": report["uptime_ms"], "timers": {}, "counters": {}}
+    for name, t in report["timers"].items():
+        p = previous["timers"].get(name) if previous else None
+        count = (t["count"] - p["count"]) & 0xFFFFFFFF if p else t["count"]
+        total = (t["total_us"] - p["total_us"]) & 0xFFFFFFFF if p else t["total_us"]
+        hist = [(a - b) & 0xFFFF for a, b in zip(t["hist"], p["hist"])] if p else t["hist"]
+        out["timers"][name] = {"count": count, "mean_us": total / count if count else None,
+                               "min_us": t["min_us"], "max_us": t["max_us"], "hist": hist}
+    for name, v in report["counters"].items():
+        p = previous["counters"].get(name) if previous else 0
+        out["counters"][name] = {"total": v, "delta": (v - p) & 0xFFFFFFFF}
+    period = out["timers"].get("block_period")
+    out["sample_rate_hz"] = BLOCK_SAMPLES * 1e6 / period["mean_us"] if period and period["mean_us"] else None
+    return out
+
+
+def print_summary(s):
+    rate = "%.1f Hz" % s["sample_rate_hz"] if s["sample_rate_hz"] else "-"
+    print("t=%.3f s  taxa de amostragem %s" % (s["uptime_ms"] / 1000, rate))
+    print("  %-17s %7s %10s %9s %9s  histograma (µs: n)" % ("", "n", "média", "mín", "máx"))
+    for name, t in s["timers"].items():
+        mean = "%.1f" % t["mean_us"] if t["mean_us"] is not None else "-"
+        hist = " ".join("%s:%d" % (bin_label(k), n) for k, n in enumerate(t["hist"]) if n)
+        print("  %-17s %7d %10s %9d %9d  %s" % (name, t["count"], mean, t["min_us"], t["max_us"], hist))
+    print("  " + "  ".join("%s=%d(+%d)" % (k, v["total"], v["delta"]) for k, v in s["counters"].items()))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("source", help="porta serial, arquivo capturado ou - para stdin")
+    ap.add_argument("--json", action="store_true", help="uma linha JSON por registro")
+    ap.add_argument("--text", action="store_true", help="repassa o texto fora dos quadros para stderr")
+    args = ap.parse_args()
+
+    previous = None
+    try:
+        for item in read_frames(open_stream(args.source)):
+            if item[0] == "text":
+                if args.text:
+                    sys.stderr.write(item[1].decode("utf-8", "replace"))
+                continue
+            _, ftype, payload = item
+            if ftype != FRAME_TELEMETRY:
+                continue
+            report = parse_report(payload)
+            s = summarize(report, previous)
+            previous = report
+            if args.json:
+                print(json.dumps(s))
+            else:
+                print_summary(s)
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
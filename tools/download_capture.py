@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Baixa a captura de áudio do último alarme (quadros FRAME_CAPTURE) em WAV.
+
+Envia 'C' (ou 'D' com --adpcm, para receber em IMA-ADPCM com um terço dos
+bytes); o firmware responde com a janela congelada em volta do alarme
+(lib/capture.h) sem parar a monitoração e a rearma no fim. O WAV começa
+CAPTURE_PRE_MS antes do início do bloco que disparou o alarme (ou no início
+da aquisição, se ela foi mais curta); a posição do gatilho é impressa e, com
+--marker, também vira um chunk "cue " no WAV.
+
+Uso: python3 tools/download_capture.py [-t segundos] [--marker] [--adpcm] /dev/ttyACM0 saida.wav
+"""
+import argparse
+import os
+import select
+import struct
+import sys
+import time
+import wave
+
+from capture_audio import SAMPLE_RATE, payload_to_pcm16
+from frame_stream import FRAME_CAPTURE, FrameParser, open_stream
+
+HEADER_FORMAT = "<IIIIHB"  # número, pré-gatilho, total, posição, amostras, formato (lib/capture.h)
+HEADER_BYTES = struct.calcsize(HEADER_FORMAT)
+
+
+def add_cue(path, sample):
+    """Acrescenta um chunk "cue " com um ponto na amostra do gatilho."""
+    cue = struct.pack("<I", 1) + struct.pack("<II4sIII", 1, sample, b"data", 0, 0, sample)
+    with open(path, "r+b") as f:
+        f.seek(0, os.SEEK_END)
+        f.write(b"cue " + struct.pack("<I", len(cue)) + cue)
+        size = f.tell() - 8
+        f.seek(4)
+        f.write(struct.pack("<I", size))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("port", help="porta serial do firmware (ou o link de detector_sim -p)")
+    ap.add_argument("wav", help="arquivo WAV de saída")
+    ap.add_argument("-t", "--timeout", type=float, default=10.0, help="segundos esperando a captura (padrão 10)")
+    ap.add_argument("--marker", action="store_true", help="marca o gatilho com um chunk cue no WAV")
+    ap.add_argument("--adpcm", action="store_true", help="pede a captura em ADPCM ('D') em vez de 12 bits ('C')")
+    args = ap.parse_args()
+
+    port = open_stream(args.port, writable=True)
+    parser = FrameParser()
+    pcm = None
+    info = None
+    received = 0
+    text = b""
+    port.write(b"D" if args.adpcm else b"C")
+    deadline = time.monotonic() + args.timeout
+    while time.monotonic() < deadline:
+        if not select.select([port], [], [], 0.2)[0]:
+            continue
+        try:
+            data = os.read(port.fileno(), 4096)
+        except OSError:
+            data = b""
+        if not data:
+            break
+        for item in parser.feed(data):
+            if item[0] == "text":
+                text += item[1]
+                if b"nenhuma pronta" in text:
+                    sys.stderr.write("Nenhuma captura pronta no firmware\n")
+                    return 1
+                continue
+            if item[1] != FRAME_CAPTURE or len(item[2]) < HEADER_BYTES:
+                continue
+            number, trigger, total, pos, count, fmt = struct.unpack_from(HEADER_FORMAT, item[2], 0)
+            chunk = payload_to_pcm16(fmt, item[2][HEADER_BYTES:], count)
+            if chunk is None or pos + count > total:
+                continue
+            if info is None or info[0] != number:
+                info = (number, trigger, total)
+                pcm = [None] * total
+                received = 0
+            for i, v in enumerate(chunk):
+                if pcm[pos + i] is None:
+                    received += 1
+                pcm[pos + i] = v
+        if info and received == info[2]:
+            break
+
+    if not info or received != info[2]:
+        sys.stderr.write("Captura incompleta: %d de %d amostras\n" % (received, info[2] if info else 0))
+        return 1
+
+    number, trigger, total = info
+    wav = wave.open(args.wav, "wb")
+    wav.setnchannels(1)
+    wav.setsampwidth(2)
+    wav.setframerate(SAMPLE_RATE)
+    wav.writeframes(struct.pack("<%dh" % total, *pcm))
+    wav.close()
+    if args.marker:
+        add_cue(args.wav, trigger)
+    print("Captura %d: %d amostras (%.3f s), gatilho na amostra %d (%.3f s)"
+          % (number, total, total / SAMPLE_RATE, trigger, trigger / SAMPLE_RATE))
+    print("Erros de CRC: %d" % parser.crc_errors)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,94 @@
+"""Leitura dos quadros binários de lib/frame.h em um fluxo USB CDC.
+
+Formato: 0xA5 0x5A | tipo | tamanho (16 bits LE) | dados | CRC-16 (LE), com o
+CRC-16/CCITT-FALSE (binascii.crc_hqx com valor inicial 0xFFFF) sobre tipo,
+tamanho e dados. Bytes fora de quadros (o texto do printf) são devolvidos à
+parte, e uma sincronia que não fecha o CRC é tratada como texto.
+"""
+import binascii
+import os
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+HEADER_BYTES = 5
+TRAILER_BYTES = 2
+MAX_PAYLOAD = 1024
+
+FRAME_TELEMETRY = 0x01
+FRAME_AUDIO = 0x02
+FRAME_CAPTURE = 0x03
+
+
+def open_stream(path, writable=False):
+    """Abre um arquivo, '-' (stdin) ou uma porta serial (em modo cru).
+
+    Com writable a porta também aceita escrita, para os comandos ao firmware.
+    """
+    if path == "-":
+        return sys.stdin.buffer
+    f = open(path, "r+b" if writable else "rb", buffering=0)
+    if os.isatty(f.fileno()):
+        import termios
+        import tty
+        tty.setraw(f.fileno())
+        attrs = termios.tcgetattr(f.fileno())
+        attrs[6][termios.VMIN] = 1
+        attrs[6][termios.VTIME] = 0
+        termios.tcsetattr(f.fileno(), termios.TCSANOW, attrs)
+    return f
+
+
+class FrameParser:
+    """Acumula bytes e separa quadros válidos do restante do fluxo."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.crc_errors = 0
+
+    def feed(self, data):
+        """Devolve uma lista de ("frame", tipo, dados) e ("text", bytes)."""
+        self.buf += data
+        out = []
+        while True:
+            start = self.buf.find(SYNC)
+            if start < 0:
+                # Guarda um possível primeiro byte de sincronia no fim
+                keep = 1 if self.buf.endswith(SYNC[:1]) else 0
+                if len(self.buf) > keep:
+                    out.append(("text", bytes(self.buf[:len(self.buf) - keep])))
+                    del self.buf[:len(self.buf) - keep]
+                return out
+            if start:
+                out.append(("text", bytes(self.buf[:start])))
+                del self.buf[:start]
+            if len(self.buf) < HEADER_BYTES:
+                return out
+            ftype, length = self.buf[2], struct.unpack_from("<H", self.buf, 3)[0]
+            if length > MAX_PAYLOAD:
+                out.append(("text", bytes(self.buf[:1])))
+                del self.buf[:1]
+                continue
+            total = HEADER_BYTES + length + TRAILER_BYTES
+            if len(self.buf) < total:
+                return out
+            crc = binascii.crc_hqx(bytes(self.buf[2:HEADER_BYTES + length]), 0xFFFF)
+            if crc != struct.unpack_from("<H", self.buf, HEADER_BYTES + length)[0]:
+                self.crc_errors += 1
+                out.append(("text", bytes(self.buf[:1])))
+                del self.buf[:1]
+                continue
+            out.append(("frame", ftype, bytes(self.buf[HEADER_BYTES:HEADER_BYTES + length])))
+            del self.buf[:total]
+
+
+def read_frames(stream, chunk=4096):
+    """Gera os itens de FrameParser.feed() até o fim do fluxo."""
+    parser = FrameParser()
+    while True:
+        data = stream.read(chunk)
+        if not data:
+            break
+        yield from parser.feed(data)
+    if parser.buf:
+        yield ("text", bytes(parser.buf))
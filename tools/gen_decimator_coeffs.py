@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Gera generated/decimator_coeffs.h com o FIR de compensação do decimador.
+
+O microfone é amostrado a taxa_saida · 12 e decimado em dois estágios
+(lib/decimator.h): um CIC de ordem 4 que divide por 6 e este FIR, que divide
+por 2. O FIR é simétrico e projetado por mínimos quadrados ponderados sobre
+uma grade densa: na banda passante o alvo é o inverso da queda do CIC (a
+resposta conjunta fica plana) e na banda de rejeição, que depois da divisão
+por 2 dobraria sobre a banda passante, o alvo é zero. O ganho DC dos
+coeficientes desfaz o ganho do CIC que sobra depois do deslocamento.
+
+A resposta conjunta (CIC + FIR) é impressa em stderr: ondulação na banda
+passante e a pior rejeição das frequências que dobram sobre ela.
+
+Uso: python3 tools/gen_decimator_coeffs.py [taxa_saida_hz] [saida.h]
+"""
+import math
+import sys
+
+FS_OUT = int(sys.argv[1]) if len(sys.argv) > 1 else 8000
+OUT = sys.argv[2] if len(sys.argv) > 2 else None
+
+CIC_ORDER = 4
+CIC_RATIO = 6
+CIC_SHIFT = 7  # Ganho do CIC (6^4 = 1296) reduzido para 10,125 antes do FIR
+FIR_RATIO = 2
+FIR_TAPS = 31
+COEF_SHIFT = 18  # Coeficientes em Q18
+
+FS_RAW = FS_OUT * CIC_RATIO * FIR_RATIO
+FS_FIR = FS_OUT * FIR_RATIO  # Taxa na entrada do FIR
+F_PASS = 0.4 * FS_OUT        # 3,2 kHz a 8 kHz
+F_STOP = FS_OUT - F_PASS     # Acima daqui dobra sobre a banda passante
+STOP_WEIGHT = 30.0
+CIC_GAIN = CIC_RATIO ** CIC_ORDER / (1 << CIC_SHIFT)
+
+
+def cic_response(f):
+    """Módulo da resposta do CIC normalizada (ganho DC 1), f em Hz."""
+    x = math.pi * f / FS_RAW
+    if x == 0:
+        return 1.0
+    return abs(math.sin(CIC_RATIO * x) / (CIC_RATIO * math.sin(x))) ** CIC_ORDER
+
+
+def fir_response(h, f):
+    w = 2 * math.pi * f / FS_FIR
+    m = (len(h) - 1) // 2
+    return h[m] + 2 * sum(h[m - k] * math.cos(k * w) for k in range(1, m + 1))
+
+
+def solve(a, b):
+    """Eliminação de Gauss com pivoteamento parcial."""
+    n = len(b)
+    for i in range(n):
+        p = max(range(i, n), key=lambda r: abs(a[r][i]))
+        a[i], a[p] = a[p], a[i]
+        b[i], b[p] = b[p], b[i]
+        for r in range(i + 1, n):
+            k = a[r][i] / a[i][i]
+            for c in range(i, n):
+                a[r][c] -= k * a[i][c]
+            b[r] -= k * b[i]
+    x = [0.0] * n
+    for i in reversed(range(n)):
+        x[i] = (b[i] - sum(a[i][c] * x[c] for c in range(i + 1, n))) / a[i][i]
+    return x
+
+
+def design():
+    m = (FIR_TAPS - 1) // 2
+    grid = []
+    for i in range(600):
+        f = F_PASS * i / 599
+        grid.append((f, 1.0 / cic_response(f), 1.0))
+    for i in range(600):
+        f = F_STOP + (FS_FIR / 2 - F_STOP) * i / 599
+        grid.append((f, 0.0, STOP_WEIGHT))
+    # H(w) = c0 + 2·Σ ck·cos(k·w): mínimos quadrados sobre os m + 1 coeficientes
+    n = m + 1
+    ata = [[0.0] * n for _ in range(n)]
+    atb = [0.0] * n
+    for f, d, wt in grid:
+        w = 2 * math.pi * f / FS_FIR
+        row = [1.0] + [2 * math.cos(k * w) for k in range(1, n)]
+        for i in range(n):
+            atb[i] += wt * row[i] * d
+            for j in range(n):
+                ata[i][j] += wt * row[i] * row[j]
+    c = solve(ata, atb)
+    h = [c[abs(k - m)] for k in range(FIR_TAPS)]
+    dc = sum(h)
+    return [x / dc for x in h]  # Ganho DC exato de 1 (a compensação fica relativa ao DC)
+
+
+def quantize(h):
+    scale = (1 << COEF_SHIFT) / CIC_GAIN
+    return [round(x * scale) for x in h]
+
+
+def report(q):
+    h = [x * CIC_GAIN / (1 << COEF_SHIFT) for x in q]
+    passband = [20 * math.log10(cic_response(f) * abs(fir_response(h, f)))
+                for f in (F_PASS * i / 100 for i in range(101))]
+    # Frequências da entrada que caem na banda passante depois das duas divisões
+    worst = -1e9
+    for i in range(1, 2001):
+        f = FS_RAW / 2 * i / 2000
+        folded = f % FS_OUT
+        folded = min(folded, FS_OUT - folded)
+        if folded > F_PASS or f <= F_PASS:
+            continue
+        g = cic_response(f) * abs(fir_response(h, f % FS_FIR if f % FS_FIR <= FS_FIR / 2 else FS_FIR - f % FS_FIR))
+        worst = max(worst, 20 * math.log10(max(g, 1e-12)))
+    print(f"Decimador {FS_RAW} Hz -> {FS_OUT} Hz: banda passante 0-{F_PASS:.0f} Hz com "
+          f"{min(passband):+.2f} a {max(passband):+.2f} dB; dobras sobre ela <= {worst:.1f} dB", file=sys.stderr)
+
+
+q = quantize(design())
+report(q)
+
+lines = [
+    "// Gerado por tools/gen_decimator_coeffs.py - não editar manualmente",
+    f"// FIR de compensação de {FIR_TAPS} taps simétricos em Q{COEF_SHIFT}, com ganho DC 1 / {CIC_GAIN:g}",
+    f"#define DECIMATOR_COEFFS_RATE {FS_OUT}",
+    f"#define DECIMATOR_CIC_ORDER {CIC_ORDER}",
+    f"#define DECIMATOR_CIC_RATIO {CIC_RATIO}",
+    f"#define DECIMATOR_CIC_SHIFT {CIC_SHIFT}",
+    f"#define DECIMATOR_FIR_RATIO {FIR_RATIO}",
+    f"#define DECIMATOR_FIR_TAPS {FIR_TAPS}",
+    f"#define DECIMATOR_COEF_SHIFT {COEF_SHIFT}",
+    "",
+    "// Primeira metade dos taps (o central é o último); a outra é o espelho",
+    f"static const int32_t decimator_fir[{(FIR_TAPS + 1) // 2}] = {{",
+]
+half = q[:(FIR_TAPS + 1) // 2]
+for i in range(0, len(half), 8):
+    lines.append("    " + ", ".join(str(x) for x in half[i:i + 8]) + ",")
+lines.append("};")
+
+text = "\n".join(lines) + "\n"
+if OUT:
+    with open(OUT, "w", encoding="utf-8") as f:
+        f.write(text)
+else:
+    sys.stdout.write(text)
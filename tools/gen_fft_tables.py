@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Gera generated/fft_tables.h para o analisador de bandas (lib/spectrum.c).
+
+Tabelas para uma FFT real de N pontos calculada como FFT complexa de N/2:
+janela de Hann, fatores de giro cos/sin em Q15, permutação bit-reversa e os
+intervalos de raias de cada banda de oitava e de terço de oitava.
+
+Uso: python3 tools/gen_fft_tables.py [N] [taxa_hz] [saida.h]
+"""
+import math
+import sys
+
+N = int(sys.argv[1]) if len(sys.argv) > 1 else 512
+FS = int(sys.argv[2]) if len(sys.argv) > 2 else 8000
+OUT = sys.argv[3] if len(sys.argv) > 3 else None
+M = N // 2
+
+if N not in (256, 512):
+    sys.exit("N deve ser 256 ou 512")
+
+
+def q15(v):
+    return max(-32768, min(32767, round(v * 32768)))
+
+
+def bitrev(i, bits):
+    r = 0
+    for _ in range(bits):
+        r = (r << 1) | (i & 1)
+        i >>= 1
+    return r
+
+
+def band_bins(centers, half_ratio):
+    """Raias cujo centro cai em [fc/r, fc·r); bandas vazias usam a raia mais próxima."""
+    df = FS / N
+    out = []
+    for fc in centers:
+        lo, hi = fc / half_ratio, fc * half_ratio
+        bins = [k for k in range(1, M) if lo <= k * df < hi]
+        if not bins:
+            k = min(M - 1, max(1, round(fc / df)))
+            bins = [k]
+        out.append((fc, bins[0], bins[-1]))
+    return out
+
+
+octave = band_bins([1000 * 2 ** n for n in range(-5, 2)], math.sqrt(2))
+third = band_bins([1000 * 10 ** (n / 10) for n in range(-15, 6)], 2 ** (1 / 6))
+bits = M.bit_length() - 1
+
+lines = []
+emit = lines.append
+emit("// Gerado por tools/gen_fft_tables.py - não editar manualmente")
+emit(f"#define FFT_TABLE_SIZE {N}")
+emit(f"#define FFT_TABLE_RATE {FS}")
+emit(f"#define FFT_OCTAVE_BANDS {len(octave)}")
+emit(f"#define FFT_THIRD_OCTAVE_BANDS {len(third)}")
+emit("")
+
+
+def array(ctype, name, values, per_line=12):
+    emit(f"static const {ctype} {name}[{len(values)}] = {{")
+    for i in range(0, len(values), per_line):
+        emit("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    emit("};")
+    emit("")
+
+
+# Hann periódica em Q15
+array("int16_t", "fft_window", [q15(0.5 * (1 - math.cos(2 * math.pi * n / N))) for n in range(N)])
+# W_N^k = cos - j·sin, k < N/2
+array("int16_t", "fft_cos", [q15(math.cos(2 * math.pi * k / N)) for k in range(M)])
+array("int16_t", "fft_sin", [q15(math.sin(2 * math.pi * k / N)) for k in range(M)])
+array("uint8_t", "fft_bitrev", [bitrev(i, bits) for i in range(M)], 16)
+
+for name, bands in (("octave", octave), ("third_octave", third)):
+    array("uint16_t", f"fft_{name}_center_hz", [round(fc) for fc, _, _ in bands])
+    array("uint16_t", f"fft_{name}_first_bin", [a for _, a, _ in bands])
+    array("uint16_t", f"fft_{name}_last_bin", [b for _, _, b in bands])
+
+text = "\n".join(lines).rstrip() + "\n"
+if OUT:
+    with open(OUT, "w", encoding="utf-8") as f:
+        f.write(text)
+else:
+    sys.stdout.write(text)
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""Gera generated/goertzel_coeffs.h com o banco de detectores de tom.
+
+Cada detector é descrito por "frequência_hz:limiar_dbfs:nome": o Goertzel de
+lib/tone_bank.h mede, por bloco, o nível do tom na frequência (em dBFS, na
+mesma escala do nível do microfone) e o detector alerta acima do limiar. O
+coeficiente 2·cos(2π·f/fs) sai em Q14. O bloco passa antes por uma janela de
+Hann (Q15, a mesma para todos os detectores): o lóbulo principal vai a duas
+raias da DFT do bloco (fs / bloco, 31,25 Hz com 256 amostras a 8 kHz) de cada
+lado, e um tom a três raias ou mais já fica mais de 30 dB abaixo.
+O nome aparece no display e na USB (até 8 letras, dígitos, '-' ou '.').
+
+Uso: python3 tools/gen_goertzel_coeffs.py taxa_hz amostras_bloco saida.h detector [detector ...]
+"""
+import math
+import re
+import sys
+
+COEFF_SHIFT = 14
+WINDOW_SHIFT = 15
+MAX_DETECTORS = 8  # Máscara de um byte nas mensagens do núcleo 1
+MIN_FREQ_HZ = 50   # Abaixo disso a raia encosta no DC que o removedor de DC deixa passar
+
+
+def parse(spec, rate):
+    parts = spec.split(":")
+    if len(parts) != 3:
+        sys.exit("detector inválido (esperado frequência:limiar:nome): %s" % spec)
+    freq, threshold, name = float(parts[0]), float(parts[1]), parts[2]
+    if not MIN_FREQ_HZ <= freq <= rate / 2 - MIN_FREQ_HZ:
+        sys.exit("frequência fora de %d a %d Hz: %s" % (MIN_FREQ_HZ, rate // 2 - MIN_FREQ_HZ, spec))
+    if not re.fullmatch(r"[A-Za-z0-9.\-]{1,8}", name):
+        sys.exit("nome com até 8 letras, dígitos, '-' ou '.': %s" % spec)
+    return freq, int(round(threshold * 10)), name
+
+
+def q15(v):
+    return max(-32768, min(32767, round(v * (1 << WINDOW_SHIFT))))
+
+
+def main():
+    if len(sys.argv) < 5:
+        sys.exit(__doc__.strip().splitlines()[-1])
+    rate, block, out = int(sys.argv[1]), int(sys.argv[2]), sys.argv[3]
+    detectors = [parse(s, rate) for s in sys.argv[4:] if s]
+    if not 1 <= len(detectors) <= MAX_DETECTORS:
+        sys.exit("de 1 a %d detectores" % MAX_DETECTORS)
+
+    coeffs = [int(round(2 * math.cos(2 * math.pi * f / rate) * (1 << COEFF_SHIFT))) for f, _, _ in detectors]
+    window = [q15(0.5 * (1 - math.cos(2 * math.pi * i / block))) for i in range(block)]  # Hann periódica
+    gain = int(round(sum(window) / (1 << WINDOW_SHIFT)))  # Soma da janela: a amplitude de um tom na DFT é A·ganho/2
+    n = len(detectors)
+    lines = [
+        "// Gerado por tools/gen_goertzel_coeffs.py - não editar manualmente",
+        "// Banco de detectores de tom: 2·cos(2π·f/fs) em Q%d, limiar em décimos de dBFS" % COEFF_SHIFT,
+        "#define TONE_COEFFS_RATE %d" % rate,
+        "#define TONE_COEFFS_BLOCK %d" % block,
+        "#define TONE_COEFF_SHIFT %d" % COEFF_SHIFT,
+        "#define TONE_DETECTORS %d" % n,
+        "#define TONE_WINDOW_SHIFT %d" % WINDOW_SHIFT,
+        "#define TONE_WINDOW_GAIN %d" % gain,
+        "",
+        "static const uint16_t tone_freq_hz[%d] = {%s};" % (n, ", ".join(str(int(round(f))) for f, _, _ in detectors)),
+        "static const int32_t tone_coeff[%d] = {%s};" % (n, ", ".join(str(c) for c in coeffs)),
+        "static const int16_t tone_threshold_x10[%d] = {%s};" % (n, ", ".join(str(t) for _, t, _ in detectors)),
+        "static const char *const tone_name[%d] = {%s};" % (n, ", ".join('"%s"' % name for _, _, name in detectors)),
+        "",
+        "static const int16_t tone_window[%d] = {" % block,
+    ]
+    for i in range(0, block, 12):
+        lines.append("    " + ", ".join(str(v) for v in window[i:i + 12]) + ",")
+    lines.append("};")
+    with open(out, "w") as f:
+        f.write("\n".join(lines) + "\n")
+    for (freq, threshold, name), c in zip(detectors, coeffs):
+        actual = rate * math.acos(c / (1 << COEFF_SHIFT) / 2) / (2 * math.pi)
+        sys.stderr.write("%-8s %7.1f Hz (coeficiente em %.2f Hz), limiar %.1f dBFS\n"
+                         % (name, freq, actual, threshold / 10))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Gera generated/weighting_coeffs.h com as seções biquad das ponderações A e C.
+
+Os polos analógicos da IEC 61672-1 são mapeados pela transformação casada
+(z = e^(-w/fs)) e os zeros em s = 0 viram zeros em z = 1. Como todos os polos
+usados estão bem abaixo de Nyquist, isso preserva a forma da curva sem a
+compressão de frequência da bilinear. O par de polos em 12194 Hz fica acima de
+Nyquist a 8 kHz; no lugar dele entra uma seção FIR (1 + c·z^-1) ajustada para
+reproduzir a mesma atenuação até ~3,5 kHz. O desvio final em relação à tabela
+da norma é impresso em stderr.
+
+Uso: python3 tools/gen_weighting_coeffs.py [taxa_hz] [saida.h]
+"""
+import cmath
+import math
+import sys
+
+FS = int(sys.argv[1]) if len(sys.argv) > 1 else 8000
+OUT = sys.argv[2] if len(sys.argv) > 2 else None
+COEF_SHIFT = 28  # Coeficientes em Q28
+
+F1, F2, F3, F4 = 20.598997, 107.65265, 737.86223, 12194.217
+
+# Valores nominais da IEC 61672-1 (dB), até abaixo de Nyquist
+IEC_A = {20: -50.5, 31.5: -39.4, 63: -26.2, 125: -16.1, 250: -8.6, 500: -3.2,
+         1000: 0.0, 1250: 0.6, 1600: 1.0, 2000: 1.2, 2500: 1.3, 3150: 1.2}
+IEC_C = {20: -6.2, 31.5: -3.0, 63: -0.8, 125: -0.2, 250: 0.0, 500: 0.0,
+         1000: 0.0, 1250: 0.0, 1600: -0.1, 2000: -0.2, 2500: -0.3, 3150: -0.5}
+
+
+def digital_pole(f):
+    return math.exp(-2 * math.pi * f / FS)
+
+
+def highpass_section(fa, fb):
+    """s² / ((s + wa)(s + wb)) -> zeros duplos em z = 1."""
+    pa, pb = digital_pole(fa), digital_pole(fb)
+    b = [1.0, -2.0, 1.0]
+    a = [1.0, -(pa + pb), pa * pb]
+    return b, a
+
+
+def hf_section():
+    """Aproxima o par de polos em F4 por (1 + c·z^-1) / (1 + c)."""
+    def atten(c, f):
+        w = 2 * math.pi * f / FS
+        return 10 * math.log10((1 + c * c + 2 * c * math.cos(w)) / (1 + c) ** 2)
+
+    def target(f):
+        return -20 * math.log10(1 + (f / F4) ** 2)
+
+    freqs = [f for f in (1000, 1250, 1600, 2000, 2500, 3150, 3500) if f < FS / 2]
+    best_c = min((i / 1000 for i in range(400)),
+                 key=lambda c: max(abs(atten(c, f) - target(f)) for f in freqs))
+    return [1.0 / (1 + best_c), best_c / (1 + best_c), 0.0], [1.0, 0.0, 0.0]
+
+
+def response(sections, f):
+    z = cmath.exp(-2j * math.pi * f / FS)
+    h = 1
+    for b, a in sections:
+        h *= (b[0] + b[1] * z + b[2] * z * z) / (a[0] + a[1] * z + a[2] * z * z)
+    return h
+
+
+def normalize(sections):
+    g = abs(response(sections, 1000.0))
+    b, a = sections[-1]
+    sections[-1] = ([x / g for x in b], a)
+    return sections
+
+
+def quantize(sections):
+    q = []
+    for b, a in sections:
+        q.append([round(x * (1 << COEF_SHIFT)) for x in (b[0], b[1], b[2], a[1], a[2])])
+    return q
+
+
+def dequantize(q):
+    return [([c[0] / (1 << COEF_SHIFT), c[1] / (1 << COEF_SHIFT), c[2] / (1 << COEF_SHIFT)],
+             [1.0, c[3] / (1 << COEF_SHIFT), c[4] / (1 << COEF_SHIFT)]) for c in q]
+
+
+def report(name, q, table):
+    secs = dequantize(q)
+    print(f"{name} @ {FS} Hz: f, calculado, IEC, desvio (dB)", file=sys.stderr)
+    for f, ref in table.items():
+        db = 20 * math.log10(abs(response(secs, f)))
+        print(f"  {f:7.1f} {db:7.2f} {ref:6.1f} {db - ref:+6.2f}", file=sys.stderr)
+
+
+def emit(name, q):
+    out(f"static const biquad_coeffs_t {name}[{len(q)}] = {{")
+    for c in q:
+        out("    {" + ", ".join(str(x) for x in c) + "},")
+    out("};")
+
+
+a_sections = quantize(normalize([highpass_section(F1, F1), highpass_section(F2, F3), hf_section()]))
+c_sections = quantize(normalize([highpass_section(F1, F1), hf_section()]))
+report("A", a_sections, IEC_A)
+report("C", c_sections, IEC_C)
+
+lines = []
+
+
+def out(text=""):
+    lines.append(text)
+
+
+out("// Gerado por tools/gen_weighting_coeffs.py - não editar manualmente")
+out("// Seções biquad {b0, b1, b2, a1, a2} em Q%d" % COEF_SHIFT)
+out(f"#define WEIGHTING_COEFFS_RATE {FS}")
+out(f"#define WEIGHTING_COEF_SHIFT {COEF_SHIFT}")
+out()
+emit("weighting_a_sections", a_sections)
+out()
+emit("weighting_c_sections", c_sections)
+
+text = "\n".join(lines) + "\n"
+if OUT:
+    with open(OUT, "w", encoding="utf-8") as f:
+        f.write(text)
+else:
+    sys.stdout.write(text)